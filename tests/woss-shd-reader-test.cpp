@@ -0,0 +1,260 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2020 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+
+/**
+ * @file   woss-shd-reader-test.cpp
+ * @author Federico Guerra
+ *
+ * \brief Tests woss::ShdResReader
+ *
+ * Checks that memory mapped SHD files give the same Pressure values of the stream reader,
+ * also when several runs share the same result file
+ */
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <stdint.h>
+#include <bellhop-woss.h>
+#include <ac-toolbox-shd-reader.h>
+#include "woss-test.h"
+
+using namespace std;
+using namespace woss;
+
+
+class WossShdReaderTest : public WossTest {
+
+  public:
+
+  WossShdReaderTest();
+
+  virtual ~WossShdReaderTest() {}
+
+
+  private:
+
+  virtual void doConfig();
+
+  virtual void doInit();
+
+  virtual void doRun();
+
+
+  void writeShdFile( const string& name, unsigned int seed ) const;
+
+  void readRuns( bool use_mmap, const vector< string >& run_files, vector< complex<double> >& values ) const;
+
+  void checkEqual( const vector< complex<double> >& first, const vector< complex<double> >& second, double scale ) const;
+
+
+  int total_tx_depths;
+  int total_rx_depths;
+  int total_rx_ranges;
+  double frequency;
+  double precision;
+
+  string first_file;
+  string second_file;
+};
+
+WossShdReaderTest::WossShdReaderTest()
+: WossTest(),
+  total_tx_depths(3),
+  total_rx_depths(4),
+  total_rx_ranges(50),
+  frequency(1000.0),
+  precision(1.0e-6),
+  first_file("./woss-shd-reader-test-1.shd"),
+  second_file("./woss-shd-reader-test-2.shd")
+{
+  //debug = true;
+}
+
+void WossShdReaderTest::doConfig() {
+}
+
+void WossShdReaderTest::doInit() {
+  writeShdFile(first_file, 1);
+  writeShdFile(second_file, 2);
+}
+
+void WossShdReaderTest::writeShdFile( const string& name, unsigned int seed ) const {
+  // BELLHOP_CREATOR_SHD_FILE_SYNTAX_1 layout, one frequency and one bearing
+  int record_length = 2 * total_rx_ranges;
+  if (record_length < 40) record_length = 40;
+
+  size_t record_size = 4 * record_length;
+  int total_records = 10 + total_tx_depths * total_rx_depths;
+  vector<char> buffer(total_records * record_size, 0);
+  char* data = &buffer[0];
+
+  int32_t length = record_length;
+  memcpy(data, &length, sizeof(int32_t));
+  memcpy(data + record_size, "rectilin  ", 10);
+
+  int32_t header[7] = { 1, 1, 1, 1, total_tx_depths, total_rx_depths, total_rx_ranges };
+  double freq_header[2] = { frequency, 0.0 };
+  memcpy(data + 2 * record_size, header, sizeof(header));
+  memcpy(data + 2 * record_size + sizeof(header), freq_header, sizeof(freq_header));
+  memcpy(data + 3 * record_size, &frequency, sizeof(double));
+
+  for (int i = 0; i < total_tx_depths; ++i) {
+    float depth = 10.0 * (i + 1);
+    memcpy(data + 7 * record_size + i * sizeof(float), &depth, sizeof(float));
+  }
+  for (int i = 0; i < total_rx_depths; ++i) {
+    float depth = 5.0 + 10.0 * i;
+    memcpy(data + 8 * record_size + i * sizeof(float), &depth, sizeof(float));
+  }
+  for (int i = 0; i < total_rx_ranges; ++i) {
+    double range = 10.0 * (i + 1);
+    memcpy(data + 9 * record_size + i * sizeof(double), &range, sizeof(double));
+  }
+
+  srand(seed);
+  for (int rec = 10; rec < total_records; ++rec) {
+    for (int i = 0; i < 2 * total_rx_ranges; ++i) {
+      float value = rand() / (float)RAND_MAX;
+      memcpy(data + rec * record_size + i * sizeof(float), &value, sizeof(float));
+    }
+  }
+
+  ofstream out(name.c_str(), ios::binary);
+  out.write(data, buffer.size());
+  if (!out) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_IO_ERROR);
+  }
+}
+
+void WossShdReaderTest::readRuns( bool use_mmap, const vector< string >& run_files, vector< complex<double> >& values ) const {
+  BellhopWoss woss;
+  woss.setBellhopShdSyntax(BELLHOP_CREATOR_SHD_FILE_SYNTAX_1).setShdMmapReadFlag(use_mmap);
+  woss.setTotalRuns(run_files.size());
+
+  ShdResReader reader(&woss);
+
+  for (vector< string >::const_iterator it = run_files.begin(); it != run_files.end(); ++it) {
+    reader.setFileName(*it);
+    if (!reader.initialize()) {
+      throw WOSS_EXCEPTION(WOSS_ERROR_IO_ERROR);
+    }
+  }
+
+  values.clear();
+  for (int tx = 0; tx < total_tx_depths; ++tx) {
+    for (int rx = 0; rx < total_rx_depths; ++rx) {
+      for (int range = 0; range < total_rx_ranges; ++range) {
+        Pressure* press = reader.readPressure(frequency, 10.0 * (tx + 1), 5.0 + 10.0 * rx, 10.0 * (range + 1));
+        values.push_back(complex<double>(*press));
+        delete press;
+      }
+    }
+  }
+}
+
+void WossShdReaderTest::checkEqual( const vector< complex<double> >& first, const vector< complex<double> >& second, double scale ) const {
+  if (first.size() != second.size() || first.empty()) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+
+  for (size_t i = 0; i < first.size(); ++i) {
+    if (std::abs(first[i] - scale * second[i]) > precision) {
+      if (debug) {
+        cout << __LINE__ << ": " << "index " << i << "; " << first[i] << " != " << scale << " * " << second[i] << endl;
+      }
+      throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+    }
+  }
+}
+
+void WossShdReaderTest::doRun() {
+  vector< complex<double> > single_stream;
+  vector< complex<double> > single_mmap;
+  vector< complex<double> > shared_stream;
+  vector< complex<double> > shared_mmap;
+  vector< complex<double> > mixed_stream;
+  vector< complex<double> > mixed_mmap;
+
+  vector< string > files(1, first_file);
+  readRuns(false, files, single_stream);
+  readRuns(true, files, single_mmap);
+  checkEqual(single_mmap, single_stream, 1.0);
+
+  // two runs sharing one result file, as returned by BellhopCacheSolver
+  files.push_back(first_file);
+  readRuns(false, files, shared_stream);
+  readRuns(true, files, shared_mmap);
+  checkEqual(shared_stream, single_stream, 2.0);
+  checkEqual(shared_mmap, shared_stream, 1.0);
+
+  files.push_back(second_file);
+  readRuns(false, files, mixed_stream);
+  readRuns(true, files, mixed_mmap);
+  checkEqual(mixed_mmap, mixed_stream, 1.0);
+
+  // a second Woss::run() replaces the mappings of the first one
+  BellhopWoss woss;
+  woss.setBellhopShdSyntax(BELLHOP_CREATOR_SHD_FILE_SYNTAX_1).setShdMmapReadFlag(true);
+  woss.setTotalRuns(2);
+
+  ShdResReader reader(&woss);
+  const char* rerun_files[4] = { second_file.c_str(), second_file.c_str(), first_file.c_str(), first_file.c_str() };
+  for (int i = 0; i < 4; ++i) {
+    reader.setFileName(rerun_files[i]);
+    if (!reader.initialize()) {
+      throw WOSS_EXCEPTION(WOSS_ERROR_IO_ERROR);
+    }
+  }
+
+  Pressure* press = reader.readPressure(frequency, 20.0, 15.0, 100.0);
+  int index = (1 * total_rx_depths + 1) * total_rx_ranges + 9;
+  if (std::abs(complex<double>(*press) - shared_mmap[index]) > precision) {
+    delete press;
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+  delete press;
+
+  remove(first_file.c_str());
+  remove(second_file.c_str());
+}
+
+
+int main(int argc, char* argv [])
+{
+  WossShdReaderTest* woss_shd_reader_test = new WossShdReaderTest();
+  woss_shd_reader_test->run();
+  delete woss_shd_reader_test;
+
+  return 0;
+}
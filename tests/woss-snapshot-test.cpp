@@ -0,0 +1,262 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2020 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+
+/**
+ * @file   woss-snapshot-test.cpp
+ * @author Federico Guerra
+ *
+ * \brief Tests the evolution snapshot interpolation of woss::WossManagerResDb
+ *
+ * Checks the interpolation between two known snapshots, the reuse of the stored snapshots 
+ * and the fallback to the exact time when the amplitude or delay error bounds are exceeded
+ */
+
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include "woss-test.h"
+
+using namespace std;
+using namespace woss;
+
+
+/**
+* WossManagerSimple whose channels are known in advance. Requests that don't match a snapshot 
+* return a single marker arrival
+**/
+class WossSnapshotTestManager : public WossManagerSimple< WossManagerResDb > {
+
+  public:
+
+  WossSnapshotTestManager() : WossManagerSimple< WossManagerResDb >(), start_time(), snapshots(), computed_offsets() { }
+
+  virtual ~WossSnapshotTestManager() { }
+
+
+  void setStartTime( const Time& time ) { start_time = time; }
+
+  void addSnapshot( int64_t offset, const TimeArr& value ) { snapshots[offset] = value; }
+
+  const vector< int64_t >& getComputedOffsets() const { return computed_offsets; }
+
+
+  static const double marker_delay;
+
+
+  protected:
+
+  virtual TimeArr* computeWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
+    int64_t offset = time_value.getEpoch() - start_time.getEpoch();
+    computed_offsets.push_back( offset );
+
+    map< int64_t, TimeArr >::const_iterator it = snapshots.find( offset );
+    if ( it != snapshots.end() ) return SDefHandler::instance()->getTimeArr()->create( it->second );
+
+    return SDefHandler::instance()->getTimeArr()->create( TimeArr( Pressure( 1.0, 0.0 ), marker_delay ) );
+  }
+
+
+  Time start_time;
+
+  map< int64_t, TimeArr > snapshots;
+
+  vector< int64_t > computed_offsets;
+};
+
+const double WossSnapshotTestManager::marker_delay = 1.0;
+
+
+class WossSnapshotTest : public WossTest {
+
+  public:
+
+  WossSnapshotTest();
+
+  virtual ~WossSnapshotTest() {}
+
+
+  private:
+
+  virtual void doConfig();
+
+  virtual void doInit();
+
+  virtual void doRun();
+
+
+  void checkArrival( const TimeArr& time_arr, int index, double delay, const complex<double>& value ) const;
+
+  TimeArr* query( int64_t offset );
+
+
+  double time_quantum;
+  double frequency;
+  double precision;
+
+  Time start_time;
+
+  CoordZ tx;
+  CoordZ rx;
+
+  WossSnapshotTestManager manager;
+};
+
+WossSnapshotTest::WossSnapshotTest()
+: WossTest(),
+  time_quantum(60.0),
+  frequency(10000.0),
+  precision(1.0e-9),
+  start_time(1, 1, 2020, 0, 0, 0),
+  tx(Coord(42.59, 10.125), 50.0),
+  rx(Coord(42.60, 10.125), 50.0),
+  manager()
+{
+  //debug = true;
+}
+
+void WossSnapshotTest::doConfig() {
+  setWossSimTime(SimTime(start_time, start_time + (time_t)86400));
+  setWossEvolutionTimeQuantum(time_quantum);
+  setWossManagerTimeEvoActive(true);
+}
+
+void WossSnapshotTest::doInit() {
+  TimeArr snapshot;
+
+  // slowly changing channel
+  snapshot.sumValue(0.1, Pressure(1.0, 0.0));
+  snapshot.sumValue(0.2, Pressure(0.5, 0.0));
+  manager.addSnapshot(60, snapshot);
+
+  snapshot.clear();
+  snapshot.sumValue(0.10001, Pressure(0.98, 0.0));
+  snapshot.sumValue(0.2, Pressure(0.0, 0.5));
+  manager.addSnapshot(120, snapshot);
+
+  // the first arrival fades, amplitude error above the bound
+  snapshot.clear();
+  snapshot.sumValue(0.10001, Pressure(0.1, 0.0));
+  snapshot.sumValue(0.2, Pressure(0.0, 0.5));
+  manager.addSnapshot(180, snapshot);
+
+  // same amplitudes, both arrivals drift within the match tolerance but above the delay error bound
+  snapshot.clear();
+  snapshot.sumValue(0.1009, Pressure(0.1, 0.0));
+  snapshot.sumValue(0.2008, Pressure(0.0, 0.5));
+  manager.addSnapshot(240, snapshot);
+
+  manager.setStartTime(start_time);
+  manager.setWossCreator(bellhop_creator);
+  manager.setTimeEvolutionActiveFlag(true);
+  manager.setSnapshotInterpolationFlag(true);
+  manager.setSnapshotErrorBound(0.1);
+  manager.setSnapshotDelayTolerance(1.0e-3);
+  manager.setSnapshotDelayErrorBound(1.0e-4);
+  manager.setDebugFlag(debug);
+}
+
+void WossSnapshotTest::checkArrival( const TimeArr& time_arr, int index, double delay, const complex<double>& value ) const {
+  if (index >= time_arr.size()) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+
+  TimeArrCIt it = time_arr.at(index);
+  if (std::abs((double)it->first - delay) > precision || std::abs(it->second - value) > precision) {
+    if (debug) {
+      cout << __LINE__ << ": " << "arrival " << index << " = " << it->first << ", " << it->second
+           << "; expected " << delay << ", " << value << endl;
+    }
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+}
+
+TimeArr* WossSnapshotTest::query( int64_t offset ) {
+  TimeArr* ret_value = manager.getWossTimeArr(tx, rx, frequency, frequency, start_time + (time_t)offset);
+
+  if (ret_value == NULL || !ret_value->isValid()) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+  return ret_value;
+}
+
+void WossSnapshotTest::doRun() {
+  // halfway between the snapshots at 60 s and 120 s
+  TimeArr* value = query(90);
+
+  if (value->size() != 2) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+  checkArrival(*value, 0, 0.100005, complex<double>(0.99, 0.0));
+  checkArrival(*value, 1, 0.2, polar(0.5, M_PI / 4.0));
+  delete value;
+
+  // stored snapshots are reused, nothing is computed again
+  value = query(75);
+  checkArrival(*value, 0, 0.1000025, complex<double>(0.995, 0.0));
+  delete value;
+
+  // amplitude error above the bound, computed at the requested time
+  value = query(150);
+  if (value->size() != 1) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+  checkArrival(*value, 0, WossSnapshotTestManager::marker_delay, complex<double>(1.0, 0.0));
+  delete value;
+
+  // delay drift above the bound, computed at the requested time
+  value = query(210);
+  checkArrival(*value, 0, WossSnapshotTestManager::marker_delay, complex<double>(1.0, 0.0));
+  delete value;
+
+  // every snapshot is computed once, in time order
+  const int64_t expected[6] = { 60, 120, 180, 150, 240, 210 };
+  const vector< int64_t >& computed = manager.getComputedOffsets();
+
+  if (computed.size() != 6) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+  for (int i = 0; i < 6; ++i) {
+    if (computed[i] != expected[i]) {
+      throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+    }
+  }
+}
+
+
+int main(int argc, char* argv [])
+{
+  WossSnapshotTest* woss_snapshot_test = new WossSnapshotTest();
+  woss_snapshot_test->run();
+  delete woss_snapshot_test;
+
+  return 0;
+}
@@ -0,0 +1,350 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2020 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+
+/**
+ * @file   woss-spatial-map-test.cpp
+ * @author Federico Guerra
+ *
+ * \brief Tests and benchmarks woss::CoordZSpatialMap
+ *
+ * Checks woss::CoordZSpatialMap lookups and compares its lookup throughput with the
+ * ::std::map and woss::CoordComparator container it replaces
+ */
+
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cstdlib>
+#include <sys/time.h>
+#include <coordinates-spatial-map.h>
+#include "woss-test.h"
+
+using namespace std;
+using namespace woss;
+
+
+class SpatialMapUser {
+
+  public:
+
+  static double getSpaceSampling() { return space_sampling; }
+
+  static double space_sampling;
+
+};
+
+double SpatialMapUser::space_sampling = 0.0;
+
+
+class WossSpatialMapTest : public WossTest {
+
+  public:
+
+  WossSpatialMapTest( int tx_links, int rx_links );
+
+  virtual ~WossSpatialMapTest() {}
+
+
+  private:
+
+  typedef CoordZSpatialMap< int, SpatialMapUser > RxMap;
+  typedef CoordZSpatialMap< RxMap, SpatialMapUser > LinkMap;
+
+  typedef ::std::map< CoordZ, int, CoordComparator< SpatialMapUser, CoordZ > > LegacyRxMap;
+  typedef ::std::map< CoordZ, LegacyRxMap, CoordComparator< SpatialMapUser, CoordZ > > LegacyLinkMap;
+
+
+  virtual void doConfig();
+
+  virtual void doInit();
+
+  virtual void doRun();
+
+
+  void doExactTests();
+
+  void doSamplingTests();
+
+  void doBenchmark();
+
+
+  CoordZ getTx( int index ) const;
+
+  CoordZ getRx( const CoordZ& tx, int index ) const;
+
+  static double getElapsed( const struct timeval& start );
+
+
+  int total_tx;
+  int total_rx;
+  double space_sampling; // meters
+  double lookup_offset; // meters
+};
+
+WossSpatialMapTest::WossSpatialMapTest( int tx_links, int rx_links )
+: WossTest(),
+  total_tx(tx_links),
+  total_rx(rx_links),
+  space_sampling(10.0),
+  lookup_offset(3.0)
+{
+  //debug = true;
+}
+
+void WossSpatialMapTest::doConfig() {
+}
+
+void WossSpatialMapTest::doInit() {
+}
+
+CoordZ WossSpatialMapTest::getTx( int index ) const {
+  return CoordZ( 42.0 + (index / 64) * 0.01, 10.0 + (index % 64) * 0.01, 10.0 + (index % 7) * 5.0 );
+}
+
+CoordZ WossSpatialMapTest::getRx( const CoordZ& tx, int index ) const {
+  return CoordZ( tx.getLatitude() + (index / 32) * 0.001, tx.getLongitude() + (index % 32) * 0.001, 20.0 + (index % 11) * 10.0 );
+}
+
+double WossSpatialMapTest::getElapsed( const struct timeval& start ) {
+  struct timeval stop;
+  gettimeofday(&stop, NULL);
+  return (stop.tv_sec - start.tv_sec) + (stop.tv_usec - start.tv_usec) / 1.0e6;
+}
+
+void WossSpatialMapTest::doExactTests() {
+  SpatialMapUser::space_sampling = 0.0;
+
+  RxMap rx_map;
+
+  for (int i = 0; i < 1000; ++i) {
+    rx_map[getRx(getTx(0), i)] = i;
+  }
+
+  if (rx_map.size() != 1000) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    RxMap::iterator it = rx_map.find(getRx(getTx(0), i));
+
+    if (it == rx_map.end() || it->second != i) {
+      throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+    }
+  }
+
+  CoordZ moved = getRx(getTx(0), 10);
+  moved.setDepth(moved.getDepth() + 0.1);
+
+  if (rx_map.find(moved) != rx_map.end()) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+}
+
+void WossSpatialMapTest::doSamplingTests() {
+  SpatialMapUser::space_sampling = space_sampling;
+
+  RxMap rx_map;
+  CoordZ tx = getTx(0);
+
+  for (int i = 0; i < 1000; ++i) {
+    rx_map[getRx(tx, i)] = i;
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    CoordZ moved = getRx(tx, i);
+    moved.setDepth(moved.getDepth() + lookup_offset);
+
+    RxMap::iterator it = rx_map.find(moved);
+
+    if (it == rx_map.end() || it->second != i) {
+      throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+    }
+
+    // a coordinate within space sampling is the same key
+    rx_map[moved] = i;
+  }
+
+  if (rx_map.size() != 1000) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+
+  // the closest key wins
+  CoordZ near = getRx(tx, 0);
+  near.setDepth(near.getDepth() + 6.0);
+  rx_map[near] = -1;
+
+  CoordZ probe = getRx(tx, 0);
+  probe.setDepth(probe.getDepth() + 4.0);
+
+  if (rx_map.find(probe)->second != -1) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+
+  // erasing keeps the other keys reachable
+  for (int i = 0; i < 1000; i += 2) {
+    rx_map.erase(rx_map.find(getRx(tx, i)));
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    RxMap::iterator it = rx_map.find(getRx(tx, i));
+
+    if ((i % 2 == 0 && i != 0 && it != rx_map.end()) || (i % 2 == 1 && (it == rx_map.end() || it->second != i))) {
+      throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+    }
+  }
+
+  // a space sampling change rebuilds the index
+  SpatialMapUser::space_sampling = 0.0;
+  if (rx_map.find(getRx(tx, 1)) == rx_map.end()) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+  SpatialMapUser::space_sampling = space_sampling;
+}
+
+void WossSpatialMapTest::doBenchmark() {
+  SpatialMapUser::space_sampling = space_sampling;
+
+  double total_links = (double)total_tx * total_rx;
+  vector< CoordZ > tx_vector;
+  vector< CoordZ > rx_vector;
+
+  for (int i = 0; i < total_tx; ++i) {
+    tx_vector.push_back(getTx(i));
+  }
+  for (int j = 0; j < total_rx; ++j) {
+    rx_vector.push_back(getRx(CoordZ(0.0, 0.0, 0.0), j));
+  }
+
+  struct timeval start;
+  double insert_time;
+  double lookup_time;
+  long int found = 0;
+
+  {
+    LinkMap link_map;
+
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < total_tx; ++i) {
+      RxMap& rx_map = link_map[tx_vector[i]];
+      for (int j = 0; j < total_rx; ++j) {
+        rx_map[getRx(tx_vector[i], j)] = j;
+      }
+    }
+    insert_time = getElapsed(start);
+
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < total_tx; ++i) {
+      CoordZ tx = tx_vector[i];
+      tx.setDepth(tx.getDepth() + lookup_offset);
+
+      LinkMap::iterator it = link_map.find(tx);
+      if (it == link_map.end()) continue;
+
+      for (int j = 0; j < total_rx; ++j) {
+        CoordZ rx = getRx(tx_vector[i], j);
+        rx.setDepth(rx.getDepth() + lookup_offset);
+
+        RxMap::iterator it2 = it->second.find(rx);
+        if (it2 != it->second.end() && it2->second == j) found++;
+      }
+    }
+    lookup_time = getElapsed(start);
+
+    cout << "CoordZSpatialMap: " << total_links << " links; insert " << total_links / insert_time
+         << " links/s; lookup " << total_links / lookup_time << " links/s" << endl;
+  }
+
+  if (found != (long int)total_links) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+
+  {
+    LegacyLinkMap link_map;
+
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < total_tx; ++i) {
+      LegacyRxMap& rx_map = link_map[tx_vector[i]];
+      for (int j = 0; j < total_rx; ++j) {
+        rx_map[getRx(tx_vector[i], j)] = j;
+      }
+    }
+    insert_time = getElapsed(start);
+
+    found = 0;
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < total_tx; ++i) {
+      CoordZ tx = tx_vector[i];
+      tx.setDepth(tx.getDepth() + lookup_offset);
+
+      LegacyLinkMap::iterator it = link_map.find(tx);
+      if (it == link_map.end()) continue;
+
+      for (int j = 0; j < total_rx; ++j) {
+        CoordZ rx = getRx(tx_vector[i], j);
+        rx.setDepth(rx.getDepth() + lookup_offset);
+
+        LegacyRxMap::iterator it2 = it->second.find(rx);
+        if (it2 != it->second.end() && it2->second == j) found++;
+      }
+    }
+    lookup_time = getElapsed(start);
+
+    cout << "std::map + CoordComparator: " << total_links << " links; insert " << total_links / insert_time
+         << " links/s; lookup " << total_links / lookup_time << " links/s; found " << found << endl;
+  }
+}
+
+void WossSpatialMapTest::doRun() {
+  doExactTests();
+
+  doSamplingTests();
+
+  doBenchmark();
+}
+
+
+int main(int argc, char* argv [])
+{
+  // 1000 transmitters x 1000 receivers = 10^6 stored links
+  int tx_links = 1000;
+  int rx_links = 1000;
+
+  if (argc == 3) {
+    tx_links = atoi(argv[1]);
+    rx_links = atoi(argv[2]);
+  }
+
+  WossSpatialMapTest* woss_spatial_map_test = new WossSpatialMapTest(tx_links, rx_links);
+  woss_spatial_map_test->run();
+  delete woss_spatial_map_test;
+
+  return 0;
+}
@@ -0,0 +1,355 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2020 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+
+/**
+ * @file   woss-time-arr-test.cpp
+ * @author Federico Guerra
+ *
+ * \brief Tests and benchmarks woss::TimeArr
+ *
+ * Checks woss::TimeArr resampling against a reference implementation working on woss::TimeArrMap
+ * and compares their throughput on 1k-tap arrivals
+ */
+
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <sys/time.h>
+#include "woss-test.h"
+
+using namespace std;
+using namespace woss;
+
+
+class WossTimeArrTest : public WossTest {
+
+  public:
+
+  WossTimeArrTest();
+
+  virtual ~WossTimeArrTest() {}
+
+
+  private:
+
+  virtual void doConfig();
+
+  virtual void doInit();
+
+  virtual void doRun();
+
+
+  void doBasicTests();
+
+  void doResamplingTests();
+
+  void doBenchmark();
+
+
+  void checkEqual( const TimeArrMap& map, const TimeArr& time_arr ) const;
+
+
+  static TimeArrMap mapCoherentSumSample( const TimeArrMap& map, double time_resolution, long double delay_precision );
+
+  static TimeArrMap mapIncoherentSumSample( const TimeArrMap& map, double time_resolution, long double delay_precision );
+
+  static TimeArrMap mapCrop( const TimeArrMap& map, double time_start, double time_end, long double delay_precision );
+
+  static TimeArrCIt flatLowerBoundTxLoss( const TimeArr& time_arr, double threshold_db );
+
+  static TimeArrMap::const_iterator mapLowerBoundTxLoss( const TimeArrMap& map, double threshold_db );
+
+  static double getElapsed( const struct timeval& start );
+
+
+  int total_taps;
+  int total_runs;
+  double symbol_resolution; // seconds
+  double equalization_time; // seconds
+  double equalization_db;
+  double precision;
+
+  TimeArrMap arrivals_map;
+  TimeArr arrivals;
+};
+
+WossTimeArrTest::WossTimeArrTest()
+: WossTest(),
+  total_taps(1000),
+  total_runs(2000),
+  symbol_resolution(1.0e-3),
+  equalization_time(1.0e-2),
+  equalization_db(60.0),
+  precision(1.0e-9),
+  arrivals_map(),
+  arrivals()
+{
+  //debug = true;
+}
+
+void WossTimeArrTest::doConfig() {
+}
+
+void WossTimeArrTest::doInit() {
+  srand(1);
+
+  for (int i = 0; i < total_taps; ++i) {
+    double delay = i * 5.0e-4 + 4.0e-4 * rand() / (double)RAND_MAX;
+    double amplitude = pow(10.0, -(40.0 + 50.0 * rand() / (double)RAND_MAX) / 20.0);
+    double phase = 2.0 * M_PI * rand() / (double)RAND_MAX;
+
+    Pressure value(amplitude * cos(phase), amplitude * sin(phase));
+
+    arrivals_map[PDouble(delay, TIMEARR_CUSTOM_DELAY_PRECISION)] = value;
+    arrivals.sumValue(delay, value);
+  }
+}
+
+void WossTimeArrTest::checkEqual( const TimeArrMap& map, const TimeArr& time_arr ) const {
+  if ((int)map.size() != time_arr.size()) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+
+  TimeArrCIt it2 = time_arr.begin();
+  for (TimeArrMap::const_iterator it = map.begin(); it != map.end(); ++it, ++it2) {
+    if (std::abs((double)it->first - (double)it2->first) > precision
+        || std::abs(it->second - it2->second) > precision * std::abs(it->second)) {
+      if (debug) {
+        cout << __LINE__ << ": " << "map " << it->first << ", " << it->second
+             << "; flat " << it2->first << ", " << it2->second << endl;
+      }
+      throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+    }
+  }
+}
+
+TimeArrMap WossTimeArrTest::mapCoherentSumSample( const TimeArrMap& map, double time_resolution, long double delay_precision ) {
+  TimeArrMap temp_map;
+
+  PDouble curr_ch_time = map.begin()->first;
+  for (TimeArrMap::const_iterator it = map.begin(); it != map.end(); it++) {
+    if (it->first > (curr_ch_time + PDouble(time_resolution, delay_precision))) curr_ch_time = it->first;
+    temp_map[curr_ch_time] += it->second;
+  }
+  return temp_map;
+}
+
+TimeArrMap WossTimeArrTest::mapIncoherentSumSample( const TimeArrMap& map, double time_resolution, long double delay_precision ) {
+  TimeArrMap temp_map;
+
+  PDouble curr_ch_time = map.begin()->first;
+  for (TimeArrMap::const_iterator it = map.begin(); it != map.end(); it++) {
+    if (it->first > (curr_ch_time + PDouble(time_resolution, delay_precision))) curr_ch_time = it->first;
+    temp_map[curr_ch_time] += pow(abs(it->second), 2.0);
+  }
+
+  for (TimeArrMap::iterator it = temp_map.begin(); it != temp_map.end(); it++) {
+    temp_map[it->first] = sqrt(it->second);
+  }
+  return temp_map;
+}
+
+TimeArrMap WossTimeArrTest::mapCrop( const TimeArrMap& map, double time_start, double time_end, long double delay_precision ) {
+  TimeArrMap temp_map;
+
+  for (TimeArrMap::const_iterator it = map.begin(); it != map.end(); it++) {
+    if (it->first >= PDouble(time_start, delay_precision) && it->first < PDouble(time_end, delay_precision)) {
+      temp_map[it->first] = it->second;
+    }
+  }
+  return temp_map;
+}
+
+TimeArrCIt WossTimeArrTest::flatLowerBoundTxLoss( const TimeArr& time_arr, double threshold_db ) {
+  return time_arr.lowerBoundTxLoss(threshold_db);
+}
+
+TimeArrMap::const_iterator WossTimeArrTest::mapLowerBoundTxLoss( const TimeArrMap& map, double threshold_db ) {
+  for (TimeArrMap::const_iterator it = map.begin(); it != map.end(); it++) {
+    if (Pressure::getTxLossDb(it->second) <= threshold_db) return it;
+  }
+  return map.end();
+}
+
+double WossTimeArrTest::getElapsed( const struct timeval& start ) {
+  struct timeval stop;
+  gettimeofday(&stop, NULL);
+  return (stop.tv_sec - start.tv_sec) + (stop.tv_usec - start.tv_usec) / 1.0e6;
+}
+
+void WossTimeArrTest::doBasicTests() {
+  TimeArr time_arr;
+
+  time_arr.sumValue(0.3, Pressure(1.0, 0.0));
+  time_arr.sumValue(0.1, Pressure(2.0, 0.0));
+  time_arr.sumValue(0.2, Pressure(3.0, 0.0));
+  time_arr.sumValue(0.1 + 0.5 * TIMEARR_CUSTOM_DELAY_PRECISION, Pressure(0.0, 1.0));
+
+  if (time_arr.size() != 3 || time_arr.getMinDelayValue() != 0.1 || time_arr.getMaxDelayValue() != 0.3) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+
+  if (time_arr.findValue(0.1)->second != complex<double>(2.0, 1.0) || time_arr.at(1)->second != complex<double>(3.0, 0.0)) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+
+  if ((complex<double>)time_arr != complex<double>(6.0, 1.0)) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+
+  double last_delay = HUGE_VAL;
+  for (TimeArrCRIt it = time_arr.rbegin(); it != time_arr.rend(); ++it) {
+    if (it->first >= PDouble(last_delay)) {
+      throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+    }
+    last_delay = it->first;
+  }
+
+  TimeArr sum = time_arr + TimeArr(Pressure(1.0, 0.0), 0.2);
+  if (sum.size() != 3 || sum.findValue(0.2)->second != complex<double>(4.0, 0.0)) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+
+  time_arr.eraseValue(0.2);
+  if (time_arr.size() != 2 || time_arr.findValue(0.2) != time_arr.end()) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+
+  // insertValue() keeps the first value within delay precision, as std::map::insert() does
+  TimeArrMap inserted_map;
+  inserted_map.insert(make_pair(PDouble(0.4, TIMEARR_CUSTOM_DELAY_PRECISION), Pressure(1.0, 0.0)));
+  inserted_map.insert(make_pair(PDouble(0.4 + 0.5 * TIMEARR_CUSTOM_DELAY_PRECISION, TIMEARR_CUSTOM_DELAY_PRECISION), Pressure(5.0, 0.0)));
+  inserted_map.insert(make_pair(PDouble(0.1, TIMEARR_CUSTOM_DELAY_PRECISION), Pressure(7.0, 0.0)));
+
+  TimeArr inserted;
+  inserted.insertValue(0.4, Pressure(1.0, 0.0));
+  inserted.insertValue(0.4 + 0.5 * TIMEARR_CUSTOM_DELAY_PRECISION, Pressure(5.0, 0.0));
+  inserted.insertValue(0.1, Pressure(7.0, 0.0));
+  checkEqual(inserted_map, inserted);
+
+  if (inserted.findValue(0.4)->second != complex<double>(1.0, 0.0)) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+
+  TimeArr not_valid(TimeArr::createNotValid());
+  if (not_valid.isValid() || !time_arr.isValid() || !TimeArr(Pressure(1.0, 0.0)).isConvertedFromPressure()) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+}
+
+void WossTimeArrTest::doResamplingTests() {
+  long double delay_precision = arrivals.getDelayPrecision();
+
+  if (arrivals.size() != (int)arrivals_map.size()) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+
+  TimeArr* coherent = arrivals.coherentSumSample(symbol_resolution);
+  TimeArrMap coherent_map = mapCoherentSumSample(arrivals_map, symbol_resolution, delay_precision);
+  checkEqual(coherent_map, *coherent);
+
+  TimeArrCIt tap_iter = flatLowerBoundTxLoss(*coherent, equalization_db);
+  TimeArrMap::const_iterator tap_map_iter = mapLowerBoundTxLoss(coherent_map, equalization_db);
+
+  if (tap_iter == coherent->end() || tap_map_iter == coherent_map.end() || std::abs((double)tap_iter->first - (double)tap_map_iter->first) > precision) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_INVALID_PARAM);
+  }
+
+  double start = tap_iter->first;
+  TimeArr* cropped = coherent->crop(start, start + equalization_time);
+  TimeArrMap cropped_map = mapCrop(coherent_map, start, start + equalization_time, delay_precision);
+  checkEqual(cropped_map, *cropped);
+
+  TimeArr* incoherent = cropped->incoherentSumSample(equalization_time);
+  TimeArrMap incoherent_map = mapIncoherentSumSample(cropped_map, equalization_time, delay_precision);
+  checkEqual(incoherent_map, *incoherent);
+
+  delete coherent;
+  delete cropped;
+  delete incoherent;
+}
+
+void WossTimeArrTest::doBenchmark() {
+  long double delay_precision = arrivals.getDelayPrecision();
+  struct timeval start;
+  double checksum = 0.0;
+
+  gettimeofday(&start, NULL);
+  for (int i = 0; i < total_runs; ++i) {
+    TimeArrMap coherent = mapCoherentSumSample(arrivals_map, symbol_resolution, delay_precision);
+    double begin = mapLowerBoundTxLoss(coherent, equalization_db)->first;
+    TimeArrMap cropped = mapCrop(coherent, begin, begin + equalization_time, delay_precision);
+    TimeArrMap after = mapCrop(coherent, begin + equalization_time, HUGE_VAL, delay_precision);
+    TimeArrMap incoherent = mapIncoherentSumSample(cropped, equalization_time, delay_precision);
+    checksum += incoherent.size() + after.size();
+  }
+  double map_time = getElapsed(start);
+
+  gettimeofday(&start, NULL);
+  for (int i = 0; i < total_runs; ++i) {
+    TimeArr* coherent = arrivals.coherentSumSample(symbol_resolution);
+    double begin = coherent->lowerBoundTxLoss(equalization_db)->first;
+    TimeArr* cropped = coherent->crop(begin, begin + equalization_time);
+    TimeArr* after = coherent->crop(begin + equalization_time, HUGE_VAL);
+    TimeArr* incoherent = cropped->incoherentSumSample(equalization_time);
+    checksum -= incoherent->size() + after->size();
+    delete coherent;
+    delete cropped;
+    delete after;
+    delete incoherent;
+  }
+  double flat_time = getElapsed(start);
+
+  cout << "TimeArr " << total_taps << " taps, " << total_runs << " resampling chains: map "
+       << total_runs / map_time << " chains/s; flat " << total_runs / flat_time << " chains/s" << endl;
+
+  if (checksum != 0.0) {
+    throw WOSS_EXCEPTION(WOSS_ERROR_OUT_OF_RANGE_PARAM);
+  }
+}
+
+void WossTimeArrTest::doRun() {
+  doBasicTests();
+
+  doResamplingTests();
+
+  doBenchmark();
+}
+
+
+int main(int argc, char* argv [])
+{
+  WossTimeArrTest* woss_time_arr_test = new WossTimeArrTest();
+  woss_time_arr_test->run();
+  delete woss_time_arr_test;
+
+  return 0;
+}
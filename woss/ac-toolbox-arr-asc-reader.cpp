@@ -36,6 +36,7 @@
  */
 
 #include <cmath>
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
@@ -51,6 +52,9 @@
 using namespace woss;
 
 
+int ArrData::cache_size = ARR_DATA_CACHE_SIZE;
+
+
 ArrData::ArrData()
 : frequency(0.0),
   Nsd(0),
@@ -59,9 +63,112 @@ ArrData::ArrData()
   rx_depths(NULL),
   Nrr(0),
   rx_ranges(NULL),
-  arr_values(NULL)
+  arr_runs(),
+  cell_cache(),
+  cache_index()
 {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_init( &cache_mutex, NULL );
+#endif // WOSS_MULTITHREAD
+}
+
+
+ArrData::~ArrData() {
+  delete[] tx_depths; 
+  delete[] rx_ranges; 
+  delete[] rx_depths; 
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_destroy( &cache_mutex );
+#endif // WOSS_MULTITHREAD
+}
+
+
+ArrData::ArrRun* ArrData::loadRun( const ::std::string& file_name ) {
+  ::std::ifstream file_reader( file_name.c_str(), ::std::ios::binary|::std::ios::in );
+
+  if ( !file_reader ) return NULL;
+
+  file_reader.seekg( 0, ::std::ios_base::end );
+  ::std::streamoff file_size = file_reader.tellg();
+  file_reader.seekg( 0, ::std::ios_base::beg );
+
+  if ( file_size <= 0 ) return NULL;
+
+  arr_runs.push_back( ArrRun() );
+  ArrRun& run = arr_runs.back();
+
+  run.buffer.resize( file_size );
+  file_reader.read( &run.buffer[0], file_size );
+
+  if ( file_reader.gcount() != file_size ) {
+    arr_runs.pop_back();
+    return NULL;
+  }
+
+  run.cells.reserve( getTotalCells() );
+
+  clearCache();
+  return &run;
+}
+
+
+bool ArrData::getCachedTimeArr( int index, TimeArr& value ) const {
+  bool found = false;
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &cache_mutex );
+#endif // WOSS_MULTITHREAD
+
+  CCIIter it = cache_index.find( index );
+
+  if ( it != cache_index.end() ) {
+    // most recently used cells are kept at the front
+    cell_cache.splice( cell_cache.begin(), cell_cache, it->second );
+    value = it->second->second;
+    found = true;
+  }
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &cache_mutex );
+#endif // WOSS_MULTITHREAD
 
+  return found;
+}
+
+
+void ArrData::insertCachedTimeArr( int index, const TimeArr& value ) const {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &cache_mutex );
+#endif // WOSS_MULTITHREAD
+
+  if ( cache_size > 0 && cache_index.find( index ) == cache_index.end() ) {
+    cell_cache.push_front( ::std::make_pair( index, value ) );
+    cache_index[ index ] = cell_cache.begin();
+
+    while ( (int)cache_index.size() > cache_size ) {
+      cache_index.erase( cell_cache.back().first );
+      cell_cache.pop_back();
+    }
+  }
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &cache_mutex );
+#endif // WOSS_MULTITHREAD
+}
+
+
+void ArrData::clearCache() {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &cache_mutex );
+#endif // WOSS_MULTITHREAD
+
+  cell_cache.clear();
+  cache_index.clear();
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &cache_mutex );
+#endif // WOSS_MULTITHREAD
 }
 
 
@@ -88,8 +195,24 @@ int ArrData::getIndex( float value, float* array, int array_size ) const {
 }
 
 
+int ArrData::getNearestIndex( float value, float* array, int array_size ) const {
+  if ( value <= array[0] || array_size == 1 ) {
+    return 0;
+  }
+  else if ( value >= array[array_size - 1] ) {
+    return( array_size - 1 );
+  }
+
+  float* upper = ::std::lower_bound( array, array + array_size, value );
+  int index = upper - array;
+
+  if ( ( *upper - value ) < ( value - *(upper - 1) ) ) return index;
+  else return( index - 1 );
+}
+
+
 int ArrData::getTimeArrIndex( double tx_depth, double rx_depth, double rx_range ) const {
-  int tx_depth_index = getIndex( tx_depth, tx_depths, Nsd );
+  int tx_depth_index = getNearestIndex( tx_depth, tx_depths, Nsd );
   int rx_depth_index = getIndex( rx_depth, rx_depths, Nrd );
   int rx_range_index = getIndex( rx_range, rx_ranges, Nrr );
 
@@ -263,8 +386,6 @@ bool ArrAscResReader::getArrAscHeader() {
     }
   }
 
-  arr_file.arr_values = SDefHandler::instance()->getTimeArr()->createArray( arr_file.Nsd*arr_file.Nrd*arr_file.Nrr );
-
   skip_header = file_reader.tellg();
   file_reader.close();
 
@@ -277,136 +398,182 @@ bool ArrAscResReader::getArrAscFile() {
   if ( !arr_asc_header_collected ) return false;
 
   assert(skip_header > 0);
-  file_reader.open(file_name.c_str() , ::std::ios::in);
-  file_reader.seekg(skip_header);
 
-  file_reader.precision(WOSS_DECIMAL_PRECISION);
-  ::std::cout.precision(WOSS_DECIMAL_PRECISION);
+  ArrData::ArrRun* run_ptr = arr_file.loadRun( file_name );
+
+  if ( run_ptr == NULL ) {
+    if (woss_ptr->usingDebug()) ::std::cout << "ArrAscResReader(" << woss_ptr->getWossId() << ")::getArrAscFile() WARNING, can't read " << file_name << ::std::endl;
+    return false;
+  }
 
   const BellhopWoss* bwoss_ptr = dynamic_cast<const BellhopWoss*>(woss_ptr);
 
+  int arrival_tokens = ( bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_0 ) ? 7 : 8;
+
+  const char* begin = run_ptr->buffer.c_str();
+  const char* end = begin + run_ptr->buffer.size();
+  const char* pos = begin + skip_header;
+  char* next = NULL;
+
   for (int isd = 0; isd < arr_file.Nsd ; isd++) {
 
-    int max_arrivals = -1;
+    long int max_arrivals = ::std::strtol( pos, &next, 10 );
 
-    file_reader >> max_arrivals;
+    if ( next == pos ) break;
+    pos = next;
 
     if (woss_ptr->usingDebug())
-      ::std::cout << "ArrAscResReader(" << woss_ptr->getWossId() << ")::getAsciiArrMap() Reading data for source " << isd << " of "
-                  << isd << "; max arrivals = " << max_arrivals << ::std::endl;
-
-    for (int ird = 0; ird < arr_file.Nrd; ird++) {
-
-      for (int irr = 0; irr < arr_file.Nrr; irr++ ) {
-
-        int curr_arrivals = -1;
-
-        file_reader >> curr_arrivals;
-
-        if ( woss_ptr->usingDebug() )
-          ::std::cout << "ArrAscResReader(" << woss_ptr->getWossId() << ")::getAsciiArrMap() curr_arrivals = "
-                      << curr_arrivals << ::std::endl;
-
-        if (curr_arrivals > 0) {
-
-          double curr_amplitude = ARR_ASC_RES_NOT_SET;
-          double curr_phase = ARR_ASC_RES_NOT_SET;
-          double curr_delay = ARR_ASC_RES_NOT_SET;
-          double curr_delay_imag = ARR_ASC_RES_NOT_SET;
-          double curr_src_angle = ARR_ASC_RES_NOT_SET;
-          double curr_rx_angle = ARR_ASC_RES_NOT_SET;
-          double curr_top_bounces = ARR_ASC_RES_NOT_SET;
-          double curr_bottom_bounces = ARR_ASC_RES_NOT_SET;
-          Pressure* curr_pressure_ptr = NULL;
-
-          for (int i = 0; i < curr_arrivals; i++) {
-
-            file_reader >> curr_amplitude;
-            file_reader >> curr_phase;
-            file_reader >> curr_delay;
-
-            if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 ||
-                bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2) {
-              file_reader >> curr_delay_imag;
-            }
-
-            file_reader >> curr_src_angle;
-            file_reader >> curr_rx_angle;
-            file_reader >> curr_top_bounces;
-            file_reader >> curr_bottom_bounces;
-
-            assert(curr_amplitude >= 0.0);
-
-            if ( woss_ptr->usingDebug() ) {
-              assert(!::std::isnan(curr_amplitude));      assert(!::std::isinf(curr_amplitude));
-              assert(!::std::isnan(curr_phase));          assert(!::std::isinf(curr_phase));
-              assert(!::std::isnan(curr_delay));          assert(!::std::isinf(curr_delay));       //assert(curr_delay >= 0.0);
-              if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 
-                 || bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2) {
-                assert(!::std::isnan(curr_delay_imag));   assert(!::std::isinf(curr_delay_imag));  //assert(curr_delay_imag >= 0.0);
-              }
-              assert(!::std::isnan(curr_src_angle));      assert(!::std::isinf(curr_src_angle));
-              assert(!::std::isnan(curr_rx_angle));       assert(!::std::isinf(curr_rx_angle));
-              assert(!::std::isnan(curr_top_bounces));    assert(!::std::isinf(curr_top_bounces)); assert(curr_top_bounces >= 0.0);
-              assert(!::std::isnan(curr_bottom_bounces)); assert(!::std::isinf(curr_top_bounces)); assert(curr_top_bounces >= 0.0);
-            }
-
-            // GLITCH RECOVERY FROM VERTICAL CHANNEL SIMULATIONS ( HORIZ RANGE == 0, ONLY VERTICAL DEPTH )
-            if ( curr_delay <= 0.0 || arr_file.rx_ranges[irr] <= 0.0 )
-              curr_delay = ( abs( arr_file.rx_depths[ird] - arr_file.tx_depths[isd] ) ) / 1500.0;
-            if ( curr_delay <= 0.0 ) curr_delay = abs( curr_delay );
-
-            if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_0) {
-              curr_pressure_ptr = new Pressure( (curr_amplitude * cos(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) ,
-                                                (curr_amplitude * sin(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) );
-            }
-            else if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 ||
-                     bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2 ) {
-              curr_pressure_ptr = new Pressure( (curr_amplitude * ::std::exp(2.0 * M_PI * arr_file.frequency * curr_delay_imag)
-                                                  * cos(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) ,
-                                                (-1.0 * curr_amplitude * ::std::exp(2.0 * M_PI * arr_file.frequency * curr_delay_imag)
-                                                  * sin(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) );
-            }
-            else
-            {
-              // syntax must be defined
-              assert(0);
-            }
-
-            arr_file.arr_values[isd * arr_file.Nrd * arr_file.Nrr + ird * arr_file.Nrr + irr].sumValue( curr_delay,  *curr_pressure_ptr);
-
-            if (woss_ptr->usingDebug())
-              ::std::cout << "ArrAscResReader(" << woss_ptr->getWossId() << ")::getAsciiArrMap() s_depth = " << arr_file.tx_depths[isd]
-                          << "; rx depth = " << arr_file.rx_depths[ird] << "; rx range = " << arr_file.rx_ranges[irr]
-                          << " freq = " << arr_file.frequency << "; delay = " << curr_delay << "; delay_imag = " << curr_delay_imag
-                          << "; amplitude = " << curr_amplitude << "; phase = " << curr_phase
-                          << "; exp = " << (bwoss_ptr->getBellhopArrSyntax() != BELLHOP_CREATOR_ARR_FILE_SYNTAX_0 ? ::std::exp(-2.0 * M_PI * arr_file.frequency * curr_delay_imag) : 1.0)
-                          << "; Press = " << *curr_pressure_ptr
-                          << "; tx loss db = " << Pressure::getTxLossDb(*curr_pressure_ptr)
-                          << "; src angle = " << curr_src_angle << "; rx angle = " << curr_rx_angle
-                          << "; top bounces = " << curr_top_bounces << "; bottom bounces = "
-                          << curr_bottom_bounces << ::std::endl;
-
-            delete curr_pressure_ptr;
-          }
-        }
-        else {
-          arr_file.arr_values[isd * arr_file.Nrd * arr_file.Nrr + ird * arr_file.Nrr + irr].sumValue( 0.0 , Pressure( 0.0, 0.0 ) ) ;
+      ::std::cout << "ArrAscResReader(" << woss_ptr->getWossId() << ")::getArrAscFile() indexing data for source " << isd << " of "
+                  << arr_file.Nsd << "; max arrivals = " << max_arrivals << ::std::endl;
 
-          if ( woss_ptr->usingDebug() )
-            ::std::cout << "ArrAscResReader(" << woss_ptr->getWossId() << ")::getAsciiArrMap() no arrivals, inserted zero value"
-                        << ::std::endl;
+    for (int irx = 0; irx < arr_file.Nrd * arr_file.Nrr; irx++) {
 
-        }
+      ArrData::ArrCell cell;
+      cell.arrivals = ::std::strtol( pos, &next, 10 );
+
+      if ( next == pos ) break;
+      pos = next;
+
+      cell.offset = pos - begin;
+      run_ptr->cells.push_back( cell );
+
+      // arrivals are only skipped here, they are parsed by decodeCell() when requested
+      for (int i = 0; i < cell.arrivals * arrival_tokens; i++) {
+        while ( pos < end && ( *pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t' ) ) pos++;
+        while ( pos < end && !( *pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t' ) ) pos++;
       }
     }
   }
-  file_reader.close();
+
+  if ( (int)run_ptr->cells.size() != arr_file.getTotalCells() || pos > end ) {
+    ::std::cerr << "ArrAscResReader(" << woss_ptr->getWossId() << ")::getArrAscFile() ERROR, " << file_name 
+                << " is truncated; cells read = " << run_ptr->cells.size() << "; cells expected = " << arr_file.getTotalCells() << ::std::endl;
+    arr_file.arr_runs.pop_back();
+    return false;
+  }
+
   arr_asc_file_collected = true;
   return arr_asc_file_collected;
 }
 
 
+void ArrAscResReader::decodeCell( int index, TimeArr& value ) const {
+  const BellhopWoss* bwoss_ptr = dynamic_cast<const BellhopWoss*>(woss_ptr);
+
+  int isd = index / ( arr_file.Nrd * arr_file.Nrr );
+  int ird = ( index / arr_file.Nrr ) % arr_file.Nrd;
+  int irr = index % arr_file.Nrr;
+
+  for ( ArrData::ARLCIter it = arr_file.arr_runs.begin(); it != arr_file.arr_runs.end(); it++ ) {
+
+    const ArrData::ArrCell& cell = it->cells[index];
+
+    if ( cell.arrivals <= 0 ) {
+      value.sumValue( 0.0 , Pressure( 0.0, 0.0 ) ) ;
+
+      if ( woss_ptr->usingDebug() )
+        ::std::cout << "ArrAscResReader(" << woss_ptr->getWossId() << ")::decodeCell() no arrivals, inserted zero value"
+                    << ::std::endl;
+      continue;
+    }
+
+    const char* pos = it->buffer.c_str() + cell.offset;
+    char* next = NULL;
+
+    double curr_amplitude = ARR_ASC_RES_NOT_SET;
+    double curr_phase = ARR_ASC_RES_NOT_SET;
+    double curr_delay = ARR_ASC_RES_NOT_SET;
+    double curr_delay_imag = ARR_ASC_RES_NOT_SET;
+    double curr_src_angle = ARR_ASC_RES_NOT_SET;
+    double curr_rx_angle = ARR_ASC_RES_NOT_SET;
+    double curr_top_bounces = ARR_ASC_RES_NOT_SET;
+    double curr_bottom_bounces = ARR_ASC_RES_NOT_SET;
+
+    for (int i = 0; i < cell.arrivals; i++) {
+
+      curr_amplitude = ::std::strtod( pos, &next ); pos = next;
+      curr_phase = ::std::strtod( pos, &next ); pos = next;
+      curr_delay = ::std::strtod( pos, &next ); pos = next;
+
+      if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 ||
+          bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2) {
+        curr_delay_imag = ::std::strtod( pos, &next ); pos = next;
+      }
+
+      curr_src_angle = ::std::strtod( pos, &next ); pos = next;
+      curr_rx_angle = ::std::strtod( pos, &next ); pos = next;
+      curr_top_bounces = ::std::strtod( pos, &next ); pos = next;
+      curr_bottom_bounces = ::std::strtod( pos, &next ); pos = next;
+
+      assert(curr_amplitude >= 0.0);
+
+      if ( woss_ptr->usingDebug() ) {
+        assert(!::std::isnan(curr_amplitude));      assert(!::std::isinf(curr_amplitude));
+        assert(!::std::isnan(curr_phase));          assert(!::std::isinf(curr_phase));
+        assert(!::std::isnan(curr_delay));          assert(!::std::isinf(curr_delay));       //assert(curr_delay >= 0.0);
+        if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 
+           || bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2) {
+          assert(!::std::isnan(curr_delay_imag));   assert(!::std::isinf(curr_delay_imag));  //assert(curr_delay_imag >= 0.0);
+        }
+        assert(!::std::isnan(curr_src_angle));      assert(!::std::isinf(curr_src_angle));
+        assert(!::std::isnan(curr_rx_angle));       assert(!::std::isinf(curr_rx_angle));
+        assert(!::std::isnan(curr_top_bounces));    assert(!::std::isinf(curr_top_bounces)); assert(curr_top_bounces >= 0.0);
+        assert(!::std::isnan(curr_bottom_bounces)); assert(!::std::isinf(curr_top_bounces)); assert(curr_top_bounces >= 0.0);
+      }
+
+      // GLITCH RECOVERY FROM VERTICAL CHANNEL SIMULATIONS ( HORIZ RANGE == 0, ONLY VERTICAL DEPTH )
+      if ( curr_delay <= 0.0 || arr_file.rx_ranges[irr] <= 0.0 )
+        curr_delay = ( abs( arr_file.rx_depths[ird] - arr_file.tx_depths[isd] ) ) / 1500.0;
+      if ( curr_delay <= 0.0 ) curr_delay = abs( curr_delay );
+
+      Pressure curr_pressure;
+
+      if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_0) {
+        curr_pressure = Pressure( (curr_amplitude * cos(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) ,
+                                  (curr_amplitude * sin(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) );
+      }
+      else if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 ||
+               bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2 ) {
+        curr_pressure = Pressure( (curr_amplitude * ::std::exp(2.0 * M_PI * arr_file.frequency * curr_delay_imag)
+                                    * cos(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) ,
+                                  (-1.0 * curr_amplitude * ::std::exp(2.0 * M_PI * arr_file.frequency * curr_delay_imag)
+                                    * sin(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) );
+      }
+      else
+      {
+        // syntax must be defined
+        assert(0);
+      }
+
+      value.sumValue( curr_delay, curr_pressure );
+
+      if (woss_ptr->usingDebug())
+        ::std::cout << "ArrAscResReader(" << woss_ptr->getWossId() << ")::decodeCell() s_depth = " << arr_file.tx_depths[isd]
+                    << "; rx depth = " << arr_file.rx_depths[ird] << "; rx range = " << arr_file.rx_ranges[irr]
+                    << " freq = " << arr_file.frequency << "; delay = " << curr_delay << "; delay_imag = " << curr_delay_imag
+                    << "; amplitude = " << curr_amplitude << "; phase = " << curr_phase
+                    << "; Press = " << curr_pressure
+                    << "; tx loss db = " << Pressure::getTxLossDb(curr_pressure)
+                    << "; src angle = " << curr_src_angle << "; rx angle = " << curr_rx_angle
+                    << "; top bounces = " << curr_top_bounces << "; bottom bounces = "
+                    << curr_bottom_bounces << ::std::endl;
+    }
+  }
+}
+
+
+TimeArr* ArrAscResReader::accessMap( double frequency, double tx_depth, double rx_depth, double rx_range ) const {
+  int index = arr_file.getTimeArrIndex( tx_depth, rx_depth, rx_range );
+  TimeArr value;
+
+  if ( !arr_file.getCachedTimeArr( index, value ) ) {
+    decodeCell( index, value );
+    arr_file.insertCachedTimeArr( index, value );
+  }
+  return( SDefHandler::instance()->getTimeArr()->create( value ) );
+}
+
+
 Pressure* ArrAscResReader::readPressure(double frequency, double tx_depth, double rx_depth, double rx_range ) const {
   return( SDefHandler::instance()->getPressure()->create( *readTimeArr( frequency, tx_depth, rx_depth, rx_range ) ) );
 }
@@ -420,7 +587,7 @@ Pressure* ArrAscResReader::readAvgPressure( double frequency, double tx_depth, d
 
 TimeArr* ArrAscResReader::readTimeArr( double frequency, double source_depth, double rx_depth, double rx_range ) const {
   if ( !arr_asc_file_collected ) return( SDefHandler::instance()->getTimeArr()->create( TimeArr::createNotValid() ) );
-  return( SDefHandler::instance()->getTimeArr()->create( *accessMap(frequency, source_depth,rx_depth,rx_range ) ) );
+  return( accessMap( frequency, source_depth, rx_depth, rx_range ) );
 }
 
 
@@ -436,7 +603,10 @@ TimeArr* ArrAscResReader::readTimeArr( double frequency, double source_depth, do
      int end_index = arr_file.getTimeArrIndex( tx_depth, end_rx_depth, end_rx_range );
 
      for ( int i = start_index; i <= end_index; i++ ) {
-       ::std::complex<double> curr_press = arr_file.arr_values[i];
+       TimeArr curr_time_arr;
+       // the cache is left to single cell queries
+       if ( !arr_file.getCachedTimeArr( i, curr_time_arr ) ) decodeCell( i, curr_time_arr );
+       ::std::complex<double> curr_press = curr_time_arr;
        sum_press += curr_press;
        sum_cnt++;
      }
@@ -43,17 +43,33 @@
 
 #include <fstream>
 #include <stdint.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
 #include <time-arrival-definitions.h>
 #include "res-reader.h"
 
+#ifdef WOSS_MULTITHREAD
+#include <pthread.h>
+#endif // WOSS_MULTITHREAD
+
 
 namespace woss {
   
+  
+  /**
+  * Default maximum number of decoded TimeArr kept by ArrData
+  **/
+  #define ARR_DATA_CACHE_SIZE (1024)
+  
     
   /**
   * \brief class for storing data of any acoustic toolbox ARR file
   *
-  * class ArrData stores TimeArr values provided by any acoustic toolbox ARR file
+  * class ArrData stores the raw content of any acoustic toolbox ARR file, one for every run, together with
+  * the file offset and the number of arrivals of every receiver cell. TimeArr values are decoded only 
+  * when requested and the last decoded ones are kept in a least recently used cache
   */
   class ArrData {
 
@@ -61,13 +77,55 @@ namespace woss {
     public: 
       
       
+    /**
+    * \brief position of a receiver cell in an ARR file
+    */
+    struct ArrCell {
+      
+      /**
+      * offset of the first arrival
+      */
+      size_t offset;
+      
+      /**
+      * total arrivals
+      */
+      int32_t arrivals;
+      
+    };
+    
+    typedef ::std::vector< ArrCell > ArrCellVector;
+    
+    
+    /**
+    * \brief content of the ARR file of a single run
+    */
+    struct ArrRun {
+      
+      /**
+      * ARR file content
+      */
+      ::std::string buffer;
+      
+      /**
+      * receiver cells, in tx depth, rx depth and rx range order
+      */
+      ArrCellVector cells;
+      
+    };
+    
+    typedef ::std::list< ArrRun > ArrRunList;
+    typedef ArrRunList::iterator ARLIter;
+    typedef ArrRunList::const_iterator ARLCIter;
+    
+    
     ArrData();
     
     
     /**
     * Destructor
     */
-    ~ArrData() { delete[] tx_depths; delete[] rx_ranges; delete[] rx_depths; delete[] arr_values; }
+    ~ArrData();
 
     
     /**
@@ -109,17 +167,50 @@ namespace woss {
     float* rx_ranges;
 
     /**
-    * Pointer to an array of TimeArr values [m]
+    * ARR files read so far, one for every run
     */
-    TimeArr* arr_values;
+    ArrRunList arr_runs;
 
 
     /**
     * Initializes the struct 
     */
-    void initialize() { tx_depths = NULL; rx_depths = NULL; rx_ranges = NULL; arr_values = NULL;
+    void initialize() { tx_depths = NULL; rx_depths = NULL; rx_ranges = NULL; arr_runs.clear(); clearCache();
                         Nrr = 0; Nrd = 0; Nsd = 0; frequency = 0.0; }
 
+    /**
+    * Reads the whole given ARR file in a new ArrRun. The cached TimeArr values are discarded
+    * @param file_name ARR file pathname
+    * @returns pointer to the new ArrRun; NULL if the file can't be read
+    */
+    ArrRun* loadRun( const ::std::string& file_name );
+
+    /**
+    * Returns the total number of receiver cells
+    * @returns Nsd * Nrd * Nrr
+    */
+    int getTotalCells() const { return( Nsd * Nrd * Nrr ); }
+
+    /**
+    * Copies the cached TimeArr of the given cell, if present
+    * @param index receiver cell index
+    * @param value TimeArr to be written
+    * @returns <i>true</i> if the cell was cached, <i>false</i> otherwise
+    */
+    bool getCachedTimeArr( int index, TimeArr& value ) const;
+
+    /**
+    * Caches the decoded TimeArr of the given cell, discarding the least recently used one if the cache is full
+    * @param index receiver cell index
+    * @param value decoded TimeArr
+    */
+    void insertCachedTimeArr( int index, const TimeArr& value ) const;
+
+    /**
+    * Discards all cached TimeArr
+    */
+    void clearCache();
+
 
     /**
     * Returns the arr_values index associated to given parameters
@@ -139,6 +230,62 @@ namespace woss {
     */
     int getIndex( float value, float* array, int array_size ) const;
 
+    /**
+    * Returns the index of the array entry closest to given value. Unlike getIndex() it doesn't
+    * assume a linear spacing, so it can be used with explicit source depth lists
+    * @param value test value
+    * @param array valid pointer to a sorted array 
+    * @param array_size size of passed array
+    * @returns valid array index value
+    */
+    int getNearestIndex( float value, float* array, int array_size ) const;
+
+
+    /**
+    * Sets the maximum number of decoded TimeArr cached by every ArrData
+    * @param size cache size
+    */
+    static void setCacheSize( int size ) { cache_size = size; }
+
+    /**
+    * Returns the maximum number of decoded TimeArr cached by every ArrData
+    * @returns cache size
+    */
+    static int getCacheSize() { return cache_size; }
+
+    
+    protected:
+      
+      
+    typedef ::std::list< ::std::pair< int, TimeArr > > CellCache;
+    typedef CellCache::iterator CCIter;
+    
+    typedef ::std::map< int, CCIter > CellCacheIndex;
+    typedef CellCacheIndex::iterator CCIIter;
+    
+    
+    /**
+    * Maximum number of cached TimeArr
+    */
+    static int cache_size;
+    
+    /**
+    * Decoded TimeArr, from the most to the least recently used
+    */
+    mutable CellCache cell_cache;
+    
+    /**
+    * Links a receiver cell index to its cell_cache entry
+    */
+    mutable CellCacheIndex cache_index;
+    
+#ifdef WOSS_MULTITHREAD
+    /**
+    * Mutex that protects the cache
+    */
+    mutable pthread_mutex_t cache_mutex;
+#endif // WOSS_MULTITHREAD
+    
     
   };
 
@@ -255,16 +402,22 @@ namespace woss {
     ::std::complex<double> last_ret_value;
 
     /**
-    * Gets the TimeArr value from ArrData TimeArr array associated to given parameters
+    * Gets a heap-created copy of the TimeArr associated to given parameters, decoding it if it isn't cached in ArrData.
+    * <b>User is responsible of pointer's ownership</b>
     * @param frequency [hZ]
     * @param tx_depth transmitter depth [m]
     * @param rx_depth start receiver depth [m]
     * @param rx_range start receiver range [m]
     * @return a valid TimeArr value; a not valid TimeArr if arr_file hasn't been read yet
     **/  
-    TimeArr* accessMap( double frequency, double tx_depth, double rx_depth, double rx_range ) const {
-      return( arr_file.arr_values + arr_file.getTimeArrIndex( tx_depth, rx_depth, rx_range ) );
-    }
+    TimeArr* accessMap( double frequency, double tx_depth, double rx_depth, double rx_range ) const;
+    
+    /**
+    * Decodes the TimeArr of the given receiver cell, summing all read runs
+    * @param index receiver cell index
+    * @param value TimeArr to be written
+    **/
+    void decodeCell( int index, TimeArr& value ) const;
     
     
     /**
@@ -287,7 +440,7 @@ namespace woss {
     bool getArrAscHeader();
 
     /**
-    * Process the ARR file data
+    * Reads the ARR file and indexes the position of every receiver cell, without decoding the arrivals
     * @return <i>true</i> if method was successful, <i>false</i> otherwise
     **/
     bool getArrAscFile();
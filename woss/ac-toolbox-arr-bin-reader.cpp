@@ -215,8 +215,6 @@ bool ArrBinResReader::getArrBinHeader() {
     }
   }
 
-  arr_file.arr_values = SDefHandler::instance()->getTimeArr()->createArray(arr_file.Nsd * arr_file.Nrd * arr_file.Nrr);
-
   skip_header = file_reader.tellg();
   file_reader.close();
 
@@ -235,138 +233,174 @@ bool ArrBinResReader::getArrBinFile() {
       ::std::cout << "ArrBinResReader(" << woss_ptr->getWossId() << ")::getArrBinFile() skip_header = "
                   << skip_header << ::std::endl;
 
-  file_reader.open(file_name.c_str() , ::std::ios::binary|::std::ios::in);
-  file_reader.seekg(skip_header);
+  ArrData::ArrRun* run_ptr = arr_file.loadRun( file_name );
+
+  if ( run_ptr == NULL ) {
+    if (woss_ptr->usingDebug()) ::std::cout << "ArrBinResReader(" << woss_ptr->getWossId()
+                                            << ")::getArrBinFile() WARNING, can't read " << file_name << ::std::endl;
+    return false;
+  }
 
   const BellhopWoss* bwoss_ptr = dynamic_cast<const BellhopWoss*>(woss_ptr);
 
-  for (int isd = 0; isd < arr_file.Nsd ; isd++) {
+  // every arrival is a record of 7 or 8 floats followed by the 8 bytes of record markers
+  size_t arrival_size = ( bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_0 ? 7 : 8 ) * sizeof(float) + 2 * sizeof(float);
+  size_t count_size = sizeof(int32_t) + 2 * sizeof(float);
+
+  const char* buffer = run_ptr->buffer.data();
+  size_t buffer_size = run_ptr->buffer.size();
+  size_t pos = skip_header;
+
+  for (int isd = 0; isd < arr_file.Nsd && pos + count_size <= buffer_size; isd++) {
 
     int32_t max_arrivals;
 
-    file_reader.read( reinterpret_cast<char*>(&max_arrivals) , sizeof(int32_t));
-    file_reader.seekg(8, ::std::ios_base::cur);
+    ::std::memcpy( &max_arrivals, buffer + pos, sizeof(int32_t) );
+    pos += count_size;
 
     if (woss_ptr->usingDebug())
-      ::std::cout << "ArrBinResReader(" << woss_ptr->getWossId() << ")::getArrBinFile() Reading data for source "
+      ::std::cout << "ArrBinResReader(" << woss_ptr->getWossId() << ")::getArrBinFile() indexing data for source "
                   << isd << " of " << arr_file.Nsd << "; max arrivals = " << max_arrivals << ::std::endl;
 
-    for (int ird = 0; ird < arr_file.Nrd; ird++) {
-
-      for (int irr = 0; irr < arr_file.Nrr; irr++ ) {
-
-        int32_t curr_arrivals;
-
-        file_reader.read( reinterpret_cast<char*>(&curr_arrivals) , sizeof(int32_t));
-        file_reader.seekg(8, ::std::ios_base::cur);
-
-        if ( woss_ptr->usingDebug() )
-          ::std::cout << "ArrBinResReader(" << woss_ptr->getWossId() << ")::getArrBinFile() curr_arrivals = "
-                      << curr_arrivals << ::std::endl;
-
-        if (curr_arrivals > 0) {
-
-          float curr_amplitude;
-          float curr_phase;
-          float curr_delay;
-          float curr_delay_imag;
-          float curr_src_angle;
-          float curr_rx_angle;
-          float curr_top_bounces;
-          float curr_bottom_bounces;
-          Pressure* curr_pressure_ptr = NULL;
-
-          for (int i = 0; i < curr_arrivals; i++) {
-
-            file_reader.read( reinterpret_cast<char*>(&curr_amplitude), sizeof(float) );
-            file_reader.read( reinterpret_cast<char*>(&curr_phase), sizeof(float) );
-            file_reader.read( reinterpret_cast<char*>(&curr_delay), sizeof(float) );
-            if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 ||
-                bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2) {
-              file_reader.read( reinterpret_cast<char*>(&curr_delay_imag), sizeof(float) );
-            }
-            file_reader.read( reinterpret_cast<char*>(&curr_src_angle), sizeof(float) );
-            file_reader.read( reinterpret_cast<char*>(&curr_rx_angle), sizeof(float) );
-            file_reader.read( reinterpret_cast<char*>(&curr_top_bounces), sizeof(float) );
-            file_reader.read( reinterpret_cast<char*>(&curr_bottom_bounces), sizeof(float) );
-            file_reader.seekg(2*sizeof(float), ::std::ios_base::cur);
-
-            assert(curr_amplitude >= 0.0);
-
-            if ( woss_ptr->usingDebug() ) {
-              assert(!::std::isnan(curr_amplitude));      assert(!::std::isinf(curr_amplitude));
-              assert(!::std::isnan(curr_phase));          assert(!::std::isinf(curr_phase));
-              assert(!::std::isnan(curr_delay));          assert(!::std::isinf(curr_delay));       //assert(curr_delay >= 0.0);
-              if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 
-                || bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2) {
-                assert(!::std::isnan(curr_delay_imag));   assert(!::std::isinf(curr_delay_imag));  //assert(curr_delay_imag >= 0.0);
-              }
-              assert(!::std::isnan(curr_src_angle));      assert(!::std::isinf(curr_src_angle));
-              assert(!::std::isnan(curr_rx_angle));       assert(!::std::isinf(curr_rx_angle));
-              assert(!::std::isnan(curr_top_bounces));    assert(!::std::isinf(curr_top_bounces)); assert(curr_top_bounces >= 0.0);
-              assert(!::std::isnan(curr_bottom_bounces)); assert(!::std::isinf(curr_top_bounces)); assert(curr_top_bounces >= 0.0);
-            }
-
-            // GLITCH RECOVERY FROM VERTICAL CHANNEL SIMULATIONS ( HORIZ RANGE == 0, ONLY VERTICAL DEPTH )
-            if ( curr_delay <= 0.0 || arr_file.rx_ranges[irr] <= 0.0 ) {
-              curr_delay = ( abs( arr_file.rx_depths[ird] - arr_file.tx_depths[isd] ) ) / 1500.0;
-            }
-            if ( curr_delay <= 0.0 ) {
-              curr_delay = abs( curr_delay );
-            }
-            if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_0) {
-              curr_pressure_ptr = new Pressure( (curr_amplitude * cos(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) ,
-                                                (curr_amplitude * sin(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) );
-            }
-            else if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 ||
-                     bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2) {
-              curr_pressure_ptr = new Pressure( (curr_amplitude * ::std::exp(2.0 * M_PI * arr_file.frequency * curr_delay_imag)
-                                                  * cos(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) ,
-                                                (-1.0 * curr_amplitude * ::std::exp(2.0 * M_PI * arr_file.frequency * curr_delay_imag)
-                                                  * sin(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) );
-            }
-            else
-            {
-              // syntax must be defined
-              assert(0);
-            }
-
-            arr_file.arr_values[isd * arr_file.Nrd * arr_file.Nrr + ird * arr_file.Nrr + irr].sumValue( curr_delay,  *curr_pressure_ptr);
-
-            if (woss_ptr->usingDebug())
-              ::std::cout << "ArrBinResReader(" << woss_ptr->getWossId() << ")::getArrBinFile() s_depth = " << arr_file.tx_depths[isd]
-                          << "; rx depth = " << arr_file.rx_depths[ird] << "; rx range = " << arr_file.rx_ranges[irr]
-                          << " freq = " << arr_file.frequency << "; delay = " << curr_delay
-                          << "; delay_imag = " << (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 ? curr_delay_imag : 0.0)
-                          << "; amplitude = " << curr_amplitude << "; phase = " << curr_phase
-                          << "; exp = " << (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 ? ::std::exp(-2.0 * M_PI * arr_file.frequency * curr_delay_imag) : 1.0)
-                          << "; Press = " << *curr_pressure_ptr
-                          << "; tx loss db = " << Pressure::getTxLossDb(*curr_pressure_ptr)
-                          << "; src angle = " << curr_src_angle << "; rx angle = " << curr_rx_angle
-                          << "; top bounces = " << curr_top_bounces << "; bottom bounces = "
-                          << curr_bottom_bounces << ::std::endl;
-
-            delete curr_pressure_ptr;
-          }
-        }
-        else {
-          arr_file.arr_values[isd * arr_file.Nrd * arr_file.Nrr + ird * arr_file.Nrr + irr].sumValue( 0.0 , Pressure( 0.0, 0.0 ) ) ;
+    for (int irx = 0; irx < arr_file.Nrd * arr_file.Nrr && pos + count_size <= buffer_size; irx++) {
 
-          if ( woss_ptr->usingDebug() )
-            ::std::cout << "ArrBinResReader(" << woss_ptr->getWossId() << ")::getArrBinFile() no arrivals, inserted zero value"
-                        << ::std::endl;
+      ArrData::ArrCell cell;
 
-        }
-      }
+      ::std::memcpy( &cell.arrivals, buffer + pos, sizeof(int32_t) );
+      pos += count_size;
+
+      cell.offset = pos;
+      run_ptr->cells.push_back( cell );
+
+      // arrivals are only skipped here, they are decoded by decodeCell() when requested
+      if ( cell.arrivals > 0 ) pos += cell.arrivals * arrival_size;
     }
   }
-  file_reader.close();
+
+  if ( (int)run_ptr->cells.size() != arr_file.getTotalCells() || pos > buffer_size ) {
+    ::std::cerr << "ArrBinResReader(" << woss_ptr->getWossId() << ")::getArrBinFile() ERROR, " << file_name 
+                << " is truncated; cells read = " << run_ptr->cells.size() << "; cells expected = " << arr_file.getTotalCells() << ::std::endl;
+    arr_file.arr_runs.pop_back();
+    return false;
+  }
 
   arr_bin_file_collected = true;
   return arr_bin_file_collected;
 }
 
 
+void ArrBinResReader::decodeCell( int index, TimeArr& value ) const {
+  const BellhopWoss* bwoss_ptr = dynamic_cast<const BellhopWoss*>(woss_ptr);
+
+  bool has_delay_imag = ( bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_1 ||
+                          bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_2 );
+  int total_fields = has_delay_imag ? 8 : 7;
+  size_t arrival_size = total_fields * sizeof(float) + 2 * sizeof(float);
+
+  int isd = index / ( arr_file.Nrd * arr_file.Nrr );
+  int ird = ( index / arr_file.Nrr ) % arr_file.Nrd;
+  int irr = index % arr_file.Nrr;
+
+  for ( ArrData::ARLCIter it = arr_file.arr_runs.begin(); it != arr_file.arr_runs.end(); it++ ) {
+
+    const ArrData::ArrCell& cell = it->cells[index];
+
+    if ( cell.arrivals <= 0 ) {
+      value.sumValue( 0.0 , Pressure( 0.0, 0.0 ) ) ;
+
+      if ( woss_ptr->usingDebug() )
+        ::std::cout << "ArrBinResReader(" << woss_ptr->getWossId() << ")::decodeCell() no arrivals, inserted zero value"
+                    << ::std::endl;
+      continue;
+    }
+
+    const char* record = it->buffer.data() + cell.offset;
+
+    for (int i = 0; i < cell.arrivals; i++, record += arrival_size) {
+
+      float fields[8] = { 0.0 };
+      ::std::memcpy( fields, record, total_fields * sizeof(float) );
+
+      float curr_amplitude = fields[0];
+      float curr_phase = fields[1];
+      float curr_delay = fields[2];
+      float curr_delay_imag = has_delay_imag ? fields[3] : 0.0;
+      float curr_src_angle = fields[total_fields - 4];
+      float curr_rx_angle = fields[total_fields - 3];
+      float curr_top_bounces = fields[total_fields - 2];
+      float curr_bottom_bounces = fields[total_fields - 1];
+
+      assert(curr_amplitude >= 0.0);
+
+      if ( woss_ptr->usingDebug() ) {
+        assert(!::std::isnan(curr_amplitude));      assert(!::std::isinf(curr_amplitude));
+        assert(!::std::isnan(curr_phase));          assert(!::std::isinf(curr_phase));
+        assert(!::std::isnan(curr_delay));          assert(!::std::isinf(curr_delay));       //assert(curr_delay >= 0.0);
+        if ( has_delay_imag ) {
+          assert(!::std::isnan(curr_delay_imag));   assert(!::std::isinf(curr_delay_imag));  //assert(curr_delay_imag >= 0.0);
+        }
+        assert(!::std::isnan(curr_src_angle));      assert(!::std::isinf(curr_src_angle));
+        assert(!::std::isnan(curr_rx_angle));       assert(!::std::isinf(curr_rx_angle));
+        assert(!::std::isnan(curr_top_bounces));    assert(!::std::isinf(curr_top_bounces)); assert(curr_top_bounces >= 0.0);
+        assert(!::std::isnan(curr_bottom_bounces)); assert(!::std::isinf(curr_top_bounces)); assert(curr_top_bounces >= 0.0);
+      }
+
+      // GLITCH RECOVERY FROM VERTICAL CHANNEL SIMULATIONS ( HORIZ RANGE == 0, ONLY VERTICAL DEPTH )
+      if ( curr_delay <= 0.0 || arr_file.rx_ranges[irr] <= 0.0 ) {
+        curr_delay = ( abs( arr_file.rx_depths[ird] - arr_file.tx_depths[isd] ) ) / 1500.0;
+      }
+      if ( curr_delay <= 0.0 ) {
+        curr_delay = abs( curr_delay );
+      }
+
+      Pressure curr_pressure;
+
+      if (bwoss_ptr->getBellhopArrSyntax() == BELLHOP_CREATOR_ARR_FILE_SYNTAX_0) {
+        curr_pressure = Pressure( (curr_amplitude * cos(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) ,
+                                  (curr_amplitude * sin(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) );
+      }
+      else if ( has_delay_imag ) {
+        curr_pressure = Pressure( (curr_amplitude * ::std::exp(2.0 * M_PI * arr_file.frequency * curr_delay_imag)
+                                    * cos(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) ,
+                                  (-1.0 * curr_amplitude * ::std::exp(2.0 * M_PI * arr_file.frequency * curr_delay_imag)
+                                    * sin(2.0 * M_PI * arr_file.frequency + curr_phase * M_PI / 180.0) ) );
+      }
+      else
+      {
+        // syntax must be defined
+        assert(0);
+      }
+
+      value.sumValue( curr_delay, curr_pressure );
+
+      if (woss_ptr->usingDebug())
+        ::std::cout << "ArrBinResReader(" << woss_ptr->getWossId() << ")::decodeCell() s_depth = " << arr_file.tx_depths[isd]
+                    << "; rx depth = " << arr_file.rx_depths[ird] << "; rx range = " << arr_file.rx_ranges[irr]
+                    << " freq = " << arr_file.frequency << "; delay = " << curr_delay
+                    << "; delay_imag = " << curr_delay_imag
+                    << "; amplitude = " << curr_amplitude << "; phase = " << curr_phase
+                    << "; Press = " << curr_pressure
+                    << "; tx loss db = " << Pressure::getTxLossDb(curr_pressure)
+                    << "; src angle = " << curr_src_angle << "; rx angle = " << curr_rx_angle
+                    << "; top bounces = " << curr_top_bounces << "; bottom bounces = "
+                    << curr_bottom_bounces << ::std::endl;
+    }
+  }
+}
+
+
+TimeArr* ArrBinResReader::accessMap( double frequency, double tx_depth, double rx_depth, double rx_range ) const {
+  int index = arr_file.getTimeArrIndex( tx_depth, rx_depth, rx_range );
+  TimeArr value;
+
+  if ( !arr_file.getCachedTimeArr( index, value ) ) {
+    decodeCell( index, value );
+    arr_file.insertCachedTimeArr( index, value );
+  }
+  return( SDefHandler::instance()->getTimeArr()->create( value ) );
+}
+
+
 Pressure* ArrBinResReader::readPressure( double frequency, double tx_depth, double rx_depth, double rx_range ) const {
   return( SDefHandler::instance()->getPressure()->create( *readTimeArr( frequency, tx_depth, rx_depth, rx_range ) ) );
 }
@@ -380,7 +414,7 @@ Pressure* ArrBinResReader::readAvgPressure( double frequency, double tx_depth, d
 
 TimeArr* ArrBinResReader::readTimeArr(double frequency, double source_depth, double rx_depth, double rx_range) const {
   if ( !arr_bin_file_collected ) SDefHandler::instance()->getTimeArr()->create( TimeArr::createNotValid() );
-  return( SDefHandler::instance()->getTimeArr()->create( *accessMap( frequency, source_depth,rx_depth,rx_range ) ) );
+  return( accessMap( frequency, source_depth, rx_depth, rx_range ) );
 }
 
 
@@ -396,7 +430,10 @@ TimeArr* ArrBinResReader::readTimeArr(double frequency, double source_depth, dou
      int end_index = arr_file.getTimeArrIndex( tx_depth, end_rx_depth, end_rx_range );
 
      for ( int i = start_index; i <= end_index; i++ ) {
-       ::std::complex<double> curr_press = arr_file.arr_values[i];
+       TimeArr curr_time_arr;
+       // the cache is left to single cell queries
+       if ( !arr_file.getCachedTimeArr( i, curr_time_arr ) ) decodeCell( i, curr_time_arr );
+       ::std::complex<double> curr_press = curr_time_arr;
        sum_press += curr_press;
        sum_cnt++;
      }
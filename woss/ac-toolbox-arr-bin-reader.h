@@ -161,16 +161,22 @@ namespace woss {
 
 
     /**
-    * Gets the TimeArr value from ArrData TimeArr array associated to given parameters
+    * Gets a heap-created copy of the TimeArr associated to given parameters, decoding it if it isn't cached in ArrData.
+    * <b>User is responsible of pointer's ownership</b>
     * @param frequency frequency [hZ]
     * @param tx_depth transmitter depth [m]
     * @param rx_depth start receiver depth [m]
     * @param rx_range start receiver range [m]
     * @return a valid TimeArr value; a not valid TimeArr if arr_file hasn't been read yet
     **/  
-    TimeArr* accessMap(double frequency, double tx_depth, double rx_depth, double rx_range) const {
-      return( arr_file.arr_values + arr_file.getTimeArrIndex( tx_depth, rx_depth, rx_range ) );
-    }
+    TimeArr* accessMap(double frequency, double tx_depth, double rx_depth, double rx_range) const;
+
+    /**
+    * Decodes the TimeArr of the given receiver cell, summing all read runs
+    * @param index receiver cell index
+    * @param value TimeArr to be written
+    **/
+    void decodeCell( int index, TimeArr& value ) const;
 
     /**
     * Gets the average Pressure value in given rx range-depth box converted from ArrStruct TimeArr array
@@ -192,7 +198,7 @@ namespace woss {
     bool getArrBinHeader();
 
     /**
-    * Process the ARR file data
+    * Reads the ARR file and indexes the position of every receiver cell, without decoding the arrivals
     * @return <i>true</i> if method was successful, <i>false</i> otherwise
     **/
     bool getArrBinFile();
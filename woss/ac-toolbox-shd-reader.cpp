@@ -38,10 +38,15 @@
 
 
 #include <cmath>
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
 #include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "woss.h"
 #include "bellhop-woss.h"
 #include <definitions-handler.h>
@@ -88,9 +93,25 @@ int ShdData::getIndex( float value, float* array, int32_t array_size ) const {
 }
 
 
+int ShdData::getNearestIndex( float value, float* array, int32_t array_size ) const {
+  if ( value <= array[0] || array_size == 1 ) {
+    return 0;
+  }
+  else if ( value >= array[array_size - 1] ) {
+    return( array_size - 1 );
+  }
+
+  float* upper = ::std::lower_bound( array, array + array_size, value );
+  int index = upper - array;
+
+  if ( ( *upper - value ) < ( value - *(upper - 1) ) ) return index;
+  else return( index - 1 );
+}
+
+
 int ShdData::getPressureIndex( double tx_depth, double rx_depth, double rx_range, double tx_theta ) const {
   int theta_index = getIndex( tx_theta, theta, Ntheta );
-  int tx_depth_index = getIndex( tx_depth, tx_depths, Nsd );
+  int tx_depth_index = getNearestIndex( tx_depth, tx_depths, Nsd );
   int rx_depth_index = getIndex( rx_depth, rx_depths, Nrx_per_range );
   int rx_range_index = getIndex( rx_range/1000.0, rx_ranges, Nrr );
 
@@ -150,10 +171,26 @@ int ShdData_v1::getIndex( double value, double* array, int32_t array_size ) cons
 }
 
 
+int ShdData_v1::getNearestIndex( float value, float* array, int32_t array_size ) const {
+  if ( value <= array[0] || array_size == 1 ) {
+    return 0;
+  }
+  else if ( value >= array[array_size - 1] ) {
+    return( array_size - 1 );
+  }
+
+  float* upper = ::std::lower_bound( array, array + array_size, value );
+  int index = upper - array;
+
+  if ( ( *upper - value ) < ( value - *(upper - 1) ) ) return index;
+  else return( index - 1 );
+}
+
+
 int ShdData_v1::getPressureIndex( double tx_freq, double tx_depth, double rx_depth, double rx_range, double tx_theta ) const {
   int freq_index = getIndex( tx_freq, frequencies, Nfreq );
   int theta_index = getIndex( tx_theta, theta, Ntheta );
-  int tx_depth_index = getIndex( tx_depth, tx_depths, Nsd );
+  int tx_depth_index = getNearestIndex( tx_depth, tx_depths, Nsd );
   int rx_depth_index = getIndex( rx_depth, rx_depths, Nrx_per_range );
   int rx_range_index = getIndex( rx_range/1000.0, rx_ranges, Nrr );
 
@@ -171,6 +208,8 @@ ShdResReader::ShdResReader()
    file_reader(),
    shd_file(),
    shd_file_v1(),
+   using_mmap(false),
+   shd_mappings(),
    last_tx_depth(SHD_RES_NOT_SET),
    last_start_rx_depth(SHD_RES_NOT_SET),
    last_start_rx_range(SHD_RES_NOT_SET),
@@ -189,6 +228,8 @@ ShdResReader::ShdResReader( const Woss* const woss )
    file_reader(),
    shd_file(),
    shd_file_v1(),
+   using_mmap(false),
+   shd_mappings(),
    last_tx_depth(SHD_RES_NOT_SET),
    last_start_rx_depth(SHD_RES_NOT_SET),
    last_start_rx_range(SHD_RES_NOT_SET),
@@ -201,7 +242,7 @@ ShdResReader::ShdResReader( const Woss* const woss )
 
 
 ShdResReader::~ShdResReader()  { 
-  
+  unmapShdFiles();
 }
 
 
@@ -209,7 +250,142 @@ bool ShdResReader::initialize() {
   assert(woss_ptr != NULL );
   assert(file_name.size() > 0);
 
-  return( getShdHeader() && getShdFile() );
+  if ( !getShdHeader() ) return false;
+  
+  if ( using_mmap ) return( mapShdFile() );
+  return( getShdFile() );
+}
+
+
+bool ShdResReader::mapShdFile() {
+  const BellhopWoss* bwoss_ptr = dynamic_cast<const BellhopWoss*>(woss_ptr);
+  assert( NULL != bwoss_ptr );
+
+  int mapped_runs = 0;
+  for ( SMVCIter it = shd_mappings.begin(); it != shd_mappings.end(); it++ ) {
+    mapped_runs += it->runs;
+  }
+  
+  // every run of the previous Woss::run() has been mapped, this file belongs to a new one
+  if ( mapped_runs >= woss_ptr->getTotalRuns() ) unmapShdFiles();
+
+  size_t record_size;
+  size_t first_record;
+  size_t total_records;
+  size_t last_record_size;
+  
+  if (bwoss_ptr->getBellhopShdSyntax() == BELLHOP_CREATOR_SHD_FILE_SYNTAX_0) {
+    record_size = 4 * shd_file.record_length;
+    first_record = 7;
+    total_records = shd_file.Ntheta * shd_file.Nsd * shd_file.Nrx_per_range;
+    last_record_size = 2 * shd_file.Nrr * sizeof(float);
+  }
+  else if (bwoss_ptr->getBellhopShdSyntax() == BELLHOP_CREATOR_SHD_FILE_SYNTAX_1) {
+    record_size = 4 * shd_file_v1.record_length;
+    first_record = 10;
+    total_records = shd_file_v1.Nfreq * shd_file_v1.Ntheta * shd_file_v1.Nsd * shd_file_v1.Nrx_per_range;
+    last_record_size = 2 * shd_file_v1.Nrr * sizeof(float);
+  }
+  else {
+    ::std::cout << "ShdResReader(" << woss_ptr->getWossId() << ")::mapShdFile() unkown Shd syntax " << ::std::endl;
+    exit(1);
+  }
+  
+  int fd = open( file_name.c_str(), O_RDONLY );
+  
+  if ( fd < 0 ) {
+    if (woss_ptr->usingDebug()) ::std::cout << "ShdResReader(" << woss_ptr->getWossId() << ")::mapShdFile() WARNING, results file " << file_name 
+                                            << " non existant" << ::std::endl;
+    return false;
+  }
+  
+  struct stat file_stat;
+  size_t needed_size = ( first_record + total_records - 1 ) * record_size + last_record_size;
+  
+  if ( record_size == 0 || last_record_size > record_size || fstat( fd, &file_stat ) != 0 || (size_t)file_stat.st_size < needed_size ) {
+    ::std::cerr << "ShdResReader(" << woss_ptr->getWossId() << ")::mapShdFile() ERROR, results file " << file_name 
+                << " doesn't match its header, size = " << file_stat.st_size << "; needed size = " << needed_size << ::std::endl;
+    close( fd );
+    return false;
+  }
+  
+  void* address = mmap( NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+  close( fd );
+  
+  if ( address == MAP_FAILED ) {
+    ::std::cerr << "ShdResReader(" << woss_ptr->getWossId() << ")::mapShdFile() ERROR, mmap of " << file_name << " failed" << ::std::endl;
+    return false;
+  }
+  
+  ShdMapping mapping;
+  mapping.name = file_name;
+  mapping.address = static_cast< const char* >( address );
+  mapping.size = file_stat.st_size;
+  mapping.runs = 1;
+  
+  SMVIter it = shd_mappings.begin();
+  for ( ; it != shd_mappings.end(); it++ ) {
+    if ( it->name == file_name ) break;
+  }
+  
+  // the same result file shared by several runs of the same Woss::run() has to be summed once per run
+  if ( it != shd_mappings.end() ) {
+    munmap( const_cast< char* >( mapping.address ), mapping.size );
+    it->runs++;
+  }
+  else shd_mappings.push_back( mapping );
+  
+  if (woss_ptr->usingDebug()) ::std::cout << "ShdResReader(" << woss_ptr->getWossId() << ")::mapShdFile() mapped " << file_name 
+                                          << "; size = " << mapping.size << "; mapped files = " << shd_mappings.size() << ::std::endl;
+  
+  last_tx_depth = SHD_RES_NOT_SET;
+  shd_file_collected = true;
+  return shd_file_collected;
+}
+
+
+void ShdResReader::unmapShdFiles() {
+  for ( SMVIter it = shd_mappings.begin(); it != shd_mappings.end(); it++ ) {
+    munmap( const_cast< char* >( it->address ), it->size );
+  }
+  shd_mappings.clear();
+}
+
+
+::std::complex<double> ShdResReader::decodePressure( int press_index ) const {
+  const BellhopWoss* bwoss_ptr = dynamic_cast<const BellhopWoss*>(woss_ptr);
+
+  size_t record_size;
+  size_t record;
+  size_t Nrr;
+  
+  // press_values is laid out record after record, every record holding Nrr complex values
+  if (bwoss_ptr->getBellhopShdSyntax() == BELLHOP_CREATOR_SHD_FILE_SYNTAX_0) {
+    record_size = 4 * shd_file.record_length;
+    Nrr = shd_file.Nrr;
+    record = 7 + press_index / Nrr;
+  }
+  else {
+    record_size = 4 * shd_file_v1.record_length;
+    Nrr = shd_file_v1.Nrr;
+    record = 10 + press_index / Nrr;
+  }
+  
+  size_t offset = record * record_size + 2 * ( press_index % Nrr ) * sizeof(float);
+  ::std::complex<double> ret_value( 0.0, 0.0 );
+  
+  for ( SMVCIter it = shd_mappings.begin(); it != shd_mappings.end(); it++ ) {
+    float press[2];
+    ::std::memcpy( press, it->address + offset, sizeof(press) );
+    
+    double real_part = press[0];
+    double imag_part = press[1];
+    
+    if ( !::std::isnan(real_part) && !::std::isnan(imag_part) && !::std::isinf(real_part) && !::std::isinf(imag_part) ) {
+      ret_value += (double)it->runs * ::std::complex<double>(real_part, imag_part);
+    }
+  }
+  return ret_value;
 }
 
 
@@ -219,6 +395,8 @@ bool ShdResReader::getShdHeader() {
   const BellhopWoss* bwoss_ptr = dynamic_cast<const BellhopWoss*>(woss_ptr);
   assert( NULL != bwoss_ptr );
 
+  using_mmap = bwoss_ptr->getShdMmapReadFlag();
+
   file_reader.open(file_name.c_str() , ::std::ios::binary|::std::ios::in);
 
   if(!file_reader) {
@@ -264,7 +442,7 @@ bool ShdResReader::getShdHeader() {
     shd_file.tx_depths = new float[shd_file.Nsd];
     shd_file.rx_depths = new float[shd_file.Nrd];
     shd_file.rx_ranges = new float[shd_file.Nrr];
-    shd_file.press_values = new ::std::complex<double>[(int)(shd_file.Ntheta * shd_file.Nsd * shd_file.Nrd * shd_file.Nrr)];
+    if ( !using_mmap ) shd_file.press_values = new ::std::complex<double>[(int)(shd_file.Ntheta * shd_file.Nsd * shd_file.Nrd * shd_file.Nrr)];
 
     file_reader.seekg(3*4*shd_file.record_length, ::std::ios_base::beg); //reposition to end of record 3
     file_reader.read(reinterpret_cast<char*>(shd_file.theta),shd_file.Ntheta*sizeof(float));
@@ -341,7 +519,7 @@ bool ShdResReader::getShdHeader() {
     shd_file_v1.tx_depths = new float[shd_file_v1.Nsd];
     shd_file_v1.rx_depths = new float[shd_file_v1.Nrd];
     shd_file_v1.rx_ranges = new double[shd_file_v1.Nrr];
-    shd_file_v1.press_values = new ::std::complex<double>[(int)(shd_file_v1.Nfreq * shd_file_v1.Ntheta * shd_file_v1.Nsd * shd_file_v1.Nrx_per_range * shd_file_v1.Nrr)];
+    if ( !using_mmap ) shd_file_v1.press_values = new ::std::complex<double>[(int)(shd_file_v1.Nfreq * shd_file_v1.Ntheta * shd_file_v1.Nsd * shd_file_v1.Nrx_per_range * shd_file_v1.Nrr)];
 
     file_reader.seekg(3*4*shd_file_v1.record_length, ::std::ios_base::beg); //reposition to end of record 3
     file_reader.read(reinterpret_cast<char*>(shd_file_v1.frequencies),shd_file_v1.Nfreq*sizeof(double));
@@ -546,10 +724,14 @@ TimeArr* ShdResReader::readTimeArr(double frequency, double tx_depth, double rx_
   assert( NULL != bwoss_ptr );
 
   if (bwoss_ptr->getBellhopShdSyntax() == BELLHOP_CREATOR_SHD_FILE_SYNTAX_0) {
-    return( shd_file.press_values[ shd_file.getPressureIndex( tx_depth, rx_depth, rx_range, theta ) ] ); 
+    int press_index = shd_file.getPressureIndex( tx_depth, rx_depth, rx_range, theta );
+    if ( using_mmap ) return( decodePressure( press_index ) );
+    return( shd_file.press_values[ press_index ] ); 
   }
   else if (bwoss_ptr->getBellhopShdSyntax() == BELLHOP_CREATOR_SHD_FILE_SYNTAX_1) {
-    return( shd_file_v1.press_values[ shd_file_v1.getPressureIndex( frequency, tx_depth, rx_depth, rx_range, theta ) ] ); 
+    int press_index = shd_file_v1.getPressureIndex( frequency, tx_depth, rx_depth, rx_range, theta );
+    if ( using_mmap ) return( decodePressure( press_index ) );
+    return( shd_file_v1.press_values[ press_index ] ); 
   }
   else {
     ::std::cout << "ShdResReader(" << woss_ptr->getWossId() << ")::accessMap() unkown Shd syntax " << ::std::endl;
@@ -577,7 +759,7 @@ TimeArr* ShdResReader::readTimeArr(double frequency, double tx_depth, double rx_
        end_index = shd_file.getPressureIndex( tx_depth, end_rx_depth, end_rx_range, theta );
 
        for ( int i = start_index; i <= end_index; i++ ) {
-         sum_press += shd_file.press_values[i];
+         sum_press += ( using_mmap ? decodePressure(i) : shd_file.press_values[i] );
          sum_cnt++;
        }
      }
@@ -586,7 +768,7 @@ TimeArr* ShdResReader::readTimeArr(double frequency, double tx_depth, double rx_
        end_index = shd_file_v1.getPressureIndex( frequency, tx_depth, end_rx_depth, end_rx_range, theta );
 
        for ( int i = start_index; i <= end_index; i++ ) {
-         sum_press += shd_file_v1.press_values[i];
+         sum_press += ( using_mmap ? decodePressure(i) : shd_file_v1.press_values[i] );
          sum_cnt++;
        }
     }
@@ -42,6 +42,7 @@
 
 
 #include <fstream>
+#include <vector>
 #include <time-arrival-definitions.h>
 #include "res-reader.h"
 
@@ -166,6 +167,16 @@ namespace woss {
     */
     int getIndex( float value, float* array, int32_t array_size ) const;
 
+    /**
+    * Returns the index of the array entry closest to given value. Unlike getIndex() it doesn't
+    * assume a linear spacing, so it can be used with explicit source depth lists
+    * @param value test value
+    * @param array valid pointer to a sorted array 
+    * @param array_size size of passed array
+    * @returns valid array index value
+    */
+    int getNearestIndex( float value, float* array, int32_t array_size ) const;
+
   };
 
   /**
@@ -298,6 +309,16 @@ namespace woss {
     * @returns valid array index value
     */
     int getIndex( double value, double* array, int32_t array_size ) const;
+
+    /**
+    * Returns the index of the array entry closest to given value. Unlike getIndex() it doesn't
+    * assume a linear spacing, so it can be used with explicit source depth lists
+    * @param value test value
+    * @param array valid pointer to a sorted array 
+    * @param array_size size of passed array
+    * @returns valid array index value
+    */
+    int getNearestIndex( float value, float* array, int32_t array_size ) const;
   };
 
   /**
@@ -305,6 +326,9 @@ namespace woss {
   *
   * Class ShdResReader stores Pressure provided by any acoustic toolbox SHD file in a ShdData. It also offers
   * Pressure manipulation and TimeArr conversion methods.
+  *
+  * If BellhopWoss::getShdMmapReadFlag() is set, only the SHD header is parsed: every SHD file is memory mapped 
+  * and the Pressure values are decoded from the mapped records when they are queried.
   */
   class ShdResReader : public ResReader {
 
@@ -396,6 +420,40 @@ namespace woss {
     */
     ShdData_v1 shd_file_v1;
 
+    /**
+    * \brief a memory mapped SHD file
+    **/
+    struct ShdMapping {
+      
+      ::std::string name;
+      
+      const char* address;
+      
+      size_t size;
+      
+      /**
+      * number of runs that produced this file (e.g. runs sharing a cached result)
+      **/
+      int runs;
+      
+    };
+    
+    typedef ::std::vector< ShdMapping > ShdMappingVector;
+    typedef ShdMappingVector::iterator SMVIter;
+    typedef ShdMappingVector::const_iterator SMVCIter;
+    
+    
+    /**
+    * <i>true</i> if the SHD files are memory mapped instead of being read into ShdData
+    */
+    bool using_mmap;
+    
+    /**
+    * SHD files mapped for the current Woss::run(), every file counted once for each run sharing it
+    */
+    ShdMappingVector shd_mappings;
+    
+    
     double last_tx_depth;
 
     double last_start_rx_depth;
@@ -447,6 +505,26 @@ namespace woss {
     **/
     bool getShdHeader();
     
+    /**
+    * Memory maps the current SHD file, after checking its size against the SHD header. 
+    * A file already mapped is mapped again, since its content has been replaced by a new run
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    bool mapShdFile();
+    
+    /**
+    * Unmaps all the mapped SHD files
+    **/
+    void unmapShdFiles();
+    
+    /**
+    * Decodes from the mapped SHD files the Pressure value with given ShdData or ShdData_v1 index. 
+    * The values of all mapped files are summed, as getShdFile() does
+    * @param press_index valid press_values index
+    * @return Pressure value
+    **/
+    ::std::complex<double> decodePressure( int press_index ) const;
+    
     
   };
 
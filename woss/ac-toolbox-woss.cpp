@@ -41,6 +41,7 @@
 #include <cmath>
 #include "ac-toolbox-woss.h"
 #include <woss-db-manager.h>
+#include "woss-metrics.h"
 
 
 using namespace woss;
@@ -63,7 +64,8 @@ ACToolboxWoss::ACToolboxWoss()
     ssp_map(),
     sediment_map(),
     altimetry_value(NULL),
-    is_ssp_map_transformable(false)
+    is_ssp_map_transformable(false),
+    is_transect_initialized(false)
 {
 
 }
@@ -86,7 +88,8 @@ ACToolboxWoss::ACToolboxWoss( const CoordZ& tx, const CoordZ& rx, const Time& st
     ssp_map(),
     sediment_map(),
     altimetry_value(NULL),
-    is_ssp_map_transformable(false)
+    is_ssp_map_transformable(false),
+    is_transect_initialized(false)
 {
 
 }
@@ -153,10 +156,52 @@ bool ACToolboxWoss::initialize() {
   is_ok = initSSPMap();
   assert(is_ok);
   
+  is_transect_initialized = true;
+  
   return true;
 }
 
 
+bool ACToolboxWoss::updateTimeVariantValues( const Time& time_value ) {
+  assert( is_transect_initialized );
+  
+  SSPMap old_ssp_map;
+  old_ssp_map.swap( ssp_map );
+  
+  bool is_ok = initSSPMap();
+  assert(is_ok);
+  
+  bool has_changed = ( old_ssp_map.size() != ssp_map.size() );
+  
+  SSPMap::iterator old_it = old_ssp_map.begin();
+  for ( SSPMap::iterator it = ssp_map.begin(); !has_changed && it != ssp_map.end(); ++it, ++old_it ) {
+    has_changed = ( it->first != old_it->first ) || !( *(it->second) == *(old_it->second) );
+  }
+  
+  for ( old_it = old_ssp_map.begin(); old_it != old_ssp_map.end(); ++old_it ) {
+    delete old_it->second;
+  }
+  
+  if ( altimetry_value != NULL && altimetry_value->isValid() ) {
+    Altimetry* new_value = altimetry_value->timeEvolve( time_value );
+    
+    has_changed = has_changed || !( *new_value == *altimetry_value );
+    
+    delete altimetry_value;
+    altimetry_value = new_value;
+    
+    min_altimetry_depth = altimetry_value->getMinAltimetryValue();
+    max_altimetry_depth = altimetry_value->getMaxAltimetryValue();
+  }
+  
+  if (debug) 
+    ::std::cout << "ACToolboxWoss(" << woss_id << ")::updateTimeVariantValues() current_time = " << current_time
+                << "; ssp map size = " << ssp_map.size() << "; has changed = " << has_changed << ::std::endl;
+  
+  return has_changed;
+}
+
+
 bool ACToolboxWoss::initRangeVector() {
   for (int i = 0; i <= total_range_steps; i++) {
     range_vector.push_back( ( total_great_circle_distance / (total_range_steps) ) * i );
@@ -173,36 +218,40 @@ bool ACToolboxWoss::initCoordZVector() {
   if (debug) ::std::cout << "ACToolboxWoss(" << woss_id << ")::initCoordZVector() tx coord = " << tx_coordz << "; rx coord = " << rx_coordz << " ; bearing = " << bearing << ::std::endl;
 
   bool valid = true;
-  CoordZ curr_coord;
   double curr_bathy;
 
+  coordz_vector.reserve( range_vector.size() );
+
   for (RangeVector::iterator it = range_vector.begin() ; it != range_vector.end(); ++it) {
     if ( *it == 0.0 ) { // first range
-      curr_coord = tx_coordz;
+      coordz_vector.push_back( tx_coordz );
     }
     else if ( *it == total_great_circle_distance ) { // last range
-      curr_coord = rx_coordz;
+      coordz_vector.push_back( rx_coordz );
     }
     else {
-      curr_coord = CoordZ( Coord::getCoordFromBearing(tx_coordz, bearing, *it) );
+      coordz_vector.push_back( CoordZ( Coord::getCoordFromBearing(tx_coordz, bearing, *it) ) );
     }
+  }
 
-    curr_bathy = db_manager->getBathymetry( tx_coordz, curr_coord );
+  // the whole transect is answered by a single bathymetry query
+  WossMetricsTimer db_timer( WOSS_METRICS_ENV_DB_READ );
+  db_manager->getBathymetry( tx_coordz, coordz_vector );
+  db_timer.stop();
+
+  for (CoordZVector::iterator it = coordz_vector.begin() ; it != coordz_vector.end(); ++it) {
+    curr_bathy = it->getDepth();
 
     assert( curr_bathy != HUGE_VAL && curr_bathy >= 0);
     
     if (curr_bathy > max_bathymetry_depth) max_bathymetry_depth = curr_bathy;
     if (curr_bathy < min_bathymetry_depth) min_bathymetry_depth = curr_bathy;
 
-    curr_coord.setDepth( curr_bathy );
-    
-    valid = valid && curr_coord.isValid();
+    valid = valid && it->isValid();
 
     if (debug)
       ::std::cout << "ACToolboxWoss(" << woss_id << ")::initCoordZVector() i = " 
-                  << ::std::distance(range_vector.begin(), it)  << " coordinate " << curr_coord << ::std::endl;
-
-    coordz_vector.push_back(curr_coord);
+                  << ::std::distance(coordz_vector.begin(), it)  << " coordinate " << *it << ::std::endl;
   }
 
   return valid;
@@ -210,8 +259,10 @@ bool ACToolboxWoss::initCoordZVector() {
 
 
 bool ACToolboxWoss::initAltimetry() {
-  if ( altimetry_value == NULL ) 
+  if ( altimetry_value == NULL ) {
+    WossMetricsTimer db_timer( WOSS_METRICS_ENV_DB_READ );
     altimetry_value = db_manager->getAltimetry( tx_coordz, rx_coordz );
+  }
   
   bool ret_value = false;
 
@@ -249,8 +300,12 @@ bool ACToolboxWoss::initAltimetry() {
 
 
 bool ACToolboxWoss::initSedimentMap() {
+  WossMetricsTimer db_timer( WOSS_METRICS_ENV_DB_READ );
+  SedimentVector sediment_vector = db_manager->getSedimentVector( tx_coordz, coordz_vector );
+  db_timer.stop();
+
   for (CoordZVector::iterator it = coordz_vector.begin() ; it != coordz_vector.end(); ++it) {
-    Sediment* curr_sediment = db_manager->getSediment( tx_coordz, *it );
+    Sediment* curr_sediment = sediment_vector[ ::std::distance(coordz_vector.begin(), it) ];
 
     if ( curr_sediment->isValid() ) {
       if (debug)
@@ -301,8 +356,12 @@ bool ACToolboxWoss::checkSedimentUnicity( Sediment*& ptr ) {
 bool ACToolboxWoss::initSSPMap() {
   is_ssp_map_transformable = true;
   
+  WossMetricsTimer db_timer( WOSS_METRICS_ENV_DB_READ );
+  SSPVector ssp_vector = db_manager->getSSPVector( tx_coordz, coordz_vector, current_time );
+  db_timer.stop();
+
   for( CoordZVector::iterator it = coordz_vector.begin(); it != coordz_vector.end(); ++it ) {
-    SSP* curr_ssp = db_manager->getSSP( tx_coordz, *it, current_time );
+    SSP* curr_ssp = ssp_vector[ ::std::distance(coordz_vector.begin(), it) ];
 
     if ( curr_ssp->isValid() ) {
       is_ssp_map_transformable = is_ssp_map_transformable && curr_ssp->isTransformable();
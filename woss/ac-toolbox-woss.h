@@ -107,6 +107,15 @@ namespace woss {
     **/
     virtual bool initialize();
 
+    /**
+    * Refreshes only the time dependent enviroment, that is the SSPs at <i>current_time</i> and the 
+    * altimetry evolved at given time. Transect geometry, bathymetry and sediments are kept.
+    * A full initialize() must have been called before
+    * @param time_value const reference to a valid Time object for the altimetry evolution
+    * @return <i>true</i> if any SSP or the altimetry has changed, <i>false</i> otherwise
+    **/
+    virtual bool updateTimeVariantValues( const Time& time_value );
+
 
     /**
     * Checks the validity of ACToolboxWoss
@@ -268,6 +277,12 @@ namespace woss {
     **/
     bool is_ssp_map_transformable;
 
+    /**
+    * <i>True</i> if the time independent enviroment (range_vector, coordz_vector, bathymetry and sediment_map) 
+    * has been initialized
+    **/
+    bool is_transect_initialized;
+
 
     /**
     * Checks if the given SSP is not equal to previous values
@@ -51,6 +51,11 @@ BellhopCreator::BellhopCreator()
 : WossCreator(),
   use_thorpe_att(true),
   bellhop_path(),  
+  bellhop_solver(NULL),
+  concurrent_runs(1),
+  shd_mmap_read(false),
+  fan_depth_step(BELLHOP_CREATOR_FAN_DEPTH_STEP),
+  fan_range_step(BELLHOP_CREATOR_FAN_RANGE_STEP),
   bellhop_arr_syntax(BELLHOP_CREATOR_ARR_FILE_INVALID),
   bellhop_shd_syntax(BELLHOP_CREATOR_SHD_FILE_INVALID),
   ccbellhop_mode(),
@@ -78,6 +83,9 @@ BellhopCreator::BellhopCreator()
 { 
   BellhopCreator::updateDebugFlag();
   cctransducer.accessAllLocations() = CustomTransducer();
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_init( &run_pools_mutex, NULL );
+#endif // WOSS_MULTITHREAD
 }
 
 
@@ -107,6 +115,42 @@ void BellhopCreator::updateDebugFlag() {
 }
 
 
+BellhopCreator::~BellhopCreator() {
+#ifdef WOSS_MULTITHREAD
+  // each pool waits for its queued jobs and joins its workers before the solver is deleted
+  for ( RPMIter it = run_pools.begin(); it != run_pools.end(); it++ ) {
+    delete it->second;
+    it->second = NULL;
+  }
+  pthread_mutex_destroy( &run_pools_mutex );
+#endif // WOSS_MULTITHREAD
+  
+  if ( bellhop_solver != NULL ) delete bellhop_solver;
+}
+
+
+#ifdef WOSS_MULTITHREAD
+WossThreadPool* BellhopCreator::getRunPool( int threads ) const {
+  pthread_mutex_lock( &run_pools_mutex );
+  
+  RPMIter it = run_pools.find( threads );
+  if ( it == run_pools.end() ) it = run_pools.insert( ::std::make_pair( threads, new WossThreadPool( threads ) ) ).first;
+  
+  WossThreadPool* ret_value = it->second;
+  
+  pthread_mutex_unlock( &run_pools_mutex );
+  return ret_value;
+}
+#endif // WOSS_MULTITHREAD
+
+
+BellhopCreator& BellhopCreator::setBellhopSolver( BellhopSolver* const solver ) {
+  if ( bellhop_solver != NULL && bellhop_solver != solver ) delete bellhop_solver;
+  bellhop_solver = solver;
+  return *this;
+}
+
+
 BellhopWoss* const BellhopCreator::createWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency ) const {
   SimTime time = getSimTime( tx, rx );
   assert( time.start_time.isValid() && time.end_time.isValid() );
@@ -117,6 +161,88 @@ BellhopWoss* const BellhopCreator::createWoss( const CoordZ& tx, const CoordZ& r
 }
 
 
+BellhopWoss* const BellhopCreator::createFanWoss( const CoordZ& tx, const CoordZVector& rx_vector, double start_frequency, double end_frequency ) const {
+  assert( !rx_vector.empty() );
+  
+  int far_index = 0;
+  double min_range = tx.getGreatCircleDistance( rx_vector[0] );
+  double max_range = min_range;
+  double min_depth = rx_vector[0].getDepth();
+  double max_depth = min_depth;
+  
+  for ( int i = 1; i < (int) rx_vector.size(); i++ ) {
+    double range = tx.getGreatCircleDistance( rx_vector[i] );
+    
+    if ( range > max_range ) {
+      max_range = range;
+      far_index = i;
+    }
+    min_range = ::std::min( min_range, range );
+    min_depth = ::std::min( min_depth, rx_vector[i].getDepth() );
+    max_depth = ::std::max( max_depth, rx_vector[i].getDepth() );
+  }
+  
+  const CoordZ& rx = rx_vector[far_index];
+  SimTime time = getSimTime( tx, rx );
+  assert( time.start_time.isValid() && time.end_time.isValid() );
+  
+  BellhopWoss* ret_value = new BellhopWoss( tx, rx, time.start_time, time.end_time, start_frequency, end_frequency, getFrequencyStep() );
+  configureBhWoss( ret_value );
+  
+  // the receiver grid is widened around the farthest receiver to reach all the others
+  double min_depth_offset = ::std::min( ret_value->getRxMinDepthOffset(), min_depth - rx.getDepth() );
+  double max_depth_offset = ::std::max( ret_value->getRxMaxDepthOffset(), max_depth - rx.getDepth() );
+  double min_range_offset = ::std::min( ret_value->getRxMinRangeOffset(), min_range - max_range );
+  double max_range_offset = ::std::max( ret_value->getRxMaxRangeOffset(), 0.0 );
+  
+  ret_value->setRxMinDepthOffset( min_depth_offset )
+            .setRxMaxDepthOffset( max_depth_offset )
+            .setRxTotalDepths( ::std::max( ret_value->getRxTotalDepths(), getFanTotalSteps( max_depth_offset - min_depth_offset, fan_depth_step ) ) )
+            .setRxMinRangeOffset( min_range_offset )
+            .setRxMaxRangeOffset( max_range_offset )
+            .setRxTotalRanges( ::std::max( ret_value->getRxTotalRanges(), getFanTotalSteps( max_range_offset - min_range_offset, fan_range_step ) ) );
+  
+  if ( debug ) ::std::cout << "BellhopCreator::createFanWoss() tx = " << tx << "; far rx = " << rx << "; receivers = " << rx_vector.size()
+                           << "; rx depths = " << ret_value->getRxTotalDepths() << "; rx ranges = " << ret_value->getRxTotalRanges() << ::std::endl;
+  
+  assert( initializeWoss( ret_value ) );
+  return ret_value;
+}
+
+
+BellhopWoss* const BellhopCreator::createStackWoss( const CoordZVector& tx_vector, const CoordZ& rx, double start_frequency, double end_frequency ) const {
+  assert( !tx_vector.empty() );
+  
+  int ref_index = 0;
+  double max_depth = tx_vector[0].getDepth();
+  DepthVector depths;
+  
+  for ( int i = 0; i < (int) tx_vector.size(); i++ ) {
+    if ( tx_vector[i].getDepth() < tx_vector[ref_index].getDepth() ) ref_index = i;
+    max_depth = ::std::max( max_depth, tx_vector[i].getDepth() );
+    depths.push_back( tx_vector[i].getDepth() );
+  }
+  
+  const CoordZ& tx = tx_vector[ref_index];
+  SimTime time = getSimTime( tx, rx );
+  assert( time.start_time.isValid() && time.end_time.isValid() );
+  
+  BellhopWoss* ret_value = new BellhopWoss( tx, rx, time.start_time, time.end_time, start_frequency, end_frequency, getFrequencyStep() );
+  configureBhWoss( ret_value );
+  
+  // the sources span from the reference transmitter down to the deepest one
+  ret_value->setTxMinDepthOffset( ::std::min( ret_value->getTxMinDepthOffset(), 0.0 ) )
+            .setTxMaxDepthOffset( ::std::max( ret_value->getTxMaxDepthOffset(), max_depth - tx.getDepth() ) )
+            .setTxDepths( depths );
+  
+  if ( debug ) ::std::cout << "BellhopCreator::createStackWoss() reference tx = " << tx << "; rx = " << rx 
+                           << "; sources = " << ret_value->getTotalTransmitters() << "; max depth = " << max_depth << ::std::endl;
+  
+  assert( initializeWoss( ret_value ) );
+  return ret_value;
+}
+
+
 bool BellhopCreator::initializeWoss( Woss* const woss_ptr ) const {
   assert( WossCreator::initializeWoss(woss_ptr) );
   return( woss_ptr->initialize() );
@@ -124,6 +250,12 @@ bool BellhopCreator::initializeWoss( Woss* const woss_ptr ) const {
 
 
 bool BellhopCreator::initializeBhWoss( BellhopWoss* const woss_ptr ) const {
+  configureBhWoss( woss_ptr );
+  return( initializeWoss( woss_ptr ) );
+}
+
+
+void BellhopCreator::configureBhWoss( BellhopWoss* const woss_ptr ) const {
   assert( !ccbellhop_mode.isEmpty() && !ccbathymetry_type.isEmpty() && !ccbeam_options.isEmpty() 
           && !ccaltimetry_type.isEmpty() );
 
@@ -152,6 +284,9 @@ bool BellhopCreator::initializeBhWoss( BellhopWoss* const woss_ptr ) const {
                                 transducer_params.multiply_costant, transducer_params.add_costant )
            .setTransformSSPDepthSteps(ccnormalized_ssp_depth_steps.get( tx, rx ))
            .setBellhopPath(bellhop_path)
+           .setBellhopSolver(bellhop_solver)
+           .setConcurrentRuns(concurrent_runs)
+           .setShdMmapReadFlag(shd_mmap_read)
            .setBellhopArrSyntax(bellhop_arr_syntax)
            .setBellhopShdSyntax(bellhop_shd_syntax)
            .setBathymetryType(ccbathymetry_type.get( tx, rx ))
@@ -161,8 +296,10 @@ bool BellhopCreator::initializeBhWoss( BellhopWoss* const woss_ptr ) const {
            .setBeamOptions(ccbeam_options.get( tx, rx ))
            .setSSPDepthPrecision(ccssp_depth_precision.get( tx, rx ))
            .setRangeSteps(cctotal_range_steps.get( tx, rx ));
-
-  return( initializeWoss( woss_ptr ) );
+  
+#ifdef WOSS_MULTITHREAD
+  if ( woss_ptr->getTotalRunThreads() > 1 ) woss_ptr->setRunPool( getRunPool( woss_ptr->getTotalRunThreads() ) );
+#endif // WOSS_MULTITHREAD
 }
 
 
@@ -46,6 +46,18 @@
 
 
 namespace woss {
+
+  
+  /**
+  * Default receiver depth resolution of receiver fans [m]
+  */
+  #define BELLHOP_CREATOR_FAN_DEPTH_STEP (5.0)
+  
+  /**
+  * Default receiver range resolution of receiver fans [m]
+  */
+  #define BELLHOP_CREATOR_FAN_RANGE_STEP (10.0)
+  
   
     
   /**
@@ -98,7 +110,7 @@ namespace woss {
     */
     BellhopCreator();
     
-    virtual ~BellhopCreator() { }
+    virtual ~BellhopCreator();
     
 
     /**
@@ -111,6 +123,28 @@ namespace woss {
     **/
     virtual BellhopWoss* const createWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency ) const;
     
+    /**
+    * Returns a pointer to a valid BellhopWoss computed towards the farthest of given receivers, whose receiver
+    * depth and range grid covers all of them. The grid resolution is given by setFanDepthStep() and setFanRangeStep()
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx_vector const reference to a non empty CoordZVector ( receivers )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @returns pointer to properly initialized BellhopWoss object
+    **/
+    virtual BellhopWoss* const createFanWoss( const CoordZ& tx, const CoordZVector& rx_vector, double start_frequency, double end_frequency ) const;
+    
+    /**
+    * Returns a pointer to a valid BellhopWoss placed at the shallowest of given transmitters, whose source
+    * depths are the depths of all of them
+    * @param tx_vector const reference to a non empty CoordZVector ( transmitters sharing latitude and longitude )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @returns pointer to properly initialized BellhopWoss object
+    **/
+    virtual BellhopWoss* const createStackWoss( const CoordZVector& tx_vector, const CoordZ& rx, double start_frequency, double end_frequency ) const;
+    
     
     /**
     * Sets the Thorpe attenuation flag for all bellhop instances
@@ -767,6 +801,75 @@ namespace woss {
     */
     ::std::string getBellhopPath() { return bellhop_path; }
 
+    /**
+    * Sets the solver backend shared by all created BellhopWoss. The object is owned and deleted by BellhopCreator,
+    * so it has to be set before any BellhopWoss is created
+    * @param solver pointer to a dynamically allocated BellhopSolver, NULL restores the default BellhopSystemSolver
+    * @return reference to <b>*this</b>
+    */
+    BellhopCreator& setBellhopSolver( BellhopSolver* const solver );
+
+    /**
+    * Gets the solver backend shared by all created BellhopWoss
+    * @return pointer to the BellhopSolver, NULL if the default one is in use
+    */
+    BellhopSolver* getBellhopSolver() { return bellhop_solver; }
+
+    /**
+    * Sets the maximum number of Bellhop jobs (frequency, run) that each created BellhopWoss executes in parallel.
+    * The jobs of all created BellhopWoss are executed by thread pools owned by BellhopCreator, 
+    * so the limit holds also when several of them run concurrently.
+    * It is effective only if WOSS_MULTITHREAD is defined
+    * @param runs 0 = number of available cpu cores, 1 or negative = serial execution
+    * @return reference to <b>*this</b>
+    */
+    BellhopCreator& setConcurrentRuns( int runs ) { concurrent_runs = runs; return *this; }
+
+    /**
+    * Gets the maximum number of Bellhop jobs executed in parallel
+    * @return concurrent runs
+    */
+    int getConcurrentRuns() { return concurrent_runs; }
+
+    /**
+    * Sets whether each created BellhopWoss memory maps its SHD results files instead of reading them in memory
+    * @param flag <i>true</i> to memory map SHD results files
+    * @return reference to <b>*this</b>
+    */
+    BellhopCreator& setShdMmapReadFlag( bool flag ) { shd_mmap_read = flag; return *this; }
+
+    /**
+    * Returns whether SHD results files are memory mapped
+    * @return <i>true</i> if SHD results files are memory mapped, <i>false</i> otherwise
+    */
+    bool getShdMmapReadFlag() { return shd_mmap_read; }
+
+    /**
+    * Sets the receiver depth resolution of the BellhopWoss created by createFanWoss()
+    * @param step depth step [m], <= 0 keeps the configured number of receiver depths
+    * @return reference to <b>*this</b>
+    */
+    BellhopCreator& setFanDepthStep( double step ) { fan_depth_step = step; return *this; }
+
+    /**
+    * Gets the receiver depth resolution of the BellhopWoss created by createFanWoss()
+    * @return depth step [m]
+    */
+    double getFanDepthStep() const { return fan_depth_step; }
+
+    /**
+    * Sets the receiver range resolution of the BellhopWoss created by createFanWoss()
+    * @param step range step [m], <= 0 keeps the configured number of receiver ranges
+    * @return reference to <b>*this</b>
+    */
+    BellhopCreator& setFanRangeStep( double step ) { fan_range_step = step; return *this; }
+
+    /**
+    * Gets the receiver range resolution of the BellhopWoss created by createFanWoss()
+    * @return range step [m]
+    */
+    double getFanRangeStep() const { return fan_range_step; }
+
     /**
     * Sets the .arr file syntax to be used during file parsing
     * @param syntax .arr file syntax
@@ -1451,6 +1554,51 @@ namespace woss {
     **/
     ::std::string bellhop_path;
     
+    /**
+    * Solver backend given to all created BellhopWoss, NULL if the default one has to be used
+    **/
+    BellhopSolver* bellhop_solver;
+    
+    /**
+    * Maximum number of Bellhop jobs executed in parallel by each BellhopWoss
+    **/
+    int concurrent_runs;
+    
+#ifdef WOSS_MULTITHREAD
+    typedef ::std::map< int, WossThreadPool* > RunPoolMap;
+    typedef RunPoolMap::iterator RPMIter;
+    
+    /**
+    * Thread pools given to the created BellhopWoss, one for each number of concurrent runs. 
+    * They are joined and deleted by the destructor, so BellhopCreator has to outlive the created BellhopWoss
+    **/
+    mutable RunPoolMap run_pools;
+    
+    mutable pthread_mutex_t run_pools_mutex;
+    
+    /**
+    * Returns the thread pool with given number of workers, creating it if needed
+    * @param threads number of worker threads (>= 1)
+    * @returns pointer to a valid WossThreadPool
+    **/
+    WossThreadPool* getRunPool( int threads ) const;
+#endif // WOSS_MULTITHREAD
+    
+    /**
+    * <i>true</i> if each BellhopWoss memory maps its SHD results files
+    **/
+    bool shd_mmap_read;
+    
+    /**
+    * Receiver depth resolution of receiver fans [m]
+    **/
+    double fan_depth_step;
+    
+    /**
+    * Receiver range resolution of receiver fans [m]
+    **/
+    double fan_range_step;
+    
     /**
      * Bellhop .arr file syntax to be used during parsing, factory value = invalid
      */
@@ -1594,6 +1742,20 @@ namespace woss {
     * @returns <i>true</i> if method succeeded, <i>false</i> otherwise
     **/
     bool initializeBhWoss( BellhopWoss* const woss_ptr ) const ;
+    
+    /**
+    * Sets all the parameters of given BellhopWoss object, without initializing it
+    * @param woss_ptr const pointer to an unitialized BellhopWoss
+    **/
+    void configureBhWoss( BellhopWoss* const woss_ptr ) const ;
+    
+    /**
+    * Returns the number of grid points needed to sample given span
+    * @param span span [m]
+    * @param step grid step [m]
+    * @returns number of grid points
+    **/
+    static int getFanTotalSteps( double span, double step ) { return ( span > 0.0 && step > 0.0 ) ? (int)::std::ceil( span / step ) + 1 : 1; }
         
 
     virtual const BellhopWoss* createNotValidWoss() const;
@@ -0,0 +1,582 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   bellhop-solver.cpp
+ * @author Federico Guerra
+ * 
+ * \brief Provides the implementation of woss::BellhopSolver derived classes
+ *
+ * Provides the implementation of woss::BellhopSystemSolver, woss::BellhopPipeSolver,
+ * woss::BellhopReplaySolver and woss::BellhopCacheSolver classes
+ */
+
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <iterator>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <ctime>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include "woss-metrics.h"
+#include "bellhop-solver.h"
+
+
+static const char* WOSS_BELLHOP_SOLVER_PROGRAM = "bellhop.exe"; /**< Bellhop program name */
+
+static const int WOSS_BELLHOP_PIPE_SOLVER_LINE_SIZE = 256; /**< Maximum length of a solver process reply */
+
+static const char* WOSS_BELLHOP_CACHE_VERSION = "woss-bellhop-cache-1"; /**< Cache key format, to be changed if the key changes */
+
+static const char* const WOSS_BELLHOP_CACHE_EXTENSIONS[] = { ".env", ".bty", ".ati", ".sbp", ".ssp" }; /**< Hashed configuration files */
+
+static const int WOSS_BELLHOP_CACHE_TOTAL_EXTENSIONS = 5; /**< Number of hashed configuration files */
+
+
+/**
+* \brief Minimal SHA-256 implementation (FIPS 180-4) used for BellhopCacheSolver keys
+*/
+class BellhopCacheHash {
+  
+  
+  public:
+  
+  
+  BellhopCacheHash() : total_length(0), buffer_size(0) {
+    static const uint32_t init_state[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    ::std::memcpy( state, init_state, sizeof(state) );
+  }
+  
+  void update( const char* data, size_t size ) {
+    for ( size_t i = 0; i < size; i++ ) {
+      buffer[buffer_size++] = (unsigned char) data[i];
+      if ( buffer_size == 64 ) {
+        transform();
+        buffer_size = 0;
+      }
+    }
+    total_length += size;
+  }
+  
+  void update( const ::std::string& data ) { update( data.data(), data.size() ); }
+  
+  ::std::string getHexDigest() {
+    uint64_t total_bits = total_length * 8;
+    
+    static const char padding = (char) 0x80;
+    update( &padding, 1 );
+    while ( buffer_size != 56 ) {
+      static const char zero = 0;
+      update( &zero, 1 );
+    }
+    for ( int i = 7; i >= 0; i-- ) {
+      char byte = (char) ( ( total_bits >> ( 8 * i ) ) & 0xff );
+      update( &byte, 1 );
+    }
+    
+    static const char* hex_digits = "0123456789abcdef";
+    ::std::string ret_val;
+    for ( int i = 0; i < 8; i++ ) {
+      for ( int j = 28; j >= 0; j -= 4 ) ret_val += hex_digits[ ( state[i] >> j ) & 0xf ];
+    }
+    return ret_val;
+  }
+  
+  
+  private:
+  
+  
+  static uint32_t rotate( uint32_t value, int bits ) { return ( value >> bits ) | ( value << ( 32 - bits ) ); }
+  
+  void transform() {
+    static const uint32_t k[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+      0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+      0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+      0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+    
+    uint32_t w[64];
+    for ( int i = 0; i < 16; i++ ) {
+      w[i] = ( (uint32_t)buffer[4 * i] << 24 ) | ( (uint32_t)buffer[4 * i + 1] << 16 ) 
+             | ( (uint32_t)buffer[4 * i + 2] << 8 ) | (uint32_t)buffer[4 * i + 3];
+    }
+    for ( int i = 16; i < 64; i++ ) {
+      uint32_t s0 = rotate( w[i - 15], 7 ) ^ rotate( w[i - 15], 18 ) ^ ( w[i - 15] >> 3 );
+      uint32_t s1 = rotate( w[i - 2], 17 ) ^ rotate( w[i - 2], 19 ) ^ ( w[i - 2] >> 10 );
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    
+    for ( int i = 0; i < 64; i++ ) {
+      uint32_t t1 = h + ( rotate( e, 6 ) ^ rotate( e, 11 ) ^ rotate( e, 25 ) ) + ( ( e & f ) ^ ( ~e & g ) ) + k[i] + w[i];
+      uint32_t t2 = ( rotate( a, 2 ) ^ rotate( a, 13 ) ^ rotate( a, 22 ) ) + ( ( a & b ) ^ ( a & c ) ^ ( b & c ) );
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+  }
+  
+  
+  uint32_t state[8];
+  
+  uint64_t total_length;
+  
+  unsigned char buffer[64];
+  
+  int buffer_size;
+  
+  
+};
+
+
+using namespace woss;
+
+
+bool BellhopSystemSolver::solve( BellhopSolverJob& job ) {
+  ::std::stringstream str_out;
+
+  if (job.debug) 
+    str_out << "cd " << job.work_path << " && " << job.bellhop_path << WOSS_BELLHOP_SOLVER_PROGRAM << " " << job.file_root << " > " << job.file_root << ".prt2";
+  else 
+    str_out << "cd " << job.work_path << " && " << job.bellhop_path << WOSS_BELLHOP_SOLVER_PROGRAM << " " << job.file_root << " > " << "/dev/null";
+
+  ::std::string command = str_out.str();
+
+  int ret_value = -1;
+  if (system(NULL)) ret_value = system(command.c_str());
+  if (ret_value != 0) return false;
+
+  job.result_file = getDefaultResultFile(job);
+  return true;
+}
+
+
+BellhopPipeSolver::BellhopPipeSolver( const ::std::string& cmd ) 
+: BellhopSolver(),
+  command(cmd),
+  child_pid(-1),
+  to_child(-1),
+  from_child(NULL)
+{
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_init(&mutex, NULL);
+#endif // WOSS_MULTITHREAD
+}
+
+
+BellhopPipeSolver::~BellhopPipeSolver() {
+  stopProcess();
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_destroy(&mutex);
+#endif // WOSS_MULTITHREAD
+}
+
+
+bool BellhopPipeSolver::startProcess() {
+  int to_pipe[2];
+  int from_pipe[2];
+
+  if ( pipe(to_pipe) != 0 ) return false;
+  if ( pipe(from_pipe) != 0 ) {
+    close(to_pipe[0]);
+    close(to_pipe[1]);
+    return false;
+  }
+
+  // pipe ends must not leak into processes started later by other threads or solvers
+  for ( int i = 0; i < 2; i++ ) {
+    fcntl(to_pipe[i], F_SETFD, FD_CLOEXEC);
+    fcntl(from_pipe[i], F_SETFD, FD_CLOEXEC);
+  }
+
+  child_pid = fork();
+
+  if ( child_pid < 0 ) {
+    close(to_pipe[0]);
+    close(to_pipe[1]);
+    close(from_pipe[0]);
+    close(from_pipe[1]);
+    return false;
+  }
+
+  if ( child_pid == 0 ) {
+    dup2(to_pipe[0], STDIN_FILENO);
+    dup2(from_pipe[1], STDOUT_FILENO);
+    close(to_pipe[0]);
+    close(to_pipe[1]);
+    close(from_pipe[0]);
+    close(from_pipe[1]);
+
+    // the solver process only keeps stdin, stdout and stderr
+    long max_fd = sysconf(_SC_OPEN_MAX);
+    if ( max_fd < 0 ) max_fd = 1024;
+    for ( int fd = STDERR_FILENO + 1; fd < max_fd; fd++ ) close(fd);
+
+    execl("/bin/sh", "sh", "-c", command.c_str(), (char*) NULL);
+    _exit(127);
+  }
+
+  close(to_pipe[0]);
+  close(from_pipe[1]);
+
+  to_child = to_pipe[1];
+  from_child = fdopen(from_pipe[0], "r");
+
+  if ( from_child == NULL ) {
+    close(from_pipe[0]);
+    stopProcess();
+    return false;
+  }
+  return true;
+}
+
+
+void BellhopPipeSolver::stopProcess() {
+  if ( to_child >= 0 ) close(to_child);
+  if ( from_child != NULL ) fclose(from_child);
+  to_child = -1;
+  from_child = NULL;
+
+  if ( child_pid > 0 ) {
+    int status;
+    waitpid(child_pid, &status, 0);
+  }
+  child_pid = -1;
+}
+
+
+::std::string BellhopPipeSolver::escapeField( const ::std::string& field ) {
+  ::std::string ret_value;
+  ret_value.reserve(field.size());
+
+  for ( size_t i = 0; i < field.size(); i++ ) {
+    if ( field[i] == '\n' ) ret_value += "\\n";
+    else {
+      if ( field[i] == '\\' || field[i] == ' ' ) ret_value += '\\';
+      ret_value += field[i];
+    }
+  }
+  return ret_value;
+}
+
+
+bool BellhopPipeSolver::writeRequest( const ::std::string& request ) {
+  sigset_t pipe_set;
+  sigset_t old_set;
+  sigset_t pending_set;
+
+  sigemptyset(&pipe_set);
+  sigaddset(&pipe_set, SIGPIPE);
+
+  // a dead solver process is reported by EPIPE instead of killing the simulation
+#ifdef WOSS_MULTITHREAD
+  pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+#else
+  sigprocmask(SIG_BLOCK, &pipe_set, &old_set);
+#endif // WOSS_MULTITHREAD
+
+  sigpending(&pending_set);
+  bool was_pending = sigismember(&pending_set, SIGPIPE);
+
+  bool ret_value = true;
+  int write_errno = 0;
+  size_t written = 0;
+
+  while ( written < request.size() ) {
+    ssize_t curr_written = write(to_child, request.data() + written, request.size() - written);
+
+    if ( curr_written < 0 ) {
+      if ( errno == EINTR ) continue;
+      write_errno = errno;
+      ret_value = false;
+      break;
+    }
+    written += curr_written;
+  }
+
+  if ( write_errno == EPIPE && !was_pending ) {
+    // consumes the SIGPIPE raised by the failed write before unblocking it
+    struct timespec no_wait = { 0, 0 };
+    sigtimedwait(&pipe_set, NULL, &no_wait);
+  }
+
+#ifdef WOSS_MULTITHREAD
+  pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+#else
+  sigprocmask(SIG_SETMASK, &old_set, NULL);
+#endif // WOSS_MULTITHREAD
+
+  return ret_value;
+}
+
+
+bool BellhopPipeSolver::solve( BellhopSolverJob& job ) {
+  bool ret_value = false;
+  bool has_reply = false;
+  char line[WOSS_BELLHOP_PIPE_SOLVER_LINE_SIZE];
+  ::std::string request = escapeField(job.work_path) + " " + escapeField(job.file_root) + "\n";
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock(&mutex);
+#endif // WOSS_MULTITHREAD
+
+  // a solver process that died is restarted once for the same job
+  for ( int attempt = 0; attempt < 2 && !has_reply; attempt++ ) {
+    if ( child_pid <= 0 && !startProcess() ) {
+      ::std::cerr << "BellhopPipeSolver::solve() ERROR, can't start solver process \"" << command << "\"" << ::std::endl;
+      break;
+    }
+
+    if ( writeRequest(request) && fgets(line, WOSS_BELLHOP_PIPE_SOLVER_LINE_SIZE, from_child) != NULL ) {
+      has_reply = true;
+      ret_value = ( atoi(line) == 0 );
+    }
+    else {
+      ::std::cerr << "BellhopPipeSolver::solve() ERROR, solver process \"" << command << "\" is not responding" << ::std::endl;
+      stopProcess();
+    }
+  }
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock(&mutex);
+#endif // WOSS_MULTITHREAD
+
+  if ( ret_value ) job.result_file = getDefaultResultFile(job);
+  return ret_value;
+}
+
+
+BellhopReplaySolver::BellhopReplaySolver( const ::std::string& path ) 
+: BellhopSolver(),
+  replay_path(path)
+{
+  if ( replay_path.size() > 0 && replay_path[replay_path.size() - 1] != '/' ) replay_path += "/";
+}
+
+
+bool BellhopReplaySolver::solve( BellhopSolverJob& job ) {
+  ::std::stringstream str_out;
+  ::std::string file_name = job.file_root + job.result_extension;
+  ::std::string candidates[4];
+
+  str_out << replay_path << "woss" << job.woss_id << "/freq" << job.frequency << "/run" << job.run << "/" << file_name;
+  candidates[0] = str_out.str();
+  str_out.str("");
+
+  str_out << replay_path << "freq" << job.frequency << "/run" << job.run << "/" << file_name;
+  candidates[1] = str_out.str();
+  str_out.str("");
+
+  str_out << replay_path << "freq" << job.frequency << "/" << file_name;
+  candidates[2] = str_out.str();
+  str_out.str("");
+
+  candidates[3] = replay_path + file_name;
+
+  for ( int i = 0; i < 4; i++ ) {
+    ::std::ifstream file_check(candidates[i].c_str(), ::std::ios::in);
+    if ( !file_check ) continue;
+
+    if (job.debug) ::std::cout << "BellhopReplaySolver::solve() woss id = " << job.woss_id << "; replaying " << candidates[i] << ::std::endl;
+
+    job.result_file = candidates[i];
+    return true;
+  }
+
+  ::std::cerr << "BellhopReplaySolver::solve() ERROR, no recorded " << file_name << " found in " << replay_path << ::std::endl;
+  return false;
+}
+
+
+BellhopCacheSolver::BellhopCacheSolver( const ::std::string& path, BellhopSolver* const ptr ) 
+: BellhopSolver(),
+  cache_path(path),
+  solver(ptr),
+  system_solver()
+{
+  if ( cache_path.size() > 0 && cache_path[cache_path.size() - 1] != '/' ) cache_path += "/";
+  
+  ::std::string command = "mkdir -p " + cache_path;
+  
+  int ret_value = -1;
+  if (system(NULL)) ret_value = system(command.c_str());
+  if (ret_value != 0) ::std::cerr << "BellhopCacheSolver::BellhopCacheSolver() ERROR, can't create cache directory " << cache_path << ::std::endl;
+}
+
+
+BellhopCacheSolver::~BellhopCacheSolver() {
+  delete solver;
+}
+
+
+::std::string BellhopCacheSolver::getCacheKey( const BellhopSolverJob& job ) {
+  BellhopCacheHash hash;
+  ::std::stringstream str_out;
+  
+  str_out << WOSS_BELLHOP_CACHE_VERSION << "\n" << job.bellhop_path << "\n" << job.result_extension << "\n";
+  hash.update( str_out.str() );
+  
+  for ( int i = 0; i < WOSS_BELLHOP_CACHE_TOTAL_EXTENSIONS; i++ ) {
+    ::std::ifstream file_in( ( job.work_path + job.file_root + WOSS_BELLHOP_CACHE_EXTENSIONS[i] ).c_str(), ::std::ios::in | ::std::ios::binary );
+    
+    str_out.str("");
+    str_out << WOSS_BELLHOP_CACHE_EXTENSIONS[i] << "\n";
+    
+    if ( !file_in ) {
+      str_out << "-\n";
+      hash.update( str_out.str() );
+      continue;
+    }
+    
+    ::std::string content( ( ::std::istreambuf_iterator< char >( file_in ) ), ::std::istreambuf_iterator< char >() );
+    
+    // the title holds the id of the BellhopWoss, it doesn't change the result
+    if ( i == 0 ) {
+      ::std::string::size_type title_end = content.find( '\n' );
+      content.erase( 0, ( title_end == ::std::string::npos ) ? content.size() : title_end + 1 );
+    }
+    
+    str_out << content.size() << "\n";
+    hash.update( str_out.str() );
+    hash.update( content );
+  }
+  return hash.getHexDigest();
+}
+
+
+bool BellhopCacheSolver::storeFile( const ::std::string& src_file, const ::std::string& dest_file ) {
+  ::std::stringstream str_out;
+  str_out << dest_file << ".tmp" << getpid();
+  ::std::string temp_file = str_out.str();
+  
+  {
+    ::std::ifstream file_in( src_file.c_str(), ::std::ios::in | ::std::ios::binary );
+    ::std::ofstream file_out( temp_file.c_str(), ::std::ios::out | ::std::ios::binary | ::std::ios::trunc );
+    
+    if ( !file_in || !file_out ) return false;
+    
+    file_out << file_in.rdbuf();
+    file_out.close();
+    
+    if ( !file_out ) {
+      unlink( temp_file.c_str() );
+      return false;
+    }
+  }
+  
+  // readers never see a partially written file
+  if ( rename( temp_file.c_str(), dest_file.c_str() ) != 0 ) {
+    unlink( temp_file.c_str() );
+    return false;
+  }
+  return true;
+}
+
+
+bool BellhopCacheSolver::solve( BellhopSolverJob& job ) {
+  ::std::string key = getCacheKey( job );
+  ::std::string dir_path = cache_path + key.substr( 0, 2 ) + "/";
+  ::std::string cached_file = dir_path + key + job.result_extension;
+  
+  if ( access( cached_file.c_str(), R_OK ) == 0 ) {
+    
+    if (job.debug) ::std::cout << "BellhopCacheSolver::solve() woss id = " << job.woss_id << "; cache hit " << cached_file << ::std::endl;
+    
+    WossMetrics::addCount( WOSS_METRICS_SOLVER_CACHE_HITS );
+    job.result_file = cached_file;
+    return true;
+  }
+  
+  if ( mkdir( dir_path.c_str(), 0777 ) != 0 && errno != EEXIST ) {
+    ::std::cerr << "BellhopCacheSolver::solve() ERROR, can't create cache directory " << dir_path << ::std::endl;
+    
+    WossMetrics::addCount( WOSS_METRICS_SOLVER_CACHE_MISSES );
+    return ( solver != NULL ? solver : &system_solver )->solve( job );
+  }
+  
+  // flock() locks belong to the open file description, so they exclude both threads and processes
+  ::std::string lock_file = dir_path + key + ".lock";
+  int lock_fd = open( lock_file.c_str(), O_RDWR | O_CREAT, 0666 );
+  
+  if ( lock_fd >= 0 ) {
+    while ( flock( lock_fd, LOCK_EX ) != 0 && errno == EINTR ) { }
+  }
+  
+  bool ret_value = false;
+  
+  // another thread or process may have computed it while waiting for the lock
+  if ( access( cached_file.c_str(), R_OK ) == 0 ) {
+    
+    if (job.debug) ::std::cout << "BellhopCacheSolver::solve() woss id = " << job.woss_id << "; cache hit after wait " << cached_file << ::std::endl;
+    
+    WossMetrics::addCount( WOSS_METRICS_SOLVER_CACHE_HITS );
+    job.result_file = cached_file;
+    ret_value = true;
+  }
+  else {
+    
+    if (job.debug) ::std::cout << "BellhopCacheSolver::solve() woss id = " << job.woss_id << "; cache miss " << cached_file << ::std::endl;
+    
+    WossMetrics::addCount( WOSS_METRICS_SOLVER_CACHE_MISSES );
+    ret_value = ( solver != NULL ? solver : &system_solver )->solve( job );
+    
+    if ( ret_value && !storeFile( job.result_file, cached_file ) ) 
+      ::std::cerr << "BellhopCacheSolver::solve() WARNING, can't store " << job.result_file << " into " << cached_file << ::std::endl;
+  }
+  
+  if ( lock_fd >= 0 ) {
+    flock( lock_fd, LOCK_UN );
+    close( lock_fd );
+  }
+  return ret_value;
+}
+
@@ -0,0 +1,442 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   bellhop-solver.h
+ * @author Federico Guerra
+ * 
+ * \brief Provides the interface for woss::BellhopSolver and derived classes
+ *
+ * Provides the interface for woss::BellhopSolver, woss::BellhopSystemSolver, woss::BellhopPipeSolver,
+ * woss::BellhopReplaySolver and woss::BellhopCacheSolver classes
+ */
+
+
+#ifndef WOSS_BELLHOP_SOLVER_DEFINITIONS_H
+#define WOSS_BELLHOP_SOLVER_DEFINITIONS_H
+
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <cstdio>
+#ifdef WOSS_MULTITHREAD
+#include <pthread.h>
+#endif // WOSS_MULTITHREAD
+
+
+namespace woss {
+  
+  
+  /**
+  * \brief Description of a single Bellhop computation
+  *
+  * BellhopSolverJob stores everything a BellhopSolver needs to perform a single Bellhop run 
+  * (one frequency, one run index) of a BellhopWoss instance. The configuration files have already
+  * been written in work_path. The solver writes back in result_file the pathname of the output file 
+  * to be parsed by the woss::ResReader.
+  */
+  struct BellhopSolverJob {
+    
+    
+    /**
+    * BellhopSolverJob default constructor
+    */
+    BellhopSolverJob() : woss_id(0), frequency(0.0), run(0), debug(false), bellhop_path(), work_path(), 
+                         file_root(), result_extension(), result_file(), elapsed_time(0.0) { }
+    
+    
+    /**
+    * Id of the BellhopWoss that submitted the job
+    */
+    int woss_id;
+    
+    /**
+    * Frequency of the run [Hz]
+    */
+    double frequency;
+    
+    /**
+    * Run index
+    */
+    int run;
+    
+    /**
+    * Debug flag
+    */
+    bool debug;
+    
+    /**
+    * Filesystem path of Bellhop program, either empty or terminated by "/"
+    */
+    ::std::string bellhop_path;
+    
+    /**
+    * Path of the directory that holds the configuration files, terminated by "/"
+    */
+    ::std::string work_path;
+    
+    /**
+    * Configuration files root name (e.g. "bellhop" for "bellhop.env")
+    */
+    ::std::string file_root;
+    
+    /**
+    * Extension of the expected result file (".arr" or ".shd")
+    */
+    ::std::string result_extension;
+    
+    /**
+    * Pathname of the result file. It is set by the BellhopSolver
+    */
+    ::std::string result_file;
+    
+    /**
+    * Wall clock time spent by the BellhopSolver [s]
+    */
+    double elapsed_time;
+    
+    
+  };
+  
+  typedef ::std::vector< BellhopSolverJob > BellhopSolverJobVector;
+  typedef BellhopSolverJobVector::iterator BSJVIter;
+  typedef BellhopSolverJobVector::const_iterator BSJVCIter;
+  
+  
+  /**
+  * \brief Abstract Bellhop solver backend
+  *
+  * BellhopSolver is the extension point used by BellhopWoss::run() to actually compute 
+  * a channel. Different backends can spawn the Bellhop program, talk to a persistent solver process 
+  * or replay recorded results. A single instance can be shared by many BellhopWoss objects, 
+  * so derived classes have to be thread safe if WOSS_MULTITHREAD is defined.
+  */
+  class BellhopSolver {
+    
+    
+    public:
+    
+    
+    BellhopSolver() { }
+    
+    virtual ~BellhopSolver() { }
+    
+    
+    /**
+    * Performs a Bellhop computation
+    * @param job job description, job.result_file is set on success
+    * @return <i>true</i> if the computation succeeded, <i>false</i> otherwise
+    */
+    virtual bool solve( BellhopSolverJob& job ) = 0;
+    
+    
+    protected:
+    
+    
+    /**
+    * Returns the default result pathname of given job
+    * @param job job description
+    * @return result pathname
+    */
+    static ::std::string getDefaultResultFile( const BellhopSolverJob& job ) {
+      return job.work_path + job.file_root + job.result_extension; }
+    
+    
+  };
+  
+  
+  /**
+  * \brief Bellhop solver backend that spawns the Bellhop program through the shell
+  *
+  * BellhopSystemSolver implements the historical behaviour: a shell is started through system() 
+  * for every run and it executes <i>bellhop.exe</i> inside the job work directory.
+  */
+  class BellhopSystemSolver : public BellhopSolver {
+    
+    
+    public:
+    
+    
+    BellhopSystemSolver() : BellhopSolver() { }
+    
+    virtual ~BellhopSystemSolver() { }
+    
+    
+    virtual bool solve( BellhopSolverJob& job );
+    
+    
+  };
+  
+  
+  /**
+  * \brief Bellhop solver backend that talks to a persistent solver process through pipes
+  *
+  * BellhopPipeSolver starts the given command once, at first use, and keeps it alive until destruction. 
+  * For every job a line with the job work directory and the configuration files root name,
+  * separated by a single space, is written on the standard input of the process. Backslashes and spaces 
+  * inside the two fields are preceded by a backslash, newlines are written as a backslash followed by 'n'.
+  * The process has to answer with a single line holding an integer status: 0 on success.
+  * Jobs are serialized: a single request is outstanding at any time. 
+  * If the process dies, the request fails with EPIPE instead of raising SIGPIPE, and the process is 
+  * restarted once for the same job.
+  */
+  class BellhopPipeSolver : public BellhopSolver {
+    
+    
+    public:
+    
+    
+    /**
+    * BellhopPipeSolver constructor
+    * @param command shell command that starts the solver process
+    */
+    BellhopPipeSolver( const ::std::string& command );
+    
+    virtual ~BellhopPipeSolver();
+    
+    
+    virtual bool solve( BellhopSolverJob& job );
+    
+    
+    /**
+    * Gets the solver process command
+    * @return command string
+    */
+    const ::std::string& getCommand() const { return command; }
+    
+    
+    protected:
+    
+    
+    /**
+    * Starts the solver process
+    * @return <i>true</i> if the process has been started, <i>false</i> otherwise
+    */
+    bool startProcess();
+    
+    /**
+    * Closes the pipes and waits for the solver process termination
+    */
+    void stopProcess();
+    
+    /**
+    * Writes a request on the standard input of the solver process. SIGPIPE is blocked during the write
+    * @param request const reference to the request line
+    * @return <i>true</i> if the whole request has been written, <i>false</i> otherwise
+    */
+    bool writeRequest( const ::std::string& request );
+    
+    /**
+    * Escapes backslashes, spaces and newlines of a request field
+    * @param field const reference to the field
+    * @return escaped field
+    */
+    static ::std::string escapeField( const ::std::string& field );
+    
+    
+    /**
+    * Shell command that starts the solver process
+    */
+    ::std::string command;
+    
+    /**
+    * PID of the solver process, -1 if not running
+    */
+    pid_t child_pid;
+    
+    /**
+    * File descriptor connected to the standard input of the solver process, -1 if not running
+    */
+    int to_child;
+    
+    /**
+    * Stream connected to the standard output of the solver process
+    */
+    FILE* from_child;
+    
+    
+#ifdef WOSS_MULTITHREAD
+    /**
+    * Mutex that serializes the requests
+    */
+    pthread_mutex_t mutex;
+#endif // WOSS_MULTITHREAD
+    
+    
+    private:
+    
+    
+    BellhopPipeSolver( const BellhopPipeSolver& copy );
+    
+    BellhopPipeSolver& operator=( const BellhopPipeSolver& copy );
+    
+    
+  };
+  
+  
+  /**
+  * \brief Bellhop solver backend that replays recorded results
+  *
+  * BellhopReplaySolver doesn't run any solver. It points the woss::ResReader to a previously recorded 
+  * .arr or .shd file, so that the simulator can be tested without Bellhop installed. 
+  * Given the replay directory <i>dir</i>, the first existing file among
+  * <ul>
+  * <li><i>dir</i>/woss&lt;id&gt;/freq&lt;frequency&gt;/run&lt;run&gt;/bellhop&lt;ext&gt;
+  * <li><i>dir</i>/freq&lt;frequency&gt;/run&lt;run&gt;/bellhop&lt;ext&gt;
+  * <li><i>dir</i>/freq&lt;frequency&gt;/bellhop&lt;ext&gt;
+  * <li><i>dir</i>/bellhop&lt;ext&gt;
+  * </ul>
+  * is used.
+  */
+  class BellhopReplaySolver : public BellhopSolver {
+    
+    
+    public:
+    
+    
+    /**
+    * BellhopReplaySolver constructor
+    * @param path directory of recorded results
+    */
+    BellhopReplaySolver( const ::std::string& path );
+    
+    virtual ~BellhopReplaySolver() { }
+    
+    
+    virtual bool solve( BellhopSolverJob& job );
+    
+    
+    /**
+    * Gets the directory of recorded results
+    * @return path string, terminated by "/"
+    */
+    const ::std::string& getReplayPath() const { return replay_path; }
+    
+    
+    protected:
+    
+    
+    /**
+    * Directory of recorded results, terminated by "/"
+    */
+    ::std::string replay_path;
+    
+    
+  };
+  
+  
+  /**
+  * \brief Bellhop solver backend that reuses the results of identical environments
+  *
+  * BellhopCacheSolver wraps another BellhopSolver. Every job is keyed by the SHA-256 hash of its configuration 
+  * files (.env without its title line, .bty, .ati, .sbp, .ssp) and of the solver options (Bellhop path and result extension). 
+  * Results are stored in <i>dir</i>/&lt;2 hex digits&gt;/&lt;hash&gt;&lt;ext&gt;, so the cache directory can be shared 
+  * by all BellhopWoss objects of all processes of a parameter sweep. 
+  * Each key is guarded by a flock() lock file: a single process or thread computes a missing result,
+  * while the others wait for it and reuse it. Cache hits and misses are reported by WossMetrics.
+  */
+  class BellhopCacheSolver : public BellhopSolver {
+    
+    
+    public:
+    
+    
+    /**
+    * BellhopCacheSolver constructor
+    * @param path cache directory, it is created if missing
+    * @param solver pointer to a dynamically allocated BellhopSolver that computes the missing results, 
+    * NULL for a BellhopSystemSolver. BellhopCacheSolver takes its ownership
+    */
+    BellhopCacheSolver( const ::std::string& path, BellhopSolver* const solver = NULL );
+    
+    virtual ~BellhopCacheSolver();
+    
+    
+    virtual bool solve( BellhopSolverJob& job );
+    
+    
+    /**
+    * Gets the cache directory
+    * @return path string, terminated by "/"
+    */
+    const ::std::string& getCachePath() const { return cache_path; }
+    
+    /**
+    * Returns the cache key of given job
+    * @param job job description, whose configuration files have been written
+    * @return hex string of the SHA-256 hash
+    */
+    static ::std::string getCacheKey( const BellhopSolverJob& job );
+    
+    
+    protected:
+    
+    
+    /**
+    * Cache directory, terminated by "/"
+    */
+    ::std::string cache_path;
+    
+    /**
+    * Solver that computes the missing results
+    */
+    BellhopSolver* solver;
+    
+    /**
+    * Solver used if none is given
+    */
+    BellhopSystemSolver system_solver;
+    
+    
+    /**
+    * Copies a result file into the cache, through a temporary file renamed in place
+    * @param src_file pathname of the result file
+    * @param dest_file pathname of the cached file
+    * @return <i>true</i> if the file has been stored, <i>false</i> otherwise
+    */
+    static bool storeFile( const ::std::string& src_file, const ::std::string& dest_file );
+    
+    
+    private:
+    
+    
+    BellhopCacheSolver( const BellhopCacheSolver& copy );
+    
+    BellhopCacheSolver& operator=( const BellhopCacheSolver& copy );
+    
+    
+  };
+  
+  
+}
+
+
+#endif /* WOSS_BELLHOP_SOLVER_DEFINITIONS_H */
+
@@ -38,14 +38,16 @@
 
 
 #include <cstdlib>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/time.h>
 #include <altimetry-definitions.h>
+#include "woss-metrics.h"
 #include "bellhop-woss.h"
 
 
 #define BELLHOP_NOT_SET (-3000)
 
-static const char* WOSS_BELLHOP_PROGRAM = "bellhop.exe"; /**< Bellhop program name */
-
 static const char* WOSS_BELLHOP_NAME = "bellhop";  /**< Bellhop configuration file name */
 
 static const char* WOSS_BELLHOP_ATI = ".ati"; /**< Bellhop altimetry file extension */
@@ -76,6 +78,10 @@ static const double BELLHOP_QUAD_SSP_RANGE_FACTOR = 1.05; /**< Bellhop range fac
 using namespace woss;
 
 
+BellhopSystemSolver BellhopWoss::default_bellhop_solver;
+
+
+
 BellhopWoss::BellhopWoss() 
 : use_thorpe_att(true),
   beam_options(),
@@ -87,14 +93,20 @@ BellhopWoss::BellhopWoss()
   bathymetry_file(),
   altimetry_file(),
   beam_pattern_file(),
+  beam_pattern_buffer(),
   ssp_file(),
   shd_file(),
   arr_file(),
   bellhop_path(""),
+  bellhop_solver(NULL),
+  concurrent_runs(1),
+  shd_mmap_read(false),
+  run_jobs(),
   curr_path(),
   tx_min_depth_offset(0.0),
   tx_max_depth_offset(0.0),
   total_transmitters(BELLHOP_NOT_SET),
+  tx_depths(),
   total_rx_depths(BELLHOP_NOT_SET),
   rx_min_depth_offset(0.0),
   rx_max_depth_offset(0.0),
@@ -123,7 +135,10 @@ BellhopWoss::BellhopWoss()
   box_range(BELLHOP_NOT_SET),
   f_out()
 {
-
+#ifdef WOSS_MULTITHREAD
+  run_pool = NULL;
+  is_run_pool_owned = false;
+#endif // WOSS_MULTITHREAD
 }
 
 
@@ -138,14 +153,20 @@ BellhopWoss::BellhopWoss(const CoordZ& tx, const CoordZ& rx, const Time& start_t
   bathymetry_file(),
   altimetry_file(),
   beam_pattern_file(),
+  beam_pattern_buffer(),
   ssp_file(),
   shd_file(),
   arr_file(),
   bellhop_path(""),
+  bellhop_solver(NULL),
+  concurrent_runs(1),
+  shd_mmap_read(false),
+  run_jobs(),
   curr_path(),
   tx_min_depth_offset(0.0),
   tx_max_depth_offset(0.0),
   total_transmitters(BELLHOP_NOT_SET),
+  tx_depths(),
   total_rx_depths(BELLHOP_NOT_SET),
   rx_min_depth_offset(0.0),
   rx_max_depth_offset(0.0),
@@ -174,7 +195,10 @@ BellhopWoss::BellhopWoss(const CoordZ& tx, const CoordZ& rx, const Time& start_t
   box_range(BELLHOP_NOT_SET),
   f_out()
 {
-
+#ifdef WOSS_MULTITHREAD
+  run_pool = NULL;
+  is_run_pool_owned = false;
+#endif // WOSS_MULTITHREAD
 }
 
 
@@ -187,6 +211,11 @@ BellhopWoss::~BellhopWoss() {
     delete it->second;
     it->second = NULL;
   }
+#ifdef WOSS_MULTITHREAD
+  // it waits for the queued jobs and joins its workers
+  if ( is_run_pool_owned ) delete run_pool;
+  run_pool = NULL;
+#endif // WOSS_MULTITHREAD
 }
 
 
@@ -197,6 +226,13 @@ bool BellhopWoss::isValid() const {
 }
 
 
+bool BellhopWoss::isRxDepthCovered( double rx_depth ) const {
+  if ( total_rx_depths <= 1 ) return( Woss::isRxDepthCovered( rx_depth ) );
+  
+  return( rx_depth >= rx_coordz.getDepth() + rx_min_depth_offset && rx_depth <= rx_coordz.getDepth() + rx_max_depth_offset );
+}
+
+
 BellhopWoss& BellhopWoss::setBhMode( const ::std::string& mode ) {
   if (isValidBhMode(mode) == true) {
     bellhop_op_mode = mode;
@@ -418,6 +454,15 @@ void BellhopWoss::writeNormalizedSSP( int curr_run ) {
 }
 
 
+BellhopWoss& BellhopWoss::setTxDepths( const DepthVector& depths ) {
+  tx_depths = depths;
+  ::std::sort( tx_depths.begin(), tx_depths.end() );
+
+  if ( !tx_depths.empty() ) total_transmitters = tx_depths.size();
+  return *this;
+}
+
+
 void BellhopWoss::checkBoundaries( double& frequency, double& tx_depth, double& rx_start_depth, double& rx_start_range, double& rx_end_depth, double& rx_end_range ) const {
   if ( frequency <= *(frequencies.begin()) ) 
     frequency = *(frequencies.begin());
@@ -429,7 +474,7 @@ void BellhopWoss::checkBoundaries( double& frequency, double& tx_depth, double&
     tx_depth = tx_coordz.getDepth() + tx_min_depth_offset;
   
   if (tx_depth >= tx_coordz.getDepth() + tx_max_depth_offset) 
-    tx_depth = tx_coordz.getDepth() + tx_min_depth_offset; 
+    tx_depth = tx_coordz.getDepth() + tx_max_depth_offset; 
   
   if (rx_start_depth <= rx_coordz.getDepth() + rx_min_depth_offset) 
     rx_start_depth = rx_coordz.getDepth() + rx_min_depth_offset;
@@ -798,10 +843,16 @@ void BellhopWoss::writeBathymetryFile() {
 
 
 void BellhopWoss::writeBeamPatternFile() {
+  if ( beam_pattern_buffer.empty() ) {
+    ::std::stringstream beam_stream;
+    beam_stream.precision(WOSS_DECIMAL_PRECISION);
+    transducer->writeVertBeamPattern( beam_stream, tx_coordz, rx_coordz, bp_initial_bearing, bp_vertical_rotation, bp_horizontal_rotation, bp_mult_costant, bp_add_costant );
+    beam_pattern_buffer = beam_stream.str();
+  }
+  
   ::std::ofstream beam_out ( beam_pattern_file.c_str() );
   assert ( beam_out.is_open() );
-  beam_out.precision(WOSS_DECIMAL_PRECISION);
-  transducer->writeVertBeamPattern( beam_out, tx_coordz, rx_coordz, bp_initial_bearing, bp_vertical_rotation, bp_horizontal_rotation, bp_mult_costant, bp_add_costant );
+  beam_out << beam_pattern_buffer;
   beam_out.close();
 }
 
@@ -886,6 +937,15 @@ bool BellhopWoss::initialize() {
 
   assert( isValid() && is_valid );
 
+  beam_pattern_buffer.clear();
+  
+  initCfgValues();
+  
+  return ( is_valid && true );
+}
+
+
+void BellhopWoss::initCfgValues() {
   resetNormalizedDbSSP();
   normalizeDbSSP();
 
@@ -898,8 +958,6 @@ bool BellhopWoss::initialize() {
   initBox( ::std::min(max_bathymetry_depth, max_normalized_ssp_depth), ::std::max(total_great_circle_distance,total_distance) + rx_max_range_offset );
   
   writeAllCfgFiles();
-  
-  return ( is_valid && true );
 }
 
 
@@ -946,56 +1004,154 @@ bool BellhopWoss::initTimeArrResReader( double curr_frequency ) {
 
 
 bool BellhopWoss::run() { 
+  WossMetricsTimer timer( WOSS_METRICS_WOSS_RUN );
+  
   is_running = true;
   
   assert((bellhop_arr_syntax != BELLHOP_CREATOR_ARR_FILE_INVALID) && (bellhop_shd_syntax != BELLHOP_CREATOR_SHD_FILE_INVALID));
 
-  ::std::stringstream str_out;
+  BellhopSolverJob job;
+  job.woss_id = woss_id;
+  job.debug = debug;
+  job.bellhop_path = bellhop_path;
+  job.file_root = WOSS_BELLHOP_NAME;
+  job.result_extension = using_time_arrival_mode ? WOSS_BELLHOP_ARR : WOSS_BELLHOP_SHD;
+  
+  run_jobs.clear();
   
   for ( FreqSIt it = frequencies.begin(); it != frequencies.end(); it++ ) {
-    double curr_frequency = *it;
-    
     for (int i = 0; i < total_runs; i++ ) {
+      job.frequency = *it;
+      job.run = i;
+      job.work_path = getCfgPath( *it, i );
+      run_jobs.push_back( job );
+    }
+  }
+  
+  if ( !solveRunJobs() ) {
+    ::std::cerr << "BellhopWoss(" << woss_id << ")::run() error! bellhop.exe aborted!" << ::std::endl;
 
-      if (debug) 
-        ::std::cout << "BellhopWoss(" << woss_id << ")::run() frequency = " << curr_frequency << "; run = " << i << ::std::endl;
-    
-      initCfgFiles( curr_frequency, i );
-      
-      if (debug) 
-        str_out << "cd " << curr_path << " && " << bellhop_path << WOSS_BELLHOP_PROGRAM << " " << WOSS_BELLHOP_NAME << " > " << WOSS_BELLHOP_NAME << ".prt2";
-      else 
-        str_out <<"cd " << curr_path << " && " << bellhop_path << WOSS_BELLHOP_PROGRAM << " " << WOSS_BELLHOP_NAME << " > " << "/dev/null";
+    is_running = false;
+    return false;
+  }
 
-      ::std::string command = str_out.str();
-      str_out.str("");
-      
-      int ret_value = -1;
-      if (system(NULL)) ret_value = system(command.c_str());
-      if (ret_value != 0) {
-        ::std::cerr << "BellhopWoss(" << woss_id << ")::run() error! bellhop.exe aborted!" << ::std::endl;
+  // results are parsed in frequency and run order, so that res_reader_map is always built the same way
+  for ( BSJVIter it = run_jobs.begin(); it != run_jobs.end(); it++ ) {
 
-        is_running = false;
-        return false;
-      }
-      bool is_ok = initResReader( curr_frequency ); 
-      assert(is_ok);
-    }
+    if (debug) 
+      ::std::cout << "BellhopWoss(" << woss_id << ")::run() frequency = " << it->frequency << "; run = " << it->run 
+                  << "; elapsed time = " << it->elapsed_time << " s" << ::std::endl;
+    
+    initCfgFiles( it->frequency, it->run );
+    
+    if ( using_time_arrival_mode ) arr_file = it->result_file;
+    else shd_file = it->result_file;
+    
+    bool is_ok = initResReader( it->frequency ); 
+    assert(is_ok);
   }
   is_running = false;
+  is_run_needed = false;
   if (!has_run_once) has_run_once = true;
   return true;
 }
 
 
-void BellhopWoss::initCfgFiles( double curr_frequency, int curr_run ) {
+bool BellhopWoss::solveJob( BellhopSolver* const solver, BellhopSolverJob& job ) {
+  struct timeval start_tv;
+  struct timeval end_tv;
+  
+  gettimeofday(&start_tv, NULL);
+  bool ret_value;
+  {
+    WossMetricsTimer timer( WOSS_METRICS_SOLVER_RUN );
+    ret_value = solver->solve( job );
+  }
+  gettimeofday(&end_tv, NULL);
+  
+  if ( !ret_value ) WossMetrics::addCount( WOSS_METRICS_SOLVER_FAILURES );
+  
+  job.elapsed_time = (double)(end_tv.tv_sec - start_tv.tv_sec) + (double)(end_tv.tv_usec - start_tv.tv_usec) / 1.0e6;
+  return ret_value;
+}
+
+
+int BellhopWoss::getTotalRunThreads() const {
+  if ( concurrent_runs == 0 ) return sysconf(_SC_NPROCESSORS_ONLN);
+  return concurrent_runs;
+}
+
+
+#ifdef WOSS_MULTITHREAD
+BellhopWoss& BellhopWoss::setRunPool( WossThreadPool* const pool ) {
+  if ( is_run_pool_owned ) delete run_pool;
+  
+  run_pool = pool;
+  is_run_pool_owned = false;
+  return *this;
+}
+
+
+WossThreadPool* BellhopWoss::getRunPool( int threads ) {
+  if ( run_pool == NULL ) {
+    run_pool = new WossThreadPool( threads );
+    is_run_pool_owned = true;
+  }
+  return run_pool;
+}
+#endif // WOSS_MULTITHREAD
+
+
+bool BellhopWoss::solveRunJobs() {
+  BellhopSolver* solver = getBellhopSolver();
+  
+#ifdef WOSS_MULTITHREAD
+  int total_threads = getTotalRunThreads();
+  
+  if ( total_threads > 1 && run_jobs.size() > 1 ) {
+    if (debug) 
+      ::std::cout << "BellhopWoss(" << woss_id << ")::solveRunJobs() total jobs = " << run_jobs.size() 
+                  << "; concurrent runs = " << total_threads << ::std::endl;
+    
+    ::std::vector< SolverTask* > tasks;
+    tasks.reserve( run_jobs.size() );
+    
+    WossThreadPool* const thread_pool = getRunPool( total_threads );
+    
+    for ( BSJVIter it = run_jobs.begin(); it != run_jobs.end(); it++ ) {
+      tasks.push_back( new SolverTask( solver, *it ) );
+      thread_pool->submit( tasks.back() );
+    }
+    
+    bool ret_value = true;
+    for ( ::std::vector< SolverTask* >::iterator it = tasks.begin(); it != tasks.end(); it++ ) {
+      (*it)->wait();
+      ret_value = ret_value && (*it)->result;
+      delete *it;
+    }
+    return ret_value;
+  }
+#endif // WOSS_MULTITHREAD
+  
+  for ( BSJVIter it = run_jobs.begin(); it != run_jobs.end(); it++ ) {
+    if ( !solveJob( solver, *it ) ) return false;
+  }
+  return true;
+}
+
+
+::std::string BellhopWoss::getCfgPath( double curr_frequency, int curr_run ) const {
   ::std::stringstream str_out;
 
   str_out << work_dir_path << "woss" << woss_id 
           << "/freq" << curr_frequency << "/time" << (time_t)current_time << "/run" << curr_run << "/";
           
-  curr_path = str_out.str();
-  str_out.str("");
+  return str_out.str();
+}
+
+
+void BellhopWoss::initCfgFiles( double curr_frequency, int curr_run ) {
+  curr_path = getCfgPath( curr_frequency, curr_run );
   
   bellhop_env_file = curr_path + WOSS_BELLHOP_NAME + WOSS_BELLHOP_ENV;
   bathymetry_file = curr_path + WOSS_BELLHOP_NAME + WOSS_BELLHOP_BTY;
@@ -1009,6 +1165,7 @@ void BellhopWoss::initCfgFiles( double curr_frequency, int curr_run ) {
 
 
 void BellhopWoss::writeCfgFiles( double curr_frequency, int curr_run ) {
+  WossMetricsTimer timer( WOSS_METRICS_WRITE_CFG );
   
   bool is_ok = mkWorkDir( curr_frequency, curr_run );
   assert(is_ok);
@@ -1074,6 +1231,8 @@ void BellhopWoss::removeCfgFiles( double curr_frequency, int curr_run ) {
 bool BellhopWoss::initResReader( double curr_frequency )  {
   assert( !(using_press_mode == false && using_time_arrival_mode == false) );
   
+  WossMetricsTimer timer( WOSS_METRICS_RES_READ );
+  
   if ( using_press_mode ) return( initPressResReader(curr_frequency) && res_reader_map[curr_frequency]->initialize() );
   if ( using_time_arrival_mode ) return( initTimeArrResReader(curr_frequency) && res_reader_map[curr_frequency]->initialize() );
   return false;
@@ -1124,8 +1283,8 @@ TimeArr* BellhopWoss::getTimeArr( double frequency, double tx_depth, double rx_d
 
 bool BellhopWoss::timeEvolve( const Time& time_value ) {
   if ( evolution_time_quantum < 0.0 ) {
-    if (!has_run_once) return true;
-    else return false;
+    is_run_needed = !has_run_once;
+    return true;
   }
   
   if ( !time_value.isValid() )
@@ -1142,10 +1301,8 @@ bool BellhopWoss::timeEvolve( const Time& time_value ) {
                  << t_value << "; evolution_time_quantum = " << evolution_time_quantum << ::std::endl;
   
   if ( t_value == current_time ) {
-    if ( !has_run_once )
-      return true;
-    else 
-      return false;
+    is_run_needed = !has_run_once;
+    return true;
   }
   
   double time_difference = ::std::abs(current_time - t_value);
@@ -1160,19 +1317,36 @@ bool BellhopWoss::timeEvolve( const Time& time_value ) {
    
     current_time = t_value; 
     //removeAllCfgFiles();
-    initialize();
     
-    if ( altimetry_value != NULL && altimetry_value->isValid() ) {
-      Altimetry* new_value = altimetry_value->timeEvolve( time_value );
-      delete altimetry_value;
-      altimetry_value = NULL;
-      altimetry_value = new_value;
+    if ( !is_transect_initialized ) {
+      initialize();
+    
+      if ( altimetry_value != NULL && altimetry_value->isValid() ) {
+        Altimetry* new_value = altimetry_value->timeEvolve( time_value );
+        delete altimetry_value;
+        altimetry_value = NULL;
+        altimetry_value = new_value;
+      }
+      is_run_needed = true;
+      return true;
+    }
+    
+    // transect, bathymetry, sediments and beam pattern don't depend on time
+    bool has_changed = updateTimeVariantValues( time_value );
+    
+    if ( !has_changed && has_run_once && total_runs == 1 ) {
+      if ( debug ) 
+        ::std::cout << "BellhopWoss(" << woss_id << ")::timeEvolve() SSP and altimetry unchanged, skipping run" << ::std::endl; 
+      
+      is_run_needed = false;
+      return true;
     }
+    
+    initCfgValues();
+    is_run_needed = true;
     return true;
   } 
   
-  if ( !has_run_once )
-    return true;
-  else 
-    return false;
+  is_run_needed = !has_run_once;
+  return true;
 }
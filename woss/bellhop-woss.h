@@ -41,6 +41,9 @@
 
 
 #include <iomanip>
+#include <vector>
+#include <map>
+#include <algorithm>
 #include <definitions.h>
 #include <sediment-definitions.h>
 #include <transducer-definitions.h>
@@ -48,6 +51,8 @@
 #include "ac-toolbox-arr-bin-reader.h"
 #include "ac-toolbox-shd-reader.h"
 #include "ac-toolbox-woss.h"
+#include "bellhop-solver.h"
+#include "woss-thread-pool.h"
 
 
 namespace woss {
@@ -59,6 +64,11 @@ namespace woss {
   typedef NormSSPMap::reverse_iterator NSMRIter;
   typedef NormSSPMap::const_reverse_iterator NSMCRIter;
 
+  /**
+  * Vector of depth values [m]
+  **/
+  typedef ::std::vector< double > DepthVector;
+
   /*
    * .arr file syntax to be used during parsing
    */
@@ -160,6 +170,13 @@ namespace woss {
   
     virtual TimeArr* getTimeArr( double frequency, double tx_depth, double rx_depth, double rx_range ) const;
 
+    /**
+    * Checks if given receiver depth lies between the minimum and maximum receiver depth offsets
+    * @param rx_depth receiver depth [m]
+    * @return <i>true</i> if the depth is covered, <i>false</i> otherwise
+    **/
+    virtual bool isRxDepthCovered( double rx_depth ) const;
+
      /**
      * Sets the thorpe attenuation flag
      * @param flag boolean flag
@@ -188,6 +205,14 @@ namespace woss {
     */
     BellhopWoss& setTotalTransmitters( int sources ) { total_transmitters = sources; return *this; }
 
+    /**
+    * Sets an explicit list of source depths, used instead of the linear span between the transmitter
+    * depth offsets. Depths are sorted and the number of transmitters is updated accordingly
+    * @param depths vector of absolute source depths [m]
+    * @return reference to <b>*this</b>
+    */
+    BellhopWoss& setTxDepths( const DepthVector& depths );
+
     /**
     * Sets the receiver mimimum depth offset [m]
     * @param offset 0 <= depth offset <= 0 [m]
@@ -272,6 +297,39 @@ namespace woss {
     */
     BellhopWoss& setBellhopPath( const ::std::string& path ) { bellhop_path = path; return *this; }
 
+    /**
+    * Sets the solver backend used by run(). The object is not owned by BellhopWoss
+    * @param solver pointer to a BellhopSolver, NULL restores the default BellhopSystemSolver
+    * @return reference to <b>*this</b>
+    */
+    BellhopWoss& setBellhopSolver( BellhopSolver* const solver ) { bellhop_solver = solver; return *this; }
+
+    /**
+    * Sets the maximum number of Bellhop jobs (frequency, run) that run() executes in parallel. 
+    * Jobs are executed by the thread pool given by setRunPool(), or else by a private one.
+    * It is effective only if WOSS_MULTITHREAD is defined.
+    * @param runs 0 = number of available cpu cores, 1 or negative = serial execution
+    * @return reference to <b>*this</b>
+    */
+    BellhopWoss& setConcurrentRuns( int runs ) { concurrent_runs = runs; return *this; }
+    
+#ifdef WOSS_MULTITHREAD
+    /**
+    * Sets the thread pool that executes the parallel Bellhop jobs, so that the concurrent runs limit 
+    * holds also when several objects share it. The object is not owned by BellhopWoss and it has to outlive it
+    * @param pool pointer to a valid WossThreadPool
+    * @return reference to <b>*this</b>
+    */
+    BellhopWoss& setRunPool( WossThreadPool* const pool );
+#endif // WOSS_MULTITHREAD
+
+    /**
+    * Sets whether SHD results files are memory mapped and decoded on demand instead of being read in memory
+    * @param flag <i>true</i> to memory map SHD results files
+    * @return reference to <b>*this</b>
+    */
+    BellhopWoss& setShdMmapReadFlag( bool flag ) { shd_mmap_read = flag; return *this; }
+
     /**
     * Sets the bellhop arr file syntax
     * @param syntax syntax to be used
@@ -374,6 +432,12 @@ namespace woss {
     */
     int getTotalTransmitters() const { return total_transmitters; }
 
+    /**
+    * Gets the explicit list of source depths
+    * @returns vector of source depths [m], empty if the linear span is used
+    */
+    const DepthVector& getTxDepths() const { return tx_depths; }
+
     /**
     * Gets the receiver mimimum depth offset [m]
     * @returns depth offset [m]
@@ -452,6 +516,36 @@ namespace woss {
     * @return path of bellhop program
     */
     ::std::string getBellhopPath() const { return bellhop_path; }
+
+    /**
+    * Gets the solver backend used by run()
+    * @returns pointer to a valid BellhopSolver
+    */
+    BellhopSolver* getBellhopSolver() const { return ( bellhop_solver == NULL ? &default_bellhop_solver : bellhop_solver ); }
+
+    /**
+    * Gets the maximum number of Bellhop jobs executed in parallel
+    * @returns concurrent runs
+    */
+    int getConcurrentRuns() const { return concurrent_runs; }
+    
+    /**
+    * Gets the number of Bellhop jobs executed in parallel, with 0 resolved to the number of available cpu cores
+    * @returns number of parallel jobs
+    */
+    int getTotalRunThreads() const;
+
+    /**
+    * Returns whether SHD results files are memory mapped
+    * @returns <i>true</i> if SHD results files are memory mapped, <i>false</i> otherwise
+    */
+    bool getShdMmapReadFlag() const { return shd_mmap_read; }
+
+    /**
+    * Gets the Bellhop jobs of the last run() call, ordered by frequency and run index, with their timing
+    * @returns const reference to the job vector
+    */
+    const BellhopSolverJobVector& getRunJobs() const { return run_jobs; }
     
    /**
     * Gets the .arr file sintax
@@ -577,6 +671,12 @@ namespace woss {
     **/     
     ::std::string beam_pattern_file;
     
+    /**
+    * Contents of the beam pattern file. It only depends on the transect and on the transducer, 
+    * so it is computed once per initialize()
+    **/
+    ::std::string beam_pattern_buffer;
+    
 
     /**
     * Pathname of Bellhop SSP file
@@ -598,6 +698,31 @@ namespace woss {
     **/
     ::std::string bellhop_path;
     
+    /**
+    * Solver backend, NULL if the default one has to be used
+    **/
+    BellhopSolver* bellhop_solver;
+    
+    /**
+    * Default solver backend, it spawns Bellhop program through the shell
+    **/
+    static BellhopSystemSolver default_bellhop_solver;
+    
+    /**
+    * Maximum number of Bellhop jobs executed in parallel
+    **/
+    int concurrent_runs;
+    
+    /**
+    * <i>true</i> if SHD results files are memory mapped and decoded on demand
+    **/
+    bool shd_mmap_read;
+    
+    /**
+    * Bellhop jobs of the last run() call
+    **/
+    BellhopSolverJobVector run_jobs;
+    
     /**
      * .arr file syntax to be used during file parsing
      */
@@ -631,6 +756,10 @@ namespace woss {
     **/  
     int total_transmitters;
 
+    /**
+    * Explicit source depths [m], written instead of the offsets span when not empty
+    **/
+    DepthVector tx_depths;
 
     /**
     * Number of receiver depths
@@ -790,6 +919,69 @@ namespace woss {
     * @param curr_run current run number
     **/
     void initCfgFiles( double curr_frequency, int curr_run );
+    
+    /**
+    * Returns the working path of given frequency and run
+    * @param curr_frequency frequency in use [Hz]
+    * @param curr_run current run number
+    * @returns path string, terminated by "/"
+    **/
+    ::std::string getCfgPath( double curr_frequency, int curr_run ) const;
+    
+    /**
+    * Executes all jobs stored in run_jobs, in parallel if allowed by concurrent_runs
+    * @returns <i>true</i> if all jobs succeeded, <i>false</i> otherwise
+    **/
+    bool solveRunJobs();
+    
+    /**
+    * Executes a single job with given solver, measuring its elapsed time
+    * @param solver pointer to a valid BellhopSolver
+    * @param job job to be executed
+    * @returns <i>true</i> if the job succeeded, <i>false</i> otherwise
+    **/
+    static bool solveJob( BellhopSolver* const solver, BellhopSolverJob& job );
+    
+    
+#ifdef WOSS_MULTITHREAD
+    /**
+    * \brief WossThreadTask that executes a single Bellhop job
+    **/
+    class SolverTask : public WossThreadTask {
+      
+      public:
+        
+      SolverTask( BellhopSolver* const ptr, BellhopSolverJob& bh_job ) : WossThreadTask(), solver(ptr), job(bh_job), result(false) { }
+      
+      virtual ~SolverTask() { }
+      
+      virtual void execute() { result = BellhopWoss::solveJob( solver, job ); }
+      
+      BellhopSolver* solver;
+      
+      BellhopSolverJob& job;
+      
+      bool result;
+      
+    };
+    
+    /**
+    * Thread pool that executes the parallel jobs, NULL until needed or set
+    **/
+    WossThreadPool* run_pool;
+    
+    /**
+    * <i>true</i> if run_pool was created by this object, which joins and deletes it
+    **/
+    bool is_run_pool_owned;
+    
+    /**
+    * Returns the thread pool that executes the parallel jobs, creating a private one if none was set
+    * @param threads number of worker threads of the private pool (>= 1)
+    * @returns pointer to a valid WossThreadPool
+    **/
+    WossThreadPool* getRunPool( int threads );
+#endif // WOSS_MULTITHREAD
    
     
     /**
@@ -854,6 +1046,12 @@ namespace woss {
     **/ 
     void writeBeamPatternFile(); 
     
+    /**
+    * Recomputes the normalized SSPs, the offsets and the box, then writes all configuration files.
+    * It is shared by initialize() and by the incremental refresh of timeEvolve()
+    **/
+    void initCfgValues();
+    
     /**
     * Writes db created altimetry in the configuration file(s)
     * @param curr_run current run number
@@ -948,7 +1146,15 @@ namespace woss {
 
   inline void BellhopWoss::writeTransmitter() {
     f_out << total_transmitters << ::std::setw(30) << "! NUMBER OF SOURCES" << ::std::endl;
-    if (total_transmitters == 1) f_out << tx_coordz.getDepth() + tx_min_depth_offset << "  " << "/" << ::std::setw(30) << "! SOURCE'S DEPTH" << ::std::endl;
+    if (!tx_depths.empty()) {
+      double min_depth = tx_coordz.getDepth() + tx_min_depth_offset;
+      double max_depth = tx_coordz.getDepth() + tx_max_depth_offset;
+
+      for ( DepthVector::const_iterator it = tx_depths.begin(); it != tx_depths.end(); it++ ) 
+        f_out << ::std::max( min_depth, ::std::min( *it, max_depth ) ) << "  ";
+      f_out << "/" << ::std::setw(30) << "! SOURCES' DEPTHS" << ::std::endl;
+    }
+    else if (total_transmitters == 1) f_out << tx_coordz.getDepth() + tx_min_depth_offset << "  " << "/" << ::std::setw(30) << "! SOURCE'S DEPTH" << ::std::endl;
     else f_out << tx_coordz.getDepth() + tx_min_depth_offset << "  " << tx_coordz.getDepth() + tx_max_depth_offset 
               << "  " << "/" << ::std::setw(30) << "! SOURCES' DEPTHS" << ::std::endl;
   }
@@ -105,6 +105,28 @@ namespace woss {
     **/
     virtual Woss* const createWoss( const CoordZ& tx, const CoordZ& rx, double start_freq, double end_freq ) const = 0;
    
+    /**
+    * Returns a pointer to a valid Woss able to compute the channel from given transmitter to all given receivers
+    * (receiver fan). The default implementation doesn't support receiver fans.
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx_vector const reference to a non empty CoordZVector ( receivers )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @returns pointer to properly initialized Woss object, NULL if receiver fans are not supported
+    **/
+    virtual Woss* const createFanWoss( const CoordZ& tx, const CoordZVector& rx_vector, double start_freq, double end_freq ) const { return NULL; }
+   
+    /**
+    * Returns a pointer to a valid Woss able to compute the channel from all given co-located transmitters
+    * to given receiver in a single run (transmitter stack). The default implementation doesn't support transmitter stacks.
+    * @param tx_vector const reference to a non empty CoordZVector ( transmitters sharing latitude and longitude )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @returns pointer to properly initialized Woss object, NULL if transmitter stacks are not supported
+    **/
+    virtual Woss* const createStackWoss( const CoordZVector& tx_vector, const CoordZ& rx, double start_freq, double end_freq ) const { return NULL; }
+   
     
     /**
     * Sets debug flag of every Woss object created
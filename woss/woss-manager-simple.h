@@ -41,7 +41,10 @@
 #define WOSS_MANAGER_SIMPLE_DEFINITIONS_H
 
 
+#include <map>
+#include <cmath>
 #include <time-arrival-definitions.h>
+#include <coordinates-spatial-map.h>
 #include <definitions-handler.h>
 #include "woss-manager.h"
 
@@ -56,6 +59,18 @@ namespace woss {
   * It creates a Woss for every tx-rx pair. No memory management is done. In simulation with high mobility rate, 
   * a Woss for every receiver will be created everytime a transmitter will move, without removing old objects. 
   * <b>If a memory management is needed, the user should extend this class to suit his needs</b>.
+  * 
+  * If a receiver fan sector is set, the receivers of a TimeArr vector query are grouped by transmitter and 
+  * bearing sector: every group gets a single Woss, created by WossCreator::createFanWoss(), that serves all of them.
+  * Receivers inside a sector share the environment computed along the bearing of the farthest one.
+  *
+  * If a transmitter stack minimum size is set, transmitters sharing latitude and longitude (within space sampling) 
+  * but placed at different depths are merged: every receiver gets a single Woss, created by WossCreator::createStackWoss(),
+  * whose sources are all the known transmitter depths. Queries are routed to the source closest to the transmitter depth.
+  * A stack is created again with the new set of depths whenever a new transmitter depth is met. 
+  * On TimeArr queries a receiver placed at a new depth is served by the stack of a receiver at the same latitude 
+  * and longitude whose receiver grid covers that depth (see Woss::isRxDepthCovered()). Pressure queries average 
+  * over the whole receiver grid, so they are always served by a stack created for their own receiver.
   */
   template< typename WMResDb = WossManagerResDb >
   class WossManagerSimple : public WMResDb {
@@ -102,13 +117,50 @@ namespace woss {
     static double getSpaceSampling() { return space_sampling; }
     
     
+    /**
+    * Sets the width of the bearing sectors used to group receivers in receiver fans
+    * @param sector sector width [decimal degrees], <= 0.0 disables receiver fans
+    **/   
+    void setReceiverFanSector( double sector ) { fan_sector = sector; }
+    
+    /**
+    * Gets the width of the bearing sectors used to group receivers in receiver fans
+    * @returns sector width [decimal degrees]
+    **/   
+    double getReceiverFanSector() const { return fan_sector; }
+    
+    /**
+    * Sets the minimum number of receivers needed to create a receiver fan
+    * @param size number of receivers
+    **/   
+    void setReceiverFanMinSize( int size ) { fan_min_size = size; }
+    
+    /**
+    * Gets the minimum number of receivers needed to create a receiver fan
+    * @returns number of receivers
+    **/   
+    int getReceiverFanMinSize() const { return fan_min_size; }
+    
+    /**
+    * Sets the minimum number of co-located transmitter depths needed to create a transmitter stack
+    * @param size number of transmitter depths, <= 1 disables transmitter stacks
+    **/   
+    void setTransmitterStackMinSize( int size ) { stack_min_size = size; }
+    
+    /**
+    * Gets the minimum number of co-located transmitter depths needed to create a transmitter stack
+    * @returns number of transmitter depths
+    **/   
+    int getTransmitterStackMinSize() const { return stack_min_size; }
+    
+    
     protected:
       
     
     /**
     * Map that links a receiver CoordZ to a pointer to a valid Woss object
     */
-    typedef typename ::std::map< CoordZ, Woss*, CoordComparator< WossManagerSimple, CoordZ > > WossCoordZMap;
+    typedef CoordZSpatialMap< Woss*, WossManagerSimple > WossCoordZMap;
     typedef typename WossCoordZMap::iterator WCZIter;
     typedef typename WossCoordZMap::reverse_iterator WCZRIter;
 
@@ -116,11 +168,110 @@ namespace woss {
     /**
     * Map that links a transmitter CoordZ to a WossCoordZMap
     */
-    typedef typename ::std::map< CoordZ, WossCoordZMap, CoordComparator< WossManagerSimple, CoordZ > > WossContainer;
+    typedef CoordZSpatialMap< WossCoordZMap, WossManagerSimple > WossContainer;
     typedef typename WossContainer::iterator WCIter;
     typedef typename WossContainer::reverse_iterator WCRIter;
     
     
+    /**
+    * \brief Woss shared by the receivers of a bearing sector
+    **/
+    struct ReceiverFan {
+      
+      
+      /**
+      * Checks if the fan can serve given receiver
+      **/
+      bool covers( int rx_sector, double range, double depth, double start_freq, double end_freq ) const {
+        return( rx_sector == sector && start_freq == start_frequency && end_freq == end_frequency 
+                && range >= min_range && range <= max_range && depth >= min_depth && depth <= max_depth );
+      }
+      
+      
+      Woss* woss;
+      
+      int sector;
+      
+      double start_frequency;
+      
+      double end_frequency;
+      
+      double min_range;
+      
+      double max_range;
+      
+      double min_depth;
+      
+      double max_depth;
+      
+      
+    };
+    
+    typedef ::std::vector< ReceiverFan > ReceiverFanVector;
+    typedef typename ReceiverFanVector::iterator RFVIter;
+    
+    /**
+    * Map that links a transmitter CoordZ to its ReceiverFanVector
+    */
+    typedef CoordZSpatialMap< ReceiverFanVector, WossManagerSimple > FanContainer;
+    typedef typename FanContainer::iterator FCIter;
+    
+    /**
+    * Map that links a bearing sector to its receivers
+    */
+    typedef ::std::map< int, CoordZVector > SectorMap;
+    typedef typename SectorMap::iterator SMIter;
+    
+    
+    /**
+    * \brief Woss shared by co-located transmitters towards a receiver
+    **/
+    struct TransmitterStack {
+      
+      
+      /**
+      * Checks if the stack can serve given transmitter depth
+      **/
+      bool covers( double depth, double start_freq, double end_freq ) const {
+        if ( start_freq != start_frequency || end_freq != end_frequency ) return false;
+        
+        for ( CoordZVector::const_iterator it = transmitters.begin(); it != transmitters.end(); it++ ) {
+          if ( ::std::abs( it->getDepth() - depth ) <= WossManagerSimple::getSpaceSampling() ) return true;
+        }
+        return false;
+      }
+      
+      
+      Woss* woss;
+      
+      double start_frequency;
+      
+      double end_frequency;
+      
+      CoordZVector transmitters;
+      
+      
+    };
+    
+    /**
+    * Map that links a receiver CoordZ to a TransmitterStack
+    */
+    typedef CoordZSpatialMap< TransmitterStack, WossManagerSimple > StackCoordZMap;
+    typedef typename StackCoordZMap::iterator SCZIter;
+    
+    /**
+    * Map that links a transmitter location (depth set to zero) to its StackCoordZMap
+    */
+    typedef CoordZSpatialMap< StackCoordZMap, WossManagerSimple > StackContainer;
+    typedef typename StackContainer::iterator SCIter;
+    
+    /**
+    * Map that links a transmitter location (depth set to zero) to all the transmitters met there
+    */
+    typedef CoordZSpatialMap< CoordZVector, WossManagerSimple > StackTxContainer;
+    typedef typename StackTxContainer::iterator STCIter;
+    
+    
     /**
     * The radius in meters (>= 0.0) of a cartesian sphere, in which all coordinates
     * are considered to be equivalent
@@ -132,6 +283,43 @@ namespace woss {
     **/ 
     WossContainer woss_map;
 
+    /**
+    * Map containing all created receiver fans
+    **/ 
+    FanContainer fan_map;
+    
+    /**
+    * Width of the bearing sectors [decimal degrees], <= 0.0 if receiver fans are disabled
+    **/
+    double fan_sector;
+    
+    /**
+    * Minimum number of receivers of a receiver fan
+    **/
+    int fan_min_size;
+    
+    /**
+    * Map containing all created transmitter stacks
+    **/ 
+    StackContainer stack_map;
+    
+    /**
+    * Map containing all the co-located transmitters met so far
+    **/ 
+    StackTxContainer stack_tx_map;
+    
+    /**
+    * Transmitter stacks replaced by a wider one, or Woss objects erased by eraseActiveWoss(), 
+    * that were still in use by a concurrent query. 
+    * They are deleted as soon as they are no longer in use (see WossManager::isWossInUse())
+    **/ 
+    ::std::vector< Woss* > retired_woss;
+    
+    /**
+    * Minimum number of transmitter depths of a transmitter stack, <= 1 if transmitter stacks are disabled
+    **/
+    int stack_min_size;
+
 
     /**
     * Returns a pointer to a properly initialized Woss, for storage purposes
@@ -143,6 +331,98 @@ namespace woss {
     **/
     virtual Woss* const getWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency ); 
     
+    /**
+    * Returns the receiver fan Woss serving given tx-rx pair if any, getLinkWoss() with a shared receiver grid otherwise
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @returns pointer to a valid Woss object
+    **/
+    virtual Woss* const getTimeArrWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency ); 
+    
+    /**
+    * Returns the transmitter stack Woss serving given tx-rx pair if any, otherwise the Woss of the pair, creating it if needed
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param is_grid_shared <i>true</i> if a stack created for another receiver may serve rx through its receiver grid
+    * @returns pointer to a valid Woss object
+    **/
+    Woss* const getLinkWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency, bool is_grid_shared );
+    
+    /**
+    * Groups the receivers of given pairs by transmitter and bearing sector, and creates a receiver fan
+    * for every group of at least fan_min_size receivers not already served by a fan
+    * @param coordinates const reference to a valid CoordZPairVect
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    **/
+    virtual void prepareTimeArrWoss( const CoordZPairVect& coordinates, double start_frequency, double end_frequency );
+    
+    /**
+    * Returns the bearing sector of given receiver
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @returns sector index
+    **/
+    int getFanSector( const CoordZ& tx, const CoordZ& rx ) const;
+    
+    /**
+    * Returns the receiver fan serving given tx-rx pair
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @returns pointer to the ReceiverFan found, NULL otherwise
+    **/
+    const ReceiverFan* findReceiverFan( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency );
+    
+    /**
+    * Returns the transmitter stack Woss serving given tx-rx pair, creating or widening it if needed
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param is_grid_shared <i>true</i> if a stack created for another receiver may serve rx through its receiver grid
+    * @returns pointer to a valid Woss object, NULL if less than stack_min_size transmitters share the tx location
+    **/
+    Woss* const getStackWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency, bool is_grid_shared );
+    
+    /**
+    * Records the depth of given transmitter among the co-located ones
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @returns reference to the co-located transmitters
+    **/
+    const CoordZVector& addStackTransmitter( const CoordZ& tx );
+    
+    /**
+    * Finds the transmitter stack that serves given receiver: the one created for it or, failing that and if allowed, 
+    * one of a receiver at the same latitude and longitude whose receiver grid covers its depth
+    * @param rx_map reference to the stacks of a transmitter location
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param is_grid_shared <i>true</i> if a stack created for another receiver may serve rx through its receiver grid
+    * @returns iterator to the stack found, rx_map.end() otherwise
+    **/
+    SCZIter findStack( StackCoordZMap& rx_map, const CoordZ& rx, double start_frequency, double end_frequency, bool is_grid_shared );
+    
+    /**
+    * Deletes given replaced or erased Woss, or keeps it until it's no longer in use. 
+    * Previously retired Woss that are no longer in use are deleted too
+    * @param woss_ptr pointer to the removed Woss
+    **/
+    void retireWoss( Woss* const woss_ptr );
+    
+    /**
+    * Returns the location key of given transmitter, used by transmitter stacks
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @returns given transmitter with depth set to zero
+    **/
+    static CoordZ getStackLocation( const CoordZ& tx ) { return CoordZ( tx.getLatitude(), tx.getLongitude(), 0.0 ); }
+    
     
   };
   
@@ -153,7 +433,14 @@ namespace woss {
     
   template< typename WMResDb >
   WossManagerSimple< WMResDb >::WossManagerSimple()
-  : woss_map() 
+  : woss_map(),
+    fan_map(),
+    fan_sector(0.0),
+    fan_min_size(2),
+    stack_map(),
+    stack_tx_map(),
+    retired_woss(),
+    stack_min_size(0)
   { 
 
 
@@ -172,51 +459,348 @@ namespace woss {
         }
     }
     woss_map.clear();
+    
+    for (FCIter it1 = fan_map.begin(); it1 != fan_map.end(); it1++) {
+        for (RFVIter it2 = (it1->second).begin(); it2 != (it1->second).end(); it2++) {
+          delete it2->woss;
+          it2->woss = NULL;
+        }
+    }
+    fan_map.clear();
+    
+    for (SCIter it1 = stack_map.begin(); it1 != stack_map.end(); it1++) {
+        for (SCZIter it2 = (it1->second).begin(); it2 != (it1->second).end(); it2++) {
+          delete it2->second.woss;
+          it2->second.woss = NULL;
+        }
+    }
+    stack_map.clear();
+    stack_tx_map.clear();
+    
+    for (int i = 0; i < (int) retired_woss.size(); i++) delete retired_woss[i];
+    retired_woss.clear();
+    
+    WMResDb::clearSnapshots();
     return true;
   }
 
   
   template< typename WMResDb >
   bool WossManagerSimple< WMResDb >::timeEvolve( const Time& time_value ) {
+    bool is_ok = true;
+    
     for (WCIter it1 = woss_map.begin(); it1 != woss_map.end(); it1++) {
         for (WCZIter it2 = (it1->second).begin(); it2 != (it1->second).end(); it2++) {
-          it2->second->timeEvolve(time_value);
+          is_ok = it2->second->timeEvolve(time_value) && is_ok;
+        }
+    }
+    for (FCIter it1 = fan_map.begin(); it1 != fan_map.end(); it1++) {
+        for (RFVIter it2 = (it1->second).begin(); it2 != (it1->second).end(); it2++) {
+          is_ok = it2->woss->timeEvolve(time_value) && is_ok;
+        }
+    }
+    for (SCIter it1 = stack_map.begin(); it1 != stack_map.end(); it1++) {
+        for (SCZIter it2 = (it1->second).begin(); it2 != (it1->second).end(); it2++) {
+          is_ok = it2->second.woss->timeEvolve(time_value) && is_ok;
         }
     }
-    return true;    
+    return is_ok;    
   }
   
 
   template< typename WMResDb >
   Woss* const WossManagerSimple< WMResDb >::getWoss( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency ) {
-    if (WMResDb::debug) ::std::cout << "WossManagerSimple::getWoss() tx coords " << tx_coordz << "; rx coords "
+    // pressure queries average over the receiver grid of the Woss
+    return( getLinkWoss( tx_coordz, rx_coordz, start_frequency, end_frequency, false ) );
+  }
+  
+
+  template< typename WMResDb >
+  Woss* const WossManagerSimple< WMResDb >::getLinkWoss( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, bool is_grid_shared ) {
+    if (WMResDb::debug) ::std::cout << "WossManagerSimple::getLinkWoss() tx coords " << tx_coordz << "; rx coords "
                                     << rx_coordz << "; start freq " << start_frequency << "; end freq " 
                                     << end_frequency << ::std::endl;
 
+    if ( stack_min_size > 1 ) {
+      Woss* const stack_woss = getStackWoss( tx_coordz, rx_coordz, start_frequency, end_frequency, is_grid_shared );
+      if ( stack_woss != NULL ) return( stack_woss );
+    }
+    
     WCIter it1 = woss_map.find( tx_coordz );
 
     if (it1 == woss_map.end() ) { // no tx CoordZ found
   
-      if (WMResDb::debug) ::std::cout << "WossManagerSimple::getWoss() no tx CoordZ found" << ::std::endl;
-      
-      Woss* const curr_woss = this->woss_creator->createWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
-      
-      woss_map[tx_coordz][rx_coordz] = curr_woss;
-      return( curr_woss );
+      if (WMResDb::debug) ::std::cout << "WossManagerSimple::getLinkWoss() no tx CoordZ found" << ::std::endl;
     }
     else { // start CoordZ found
       WCZIter it2 = (it1->second).find( rx_coordz );
 
-      if ( it2 == it1->second.end() ) { // no rx CoordZ foundZ
+      if ( it2 != it1->second.end() ) return( it2->second );
 
-        if (WMResDb::debug) ::std::cout << "WossManagerSimple::getWoss() no rx CoordZ found" << ::std::endl;
+      if (WMResDb::debug) ::std::cout << "WossManagerSimple::getLinkWoss() no rx CoordZ found" << ::std::endl;
+    }
+    
+    WMResDb::beginWossCreation();
+    Woss* const curr_woss = WMResDb::woss_creator->createWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
+    WMResDb::endWossCreation();
+    
+    // a concurrent query may have created the same Woss in the meantime
+    WossCoordZMap& rx_map = woss_map[tx_coordz];
+    WCZIter it2 = rx_map.find( rx_coordz );
+    
+    if ( it2 != rx_map.end() ) {
+      delete curr_woss;
+      return( it2->second );
+    }
+    
+    rx_map[rx_coordz] = curr_woss;
+    return( curr_woss );
+  }
 
-        Woss* const curr_woss = WMResDb::woss_creator->createWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
 
-        woss_map[tx_coordz][rx_coordz] = curr_woss;
-        return( curr_woss );  
+  template< typename WMResDb >
+  const CoordZVector& WossManagerSimple< WMResDb >::addStackTransmitter( const CoordZ& tx_coordz ) {
+    CoordZVector& transmitters = stack_tx_map[ getStackLocation( tx_coordz ) ];
+    
+    for ( CoordZVector::iterator it = transmitters.begin(); it != transmitters.end(); it++ ) {
+      if ( ::std::abs( it->getDepth() - tx_coordz.getDepth() ) <= space_sampling ) return( transmitters );
+    }
+    transmitters.push_back( tx_coordz );
+    return( transmitters );
+  }
+
+
+  template< typename WMResDb >
+  Woss* const WossManagerSimple< WMResDb >::getStackWoss( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, bool is_grid_shared ) {
+    CoordZ location = getStackLocation( tx_coordz );
+    StackCoordZMap& rx_map = stack_map[ location ];
+    SCZIter it = findStack( rx_map, rx_coordz, start_frequency, end_frequency, is_grid_shared );
+    
+    if ( it != rx_map.end() && it->second.covers( tx_coordz.getDepth(), start_frequency, end_frequency ) ) return( it->second.woss );
+    
+    // copied, since concurrent queries may add transmitters while the stack is created
+    const CoordZVector transmitters = addStackTransmitter( tx_coordz );
+    
+    if ( (int) transmitters.size() < stack_min_size ) {
+      if ( rx_map.empty() ) stack_map.erase( stack_map.find( location ) );
+      return NULL;
+    }
+    
+    // a stack found through its receiver grid is widened around its own receiver
+    const CoordZ stack_rx = ( it != rx_map.end() ) ? it->first : rx_coordz;
+    
+    WMResDb::beginWossCreation();
+    Woss* const curr_woss = WMResDb::woss_creator->createStackWoss( transmitters, stack_rx, start_frequency, end_frequency );
+    WMResDb::endWossCreation();
+    
+    // the containers may have changed while the stack was created
+    StackCoordZMap& curr_rx_map = stack_map[ location ];
+    
+    if ( curr_woss == NULL ) { // transmitter stacks are not supported by the creator
+      if ( curr_rx_map.empty() ) stack_map.erase( stack_map.find( location ) );
+      return NULL;
+    }
+    
+    it = findStack( curr_rx_map, rx_coordz, start_frequency, end_frequency, is_grid_shared );
+    
+    if ( it != curr_rx_map.end() && it->second.covers( tx_coordz.getDepth(), start_frequency, end_frequency ) ) {
+      delete curr_woss;
+      return( it->second.woss );
+    }
+    
+    if (WMResDb::debug) ::std::cout << "WossManagerSimple::getStackWoss() tx location " << location << "; rx coords " 
+                                    << stack_rx << "; transmitters " << transmitters.size() << ::std::endl;
+    
+    it = curr_rx_map.find( stack_rx );
+    
+    if ( it != curr_rx_map.end() ) {
+      retireWoss( it->second.woss );
+      curr_rx_map.erase( it );
+    }
+    
+    TransmitterStack stack;
+    stack.woss = curr_woss;
+    stack.start_frequency = start_frequency;
+    stack.end_frequency = end_frequency;
+    stack.transmitters = transmitters;
+    
+    curr_rx_map[stack_rx] = stack;
+    return( curr_woss );
+  }
+
+
+  template< typename WMResDb >
+  typename WossManagerSimple< WMResDb >::SCZIter WossManagerSimple< WMResDb >::findStack( StackCoordZMap& rx_map, const CoordZ& rx_coordz, double start_frequency, double end_frequency, bool is_grid_shared ) {
+    SCZIter it = rx_map.find( rx_coordz );
+    
+    if ( it != rx_map.end() || !is_grid_shared ) return( it );
+    
+    const CoordZ rx_location = getStackLocation( rx_coordz );
+    
+    for ( it = rx_map.begin(); it != rx_map.end(); it++ ) {
+      if ( it->second.start_frequency != start_frequency || it->second.end_frequency != end_frequency ) continue;
+      
+      if ( getStackLocation( it->first ).getCartDistance( rx_location ) > space_sampling ) continue;
+      
+      if ( it->second.woss->isRxDepthCovered( rx_coordz.getDepth() ) ) {
+        
+        if (WMResDb::debug) ::std::cout << "WossManagerSimple::findStack() rx coords " << rx_coordz 
+                                        << " served by the receiver grid of " << it->first << ::std::endl;
+        
+        return( it );
       }
-      else return( it2->second );
+    }
+    return( rx_map.end() );
+  }
+
+
+  template< typename WMResDb >
+  void WossManagerSimple< WMResDb >::retireWoss( Woss* const woss_ptr ) {
+    retired_woss.push_back( woss_ptr );
+    
+    ::std::vector< Woss* >::iterator it = retired_woss.begin();
+    
+    while ( it != retired_woss.end() ) {
+      if ( WMResDb::isWossInUse( *it ) ) it++;
+      else {
+        delete *it;
+        it = retired_woss.erase( it );
+      }
+    }
+  }
+
+
+  template< typename WMResDb >
+  int WossManagerSimple< WMResDb >::getFanSector( const CoordZ& tx_coordz, const CoordZ& rx_coordz ) const {
+    double bearing = tx_coordz.getInitialBearing( rx_coordz ) * 180.0 / M_PI;
+    bearing = ::std::fmod( bearing, 360.0 );
+    if ( bearing < 0.0 ) bearing += 360.0;
+    return( (int) ::std::floor( bearing / fan_sector ) );
+  }
+
+
+  template< typename WMResDb >
+  const typename WossManagerSimple< WMResDb >::ReceiverFan* WossManagerSimple< WMResDb >::findReceiverFan( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency ) {
+    FCIter it1 = fan_map.find( tx_coordz );
+    if ( it1 == fan_map.end() ) return NULL;
+    
+    int sector = getFanSector( tx_coordz, rx_coordz );
+    double range = tx_coordz.getGreatCircleDistance( rx_coordz );
+    
+    for (RFVIter it2 = (it1->second).begin(); it2 != (it1->second).end(); it2++) {
+      if ( it2->covers( sector, range, rx_coordz.getDepth(), start_frequency, end_frequency ) ) return( &(*it2) );
+    }
+    return NULL;
+  }
+
+
+  template< typename WMResDb >
+  Woss* const WossManagerSimple< WMResDb >::getTimeArrWoss( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency ) {
+    if ( fan_sector > 0.0 ) {
+      const ReceiverFan* fan = findReceiverFan( tx_coordz, rx_coordz, start_frequency, end_frequency );
+      
+      if ( fan != NULL ) {
+        
+        if (WMResDb::debug) ::std::cout << "WossManagerSimple::getTimeArrWoss() tx coords " << tx_coordz << "; rx coords "
+                                        << rx_coordz << " served by receiver fan of sector " << fan->sector << ::std::endl;
+        
+        return( fan->woss );
+      }
+    }
+    return( getLinkWoss( tx_coordz, rx_coordz, start_frequency, end_frequency, true ) );
+  }
+
+
+  template< typename WMResDb >
+  void WossManagerSimple< WMResDb >::prepareTimeArrWoss( const CoordZPairVect& coordinates, double start_frequency, double end_frequency ) {
+    if ( stack_min_size > 1 ) { // all the transmitters are known before the first stack is created
+      for ( int i = 0; i < (int) coordinates.size(); i++ ) addStackTransmitter( coordinates[i].first );
+    }
+    
+    if ( fan_sector <= 0.0 ) return;
+    
+    CoordZSpatialMap< SectorMap, WossManagerSimple > tx_map;
+    
+    for ( int i = 0; i < (int) coordinates.size(); i++ ) {
+      const CoordZ& tx_coordz = coordinates[i].first;
+      const CoordZ& rx_coordz = coordinates[i].second;
+      
+      if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) continue;
+      if ( findReceiverFan( tx_coordz, rx_coordz, start_frequency, end_frequency ) != NULL ) continue;
+      
+      tx_map[tx_coordz][ getFanSector( tx_coordz, rx_coordz ) ].push_back( rx_coordz );
+    }
+    
+    ReceiverFanVector new_fans;
+    CoordZVector new_fans_tx;
+    ::std::vector< const CoordZVector* > new_fans_rx;
+    
+    for ( typename CoordZSpatialMap< SectorMap, WossManagerSimple >::iterator it1 = tx_map.begin(); it1 != tx_map.end(); it1++ ) {
+      const CoordZ& tx_coordz = it1->first;
+      
+      for ( SMIter it2 = (it1->second).begin(); it2 != (it1->second).end(); it2++ ) {
+        const CoordZVector& rx_vector = it2->second;
+        
+        if ( (int) rx_vector.size() < ::std::max( fan_min_size, 1 ) ) continue;
+        
+        ReceiverFan fan;
+        fan.woss = NULL;
+        fan.sector = it2->first;
+        fan.start_frequency = start_frequency;
+        fan.end_frequency = end_frequency;
+        fan.min_range = HUGE_VAL;
+        fan.max_range = 0.0;
+        fan.min_depth = HUGE_VAL;
+        fan.max_depth = -HUGE_VAL;
+        
+        for ( int i = 0; i < (int) rx_vector.size(); i++ ) {
+          double range = tx_coordz.getGreatCircleDistance( rx_vector[i] );
+          
+          fan.min_range = ::std::min( fan.min_range, range );
+          fan.max_range = ::std::max( fan.max_range, range );
+          fan.min_depth = ::std::min( fan.min_depth, rx_vector[i].getDepth() );
+          fan.max_depth = ::std::max( fan.max_depth, rx_vector[i].getDepth() );
+        }
+        
+        new_fans.push_back( fan );
+        new_fans_tx.push_back( tx_coordz );
+        new_fans_rx.push_back( &rx_vector );
+      }
+    }
+    
+    if ( new_fans.empty() ) return;
+    
+    // fans are created and initialized without the request lock, then published
+    WMResDb::beginWossCreation();
+    
+    for ( int i = 0; i < (int) new_fans.size(); i++ ) {
+      new_fans[i].woss = WMResDb::woss_creator->createFanWoss( new_fans_tx[i], *new_fans_rx[i], start_frequency, end_frequency );
+      
+      if ( new_fans[i].woss == NULL ) break; // receiver fans are not supported by the creator
+    }
+    
+    WMResDb::endWossCreation();
+    
+    for ( int i = 0; i < (int) new_fans.size() && new_fans[i].woss != NULL; i++ ) {
+      const CoordZ& tx_coordz = new_fans_tx[i];
+      const CoordZVector& rx_vector = *new_fans_rx[i];
+      
+      // a concurrent query may have published a fan for the same receivers in the meantime
+      bool is_covered = true;
+      for ( int j = 0; j < (int) rx_vector.size() && is_covered; j++ ) {
+        is_covered = ( findReceiverFan( tx_coordz, rx_vector[j], start_frequency, end_frequency ) != NULL );
+      }
+      
+      if ( is_covered ) {
+        delete new_fans[i].woss;
+        continue;
+      }
+      
+      if (WMResDb::debug) ::std::cout << "WossManagerSimple::prepareTimeArrWoss() tx coords " << tx_coordz << "; sector " 
+                                      << new_fans[i].sector << "; receivers " << rx_vector.size() << "; min range " << new_fans[i].min_range
+                                      << "; max range " << new_fans[i].max_range << ::std::endl;
+      
+      fan_map[tx_coordz].push_back( new_fans[i] );
     }
   }
 
@@ -226,20 +810,51 @@ namespace woss {
     if (WMResDb::debug) ::std::cout << "WossManagerSimple::eraseActiveWoss() tx coords " << tx_coordz << "; rx coords "
                                     << rx_coordz << "; start freq " << start_frequency << "; end freq " 
                                     << end_frequency << ::std::endl;
+    
+    // removed Woss may still be run by a concurrent query, so they are retired instead of deleted
+    WMResDb::beginWossErasure();
+
+    FCIter it5 = fan_map.find( tx_coordz );
+    
+    if ( it5 != fan_map.end() ) {
+      int sector = getFanSector( tx_coordz, rx_coordz );
+      double range = tx_coordz.getGreatCircleDistance( rx_coordz );
+      
+      for ( RFVIter it6 = (it5->second).begin(); it6 != (it5->second).end(); ) {
+        if ( it6->covers( sector, range, rx_coordz.getDepth(), start_frequency, end_frequency ) ) {
+          retireWoss( it6->woss );
+          it6 = (it5->second).erase(it6);
+        }
+        else it6++;
+      }
+      if ( it5->second.empty() ) fan_map.erase(it5);
+    }
+    
+    SCIter it3 = stack_map.find( getStackLocation( tx_coordz ) );
+    
+    if ( it3 != stack_map.end() ) {
+      SCZIter it4 = findStack( it3->second, rx_coordz, start_frequency, end_frequency, true );
+      
+      if ( it4 != it3->second.end() ) {
+        retireWoss( it4->second.woss );
+        it3->second.erase(it4);
+        if ( it3->second.empty() ) stack_map.erase(it3);
+      }
+    }
 
     WCIter it1 = woss_map.find( tx_coordz );
 
-    if (it1 == woss_map.end() ) return *this;
-    else { // start CoordZ found
+    if ( it1 != woss_map.end() ) { // start CoordZ found
       WCZIter it2 = (it1->second).find( rx_coordz );
 
-      if ( it2 == it1->second.end() ) return *this;
-      else {
-        delete it2->second;
+      if ( it2 != it1->second.end() ) {
+        retireWoss( it2->second );
         it1->second.erase(it2);
         if ( it1->second.empty() ) woss_map.erase(it1);
       }
     }
+    
+    WMResDb::endWossErasure();
     return *this;
   } 
   
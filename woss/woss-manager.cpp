@@ -73,11 +73,11 @@ TimeArr* WossManager::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_
   if ( debug ) ::std::cout << "WossManager::getWossTimeArr() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
                            << "; start freq = " << start_frequency << "; end freq = " << end_frequency << "; distance = " << tx_coordz.getCartDistance( rx_coordz ) << ::std::endl; 
  
-  Woss* const curr_woss = getWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
+  Woss* const curr_woss = getTimeArrWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
     
   bool is_ok = curr_woss->timeEvolve(time_value);
   assert(is_ok);
-  is_ok = curr_woss->run();
+  if ( curr_woss->isRunNeeded() ) is_ok = curr_woss->run();
   assert(is_ok);
   
   if ( start_frequency == end_frequency ) return( curr_woss->getTimeArr( start_frequency, tx_coordz.getDepth(), rx_coordz.getDepth(), tx_coordz.getGreatCircleDistance( rx_coordz ) ) );
@@ -129,7 +129,7 @@ Pressure* WossManager::getWossPressure( const CoordZ& tx_coordz, const CoordZ& r
   
   bool is_ok = curr_woss->timeEvolve(time_value);
   assert(is_ok);
-  is_ok = curr_woss->run();
+  if ( curr_woss->isRunNeeded() ) is_ok = curr_woss->run();
   assert(is_ok);
   
   if ( start_frequency == end_frequency ) return( curr_woss->getPressure( start_frequency, tx_coordz.getDepth(), rx_coordz.getDepth(), tx_coordz.getGreatCircleDistance( rx_coordz ) ) );
@@ -212,6 +212,8 @@ TimeArrVector WossManager::getWossTimeArr( const CoordZPairVect& coordinates, do
   TimeArrVector ret_value;
   ret_value.reserve(coordinates.size());
   
+  prepareTimeArrWoss( coordinates, start_frequency, end_frequency );
+  
   for ( int i = 0; i < (int) coordinates.size(); i++ ) {
     ret_value.push_back( getWossTimeArr( coordinates[i].first, coordinates[i].second, start_frequency, end_frequency, time_value ) );
   }
@@ -222,6 +224,8 @@ TimeArrVector WossManager::getWossTimeArr( const CoordZPairVect& coordinates, do
 TimeArrVector WossManager::getWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value ) {
   TimeArrVector ret_value;
   ret_value.reserve(coordinates.size());
+  
+  prepareTimeArrWoss( coordinates, start_frequency, end_frequency );
 
   for ( int i = 0; i < (int) coordinates.size(); i++ ) {
     SimTime sim_time = woss_creator->getSimTime(coordinates[i].first, coordinates[i].second);
@@ -255,18 +259,353 @@ const Woss& WossManager::getActiveWoss( const CoordZ& tx, const CoordZ& rx, doub
 
 /////////
 WossManagerResDb::WossManagerResDb()
-:  woss_db_manager(NULL)
+:  woss_db_manager(NULL),
+  is_snapshot_interpolation_active(false),
+  snapshot_error_bound(WOSS_DEFAULT_SNAPSHOT_ERROR_BOUND),
+  snapshot_delay_tolerance(WOSS_DEFAULT_SNAPSHOT_DELAY_TOLERANCE),
+  snapshot_delay_error_bound(WOSS_DEFAULT_SNAPSHOT_DELAY_ERROR_BOUND),
+  timearr_snapshots(),
+  pressure_snapshots()
 {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_init( &snapshot_mutex, NULL );
+#endif // WOSS_MULTITHREAD
+}
 
+
+WossManagerResDb::~WossManagerResDb() {
+  clearSnapshots();
+  
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_destroy( &snapshot_mutex );
+#endif // WOSS_MULTITHREAD
 }
 
 
 TimeArr* WossManagerResDb::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
   if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) return( SDefHandler::instance()->getTimeArr()->create( TimeArr::createImpulse() ) ); // it is the same node!
+  
+  Time before;
+  Time after;
+  double weight = 0.0;
+  
+  if ( getSnapshotTimes( tx_coordz, rx_coordz, time_value, before, after, weight ) ) 
+    return getInterpolatedTimeArr( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value, before, after, weight );
+  
+  return computeWossTimeArr( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+}
+
+
+Pressure* WossManagerResDb::getWossPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
+  if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) return( SDefHandler::instance()->getPressure()->create(1.0, 0) ); // it is the same node!
+  
+  Time before;
+  Time after;
+  double weight = 0.0;
+  
+  if ( getSnapshotTimes( tx_coordz, rx_coordz, time_value, before, after, weight ) ) 
+    return getInterpolatedPressure( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value, before, after, weight );
+  
+  return computeWossPressure( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+}
+
+
+bool WossManagerResDb::getSnapshotTimes( const CoordZ& tx, const CoordZ& rx, const Time& time_value, Time& before, Time& after, double& weight ) const {
+  if ( !is_snapshot_interpolation_active || !is_time_evolution_active ) return false;
+  
+  double time_quantum = woss_creator->getEvolutionTimeQuantum( tx, rx );
+  
+  if ( time_quantum <= 0.0 || !time_value.isValid() ) return false;
+  
+  SimTime sim_time = woss_creator->getSimTime( tx, rx );
+  
+  if ( !sim_time.start_time.isValid() ) return false;
+  
+  // snapshots lie on the multiples of the quantum after the start time. The quantum is rounded up 
+  // to whole seconds, so that the Woss always evolves from one snapshot to the next one
+  int64_t quantum = (int64_t) ::std::ceil( time_quantum );
+  int64_t offset = time_value.getEpoch() - sim_time.start_time.getEpoch();
+  
+  if ( offset <= 0 || ( offset % quantum ) == 0 ) return false;
+  
+  int64_t before_offset = offset - ( offset % quantum );
+  
+  before = sim_time.start_time + (time_t)before_offset;
+  after = before + (time_t)quantum;
+  
+  // the Woss doesn't evolve after the end time
+  if ( sim_time.end_time.isValid() && after > sim_time.end_time ) return false;
+  
+  weight = (double)( offset - before_offset ) / (double)quantum;
+  
+  if ( debug ) ::std::cout << "WossManagerResDb::getSnapshotTimes() time = " << time_value << "; before = " << before 
+                           << "; after = " << after << "; weight = " << weight << ::std::endl;
+  
+  return true;
+}
+
+
+TimeArr* WossManagerResDb::interpolateSnapshots( const TimeArr& before, const TimeArr& after, double weight, double& error, double& delay_error ) const {
+  TimeArr* ret_val = SDefHandler::instance()->getTimeArr()->create( before.getDelayPrecision() );
+  
+  double before_energy = 0.0;
+  double after_energy = 0.0;
+  double error_energy = 0.0;
+  double matched_energy = 0.0;
+  double drift_energy = 0.0;
+  
+  int i = 0;
+  int j = 0;
+  
+  while ( i < before.size() || j < after.size() ) {
+    double before_delay = ( i < before.size() ) ? (double)before.at(i)->first : HUGE_VAL;
+    double after_delay = ( j < after.size() ) ? (double)after.at(j)->first : HUGE_VAL;
+    double difference = ::std::abs( after_delay - before_delay );
+    
+    // an arrival is matched only with its closest arrival of the other snapshot
+    bool is_matched = i < before.size() && j < after.size() && difference <= snapshot_delay_tolerance
+                      && !( i + 1 < before.size() && ::std::abs( after_delay - (double)before.at(i + 1)->first ) < difference )
+                      && !( j + 1 < after.size() && ::std::abs( (double)after.at(j + 1)->first - before_delay ) < difference );
+    
+    if ( is_matched ) {
+      ::std::complex< double > before_value = before.at(i)->second;
+      ::std::complex< double > after_value = after.at(j)->second;
+      
+      double before_amplitude = ::std::abs( before_value );
+      double after_amplitude = ::std::abs( after_value );
+      
+      // phase follows the shortest rotation
+      double phase_difference = ::std::arg( after_value ) - ::std::arg( before_value );
+      if ( phase_difference > M_PI ) phase_difference -= 2.0 * M_PI;
+      else if ( phase_difference < -M_PI ) phase_difference += 2.0 * M_PI;
+      
+      ret_val->sumValue( ( 1.0 - weight ) * before_delay + weight * after_delay, 
+                         Pressure( ::std::polar( ( 1.0 - weight ) * before_amplitude + weight * after_amplitude, 
+                                                 ::std::arg( before_value ) + weight * phase_difference ) ) );
+      
+      before_energy += before_amplitude * before_amplitude;
+      after_energy += after_amplitude * after_amplitude;
+      error_energy += ( after_amplitude - before_amplitude ) * ( after_amplitude - before_amplitude );
+      
+      // matched arrivals drifting in delay are weighted by their strongest amplitude
+      double arrival_energy = ::std::max( before_amplitude * before_amplitude, after_amplitude * after_amplitude );
+      matched_energy += arrival_energy;
+      drift_energy += arrival_energy * ( after_delay - before_delay ) * ( after_delay - before_delay );
+      i++;
+      j++;
+    }
+    else if ( before_delay < after_delay ) {
+      // arrival that disappears
+      ::std::complex< double > before_value = before.at(i)->second;
+      
+      ret_val->sumValue( before_delay, Pressure( before_value * ( 1.0 - weight ) ) );
+      
+      before_energy += ::std::norm( before_value );
+      error_energy += ::std::norm( before_value );
+      i++;
+    }
+    else {
+      // arrival that appears
+      ::std::complex< double > after_value = after.at(j)->second;
+      
+      ret_val->sumValue( after_delay, Pressure( after_value * weight ) );
+      
+      after_energy += ::std::norm( after_value );
+      error_energy += ::std::norm( after_value );
+      j++;
+    }
+  }
+  
+  double max_energy = ::std::max( before_energy, after_energy );
+  
+  if ( max_energy > 0.0 ) error = error_energy / max_energy;
+  else error = 0.0;
+  
+  if ( matched_energy > 0.0 ) delay_error = ::std::sqrt( drift_energy / matched_energy );
+  else delay_error = 0.0;
+  
+  return ret_val;
+}
+
+
+TimeArr* WossManagerResDb::getSnapshot( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& snapshot_time, bool is_pressure ) {
+  SnapshotMap& snapshots = is_pressure ? pressure_snapshots : timearr_snapshots;
+  SnapshotLink link( CoordZPair( tx_coordz, rx_coordz ), SimFreq( start_frequency, end_frequency ) );
+  TimeArr* ret_val = NULL;
+  
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &snapshot_mutex );
+#endif // WOSS_MULTITHREAD
+  
+  SMIter it = snapshots.find( link );
+  
+  if ( it != snapshots.end() ) {
+    STMIter it2 = it->second.find( snapshot_time );
+    
+    if ( it2 != it->second.end() ) ret_val = SDefHandler::instance()->getTimeArr()->create( *(it2->second) );
+  }
+  
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &snapshot_mutex );
+#endif // WOSS_MULTITHREAD
+  
+  if ( ret_val != NULL ) {
+    if ( debug ) ::std::cout << "WossManagerResDb::getSnapshot() stored snapshot found, time = " << snapshot_time << ::std::endl;
+    
+    return ret_val;
+  }
+  
+  // the snapshot is read from the result db or computed only once
+  if ( is_pressure ) {
+    Pressure* press = computeWossPressure( tx_coordz, rx_coordz, start_frequency, end_frequency, snapshot_time );
+    
+    if ( press != NULL && press->isValid() ) ret_val = SDefHandler::instance()->getTimeArr()->create( *press, 0.0 );
+    delete press;
+  }
+  else {
+    ret_val = computeWossTimeArr( tx_coordz, rx_coordz, start_frequency, end_frequency, snapshot_time );
+    
+    if ( ret_val != NULL && !ret_val->isValid() ) {
+      delete ret_val;
+      ret_val = NULL;
+    }
+  }
+  
+  if ( ret_val == NULL ) return NULL;
+  
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &snapshot_mutex );
+#endif // WOSS_MULTITHREAD
+  
+  SnapshotTimeMap& link_snapshots = snapshots[ link ];
+  
+  if ( link_snapshots.find( snapshot_time ) == link_snapshots.end() ) {
+    link_snapshots[ snapshot_time ] = SDefHandler::instance()->getTimeArr()->create( *ret_val );
+    
+    while ( link_snapshots.size() > WOSS_SNAPSHOTS_PER_LINK ) {
+      delete link_snapshots.begin()->second;
+      link_snapshots.erase( link_snapshots.begin() );
+    }
+  }
+  
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &snapshot_mutex );
+#endif // WOSS_MULTITHREAD
+  
+  if ( debug ) ::std::cout << "WossManagerResDb::getSnapshot() snapshot stored, time = " << snapshot_time << ::std::endl;
+  
+  return ret_val;
+}
+
+
+void WossManagerResDb::clearSnapshots() {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &snapshot_mutex );
+#endif // WOSS_MULTITHREAD
+  
+  for ( int i = 0; i < 2; i++ ) {
+    SnapshotMap& snapshots = ( i == 0 ) ? timearr_snapshots : pressure_snapshots;
+    
+    for ( SMIter it = snapshots.begin(); it != snapshots.end(); it++ ) {
+      for ( STMIter it2 = it->second.begin(); it2 != it->second.end(); it2++ ) {
+        delete it2->second;
+        it2->second = NULL;
+      }
+    }
+    snapshots.clear();
+  }
+  
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &snapshot_mutex );
+#endif // WOSS_MULTITHREAD
+}
+
+
+TimeArr* WossManagerResDb::getInterpolatedTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value, const Time& before, const Time& after, double weight ) {
+  TimeArr* before_value = getSnapshot( tx_coordz, rx_coordz, start_frequency, end_frequency, before, false );
+  TimeArr* after_value = NULL;
+  
+  if ( before_value != NULL ) after_value = getSnapshot( tx_coordz, rx_coordz, start_frequency, end_frequency, after, false );
+  
+  TimeArr* ret_val = NULL;
+  double error = HUGE_VAL;
+  double delay_error = HUGE_VAL;
+  
+  if ( before_value != NULL && after_value != NULL ) 
+    ret_val = interpolateSnapshots( *before_value, *after_value, weight, error, delay_error );
+  
+  delete before_value;
+  before_value = NULL;
+  delete after_value;
+  after_value = NULL;
+  
+  if ( debug ) ::std::cout << "WossManagerResDb::getInterpolatedTimeArr() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
+                           << "; time = " << time_value << "; weight = " << weight << "; error = " << error 
+                           << "; delay error = " << delay_error << ::std::endl; 
+  
+  if ( ret_val != NULL && error <= snapshot_error_bound && delay_error <= snapshot_delay_error_bound ) {
+    WossMetrics::addCount( WOSS_METRICS_SNAPSHOT_INTERPOLATIONS );
+    return ret_val;
+  }
+  
+  delete ret_val;
+  ret_val = NULL;
+  
+  WossMetrics::addCount( WOSS_METRICS_SNAPSHOT_RECOMPUTATIONS );
+  
+  return computeWossTimeArr( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+}
+
+
+Pressure* WossManagerResDb::getInterpolatedPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value, const Time& before, const Time& after, double weight ) {
+  // a Pressure is interpolated as a single arrival
+  TimeArr* before_value = getSnapshot( tx_coordz, rx_coordz, start_frequency, end_frequency, before, true );
+  TimeArr* after_value = NULL;
+  
+  if ( before_value != NULL ) after_value = getSnapshot( tx_coordz, rx_coordz, start_frequency, end_frequency, after, true );
+  
+  Pressure* ret_val = NULL;
+  double error = HUGE_VAL;
+  double delay_error = HUGE_VAL;
+  
+  if ( before_value != NULL && after_value != NULL ) {
+    TimeArr* curr_arr = interpolateSnapshots( *before_value, *after_value, weight, error, delay_error );
+    
+    ret_val = SDefHandler::instance()->getPressure()->create( *curr_arr );
+    
+    delete curr_arr;
+  }
+  
+  delete before_value;
+  before_value = NULL;
+  delete after_value;
+  after_value = NULL;
+  
+  if ( debug ) ::std::cout << "WossManagerResDb::getInterpolatedPressure() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
+                           << "; time = " << time_value << "; weight = " << weight << "; error = " << error 
+                           << "; delay error = " << delay_error << ::std::endl; 
+  
+  if ( ret_val != NULL && error <= snapshot_error_bound && delay_error <= snapshot_delay_error_bound ) {
+    WossMetrics::addCount( WOSS_METRICS_SNAPSHOT_INTERPOLATIONS );
+    return ret_val;
+  }
+  
+  delete ret_val;
+  ret_val = NULL;
+  
+  WossMetrics::addCount( WOSS_METRICS_SNAPSHOT_RECOMPUTATIONS );
+  
+  return computeWossPressure( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+}
+
+
+TimeArr* WossManagerResDb::computeWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
    
-  if ( debug ) ::std::cout << "WossManagerResDb::getWossTimeArr() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
+  if ( debug ) ::std::cout << "WossManagerResDb::computeWossTimeArr() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
                            << "; start freq = " << start_frequency << "; end freq = " << end_frequency << "; distance = " << tx_coordz.getCartDistance( rx_coordz ) << ::std::endl; 
   
+  WossMetricsTimer timer( WOSS_METRICS_MANAGER_QUERY );
+  
   bool valid = true;
   
   double freq_step = woss_creator->getFrequencyStep(tx_coordz,rx_coordz);
@@ -281,7 +620,7 @@ TimeArr* WossManagerResDb::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ
   
   TimeArr* sum = dbGetTimeArr( tx_coordz, rx_coordz, (start_frequency + ((double)i) * freq_step ), *time );
   
-  if ( debug && sum != NULL ) ::std::cout << "WossManagerResDb::getWossTimeArr() first TimeArr in db " << *sum << ::std::endl; 
+  if ( debug && sum != NULL ) ::std::cout << "WossManagerResDb::computeWossTimeArr() first TimeArr in db " << *sum << ::std::endl; 
   
   i++;
   valid = valid && sum->isValid();
@@ -291,7 +630,7 @@ TimeArr* WossManagerResDb::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ
       curr_time_arr = dbGetTimeArr( tx_coordz, rx_coordz, (start_frequency + ((double)i) * freq_step ), *time );
       valid = valid && curr_time_arr->isValid();
 
-      if ( debug && curr_time_arr != NULL ) ::std::cout << "WossManagerResDb::getWossTimeArr() " << i << "-th TimeArr in db" << *curr_time_arr << ::std::endl; 
+      if ( debug && curr_time_arr != NULL ) ::std::cout << "WossManagerResDb::computeWossTimeArr() " << i << "-th TimeArr in db" << *curr_time_arr << ::std::endl; 
       
       if (!valid) { 
         delete curr_time_arr; 
@@ -300,19 +639,24 @@ TimeArr* WossManagerResDb::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ
       }
       *sum += *curr_time_arr;
 
-      if ( debug && sum != NULL ) ::std::cout << "WossManagerResDb::getWossTimeArr() sum TimeArr " << *sum << ::std::endl; 
+      if ( debug && sum != NULL ) ::std::cout << "WossManagerResDb::computeWossTimeArr() sum TimeArr " << *sum << ::std::endl; 
      
       delete curr_time_arr;
       curr_time_arr = NULL;
   }
-  if (valid) return sum;
+  if (valid) {
+    WossMetrics::addCount( WOSS_METRICS_RES_DB_HITS );
+    return sum;
+  }
+  
+  WossMetrics::addCount( WOSS_METRICS_RES_DB_MISSES );
   
   sum->clear();
 
-  bool is_ok = true;
-  Woss* const curr_woss = getWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
+  Woss* const curr_woss = getTimeArrWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
   
-  if ( curr_woss->timeEvolve(time_value) ) is_ok = curr_woss->run();
+  bool is_ok = curr_woss->timeEvolve(time_value);
+  if ( is_ok && curr_woss->isRunNeeded() ) is_ok = curr_woss->run();
   assert(is_ok);
   
   for( FreqSIt it = curr_woss->freq_lower_bound( start_frequency ); it == curr_woss->freq_lower_bound( end_frequency ); it++ ) {
@@ -320,7 +664,7 @@ TimeArr* WossManagerResDb::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ
 
     assert(curr_time_arr != NULL);
 
-    if ( debug ) ::std::cout << "WossManagerResDb::getWossTimeArr() " << i << "-th TimeArr " << *curr_time_arr << ::std::endl; 
+    if ( debug ) ::std::cout << "WossManagerResDb::computeWossTimeArr() " << i << "-th TimeArr " << *curr_time_arr << ::std::endl; 
 
     dbInsertTimeArr( tx_coordz, rx_coordz, *it, *time, *curr_time_arr );
     *sum += *curr_time_arr;
@@ -328,18 +672,18 @@ TimeArr* WossManagerResDb::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ
     curr_time_arr = NULL;
   }
 
-  if ( debug && sum != NULL ) ::std::cout << "WossManagerResDb::getWossTimeArr() final TimeArr " << *sum << ::std::endl; 
+  if ( debug && sum != NULL ) ::std::cout << "WossManagerResDb::computeWossTimeArr() final TimeArr " << *sum << ::std::endl; 
 
   return sum; 
 }
 
 
-Pressure* WossManagerResDb::getWossPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
-  if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) return( SDefHandler::instance()->getPressure()->create(1.0, 0) ); // it is the same node!
-  
-  if ( debug ) ::std::cout << "WossManagerResDb::getWossPressure() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
+Pressure* WossManagerResDb::computeWossPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
+  if ( debug ) ::std::cout << "WossManagerResDb::computeWossPressure() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
                            << "; start freq = " << start_frequency << "; end freq = " << end_frequency << "; distance = " << tx_coordz.getCartDistance( rx_coordz ) << ::std::endl; 
   
+  WossMetricsTimer timer( WOSS_METRICS_MANAGER_QUERY );
+  
   bool valid = true;
   double freq_step = woss_creator->getFrequencyStep(tx_coordz,rx_coordz);
   int i = 0;
@@ -376,6 +720,8 @@ Pressure* WossManagerResDb::getWossPressure( const CoordZ& tx_coordz, const Coor
       curr_press = NULL;
   }
   if (valid) {
+    WossMetrics::addCount( WOSS_METRICS_RES_DB_HITS );
+    
     Pressure* ret_val = SDefHandler::instance()->getPressure()->create( *sum_avg );
     delete sum_avg;
     sum_avg = NULL;
@@ -383,15 +729,17 @@ Pressure* WossManagerResDb::getWossPressure( const CoordZ& tx_coordz, const Coor
     return ret_val;
   }
   
+  WossMetrics::addCount( WOSS_METRICS_RES_DB_MISSES );
+  
   delete curr_press;
   curr_press = NULL;
   
   sum_avg->clear();
 
-  bool is_ok = false;
   Woss* const curr_woss = getWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
   
-  if ( curr_woss->timeEvolve(time_value) ) is_ok = curr_woss->run();
+  bool is_ok = curr_woss->timeEvolve(time_value);
+  if ( is_ok && curr_woss->isRunNeeded() ) is_ok = curr_woss->run();
   assert(is_ok);
   
   for( FreqSIt it = curr_woss->freq_lower_bound( start_frequency ); it == curr_woss->freq_lower_bound( end_frequency ); it++ ) {
@@ -416,19 +764,26 @@ Pressure* WossManagerResDb::getWossPressure( const CoordZ& tx_coordz, const Coor
 
 WossManagerResDbMT::WossManagerResDbMT() 
 : max_thread_number(0),
-  total_queries(0),
   concurrent_threads(0),
-  total_thread_created(0),
-  total_thread_ended(0),
-  thread_query(),
-  thread_time_arr_reply(),
-  thread_pressure_reply()
+  thread_pool(NULL),
+  active_woss(),
+  woss_users(),
+  timearr_cache(),
+  pressure_cache(),
+  prefetch_keys(),
+  prefetch_key_order(),
+  total_prefetch_keys(0),
+  prefetch_hits(0),
+  timearr_inserts(),
+  pressure_inserts(),
+  db_insert_batch_size(WOSS_DEFAULT_DB_INSERT_BATCH),
+  active_vector_queries(0)
 {
-  int ret = pthread_spin_init( &mutex, PTHREAD_PROCESS_PRIVATE );
-  assert( ret == 0 );
-  
-  ret = pthread_spin_init( &request_mutex, PTHREAD_PROCESS_PRIVATE );
+  int ret = pthread_spin_init( &request_mutex, PTHREAD_PROCESS_PRIVATE );
   assert( ret == 0 );
+  pthread_mutex_init( &creation_mutex, NULL );
+  pthread_mutex_init( &prefetch_mutex, NULL );
+  pthread_mutex_init( &db_mutex, NULL );
 
   max_thread_number = sysconf(_SC_NPROCESSORS_CONF);
   if ( max_thread_number != 1 ) {
@@ -440,15 +795,35 @@ WossManagerResDbMT::WossManagerResDbMT()
 
 
 WossManagerResDbMT::~WossManagerResDbMT() {
-  pthread_spin_destroy( &mutex );
+  delete thread_pool;
+  thread_pool = NULL;
+  
+  dbFlushInserts();
+  
   pthread_spin_destroy( &request_mutex );
+  pthread_mutex_destroy( &creation_mutex );
+  pthread_mutex_destroy( &prefetch_mutex );
+  pthread_mutex_destroy( &db_mutex );
+}
+
+
+const Woss& WossManagerResDbMT::getActiveWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency ) const {
+  if ( concurrent_threads < 0 ) return WossManager::getActiveWoss( tx, rx, start_frequency, end_frequency );
+  
+  pthread_spinlock_t* lock = const_cast< pthread_spinlock_t* >( &request_mutex );
+  
+  pthread_spin_lock( lock );
+  const Woss& ret_value = WossManager::getActiveWoss( tx, rx, start_frequency, end_frequency );
+  pthread_spin_unlock( lock );
+  
+  return ret_value;
 }
 
 
 void WossManagerResDbMT::checkConcurrentThreads() {
-  if ( concurrent_threads <= 0 ) 
+  if ( concurrent_threads == 0 ) 
     concurrent_threads = max_thread_number;
-  else 
+  else if ( concurrent_threads > 0 )
     concurrent_threads = ::std::min( max_thread_number, concurrent_threads );
   
   if (debug)
@@ -456,454 +831,717 @@ void WossManagerResDbMT::checkConcurrentThreads() {
 }
 
 
-WossManagerResDbMT::ThreadParamIndex WossManagerResDbMT::popThreadParamIndex() {
-  pthread_spin_lock( &mutex );
+WossThreadPool* WossManagerResDbMT::getThreadPool() {
+  assert( concurrent_threads > 0 );
+  
+  if ( thread_pool != NULL && thread_pool->getTotalThreads() != concurrent_threads ) {
+    delete thread_pool;
+    thread_pool = NULL;
+  }
+  if ( thread_pool == NULL ) {
+    
+    if ( debug ) ::std::cout << "WossManagerResDbMT::getThreadPool() creating pool with " << concurrent_threads 
+                             << " threads" << ::std::endl;
+    
+    thread_pool = new WossThreadPool( concurrent_threads );
+  }
+  return thread_pool;
+}
 
-  if( debug ) ::std::cout << "WossManagerResDbMT::popThreadParamIndex() thread = " << ::std::hex << pthread_self() 
-                          << ::std::dec << "; thread_query size = " << thread_query.coordz_pair_vect.size() 
-                          << "; index = " << thread_query.curr_index << ::std::endl;
 
-  ThreadParamIndex ret_value; 
-  assert( !thread_query.coordz_pair_vect.empty() );
+void WossManagerResDbMT::dbQueueTimeArr( const CoordZ& tx, const CoordZ& rx, double frequency, const Time& time_value, const TimeArr& channel ) {
+  if ( woss_db_manager == NULL ) return;
+  
+  timearr_inserts.push_back( DbInsert< TimeArr >( tx, rx, frequency, time_value, channel ) );
+}
 
-  ret_value.first = thread_query.curr_index;
 
-  CoordZPairVect::iterator it = thread_query.coordz_pair_vect.begin();
-  ret_value.second.coordz_pair = *it; 
-  ret_value.second.sim_freq = thread_query.sim_freq;
-  ret_value.second.time_data.is_time_object = thread_query.time_data.is_time_object;
-  ret_value.second.time_data.time_cal = thread_query.time_data.time_cal;
-  ret_value.second.time_data.time_double = thread_query.time_data.time_double;
+void WossManagerResDbMT::dbQueuePressure( const CoordZ& tx, const CoordZ& rx, double frequency, const Time& time_value, const Pressure& press ) {
+  if ( woss_db_manager == NULL ) return;
   
-  if( debug ) ::std::cout << "WossManagerResDbMT::popThreadParamIndex() tx = " << it->first << "; rx " << it->second
-                          << "; start freq " << thread_query.sim_freq.first << "; end freq " << thread_query.sim_freq.second
-                          << "; time cal " << thread_query.time_data.time_cal 
-                          << "; time double " << thread_query.time_data.time_double << ::std::endl;
+  pressure_inserts.push_back( DbInsert< Pressure >( tx, rx, frequency, time_value, press ) );
+}
 
-  thread_query.coordz_pair_vect.erase(it);
-  thread_query.curr_index++;
 
-  pthread_spin_unlock( &mutex );
+void WossManagerResDbMT::dbFlushInserts( bool is_forced ) {
+  if ( woss_db_manager == NULL ) return;
   
-  return ret_value;
+  pthread_mutex_lock( &db_mutex );
+  dbWriteInserts( is_forced );
+  pthread_mutex_unlock( &db_mutex );
 }
 
 
-PressureVector WossManagerResDbMT::getWossPressure( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, const Time& time_value ) {
-  if ( concurrent_threads < 0 ) return WossManager::getWossPressure( coordinates, start_frequency, end_frequency );
-
-  thread_pressure_reply.clear();
-  thread_pressure_reply.reserve(coordinates.size());
-  thread_pressure_reply.resize(coordinates.size(), NULL);
-  
-  thread_query.coordz_pair_vect = coordinates;
-  thread_query.sim_freq = ::std::make_pair( start_frequency, end_frequency );
-  thread_query.time_data.is_time_object = true;
-  thread_query.time_data.time_cal = time_value;
-  thread_query.time_data.time_double = 0.0;
-  thread_query.curr_index = 0;
-
-  initThreadVars();
-  
-  int index_thd = 0;
-  for ( ; index_thd < concurrent_threads; index_thd++ ) {
-    if ( total_thread_created < total_queries ) {
-      total_thread_created++;
-      int ret = pthread_create( &thread_arr[index_thd], NULL, WMSMTcreateThreadPressure , (void*)this );
-      assert( ret == 0 );
-    }
+void WossManagerResDbMT::dbWriteInserts( bool is_forced ) {
+  TimeArrInsertVector curr_timearr_inserts;
+  PressureInsertVector curr_pressure_inserts;
+  
+  // the queues are swapped out under request_mutex and written under db_mutex only
+  pthread_spin_lock( &request_mutex );
+  
+  if ( is_forced || ( active_vector_queries == 0 && ( (int)timearr_inserts.size() >= db_insert_batch_size 
+                                                   || (int)pressure_inserts.size() >= db_insert_batch_size ) ) ) {
+    curr_timearr_inserts.swap( timearr_inserts );
+    curr_pressure_inserts.swap( pressure_inserts );
   }
   
-  int curr = 0;
-  while ( total_thread_ended < total_thread_created ) {
-    int ret = pthread_join( thread_arr[curr], NULL ); 
-    assert( ret == 0 );
-    total_thread_ended++;
-    curr = (curr + 1) % MAX_TOTAL_PTHREAD;
-    if ( total_thread_created < total_queries ) {
-      index_thd %= MAX_TOTAL_PTHREAD;
-      ret = pthread_create( &thread_arr[index_thd], NULL, WMSMTcreateThreadPressure , (void*)this );
-      assert( ret == 0 );
-      total_thread_created++;
-      index_thd++;
-    }
+  pthread_spin_unlock( &request_mutex );
+  
+  if ( debug && ( !curr_timearr_inserts.empty() || !curr_pressure_inserts.empty() ) ) 
+    ::std::cout << "WossManagerResDbMT::dbWriteInserts() TimeArr = " << curr_timearr_inserts.size() 
+                << "; Pressure = " << curr_pressure_inserts.size() << ::std::endl;
+  
+  for ( int i = 0; i < (int) curr_timearr_inserts.size(); i++ ) {
+    const DbInsert< TimeArr >& curr = curr_timearr_inserts[i];
+    dbInsertTimeArr( curr.tx_coordz, curr.rx_coordz, curr.frequency, curr.time_value, curr.value );
+  }
+  
+  for ( int i = 0; i < (int) curr_pressure_inserts.size(); i++ ) {
+    const DbInsert< Pressure >& curr = curr_pressure_inserts[i];
+    dbInsertPressure( curr.tx_coordz, curr.rx_coordz, curr.frequency, curr.time_value, curr.value );
   }
-
-  assert( total_thread_ended == total_queries );
-   
-  return thread_pressure_reply;
 }
 
 
-PressureVector WossManagerResDbMT::getWossPressure( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value ) {
-  if ( concurrent_threads < 0 ) return WossManager::getWossPressure( coordinates, start_frequency, end_frequency, time_value );
+void WossManagerResDbMT::flushDbInserts() {
+  dbFlushInserts();
+}
 
-  thread_pressure_reply.clear();
-  thread_pressure_reply.reserve(coordinates.size());
-  thread_pressure_reply.resize(coordinates.size(), NULL);
-  
-  thread_query.coordz_pair_vect = coordinates;
-  thread_query.sim_freq = ::std::make_pair( start_frequency, end_frequency );
-  thread_query.time_data.is_time_object = false;
-  thread_query.time_data.time_cal = Time();
-  thread_query.time_data.time_double = time_value;
-  thread_query.curr_index = 0;
-
-  initThreadVars();
-  
-  int index_thd = 0;
-  for ( ; index_thd < concurrent_threads; index_thd++ ) {
-    if ( total_thread_created < total_queries ) {
-      total_thread_created++;
-      int ret = pthread_create( &thread_arr[index_thd], NULL, WMSMTcreateThreadPressure , (void*)this );
-      assert( ret == 0 );
-    }
-  }
-  
-  int curr = 0;
-  while ( total_thread_ended < total_thread_created ) {
-    int ret = pthread_join( thread_arr[curr], NULL ); 
-    assert( ret == 0 );
-    total_thread_ended++;
-    curr = (curr + 1) % MAX_TOTAL_PTHREAD;
-    if ( total_thread_created < total_queries ) {
-      index_thd %= MAX_TOTAL_PTHREAD;
-      ret = pthread_create( &thread_arr[index_thd], NULL, WMSMTcreateThreadPressure , (void*)this );
-      assert( ret == 0 );
-      total_thread_created++;
-      index_thd++;
-    }
-  }
 
-  assert( total_thread_ended == total_queries );
-   
-  return thread_pressure_reply;
+void WossManagerResDbMT::beginVectorQuery() {
+  pthread_spin_lock( &request_mutex );
+  active_vector_queries++;
+  pthread_spin_unlock( &request_mutex );
 }
 
 
-
-TimeArrVector WossManagerResDbMT::getWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, const Time& time_value ) {
-  if ( concurrent_threads < 0 ) return WossManager::getWossTimeArr( coordinates, start_frequency, end_frequency );
-
-  thread_time_arr_reply.clear();
-  thread_time_arr_reply.reserve(coordinates.size());
-  thread_time_arr_reply.resize(coordinates.size(), NULL);
-  
-  thread_query.coordz_pair_vect = coordinates;
-  thread_query.sim_freq = ::std::make_pair( start_frequency, end_frequency );
-  thread_query.time_data.is_time_object = true;
-  thread_query.time_data.time_cal = time_value;
-  thread_query.time_data.time_double = 0.0;
-  thread_query.curr_index = 0;
-  
-  initThreadVars();
-  
-  int index_thd = 0;
-  for ( ; index_thd < concurrent_threads; index_thd++ ) {
-    if ( total_thread_created < total_queries ) {
-      total_thread_created++;
-      int ret = pthread_create( &thread_arr[index_thd], NULL, WMSMTcreateThreadTimeArr , (void*)this );
-      assert( ret == 0 );
-    }
-  }
-  
-  int curr = 0;
-  while ( total_thread_ended < total_thread_created ) {
-    int ret = pthread_join( thread_arr[curr], NULL ); 
-    assert( ret == 0 );
-    total_thread_ended++;
-    curr = (curr + 1) % MAX_TOTAL_PTHREAD;
-    if ( total_thread_created < total_queries ) {
-      index_thd %= MAX_TOTAL_PTHREAD;
-      ret = pthread_create( &thread_arr[index_thd], NULL, WMSMTcreateThreadTimeArr , (void*)this );
-      assert( ret == 0 );
-      total_thread_created++;
-      index_thd++;
-    }
-  }
-     
-  assert( total_thread_ended == total_queries );
+void WossManagerResDbMT::endVectorQuery() {
+  pthread_spin_lock( &request_mutex );
+  active_vector_queries--;
+  bool is_last = ( active_vector_queries == 0 );
+  pthread_spin_unlock( &request_mutex );
   
-  return thread_time_arr_reply;
+  if ( is_last ) dbFlushInserts();
 }
 
 
-TimeArrVector WossManagerResDbMT::getWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value ) {
-  if ( concurrent_threads < 0 ) return WossManager::getWossTimeArr( coordinates, start_frequency, end_frequency );
-
-  thread_time_arr_reply.clear();
-  thread_time_arr_reply.reserve(coordinates.size());
-  thread_time_arr_reply.resize(coordinates.size(), NULL);
-  
-  thread_query.coordz_pair_vect = coordinates;
-  thread_query.sim_freq = ::std::make_pair( start_frequency, end_frequency );
-  thread_query.time_data.is_time_object = false;
-  thread_query.time_data.time_cal = Time();
-  thread_query.time_data.time_double = time_value;
-  thread_query.curr_index = 0;
-
-  initThreadVars();
-  
-  int index_thd = 0;
-  for ( ; index_thd < concurrent_threads; index_thd++ ) {
-    if ( total_thread_created < total_queries ) {
-      total_thread_created++;
-      int ret = pthread_create( &thread_arr[index_thd], NULL, WMSMTcreateThreadTimeArr , (void*)this );
-      assert( ret == 0 );
-    }
-  }
+TimeArr* WossManagerResDbMT::readTimeArrSum( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value, bool is_prefetch ) {
+  WossResultKey key( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+  TimeArr cached;
   
-  int curr = 0;
-  while ( total_thread_ended < total_thread_created ) {
-    int ret = pthread_join( thread_arr[curr], NULL ); 
-    assert( ret == 0 );
-    total_thread_ended++;
-    curr = (curr + 1) % MAX_TOTAL_PTHREAD;
-    if ( total_thread_created < total_queries ) {
-      index_thd %= MAX_TOTAL_PTHREAD;
-      ret = pthread_create( &thread_arr[index_thd], NULL, WMSMTcreateThreadTimeArr , (void*)this );
-      assert( ret == 0 );
-      total_thread_created++;
-      index_thd++;
-    }
+  if ( woss_db_manager != NULL && timearr_cache.find( key, cached ) ) {
+    
+    if ( debug ) ::std::cout << "WossManagerResDbMT::readTimeArrSum() cached TimeArr found." << ::std::endl;
+    
+    WossMetrics::addCount( WOSS_METRICS_RES_CACHE_HITS );
+    
+    if ( !is_prefetch ) checkPrefetchHit( key );
+    
+    return SDefHandler::instance()->getTimeArr()->create( cached );
   }
-     
-  assert( total_thread_ended == total_queries );
   
-  return thread_time_arr_reply;
+  pthread_mutex_lock( &db_mutex );
+  // queued insertions have to be visible to the db lookup
+  dbWriteInserts( true );
+  TimeArr* sum = dbGetTimeArrSum( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+  pthread_mutex_unlock( &db_mutex );
+  
+  WossMetrics::addCount( sum != NULL ? WOSS_METRICS_RES_DB_HITS : WOSS_METRICS_RES_DB_MISSES );
+  
+  if ( sum != NULL && woss_db_manager != NULL ) timearr_cache.insert( key, *sum );
+  if ( sum != NULL && !is_prefetch ) checkPrefetchHit( key );
+  return sum;
 }
 
 
-void WossManagerResDbMT::initThreadVars() {
-  total_thread_created = 0;
-  total_thread_ended = 0;
+void WossManagerResDbMT::addPrefetchKey( const WossResultKey& key ) {
+  pthread_mutex_lock( &prefetch_mutex );
   
-  total_queries = thread_query.coordz_pair_vect.size();
+  prefetch_keys.insert( key );
+  prefetch_key_order.push_back( key );
+  
+  while ( (int) prefetch_key_order.size() > WOSS_MAX_PREFETCH_KEYS ) {
+    prefetch_keys.erase( prefetch_key_order.front() );
+    prefetch_key_order.pop_front();
+  }
+  total_prefetch_keys = prefetch_keys.size();
   
-  if(debug) ::std::cout << "WossManagerResDbMT::initThreadVars() thread = " << ::std::hex << pthread_self()
-                        << ::std::dec << "; total queries = " << total_queries 
-                        << "; concurrent threads = " << concurrent_threads << "; total_thread_created = " 
-                        << total_thread_created << "; total thread ended = "<< total_thread_ended << ::std::endl; 
+  pthread_mutex_unlock( &prefetch_mutex );
 }
 
 
-void* woss::WMSMTcreateThreadTimeArr( void* ptr ) {
-  WossManager* manager_ptr = reinterpret_cast< WossManager* >( ptr );
-  WossManagerResDbMT* manager_mt_ptr = reinterpret_cast< WossManagerResDbMT* >( ptr );
+void WossManagerResDbMT::checkPrefetchHit( const WossResultKey& key ) {
+  if ( total_prefetch_keys == 0 ) return;
   
-  assert( manager_mt_ptr );
+  pthread_mutex_lock( &prefetch_mutex );
   
-  WossManagerResDbMT::ThreadParamIndex curr_param = manager_mt_ptr->popThreadParamIndex();
-
-  int index = curr_param.first;
-  WossManagerResDbMT::ThreadParam& param = curr_param.second;
-
-  if(manager_mt_ptr->debug) ::std::cout << "woss::WMSMTcreateThreadTimeArr() called, index = " << index << "; tx = " << param.coordz_pair.first
-                                        << "; rx = " << param.coordz_pair.second << "; start freq = " << param.sim_freq.first
-                                        << "; end_freq = " << param.sim_freq.second  << ::std::flush
-                                        << "; time = " << (param.time_data.is_time_object?param.time_data.time_cal:param.time_data.time_double) << ::std::endl;
-  woss::TimeArr* value = NULL;
+  PKSIter it = prefetch_keys.find( key );
   
-  if ( param.time_data.is_time_object ) {
-    value = manager_ptr->getWossTimeArr( param.coordz_pair.first, param.coordz_pair.second, 
-                                                        param.sim_freq.first, param.sim_freq.second, param.time_data.time_cal);
-  }                                                  
-  else {
-     SimTime sim_time = manager_ptr->getWossCreator()->getSimTime(param.coordz_pair.first, param.coordz_pair.second);
-     if ( sim_time.start_time.isValid() ) {
-        Time time = sim_time.start_time + (time_t)param.time_data.time_double;
-        value = manager_ptr->getWossTimeArr( param.coordz_pair.first, param.coordz_pair.second, 
-                                                            param.sim_freq.first, param.sim_freq.second, time);
-     }
-     else {
-        ::std::cout << "woss::WMSMTcreateThreadTimeArr() WARNING, invalid start time for tx = " << param.coordz_pair.first << "; rx = " 
-                    << param.coordz_pair.second << ::std::endl;
-     }
+  if ( it != prefetch_keys.end() ) {
+    prefetch_keys.erase( it );
+    total_prefetch_keys = prefetch_keys.size();
+    prefetch_hits++;
   }
+  
+  pthread_mutex_unlock( &prefetch_mutex );
+}
 
-  assert( value != NULL );
 
-  manager_mt_ptr->insertThreadReplyTimeArr( index, value );
-  
-  return NULL;
+unsigned long WossManagerResDbMT::getPrefetchHits() {
+  pthread_mutex_lock( &prefetch_mutex );
+  unsigned long ret_value = prefetch_hits;
+  pthread_mutex_unlock( &prefetch_mutex );
+  return ret_value;
 }
 
 
-void* woss::WMSMTcreateThreadPressure( void* ptr ) {
-  WossManager* manager_ptr = reinterpret_cast< WossManager* >( ptr );
-  WossManagerResDbMT* manager_mt_ptr = dynamic_cast< WossManagerResDbMT* >( manager_ptr );
+Pressure* WossManagerResDbMT::readPressureSum( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
+  WossResultKey key( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+  Pressure cached;
   
-  assert( manager_mt_ptr );
-  
-  WossManagerResDbMT::ThreadParamIndex curr_param = manager_mt_ptr->popThreadParamIndex();
+  if ( woss_db_manager != NULL && pressure_cache.find( key, cached ) ) {
+    
+    if ( debug ) ::std::cout << "WossManagerResDbMT::readPressureSum() cached Pressure found." << ::std::endl;
+    
+    WossMetrics::addCount( WOSS_METRICS_RES_CACHE_HITS );
+    
+    return SDefHandler::instance()->getPressure()->create( cached );
+  }
   
-  int index = curr_param.first;
-  WossManagerResDbMT::ThreadParam& param = curr_param.second;
-
-  if(manager_mt_ptr->debug) ::std::cout << "woss::WMSMTcreateThreadPressure() called, index = " << index << "; tx = " << param.coordz_pair.first
-                                        << "; rx = " << param.coordz_pair.second << "; start freq = " << param.sim_freq.first << ::std::flush
-                                        << "; time = " << (param.time_data.is_time_object?param.time_data.time_cal:param.time_data.time_double) << ::std::endl;
-  woss::Pressure* value = NULL;
+  pthread_mutex_lock( &db_mutex );
+  // queued insertions have to be visible to the db lookup
+  dbWriteInserts( true );
+  Pressure* avg = dbGetPressureSum( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+  pthread_mutex_unlock( &db_mutex );
   
-  if ( param.time_data.is_time_object ) {
-    value = manager_ptr->getWossPressure( param.coordz_pair.first, param.coordz_pair.second, 
-                                                        param.sim_freq.first, param.sim_freq.second, param.time_data.time_cal);
-  }                                                  
-  else {
-    SimTime sim_time = manager_ptr->getWossCreator()->getSimTime(param.coordz_pair.first, param.coordz_pair.second);
-     if ( sim_time.start_time.isValid() ) {
-        Time time = sim_time.start_time + (time_t)param.time_data.time_double;
-        value = manager_ptr->getWossPressure( param.coordz_pair.first, param.coordz_pair.second, 
-                                              param.sim_freq.first, param.sim_freq.second, time);
-     }
-     else {
-        ::std::cout << "woss::WMSMTcreateThreadPressure() WARNING, invalid start time for tx = " << param.coordz_pair.first << "; rx = " 
-                    << param.coordz_pair.second << ::std::endl;
-     }
-  }
-  manager_mt_ptr->insertThreadReplyPressure( index, value );
+  WossMetrics::addCount( avg != NULL ? WOSS_METRICS_RES_DB_HITS : WOSS_METRICS_RES_DB_MISSES );
   
-  return NULL;
-}
- 
-
-void WossManagerResDbMT::insertThreadReplyTimeArr( int index, woss::TimeArr* time_arr ) {
-  pthread_spin_lock( &mutex );
-  thread_time_arr_reply[index] = time_arr;
-  pthread_spin_unlock( &mutex );
+  if ( avg != NULL && woss_db_manager != NULL ) pressure_cache.insert( key, *avg );
+  return avg;
 }
 
 
-void WossManagerResDbMT::insertThreadReplyPressure( int index, woss::Pressure* pressure ) {
-  pthread_spin_lock( &mutex );
-  thread_pressure_reply[index] = pressure;
-  pthread_spin_unlock( &mutex );
+void WossManagerResDbMT::releaseRunTask( WossRunTask* task ) {
+  assert( task != NULL && task->references > 0 );
+  
+  task->references--;
+  if ( task->references == 0 ) delete task;
 }
 
 
-TimeArr* WossManagerResDbMT::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
-  if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) return( SDefHandler::instance()->getTimeArr()->create( TimeArr::createImpulse() ) ); // it is the same node!
-   
-  if ( concurrent_threads < 0 ) return WossManagerResDb::getWossTimeArr( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+void WossManagerResDbMT::runWoss( Woss* const curr_woss, const Time& time_value ) {
+  AWIter it = active_woss.find( curr_woss ); 
   
-  if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
-                           << "; start freq = " << start_frequency << "; end freq = " << end_frequency 
-                           << "; distance = " << tx_coordz.getCartDistance( rx_coordz ) << ::std::flush
-                           << "; time_value = " << time_value << ::std::endl; 
+  if ( it != active_woss.end() ) {
+    
+    if ( debug ) ::std::cout << "WossManagerResDbMT::runWoss() curr Woss is running." 
+                             << " Waiting for it to finish..."<< ::std::endl;
+    
+    WossRunTask* task = it->second;
+    assert( task != NULL );
+    task->references++;
+    
+    releaseRequestLock( curr_woss );
+    task->wait();
+    acquireRequestLock( curr_woss );
+    
+    assert( task->is_ok );
+    releaseRunTask( task );
+    return;
+  }
   
-  bool valid = true;
+  if ( curr_woss->isRunning() ) return;
   
-  double freq_step = woss_creator->getFrequencyStep( tx_coordz, rx_coordz );
+  pthread_mutex_lock( &creation_mutex );
+  bool is_ok = curr_woss->timeEvolve( time_value );
+  pthread_mutex_unlock( &creation_mutex );
+  assert( is_ok );
+  
+  if ( !is_ok || !curr_woss->isRunNeeded() ) return;
+  
+  WossRunTask* task = new WossRunTask( curr_woss );
+  active_woss[curr_woss] = task;
+  
+  releaseRequestLock( curr_woss );
+  task->runInline();
+  acquireRequestLock( curr_woss );
+  
+  assert( task->is_ok );
+  active_woss.erase( curr_woss );
+  releaseRunTask( task );
   
+  if ( debug ) ::std::cout << "WossManagerResDbMT::runWoss() curr Woss was active and has now run." 
+                           << ::std::endl;
+}
+
+
+void WossManagerResDbMT::releaseRequestLock( const Woss* const woss_ptr ) {
+  woss_users[woss_ptr]++;
+  pthread_spin_unlock( &request_mutex );
+}
+
+
+void WossManagerResDbMT::acquireRequestLock( const Woss* const woss_ptr ) {
   pthread_spin_lock( &request_mutex );
+  WUIter it = woss_users.find( woss_ptr );
+  assert( it != woss_users.end() );
+  
+  it->second--;
+  if ( it->second == 0 ) woss_users.erase( it );
+}
 
-  const Time* time = NULL;
+
+bool WossManagerResDbMT::isWossInUse( const Woss* const woss_ptr ) const {
+  return( woss_users.find( woss_ptr ) != woss_users.end() );
+}
+
+
+void WossManagerResDbMT::beginWossCreation() {
+  // single-threaded queries don't hold request_mutex
+  if ( concurrent_threads >= 0 ) pthread_spin_unlock( &request_mutex );
+  pthread_mutex_lock( &creation_mutex );
+}
+
+
+void WossManagerResDbMT::endWossCreation() {
+  pthread_mutex_unlock( &creation_mutex );
+  if ( concurrent_threads >= 0 ) pthread_spin_lock( &request_mutex );
+}
+
+
+void WossManagerResDbMT::beginWossErasure() {
+  if ( concurrent_threads >= 0 ) pthread_spin_lock( &request_mutex );
+}
+
+
+void WossManagerResDbMT::endWossErasure() {
+  if ( concurrent_threads >= 0 ) pthread_spin_unlock( &request_mutex );
+}
+
+
+TimeArr* WossManagerResDbMT::dbGetTimeArrSum( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
+  double freq_step = woss_creator->getFrequencyStep( tx_coordz, rx_coordz );
+
+  TimeArr* sum = dbGetTimeArr( tx_coordz, rx_coordz, start_frequency, time_value );
   
-  if ( is_time_evolution_active == false ) {
-    time = &NO_EVOLUTION_TIME;
+  if ( debug && sum != NULL ) ::std::cout << "WossManagerResDbMT::dbGetTimeArrSum() first TimeArr in db " << *sum << ::std::endl; 
+    
+  bool valid = sum->isValid();
+  
+  TimeArr* curr_time_arr = NULL;
+  for( int i = 1; valid && i <= floor( ( end_frequency - start_frequency) / freq_step ); i++ ) {
+    curr_time_arr = dbGetTimeArr( tx_coordz, rx_coordz, (start_frequency + ((double)i) * freq_step ), time_value );
+    valid = curr_time_arr->isValid();
+
+    if (valid) *sum += *curr_time_arr;
+    delete curr_time_arr;
+    curr_time_arr = NULL;
   }
-  else 
-    time = &time_value;
+  if (valid) return sum;
+
+  delete sum;
+  return NULL;
+}
+
+
+Pressure* WossManagerResDbMT::dbGetPressureSum( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
+  double freq_step = woss_creator->getFrequencyStep( tx_coordz, rx_coordz );
+
+  Pressure* temp = dbGetPressure( tx_coordz, rx_coordz, start_frequency, time_value );
+  TimeArr* sum_avg = SDefHandler::instance()->getTimeArr()->create( *temp );
+  delete temp;
+  temp = NULL;
   
-  TimeArr* sum = dbGetTimeArr( tx_coordz, rx_coordz, start_frequency, *time );
+  bool valid = sum_avg->isValid();
   
-  if ( debug && sum != NULL ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() first TimeArr in db " << *sum << ::std::endl; 
+  Pressure* curr_press = NULL;
+  for( int i = 1; valid && i <= floor( ( end_frequency - start_frequency) / freq_step ); i++ ) {
+    curr_press = dbGetPressure( tx_coordz, rx_coordz, (start_frequency + ((double)i) * freq_step), time_value );
+    valid = curr_press->isValid();
     
-  valid = valid && sum->isValid();
+    if (valid) *sum_avg += *curr_press;
+    delete curr_press;
+    curr_press = NULL;
+  }
   
-  int i = 1;
-  TimeArr* curr_time_arr = NULL;
-  for( ; i <= floor( ( end_frequency - start_frequency) / freq_step ); i++ ) {
-      curr_time_arr = dbGetTimeArr( tx_coordz, rx_coordz, (start_frequency + ((double)i) * freq_step ), *time );
-      valid = valid && curr_time_arr->isValid();
+  Pressure* ret_val = NULL;
+  if (valid) ret_val = SDefHandler::instance()->getPressure()->create( *sum_avg );
 
-      if (!valid) { 
-        delete curr_time_arr; 
-        curr_time_arr = NULL;
-        break;
-      }
-      *sum += *curr_time_arr;
-      delete curr_time_arr;
-      curr_time_arr = NULL;
+  delete sum_avg;
+  sum_avg = NULL;
+  
+  return ret_val;
+}
+
+
+WossManagerResDbMT::TimeArrTask::TimeArrTask( WossManagerResDbMT* manager, const CoordZPair& coords, double start_freq, double end_freq, const Time& time ) 
+: WossThreadTask(),
+  result(NULL),
+  manager_ptr(manager),
+  coordz_pair(coords),
+  sim_freq( ::std::make_pair( start_freq, end_freq ) ),
+  time_value(time)
+{
+
+}
+
+
+void WossManagerResDbMT::TimeArrTask::execute() {
+  if ( manager_ptr->debug ) ::std::cout << "WossManagerResDbMT::TimeArrTask::execute() thread = " << ::std::hex << pthread_self() 
+                                        << ::std::dec << "; tx = " << coordz_pair.first << "; rx = " << coordz_pair.second 
+                                        << "; start freq = " << sim_freq.first << "; end_freq = " << sim_freq.second 
+                                        << "; time = " << time_value << ::std::endl;
+
+  result = manager_ptr->getWossTimeArr( coordz_pair.first, coordz_pair.second, sim_freq.first, sim_freq.second, time_value );
+  assert( result != NULL );
+}
+
+
+WossManagerResDbMT::PressureTask::PressureTask( WossManagerResDbMT* manager, const CoordZPair& coords, double start_freq, double end_freq, const Time& time ) 
+: WossThreadTask(),
+  result(NULL),
+  manager_ptr(manager),
+  coordz_pair(coords),
+  sim_freq( ::std::make_pair( start_freq, end_freq ) ),
+  time_value(time)
+{
+
+}
+
+
+void WossManagerResDbMT::PressureTask::execute() {
+  if ( manager_ptr->debug ) ::std::cout << "WossManagerResDbMT::PressureTask::execute() thread = " << ::std::hex << pthread_self() 
+                                        << ::std::dec << "; tx = " << coordz_pair.first << "; rx = " << coordz_pair.second 
+                                        << "; start freq = " << sim_freq.first << "; end_freq = " << sim_freq.second 
+                                        << "; time = " << time_value << ::std::endl;
+
+  result = manager_ptr->getWossPressure( coordz_pair.first, coordz_pair.second, sim_freq.first, sim_freq.second, time_value );
+  assert( result != NULL );
+}
+
+
+PressureVector WossManagerResDbMT::getWossPressure( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, const Time& time_value ) {
+  if ( concurrent_threads < 0 ) return WossManager::getWossPressure( coordinates, start_frequency, end_frequency, time_value );
+
+  beginVectorQuery();
+  
+  PressureVector ret_value( coordinates.size(), (Pressure*)NULL );
+  ::std::vector< ::std::pair< int, PressureTask* > > tasks;
+  
+  for ( int i = 0; i < (int) coordinates.size(); i++ ) {
+    const CoordZ& tx_coordz = coordinates[i].first;
+    const CoordZ& rx_coordz = coordinates[i].second;
+
+    if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) {
+      ret_value[i] = SDefHandler::instance()->getPressure()->create(1.0, 0); // it is the same node!
+      continue;
+    }
+    
+    // cached and result db hits are served on the calling thread
+    ret_value[i] = readPressureSum( tx_coordz, rx_coordz, start_frequency, end_frequency, getDbTime( time_value ) );
+    
+    if ( ret_value[i] != NULL ) continue;
+    
+    if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() index = " << i << " not in db, submitting to thread pool" << ::std::endl;
+    
+    PressureTask* task = new PressureTask( this, coordinates[i], start_frequency, end_frequency, time_value );
+    tasks.push_back( ::std::make_pair( i, task ) );
+    getThreadPool()->submit( task );
   }
-  if (valid) {
+  
+  for ( int j = 0; j < (int) tasks.size(); j++ ) {
+    tasks[j].second->wait();
+    ret_value[ tasks[j].first ] = tasks[j].second->result;
+    delete tasks[j].second;
+  }
+  
+  endVectorQuery();
+  return ret_value;
+}
+
+
+PressureVector WossManagerResDbMT::getWossPressure( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value ) {
+  if ( concurrent_threads < 0 ) return WossManager::getWossPressure( coordinates, start_frequency, end_frequency, time_value );
+
+  beginVectorQuery();
+  
+  PressureVector ret_value( coordinates.size(), (Pressure*)NULL );
+  ::std::vector< ::std::pair< int, PressureTask* > > tasks;
+  
+  for ( int i = 0; i < (int) coordinates.size(); i++ ) {
+    const CoordZ& tx_coordz = coordinates[i].first;
+    const CoordZ& rx_coordz = coordinates[i].second;
+
+    if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) {
+      ret_value[i] = SDefHandler::instance()->getPressure()->create(1.0, 0); // it is the same node!
+      continue;
+    }
     
-    if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() valid TimeArr in db found." << ::std::endl;
+    SimTime sim_time = woss_creator->getSimTime( tx_coordz, rx_coordz );
+    if ( !sim_time.start_time.isValid() ) {
+      ::std::cout << "WossManagerResDbMT::getWossPressure() WARNING, invalid start time for tx = " << tx_coordz << "; rx = " 
+                  << rx_coordz << ::std::endl;
+
+      ret_value[i] = SDefHandler::instance()->getPressure()->create( Pressure::createNotValid() );
+      continue;
+    }
+    Time time = sim_time.start_time + (time_t)time_value;
     
+    // cached and result db hits are served on the calling thread
+    ret_value[i] = readPressureSum( tx_coordz, rx_coordz, start_frequency, end_frequency, getDbTime( time ) );
+    
+    if ( ret_value[i] != NULL ) continue;
+    
+    if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() index = " << i << " not in db, submitting to thread pool" << ::std::endl;
+    
+    PressureTask* task = new PressureTask( this, coordinates[i], start_frequency, end_frequency, time );
+    tasks.push_back( ::std::make_pair( i, task ) );
+    getThreadPool()->submit( task );
+  }
+  
+  for ( int j = 0; j < (int) tasks.size(); j++ ) {
+    tasks[j].second->wait();
+    ret_value[ tasks[j].first ] = tasks[j].second->result;
+    delete tasks[j].second;
+  }
+  
+  endVectorQuery();
+  return ret_value;
+}
+
+
+TimeArrVector WossManagerResDbMT::getWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, const Time& time_value ) {
+  if ( concurrent_threads < 0 ) return WossManager::getWossTimeArr( coordinates, start_frequency, end_frequency, time_value );
+
+  beginVectorQuery();
+  
+  TimeArrVector ret_value( coordinates.size(), (TimeArr*)NULL );
+  ::std::vector< ::std::pair< int, TimeArrTask* > > tasks;
+  CoordZPairVect miss_coordinates;
+  
+  for ( int i = 0; i < (int) coordinates.size(); i++ ) {
+    const CoordZ& tx_coordz = coordinates[i].first;
+    const CoordZ& rx_coordz = coordinates[i].second;
+
+    if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) {
+      ret_value[i] = SDefHandler::instance()->getTimeArr()->create( TimeArr::createImpulse() ); // it is the same node!
+      continue;
+    }
+    
+    // cached and result db hits are served on the calling thread
+    ret_value[i] = readTimeArrSum( tx_coordz, rx_coordz, start_frequency, end_frequency, getDbTime( time_value ) );
+    
+    if ( ret_value[i] != NULL ) continue;
+    
+    if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() index = " << i << " not in db, submitting to thread pool" << ::std::endl;
+    
+    tasks.push_back( ::std::make_pair( i, new TimeArrTask( this, coordinates[i], start_frequency, end_frequency, time_value ) ) );
+    miss_coordinates.push_back( coordinates[i] );
+  }
+  
+  if ( !tasks.empty() ) {
+    pthread_spin_lock( &request_mutex );
+    prepareTimeArrWoss( miss_coordinates, start_frequency, end_frequency );
     pthread_spin_unlock( &request_mutex );
-    return sum;
   }
   
-  sum->clear();
+  for ( int j = 0; j < (int) tasks.size(); j++ ) {
+    getThreadPool()->submit( tasks[j].second );
+  }
+  
+  for ( int j = 0; j < (int) tasks.size(); j++ ) {
+    tasks[j].second->wait();
+    ret_value[ tasks[j].first ] = tasks[j].second->result;
+    delete tasks[j].second;
+  }
+  
+  endVectorQuery();
+  return ret_value;
+}
 
-  if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() NO valid TimeArr in db found" 
-                           << ", getting a Woss object." << ::std::endl;
+
+TimeArrVector WossManagerResDbMT::getWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value ) {
+  if ( concurrent_threads < 0 ) return WossManager::getWossTimeArr( coordinates, start_frequency, end_frequency, time_value );
+
+  beginVectorQuery();
   
-  Woss* const curr_woss = getWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
+  TimeArrVector ret_value( coordinates.size(), (TimeArr*)NULL );
+  ::std::vector< ::std::pair< int, TimeArrTask* > > tasks;
+  CoordZPairVect miss_coordinates;
   
-  if ( curr_woss->isRunning() ) {
-    AWIter it = active_woss.find( curr_woss ); 
+  for ( int i = 0; i < (int) coordinates.size(); i++ ) {
+    const CoordZ& tx_coordz = coordinates[i].first;
+    const CoordZ& rx_coordz = coordinates[i].second;
+
+    if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) {
+      ret_value[i] = SDefHandler::instance()->getTimeArr()->create( TimeArr::createImpulse() ); // it is the same node!
+      continue;
+    }
     
-    if ( it != active_woss.end() ) {
+    SimTime sim_time = woss_creator->getSimTime( tx_coordz, rx_coordz );
+    if ( !sim_time.start_time.isValid() ) {
+      ::std::cout << "WossManagerResDbMT::getWossTimeArr() WARNING, invalid start time for tx = " << tx_coordz << "; rx = " 
+                  << rx_coordz << ::std::endl;
 
-      if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() curr Woss is running." 
-                               << " Waiting for it to finish..."<< ::std::endl;
-          
-      assert( it->second != NULL );
-      
-      pthread_spin_unlock( &request_mutex );
+      ret_value[i] = SDefHandler::instance()->getTimeArr()->create( TimeArr::createNotValid() );
+      continue;
+    }
+    Time time = sim_time.start_time + (time_t)time_value;
+    
+    // cached and result db hits are served on the calling thread
+    ret_value[i] = readTimeArrSum( tx_coordz, rx_coordz, start_frequency, end_frequency, getDbTime( time ) );
+    
+    if ( ret_value[i] != NULL ) continue;
+    
+    if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() index = " << i << " not in db, submitting to thread pool" << ::std::endl;
+    
+    tasks.push_back( ::std::make_pair( i, new TimeArrTask( this, coordinates[i], start_frequency, end_frequency, time ) ) );
+    miss_coordinates.push_back( coordinates[i] );
+  }
+  
+  if ( !tasks.empty() ) {
+    pthread_spin_lock( &request_mutex );
+    prepareTimeArrWoss( miss_coordinates, start_frequency, end_frequency );
+    pthread_spin_unlock( &request_mutex );
+  }
+  
+  for ( int j = 0; j < (int) tasks.size(); j++ ) {
+    getThreadPool()->submit( tasks[j].second );
+  }
+  
+  for ( int j = 0; j < (int) tasks.size(); j++ ) {
+    tasks[j].second->wait();
+    ret_value[ tasks[j].first ] = tasks[j].second->result;
+    delete tasks[j].second;
+  }
+  
+  endVectorQuery();
+  return ret_value;
+}
 
-      pthread_mutex_lock( &(it->second->mutex) );
-      pthread_cond_wait( &(it->second->condition), &(it->second->mutex) );
-      pthread_mutex_unlock( &(it->second->mutex) ); 
+
+void WossManagerResDbMT::prefetchWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value ) {
+  if ( concurrent_threads < 0 || woss_db_manager == NULL ) return;
+  
+  beginVectorQuery();
+  
+  for ( int i = 0; i < (int) coordinates.size(); i++ ) {
+    const CoordZ& tx_coordz = coordinates[i].first;
+    const CoordZ& rx_coordz = coordinates[i].second;
+
+    if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) continue;
+    
+    SimTime sim_time = woss_creator->getSimTime( tx_coordz, rx_coordz );
+    if ( !sim_time.start_time.isValid() ) continue;
+    
+    Time time = sim_time.start_time + (time_t)time_value;
+    const Time& db_time = getDbTime( time );
+    
+    TimeArr* sum = readTimeArrSum( tx_coordz, rx_coordz, start_frequency, end_frequency, db_time, true );
+    
+    if ( sum != NULL ) {
+      delete sum;
+      continue;
+    }
+    
+    pthread_mutex_lock( &creation_mutex );
+    Woss* const curr_woss = woss_creator->createWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
+    bool is_ok = curr_woss->timeEvolve( time );
+    pthread_mutex_unlock( &creation_mutex );
+    
+    if ( is_ok && curr_woss->isRunNeeded() ) is_ok = curr_woss->run();
+    
+    if ( debug ) ::std::cout << "WossManagerResDbMT::prefetchWossTimeArr() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
+                             << "; time = " << time << "; is ok = " << is_ok << ::std::endl;
+    
+    if ( is_ok ) {
+      sum = SDefHandler::instance()->getTimeArr()->create();
+      ::std::vector< ::std::pair< double, TimeArr* > > results;
+      
+      // the private Woss is read without request_mutex, which only guards the insert queue
+      for( FreqSIt it = curr_woss->freq_lower_bound( start_frequency ); it == curr_woss->freq_lower_bound( end_frequency ); ++it ) {
+        results.push_back( ::std::make_pair( *it, curr_woss->getTimeArr( *it, tx_coordz.getDepth(), rx_coordz.getDepth(), tx_coordz.getGreatCircleDistance( rx_coordz ) ) ) ); 
+        *sum += *(results.back().second);
+      }
       
       pthread_spin_lock( &request_mutex );
+      for ( int j = 0; j < (int) results.size(); j++ ) {
+        dbQueueTimeArr( tx_coordz, rx_coordz, results[j].first, db_time, *(results[j].second) );
+        delete results[j].second;
+      }
+      pthread_spin_unlock( &request_mutex );
+      
+      WossResultKey key( tx_coordz, rx_coordz, start_frequency, end_frequency, db_time );
+      
+      timearr_cache.insert( key, *sum );
+      addPrefetchKey( key );
+      delete sum;
     }
+    
+    delete curr_woss;
   }
-  else {    
-    bool has_to_run = curr_woss->timeEvolve(time_value);
-    bool is_ok = true;
+  
+  endVectorQuery();
+}
+
+
+TimeArr* WossManagerResDbMT::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
+  return WossManagerResDb::getWossTimeArr( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+}
 
-    if ( has_to_run )
-       active_woss[curr_woss] = new ThreadCondSignal();
-    
-    pthread_spin_unlock( &request_mutex );
 
-    if ( has_to_run ) is_ok = curr_woss->run();
-    assert( is_ok );
+TimeArr* WossManagerResDbMT::computeWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
+   
+  if ( concurrent_threads < 0 ) return WossManagerResDb::computeWossTimeArr( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+  
+  if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossTimeArr() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
+                           << "; start freq = " << start_frequency << "; end freq = " << end_frequency 
+                           << "; distance = " << tx_coordz.getCartDistance( rx_coordz ) << ::std::flush
+                           << "; time_value = " << time_value << ::std::endl; 
+  
+  WossMetricsTimer timer( WOSS_METRICS_MANAGER_QUERY );
+  
+  const Time& time = getDbTime( time_value );
+  
+  TimeArr* sum = readTimeArrSum( tx_coordz, rx_coordz, start_frequency, end_frequency, time );
+
+  if ( sum != NULL ) {
     
-    pthread_spin_lock( &request_mutex );
+    if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossTimeArr() valid TimeArr in db found." << ::std::endl;
+    
+    return sum;
+  }
+  
+  sum = SDefHandler::instance()->getTimeArr()->create();
+  TimeArr* curr_time_arr = NULL;
 
-    if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() curr Woss was active and has now run." 
-                              << ::std::endl;
-  }  
+  if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossTimeArr() NO valid TimeArr in db found" 
+                           << ", getting a Woss object." << ::std::endl;
   
-  if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() curr Woss object has run." << ::std::endl;
+  pthread_spin_lock( &request_mutex );
+
+  Woss* const curr_woss = getTimeArrWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
+  
+  runWoss( curr_woss, time_value );
+  
+  if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossTimeArr() curr Woss object has run." << ::std::endl;
   
   for( FreqSIt it = curr_woss->freq_lower_bound( start_frequency ); it == curr_woss->freq_lower_bound( end_frequency ); ++it ) {
     curr_time_arr = curr_woss->getTimeArr( *it, tx_coordz.getDepth(), rx_coordz.getDepth(), tx_coordz.getGreatCircleDistance( rx_coordz ) ) ; 
-    dbInsertTimeArr( tx_coordz, rx_coordz, *it, *time, *curr_time_arr );
+    dbQueueTimeArr( tx_coordz, rx_coordz, *it, time, *curr_time_arr );
     *sum += *curr_time_arr;
     delete curr_time_arr;
     curr_time_arr = NULL;
   }
   
-  if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() TimeArr computed = " << *sum << ::std::endl;
-   
-  AWIter it = active_woss.find( curr_woss ); 
-  if ( it != active_woss.end() ) {
-    assert( it->second != NULL );
-    
-    pthread_mutex_lock( &(it->second->mutex) );
-    pthread_cond_broadcast( &(it->second->condition) );
-    pthread_mutex_unlock( &(it->second->mutex) );    
-    
-    delete it->second;
-    active_woss.erase(it);
-  }
-
   pthread_spin_unlock( &request_mutex );
   
+  dbFlushInserts( false );
+  
+  if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossTimeArr() TimeArr computed = " << *sum << ::std::endl;
+  
+  if ( woss_db_manager != NULL ) timearr_cache.insert( WossResultKey( tx_coordz, rx_coordz, start_frequency, end_frequency, time ), *sum );
+  
   return sum; 
 }
 
@@ -911,8 +1549,6 @@ TimeArr* WossManagerResDbMT::getWossTimeArr( const CoordZ& tx_coordz, const Coor
 TimeArr* WossManagerResDbMT::getWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, double time_value ) {
   if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) return( SDefHandler::instance()->getTimeArr()->create( TimeArr::createImpulse() ) ); // it is the same node!
  
-  pthread_spin_lock( &request_mutex );
- 
   if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
                            << "; start freq = " << start_frequency << "; end freq = " << end_frequency << "; distance = " << tx_coordz.getCartDistance( rx_coordz ) 
                            << "; time_value = " << time_value << ::std::endl; 
@@ -923,155 +1559,78 @@ TimeArr* WossManagerResDbMT::getWossTimeArr( const CoordZ& tx_coordz, const Coor
     
     if ( debug ) ::std::cout << "WossManagerResDbMT::getWossTimeArr() time converted = " << time << ::std::endl;
     
-    pthread_spin_unlock( &request_mutex );
-    
     return getWossTimeArr(tx_coordz, rx_coordz, start_frequency, end_frequency, time );
   }
   else {
     ::std::cout << "WossManagerResDbMT::getWossTimeArr() WARNING, invalid start time for tx = " << tx_coordz << "; rx = " 
                 << rx_coordz << ::std::endl;
           
-    pthread_spin_unlock( &request_mutex );
-    
     return NULL;
   }  
 }
 
 
 Pressure* WossManagerResDbMT::getWossPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
-  if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) return( SDefHandler::instance()->getPressure()->create(1.0, 0) ); // it is the same node!
+  return WossManagerResDb::getWossPressure( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+}
+
+
+Pressure* WossManagerResDbMT::computeWossPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value ) {
   
-  if ( concurrent_threads < 0 ) return WossManagerResDb::getWossPressure( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
+  if ( concurrent_threads < 0 ) return WossManagerResDb::computeWossPressure( tx_coordz, rx_coordz, start_frequency, end_frequency, time_value );
 
-  if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
+  if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossPressure() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
                            << "; start freq = " << start_frequency << "; end freq = " << end_frequency 
                            << "; distance = " << tx_coordz.getCartDistance( rx_coordz ) 
                            << "; time_value = " << time_value << ::std::endl; 
   
-  bool valid = true;
-  double freq_step = woss_creator->getFrequencyStep(tx_coordz,rx_coordz);
-  
-  pthread_spin_lock( &request_mutex );
-  
-  const Time* time = NULL;
-  
-  if ( is_time_evolution_active == false ) {
-    time = &NO_EVOLUTION_TIME;
-  }
-  else 
-    time = &time_value;
+  WossMetricsTimer timer( WOSS_METRICS_MANAGER_QUERY );
   
-  Pressure* temp = dbGetPressure( tx_coordz, rx_coordz, start_frequency, *time );
-  TimeArr* sum_avg = SDefHandler::instance()->getTimeArr()->create( *temp );
-  delete temp;
-  temp = NULL;
+  const Time& time = getDbTime( time_value );
   
-  valid = valid && sum_avg->isValid();
+  Pressure* ret_val = readPressureSum( tx_coordz, rx_coordz, start_frequency, end_frequency, time );
   
-  int i = 1;
-  Pressure* curr_press = NULL;
-  for( ; i <= floor( ( end_frequency - start_frequency) / freq_step ); i++ ) {
-      curr_press = dbGetPressure( tx_coordz, rx_coordz, (start_frequency + ((double)i) * freq_step), *time );
-      
-      valid = valid && curr_press->isValid();
-      if (!valid) {
-        delete curr_press;
-        curr_press = NULL;
-        break;
-      }
-      *sum_avg += *curr_press;
-      delete curr_press;
-      curr_press = NULL;
-  }
-  if (valid) {
-    Pressure* ret_val = SDefHandler::instance()->getPressure()->create( *sum_avg );
-    delete sum_avg;
-    sum_avg = NULL;
+  if ( ret_val != NULL ) {
 
-    if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() valid Pressure in db found." << ::std::endl;
-    
-    pthread_spin_unlock( &request_mutex );
+    if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossPressure() valid Pressure in db found." << ::std::endl;
 
     return ret_val;
   }
   
-  delete curr_press;
-  curr_press = NULL;
-  
-  sum_avg->clear();
+  TimeArr* sum_avg = SDefHandler::instance()->getTimeArr()->create();
+  Pressure* curr_press = NULL;
 
-  if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() NO valid Pressure in db found." 
+  if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossPressure() NO valid Pressure in db found." 
                            << ", getting a Woss object." << ::std::endl;
   
+  pthread_spin_lock( &request_mutex );
+  
   Woss* const curr_woss = getWoss( tx_coordz, rx_coordz, start_frequency, end_frequency );
   
-  if ( curr_woss->isRunning() ) {
-    AWIter it = active_woss.find( curr_woss ); 
-    
-    if ( it != active_woss.end() ) {
-
-      if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() curr Woss is running." 
-                               << " Waiting for it to finish..."<< ::std::endl;
-          
-      assert( it->second != NULL );
-      
-      pthread_spin_unlock( &request_mutex );
-
-      pthread_mutex_lock( &(it->second->mutex) );
-      pthread_cond_wait( &(it->second->condition), &(it->second->mutex) );
-      pthread_mutex_unlock( &(it->second->mutex) ); 
-      
-      pthread_spin_lock( &request_mutex );
-    }
-  }
-  else {    
-    bool has_to_run = curr_woss->timeEvolve(time_value);
-    bool is_ok = true;
-
-    if ( has_to_run )
-       active_woss[curr_woss] = new ThreadCondSignal();
-    
-    pthread_spin_unlock( &request_mutex );
-
-    if ( has_to_run ) is_ok = curr_woss->run();
-    assert( is_ok );
-    
-    pthread_spin_lock( &request_mutex );
-
-    if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() curr Woss was active and has now run." 
-                              << ::std::endl;
-  } 
+  runWoss( curr_woss, time_value );
   
-  if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() curr Woss object has run." << ::std::endl;
+  if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossPressure() curr Woss object has run." << ::std::endl;
   
   for( FreqSIt it = curr_woss->freq_lower_bound( start_frequency ); it == curr_woss->freq_lower_bound( end_frequency ); it++ ) {
     curr_press = curr_woss->getAvgPressure( *it, tx_coordz.getDepth() ) ; 
-    dbInsertPressure( tx_coordz, rx_coordz, *it, *time, *curr_press );
+    dbQueuePressure( tx_coordz, rx_coordz, *it, time, *curr_press );
     *sum_avg += *curr_press;
     delete curr_press;
     curr_press = NULL;
   }
   
+  pthread_spin_unlock( &request_mutex );
+  
+  dbFlushInserts( false );
+  
   Pressure* ret_value = SDefHandler::instance()->getPressure()->create( *sum_avg );
   
   delete sum_avg;
   sum_avg = NULL;
   
-  if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() Pressure computed = " << *ret_value << ::std::endl;
+  if ( debug ) ::std::cout << "WossManagerResDbMT::computeWossPressure() Pressure computed = " << *ret_value << ::std::endl;
   
-  AWIter it = active_woss.find( curr_woss ); 
-  if ( it != active_woss.end() ) {
-    assert( it->second != NULL );
-    
-    pthread_mutex_lock( &(it->second->mutex) );
-    pthread_cond_broadcast( &(it->second->condition) );
-    pthread_mutex_unlock( &(it->second->mutex) );    
-    
-    delete it->second;
-    active_woss.erase(it);
-  }
-
-  pthread_spin_unlock( &request_mutex );
+  if ( woss_db_manager != NULL ) pressure_cache.insert( WossResultKey( tx_coordz, rx_coordz, start_frequency, end_frequency, time ), *ret_value );
 
   return( ret_value ); 
 }
@@ -1080,8 +1639,6 @@ Pressure* WossManagerResDbMT::getWossPressure( const CoordZ& tx_coordz, const Co
 Pressure* WossManagerResDbMT::getWossPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, double time_value ) {
   if ( tx_coordz.getCartDistance( rx_coordz ) == 0 ) return( SDefHandler::instance()->getPressure()->create(1.0, 0) ); // it is the same node!
  
-  pthread_spin_lock( &request_mutex );
-  
   if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() tx coords = " << tx_coordz << "; rx coords = " << rx_coordz
                            << "; start freq = " << start_frequency << "; end freq = " << end_frequency 
                            << "; distance = " << tx_coordz.getCartDistance( rx_coordz ) 
@@ -1093,16 +1650,12 @@ Pressure* WossManagerResDbMT::getWossPressure( const CoordZ& tx_coordz, const Co
     
     if ( debug ) ::std::cout << "WossManagerResDbMT::getWossPressure() time converted = " << time << ::std::endl;
     
-    pthread_spin_unlock( &request_mutex );
-    
     return getWossPressure(tx_coordz, rx_coordz, start_frequency, end_frequency, time );
   }
   else {
     ::std::cout << "WossManagerResDbMT::getWossPressure() WARNING, invalid start time for tx = " << tx_coordz << "; rx = " 
                 << rx_coordz << ::std::endl;
           
-    pthread_spin_unlock( &request_mutex );
-    
     return NULL;
   }  
 }
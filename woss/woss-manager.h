@@ -41,10 +41,15 @@
 #define WOSS_MANAGER_DEFINITIONS_H
 
 
+#include <set>
+#include <deque>
 #include <definitions-handler.h>
 #include <time-arrival-definitions.h>
 #include "woss-creator.h"
 #include <woss-db-manager.h>
+#include "woss-thread-pool.h"
+#include "woss-result-cache.h"
+#include "woss-metrics.h"
 
 
 namespace woss {
@@ -208,6 +213,22 @@ namespace woss {
     **/
     virtual TimeArrVector getWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value = 0.0 );
    
+    /**
+    * Computes in advance the TimeArr of given links and stores them in the result db, 
+    * without evolving the Woss objects that serve the regular queries. By default it does nothing
+    * @param coordinates const reference to a valid CoordZPairVect
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value number of seconds after start time
+    **/
+    virtual void prefetchWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value ) { }
+    
+    /**
+    * Returns the number of queries served by a result computed by prefetchWossTimeArr(). By default it returns 0
+    * @returns number of queries
+    **/
+    virtual unsigned long getPrefetchHits() { return 0; }
+    
     
     /**
     * Deletes all created Woss instances
@@ -274,15 +295,94 @@ namespace woss {
     **/
     virtual Woss* const getWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency ) = 0;
     
+    /**
+    * Returns a pointer to a properly initialized Woss able to compute the TimeArr of given tx-rx pair.
+    * The returned Woss may be shared by other pairs, so it has to be queried with the pair depths and range.
+    * By default it returns getWoss()
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @returns pointer to a valid Woss object
+    **/
+    virtual Woss* const getTimeArrWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency ) { return getWoss( tx, rx, start_frequency, end_frequency ); }
+    
+    /**
+    * Creates in advance the Woss objects that will be needed by a TimeArr vector query. By default it does nothing
+    * @param coordinates const reference to a valid CoordZPairVect
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    **/
+    virtual void prepareTimeArrWoss( const CoordZPairVect& coordinates, double start_frequency, double end_frequency ) { }
+    
+    /**
+    * Called before a WossCreator call made by getWoss(), getTimeArrWoss() or prepareTimeArrWoss(). 
+    * Multi-threaded managers release here the request lock held by the caller, so that the creation 
+    * and initialization of a Woss don't stall the other requests. By default it does nothing
+    **/
+    virtual void beginWossCreation() { }
+    
+    /**
+    * Called after a WossCreator call, it reacquires the request lock. Shared containers may have changed 
+    * in between, so they have to be looked up again. By default it does nothing
+    **/
+    virtual void endWossCreation() { }
+    
+    /**
+    * Checks if given Woss may still be used by a concurrent request, so it can't be deleted yet. 
+    * <b>The request lock must be held</b> by multi-threaded managers. By default it returns <i>false</i>
+    * @param woss_ptr pointer to a Woss created by this manager
+    * @return <i>true</i> if the Woss is in use, <i>false</i> otherwise
+    **/
+    virtual bool isWossInUse( const Woss* const woss_ptr ) const { return false; }
+    
+    /**
+    * Called by eraseActiveWoss() before it removes Woss objects. Multi-threaded managers acquire here 
+    * the request lock, so that isWossInUse() can be checked. By default it does nothing
+    **/
+    virtual void beginWossErasure() { }
+    
+    /**
+    * Called by eraseActiveWoss() after it removed Woss objects, it releases the request lock. By default it does nothing
+    **/
+    virtual void endWossErasure() { }
+    
     
   };
 
 
+  /**
+  * Default normalized amplitude error between two bracketing evolution snapshots above which 
+  * the channel is recomputed at the requested time
+  */
+  #define WOSS_DEFAULT_SNAPSHOT_ERROR_BOUND (0.1)
+  
+  /**
+  * Default max delay difference [s] between two arrivals matched by the snapshot interpolation
+  */
+  #define WOSS_DEFAULT_SNAPSHOT_DELAY_TOLERANCE (1.0e-3)
+  
+  /**
+  * Default energy weighted rms delay drift [s] between the matched arrivals of two bracketing evolution snapshots
+  * above which the channel is recomputed at the requested time
+  */
+  #define WOSS_DEFAULT_SNAPSHOT_DELAY_ERROR_BOUND (1.0e-4)
+  
+  /**
+  * Max number of evolution snapshots kept in memory for every link, the oldest ones are dropped first
+  */
+  #define WOSS_SNAPSHOTS_PER_LINK (3)
+  
+  
   /**
   * \brief Abstract class that implements WossManager. It adds computed results dbs control
   *
   * WossManagerResDb adds control over optional computed dbs control. If dbs are present and valid requested TimeArr
-  * or Pressure is returned, no channel simulator is run
+  * or Pressure is returned, no channel simulator is run. 
+  * If snapshot interpolation is active, only the channels at the multiples of the link evolution time quantum 
+  * are computed and stored into the result dbs, while the requests in between are interpolated from the 
+  * two bracketing snapshots. Snapshots are kept as immutable results, so that the interpolated requests 
+  * never evolve the Woss of the link
   */
   class WossManagerResDb : public WossManager {
 
@@ -292,7 +392,7 @@ namespace woss {
       
     WossManagerResDb();
     
-    virtual ~WossManagerResDb() {}
+    virtual ~WossManagerResDb();
     
 
     /**
@@ -347,6 +447,42 @@ namespace woss {
     **/
     WossManagerResDb& setWossDbManager( const WossDbManager* const ptr ) { woss_db_manager = ptr; return *this; }
     
+    /**
+    * Activates the interpolation between evolution snapshots. It is used only if time evolution is active
+    * and the link has a positive evolution time quantum
+    * @param flag <i>true</i> to activate the interpolation
+    **/
+    void setSnapshotInterpolationFlag( bool flag ) { is_snapshot_interpolation_active = flag; }
+    
+    /**
+    * Sets the normalized amplitude error between the two bracketing snapshots above which 
+    * the channel is recomputed at the requested time
+    * @param value error bound, 0 means that the snapshots have to be equal
+    **/
+    void setSnapshotErrorBound( double value ) { snapshot_error_bound = value; }
+    
+    /**
+    * Sets the max delay difference between two arrivals matched by the snapshot interpolation
+    * @param value delay tolerance [s]
+    **/
+    void setSnapshotDelayTolerance( double value ) { snapshot_delay_tolerance = value; }
+    
+    /**
+    * Sets the energy weighted rms delay drift between the matched arrivals of the two bracketing snapshots 
+    * above which the channel is recomputed at the requested time
+    * @param value delay error bound [s]
+    **/
+    void setSnapshotDelayErrorBound( double value ) { snapshot_delay_error_bound = value; }
+    
+    
+    bool getSnapshotInterpolationFlag() const { return is_snapshot_interpolation_active; }
+    
+    double getSnapshotErrorBound() const { return snapshot_error_bound; }
+    
+    double getSnapshotDelayTolerance() const { return snapshot_delay_tolerance; }
+    
+    double getSnapshotDelayErrorBound() const { return snapshot_delay_error_bound; }
+    
     
     protected:
       
@@ -357,6 +493,142 @@ namespace woss {
     const WossDbManager* woss_db_manager;
     
     
+    /**
+    * Snapshot interpolation flag
+    **/
+    bool is_snapshot_interpolation_active;
+    
+    /**
+    * Normalized amplitude error bound between the two bracketing snapshots
+    **/
+    double snapshot_error_bound;
+    
+    /**
+    * Max delay difference [s] between two matched arrivals
+    **/
+    double snapshot_delay_tolerance;
+    
+    /**
+    * Energy weighted rms delay drift bound [s] between the two bracketing snapshots
+    **/
+    double snapshot_delay_error_bound;
+    
+    
+    /**
+    * Link ( tx, rx ) and frequency range of a stored snapshot
+    **/
+    typedef ::std::pair< CoordZPair, SimFreq > SnapshotLink;
+    
+    /**
+    * Snapshots of a link, sorted by time. Pressure snapshots are stored as a single arrival with zero delay
+    **/
+    typedef ::std::map< Time, TimeArr* > SnapshotTimeMap;
+    typedef SnapshotTimeMap::iterator STMIter;
+    
+    typedef ::std::map< SnapshotLink, SnapshotTimeMap > SnapshotMap;
+    typedef SnapshotMap::iterator SMIter;
+    
+    /**
+    * Stored TimeArr snapshots
+    **/
+    SnapshotMap timearr_snapshots;
+    
+    /**
+    * Stored Pressure snapshots
+    **/
+    SnapshotMap pressure_snapshots;
+    
+#ifdef WOSS_MULTITHREAD
+    /**
+    * Mutex protecting the stored snapshots
+    **/
+    pthread_mutex_t snapshot_mutex;
+#endif // WOSS_MULTITHREAD
+    
+    
+    /**
+    * Returns a valid TimeArr for given parameters, reading it from the result db or running the channel simulator
+    * at the requested time
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value const reference to a valid Time& object
+    * @returns valid TimeArr value
+    **/
+    virtual TimeArr* computeWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value );
+    
+    /**
+    * Returns a valid Pressure for given parameters, reading it from the result db or running the channel simulator
+    * at the requested time
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value const reference to a valid Time object
+    * @returns valid Pressure value
+    **/
+    virtual Pressure* computeWossPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value );
+    
+    
+    /**
+    * Finds the two evolution snapshots that bracket the requested time
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param time_value const reference to a valid Time object
+    * @param before reference to the snapshot time before <i>time_value</i>
+    * @param after reference to the snapshot time after <i>time_value</i>
+    * @param weight reference to the interpolation weight of the <i>after</i> snapshot, in ( 0, 1 )
+    * @returns <i>true</i> if the request has to be interpolated, <i>false</i> otherwise 
+    **/
+    bool getSnapshotTimes( const CoordZ& tx, const CoordZ& rx, const Time& time_value, Time& before, Time& after, double& weight ) const;
+    
+    /**
+    * Interpolates two snapshots. Arrivals are matched by delay; matched arrivals have their delay, amplitude and phase
+    * interpolated, the others are faded in or out.
+    * <b>User is responsible of pointer's ownership</b>
+    * @param before const reference to the snapshot before the requested time
+    * @param after const reference to the snapshot after the requested time
+    * @param weight interpolation weight of the <i>after</i> snapshot
+    * @param error reference to the normalized amplitude error between the two snapshots
+    * @param delay_error reference to the energy weighted rms delay drift [s] of the matched arrivals
+    * @returns heap-created interpolated TimeArr
+    **/
+    TimeArr* interpolateSnapshots( const TimeArr& before, const TimeArr& after, double weight, double& error, double& delay_error ) const;
+    
+    /**
+    * Returns a copy of the snapshot stored for given link and time. A missing snapshot is read from the 
+    * result db or computed once and then stored. Snapshots are requested in time order, so the Woss of the link 
+    * only moves forward from one snapshot to the next one.
+    * <b>User is responsible of pointer's ownership</b>
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param snapshot_time const reference to the snapshot Time
+    * @param is_pressure <i>true</i> for a Pressure snapshot, <i>false</i> for a TimeArr one
+    * @returns heap-created TimeArr, NULL if the snapshot is not valid
+    **/
+    TimeArr* getSnapshot( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& snapshot_time, bool is_pressure );
+    
+    /**
+    * Erases all stored snapshots
+    **/
+    void clearSnapshots();
+    
+    /**
+    * Returns the TimeArr interpolated between two snapshots, or computed at the requested time if 
+    * the snapshots differ more than snapshot_error_bound or snapshot_delay_error_bound
+    **/
+    TimeArr* getInterpolatedTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value, const Time& before, const Time& after, double weight );
+    
+    /**
+    * Returns the Pressure interpolated between two snapshots, or computed at the requested time if 
+    * the snapshots differ more than snapshot_error_bound or snapshot_delay_error_bound
+    **/
+    Pressure* getInterpolatedPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value, const Time& before, const Time& after, double weight );
+    
+    
     /**
     * Returns a TimeArr* from a WossResTimeArrDb for given parameters.
     * <b>User is responsible of pointer's ownership</b>
@@ -412,6 +684,7 @@ namespace woss {
 
 
   inline TimeArr* WossManagerResDb::dbGetTimeArr( const CoordZ& tx, const CoordZ& rx, double frequency, const Time& time_value ) const {
+    WossMetricsTimer timer( WOSS_METRICS_RES_DB_READ );
     if ( woss_db_manager ) return( woss_db_manager->getTimeArr( tx, rx, frequency, time_value ) );
     return( SDefHandler::instance()->getTimeArr()->create( TimeArr::createNotValid() ) );
   }
@@ -423,6 +696,7 @@ namespace woss {
 
 
   inline Pressure* WossManagerResDb::dbGetPressure( const CoordZ& tx, const CoordZ& rx, double frequency, const Time& time_value ) const {
+    WossMetricsTimer timer( WOSS_METRICS_RES_DB_READ );
     if ( woss_db_manager ) return( woss_db_manager->getPressure( tx, rx, frequency, time_value ) );
     return( SDefHandler::instance()->getPressure()->create( Pressure::createNotValid() ) );
   }
@@ -431,23 +705,33 @@ namespace woss {
   #ifdef WOSS_MULTITHREAD
   
   
-  #include <set>
-  
-  
   /**
   * Max number of active threads
   */
   #define MAX_TOTAL_PTHREAD 32 
   
+  /**
+  * Default number of result db insertions queued by single queries before being written
+  */
+  #define WOSS_DEFAULT_DB_INSERT_BATCH 1
+  
+  /**
+  * Max number of prefetched results tracked for the prefetch hit count. The oldest ones are dropped first
+  */
+  #define WOSS_MAX_PREFETCH_KEYS (65536)
+  
   
   /**
   * \brief Multi-threaded extension of WossManagerResDb
   *
   * WossManagerResDbMT is a multi-threaded extension of WossManagerResDb. It uses the pthread library</b>.
   * This class is optimized for multi-processor cpu.<b>Don't use it if a multi-processor cpu is not installed</b>.
-  * <i>Please notice that simulation will suffer an heavy time penalty if a result db is used and Woss objects 
-  * are not run</i>. This is due to the thread creation and synchronization overhead. Therefore no multi-thread should
-  * be used when reading already computed channel simulator data.
+  * Vector queries are scheduled on a persistent WossThreadPool: results already stored in the result dbs 
+  * are read on the calling thread, while only the queries that need a channel simulator run
+  * are submitted to the worker threads.
+  * When a WossDbManager is set, results are also kept in two sharded WossResultCache, so that repeated 
+  * queries are served without taking the global request lock. Result db insertions are queued and
+  * written in batches; result db reads and writes are serialized by their own mutex, outside the request lock.
   */
   class WossManagerResDbMT : public WossManagerResDb {
 
@@ -463,6 +747,18 @@ namespace woss {
     virtual ~WossManagerResDbMT();
     
     
+    /**
+    * Returns a const reference to a valid and properly initialized woss::Woss object, 
+    * looked up under request_mutex
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @returns const reference to a valid woss::Woss object
+    **/
+    virtual const Woss& getActiveWoss( const CoordZ& tx, const CoordZ& rx, double start_frequency, double end_frequency ) const;
+    
+    
     /**
     * Returns a valid Pressure for given parameters
     * @param tx const reference to a valid CoordZ object ( transmitter )
@@ -549,6 +845,25 @@ namespace woss {
     **/
     virtual TimeArrVector getWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value );
     
+    /**
+    * Computes in advance the TimeArr of given links that are missing from the result db. 
+    * Every link is computed by a private Woss created, evolved and deleted on the calling thread, 
+    * so that the shared ones are never evolved ahead of the simulation. It does nothing if 
+    * no WossDbManager is set or if multi-threading is disabled
+    * @param coordinates const reference to a valid CoordZPairVect
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value number of seconds after start time
+    **/
+    virtual void prefetchWossTimeArr( const CoordZPairVect& coordinates, double start_frequency, double end_frequency, double time_value );
+    
+    /**
+    * Returns the number of queries served by a result computed by prefetchWossTimeArr(). 
+    * Every prefetched result is counted at most once
+    * @returns number of queries
+    **/
+    virtual unsigned long getPrefetchHits();
+    
     /**
     * Sets the number of concurrent threads. If <i>number</i> < 0 multi-threading is disabled. 
     * If <i>number</i> = 0 the thread number is automatically handled.
@@ -563,91 +878,200 @@ namespace woss {
     int getConcurrentThreads() { return concurrent_threads; }
     
     
-    friend void* WMSMTcreateThreadTimeArr( void* ptr );
-      
-    friend void* WMSMTcreateThreadPressure( void* ptr );       
+    /**
+    * Sets the total number of results kept by each result cache. If <i>size</i> <= 0 the caches are disabled.
+    * <b>It must not be called while queries are in progress</b>
+    * @param size number of results
+    **/
+    void setResultCacheSize( int size ) { timearr_cache.setSize( size ); pressure_cache.setSize( size ); }
+
+    /**
+    * Gets the total number of results kept by each result cache
+    * @returns number of results
+    **/
+    int getResultCacheSize() const { return timearr_cache.getSize(); }
+    
+    /**
+    * Sets the number of result db insertions queued by single queries before being written. 
+    * Vector queries always write their insertions when they end.
+    * @param size number of insertions, values < 1 are considered as 1
+    **/
+    void setDbInsertBatchSize( int size ) { db_insert_batch_size = ::std::max( 1, size ); }
 
+    /**
+    * Gets the number of result db insertions queued by single queries before being written
+    * @returns number of insertions
+    **/
+    int getDbInsertBatchSize() const { return db_insert_batch_size; }
+    
+    /**
+    * Writes all queued insertions into the result dbs. 
+    * It should be called before closing the connections of the result dbs
+    **/
+    void flushDbInserts();
+    
     
     protected:   
     
     
     /**
-    * Type for storing current queries
+    * \brief Pool task that computes a TimeArr query
     */
-    //typedef ::std::pair< CoordZPairVect, SimFreq > ThreadQuery;
-    struct ThreadQuery {
+    class TimeArrTask : public WossThreadTask {
+      
+      
+      public:
+      
+      
+      TimeArrTask( WossManagerResDbMT* manager, const CoordZPair& coords, double start_freq, double end_freq, const Time& time );
+      
+      virtual ~TimeArrTask() { }
+      
+      virtual void execute();
+      
+      /**
+      * Valid after wait(). <b>User is responsible of pointer's ownership</b>
+      **/
+      TimeArr* result;
       
       
-      CoordZPairVect coordz_pair_vect;
+      protected:
+      
+      
+      WossManagerResDbMT* manager_ptr;
+      
+      CoordZPair coordz_pair;
       
       SimFreq sim_freq;
-
-      int curr_index;
       
-      struct {
-          bool is_time_object;
-          
-          Time time_cal;
-          
-          double time_double;
-          
-      } time_data;
+      Time time_value;
+      
       
     };
     
     
     /**
-    * Type used by an active query thread
+    * \brief Pool task that computes a Pressure query
     */
-//     typedef ::std::pair< CoordZPair, SimFreq > ThreadParam;
-    struct ThreadParam {
+    class PressureTask : public WossThreadTask {
+      
+      
+      public:
+      
+      
+      PressureTask( WossManagerResDbMT* manager, const CoordZPair& coords, double start_freq, double end_freq, const Time& time );
+      
+      virtual ~PressureTask() { }
+      
+      virtual void execute();
+      
+      /**
+      * Valid after wait(). <b>User is responsible of pointer's ownership</b>
+      **/
+      Pressure* result;
       
       
+      protected:
+      
+      
+      WossManagerResDbMT* manager_ptr;
+      
       CoordZPair coordz_pair;
       
       SimFreq sim_freq;
       
-      struct {
-          bool is_time_object;
-          
-          Time time_cal;
-          
-          double time_double;
-          
-      } time_data;
+      Time time_value;
       
       
     };
     
     
     /**
-    * Type used by an active query thread
-    */ 
-    typedef ::std::pair< int, ThreadParam > ThreadParamIndex;
-    
+    * \brief Future of a Woss::run() call
+    *
+    * WossRunTask is executed by the thread that has evolved the Woss, while the other threads 
+    * that need the same Woss wait() on it. It is shared by reference count, <b>request_mutex must be held</b>
+    * when the references are changed.
+    */
+    class WossRunTask : public WossThreadTask {
+      
+      
+      public:
+      
+      
+      WossRunTask( Woss* woss ) : WossThreadTask(), is_ok(false), references(1), woss_ptr(woss) { }
+      
+      virtual ~WossRunTask() { }
+      
+      virtual void execute() { is_ok = woss_ptr->run(); }
+      
+      /**
+      * Executes the task on the calling thread and wakes up all waiting threads
+      **/
+      void runInline() { execute(); setDone(); }
+      
+      /**
+      * Valid after wait()
+      **/
+      bool is_ok;
+      
+      /**
+      * Number of threads holding the task
+      **/
+      int references;
+      
+      
+      protected:
+      
+      
+      Woss* woss_ptr;
+      
+      
+    };
     
-    struct ThreadCondSignal {
     
+    /**
+    * \brief Queued result db insertion
+    */
+    template < typename Value >
+    struct DbInsert {
+      
       
-      ThreadCondSignal() { pthread_mutex_init( &mutex, NULL ); pthread_cond_init( &condition, NULL );  }
+      DbInsert( const CoordZ& tx, const CoordZ& rx, double freq, const Time& time, const Value& val ) 
+      : tx_coordz(tx), rx_coordz(rx), frequency(freq), time_value(time), value(val) { }
       
-      ~ThreadCondSignal() { pthread_mutex_destroy( &mutex ); pthread_cond_destroy( &condition ); }
       
+      CoordZ tx_coordz;
       
-      pthread_mutex_t mutex;
+      CoordZ rx_coordz;
       
-      pthread_cond_t condition;
+      double frequency;
+      
+      Time time_value;
+      
+      Value value;
       
       
     };
     
+    typedef ::std::vector< DbInsert< TimeArr > > TimeArrInsertVector;
+    typedef ::std::vector< DbInsert< Pressure > > PressureInsertVector;
+    
     
-    typedef ::std::map< Woss*, ThreadCondSignal* > ActiveWoss;
+    typedef ::std::map< Woss*, WossRunTask* > ActiveWoss;
     typedef ActiveWoss::iterator AWIter;
     typedef ActiveWoss::reverse_iterator AWRIter;
     typedef ActiveWoss::const_iterator AWCIter;
     typedef ActiveWoss::const_reverse_iterator AWCRIter;
     
+    typedef ::std::map< const Woss*, int > WossUsers;
+    typedef WossUsers::iterator WUIter;
+    typedef WossUsers::const_iterator WUCIter;
+    
+    typedef ::std::set< WossResultKey > PrefetchKeySet;
+    typedef PrefetchKeySet::iterator PKSIter;
+    typedef ::std::deque< WossResultKey > PrefetchKeyDeque;
+    
     
     /**
     * Max number of created threads
@@ -655,69 +1079,103 @@ namespace woss {
     int max_thread_number;    
     
     /**
-    * Number of queries
+    * Max number of concurrent threads
+    **/
+    int concurrent_threads;
+    
+    
+    /**
+    * Persistent pool of worker threads, lazily created with concurrent_threads workers
     **/
-    int total_queries;
+    WossThreadPool* thread_pool;
+    
 
     /**
-    * Max number of concurrent threads
+    * Secondary spinlock
     **/
-    int concurrent_threads;
+    pthread_spinlock_t request_mutex;
     
-       
     /**
-    * Number of created threads
+    * Serializes the Woss creations made without request_mutex with the time evolutions made with it, 
+    * since both of them query the environmental dbs
     **/
-    volatile int total_thread_created;
-       
+    pthread_mutex_t creation_mutex;
+    
     /**
-    * Total number of completed threads
+    * Serializes the result db accesses, so that they are made without request_mutex. 
+    * It is always acquired before request_mutex
     **/
-    volatile int total_thread_ended;
-        
-
+    pthread_mutex_t db_mutex;
+   
+      
+    /**
+    * Running Woss objects and their futures. <b>request_mutex must be held</b>
+    **/   
+    ActiveWoss active_woss;
+    
     /**
-    * pthread id associated to the creation croller thread
+    * Number of threads that released request_mutex inside runWoss() for each Woss. <b>request_mutex must be held</b>
+    **/   
+    WossUsers woss_users;
+    
+    
+    /**
+    * Cache of computed or stored TimeArr sums
     **/
-    pthread_t thread_controller;
+    WossResultCache< TimeArr > timearr_cache;
     
     /**
-    * Array of pthread ids associated to the created query threads
+    * Cache of computed or stored Pressure averages
     **/
-    pthread_t thread_arr[MAX_TOTAL_PTHREAD];
+    WossResultCache< Pressure > pressure_cache;
+    
     
-
     /**
-    * Master spinlock
+    * Guards prefetch_keys, prefetch_key_order and prefetch_hits
     **/
-    pthread_spinlock_t mutex;
+    pthread_mutex_t prefetch_mutex;
     
     /**
-    * Secondary spinlock
+    * Keys of the results computed by prefetchWossTimeArr() that have not been queried yet
     **/
-    pthread_spinlock_t request_mutex;
-   
+    PrefetchKeySet prefetch_keys;
     
     /**
-    * Storage for current queries
+    * Keys computed by prefetchWossTimeArr() in insertion order, used to bound prefetch_keys
     **/
-    ThreadQuery thread_query;
-      
+    PrefetchKeyDeque prefetch_key_order;
     
     /**
-    * The computation of current queries
+    * Size of prefetch_keys, read without prefetch_mutex so that queries skip it when nothing has been prefetched
     **/
-    TimeArrVector thread_time_arr_reply;
+    volatile int total_prefetch_keys;
     
     /**
-    * The computation of current queries
+    * Number of queries served by a prefetched result
     **/
-    PressureVector thread_pressure_reply;
-      
+    unsigned long prefetch_hits;
+    
+    
     /**
-    * Set of current active Woss objects
-    **/   
-    ActiveWoss active_woss;
+    * Queued TimeArr insertions. <b>request_mutex must be held</b>
+    **/
+    TimeArrInsertVector timearr_inserts;
+    
+    /**
+    * Queued Pressure insertions. <b>request_mutex must be held</b>
+    **/
+    PressureInsertVector pressure_inserts;
+    
+    /**
+    * Number of insertions queued by single queries before being written
+    **/
+    int db_insert_batch_size;
+    
+    /**
+    * Number of vector queries in progress. <b>request_mutex must be held</b>
+    **/
+    int active_vector_queries;
+    
     
     /**
     * Sets concurrent_threads valid range
@@ -725,51 +1183,189 @@ namespace woss {
     void checkConcurrentThreads();
     
     /**
-    * Initializes variable for current query round
+    * Returns the thread pool, (re)creating it if its size doesn't match concurrent_threads
+    * @returns pointer to a valid WossThreadPool
     **/
-    void initThreadVars();
-
-
+    WossThreadPool* getThreadPool();
+    
+    
     /**
-    * Returns a valid ThreadParamIndex for a requesting thread
-    * @returns valid ThreadParamIndex
+    * Sums all TimeArr stored in the result db for given parameters. <b>db_mutex must be held</b>.
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value const reference to the db Time object
+    * @returns heap-created TimeArr if all frequencies are found, NULL otherwise
     **/
-    ThreadParamIndex popThreadParamIndex();
-
+    TimeArr* dbGetTimeArrSum( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value );
+    
+    /**
+    * Averages all Pressure stored in the result db for given parameters. <b>db_mutex must be held</b>.
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value const reference to the db Time object
+    * @returns heap-created Pressure if all frequencies are found, NULL otherwise
+    **/
+    Pressure* dbGetPressureSum( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value );
     
     /**
-    * Insert the given TimeArr pointer in the TimeArrVector reply at given index
-    * @param index vector index
-    * @param time_arr pointer to a heap-created TimeArr
+    * Returns the Time object used as result db key
+    * @param time_value const reference to a valid Time object
+    * @returns const reference to the db Time object
     **/
-    void insertThreadReplyTimeArr( int index, woss::TimeArr* time_arr );
+    const Time& getDbTime( const Time& time_value ) const { return( is_time_evolution_active ? time_value : NO_EVOLUTION_TIME ); }
+    
     
     /**
-    * Insert the given Pressure pointer in the PressureVector reply at given index
-    * @param index vector index
-    * @param pressure pointer to a heap-created Pressure
+    * Returns the TimeArr sum from the cache or from the result db, filling the cache. It takes db_mutex on a cache miss.
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value const reference to the db Time object
+    * @param is_prefetch <i>true</i> if called by prefetchWossTimeArr(), so that the hit is not counted as a prefetch hit
+    * @returns heap-created TimeArr if found, NULL otherwise
     **/
-    void insertThreadReplyPressure( int index, woss::Pressure* pressure );
-         
-   
+    TimeArr* readTimeArrSum( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value, bool is_prefetch = false );
+    
+    /**
+    * Returns the Pressure average from the cache or from the result db, filling the cache. It takes db_mutex on a cache miss.
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value const reference to the db Time object
+    * @returns heap-created Pressure if found, NULL otherwise
+    **/
+    Pressure* readPressureSum( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value );
+    
+    /**
+    * Records given key as computed by prefetchWossTimeArr()
+    * @param key const reference to the result key
+    **/
+    void addPrefetchKey( const WossResultKey& key );
+    
+    /**
+    * Counts a prefetch hit if given key has been computed by prefetchWossTimeArr() and not queried yet
+    * @param key const reference to the result key
+    **/
+    void checkPrefetchHit( const WossResultKey& key );
+    
+    /**
+    * Evolves and runs given Woss, or waits for the thread that is already running it. 
+    * <b>request_mutex must be held</b>, it is released while the Woss runs.
+    * @param curr_woss pointer to a valid Woss
+    * @param time_value const reference to a valid Time object
+    **/
+    void runWoss( Woss* const curr_woss, const Time& time_value );
+    
+    /**
+    * Releases request_mutex and acquires creation_mutex. 
+    * <b>request_mutex must be held</b> if concurrent_threads >= 0
+    **/
+    virtual void beginWossCreation();
+    
+    /**
+    * Releases creation_mutex and reacquires request_mutex
+    **/
+    virtual void endWossCreation();
+    
+    /**
+    * Checks if a thread is running or waiting for given Woss. <b>request_mutex must be held</b> if concurrent_threads >= 0
+    **/
+    virtual bool isWossInUse( const Woss* const woss_ptr ) const;
+    
+    /**
+    * Acquires request_mutex if concurrent_threads >= 0
+    **/
+    virtual void beginWossErasure();
+    
+    /**
+    * Releases request_mutex if concurrent_threads >= 0
+    **/
+    virtual void endWossErasure();
+    
+    /**
+    * Releases request_mutex while given Woss is used by runWoss(), keeping track of its users
+    **/
+    void releaseRequestLock( const Woss* const woss_ptr );
+    
+    /**
+    * Reacquires request_mutex after releaseRequestLock()
+    **/
+    void acquireRequestLock( const Woss* const woss_ptr );
+    
+    /**
+    * Drops a reference to given WossRunTask, deleting it when unused. <b>request_mutex must be held</b>
+    * @param task pointer to a valid WossRunTask
+    **/
+    void releaseRunTask( WossRunTask* task );
+    
+    /**
+    * Queues a TimeArr insertion. <b>request_mutex must be held</b>. The queue is written by dbFlushInserts()
+    **/
+    void dbQueueTimeArr( const CoordZ& tx, const CoordZ& rx, double frequency, const Time& time_value, const TimeArr& channel );
+    
+    /**
+    * Queues a Pressure insertion. <b>request_mutex must be held</b>. The queue is written by dbFlushInserts()
+    **/
+    void dbQueuePressure( const CoordZ& tx, const CoordZ& rx, double frequency, const Time& time_value, const Pressure& press );
+    
+    /**
+    * Writes the queued insertions into the result dbs. <b>request_mutex must not be held</b>
+    * @param is_forced <i>false</i> to write them only if no vector query is in progress and a batch is full
+    **/
+    void dbFlushInserts( bool is_forced = true );
+    
+    /**
+    * Takes the queued insertions under request_mutex and writes them. <b>db_mutex must be held</b>, 
+    * request_mutex must not be held
+    * @param is_forced <i>false</i> to write them only if no vector query is in progress and a batch is full
+    **/
+    void dbWriteInserts( bool is_forced );
+    
+    /**
+    * Marks the beginning of a vector query
+    **/
+    void beginVectorQuery();
+    
+    /**
+    * Marks the end of a vector query, writing the queued insertions if no other vector query is in progress
+    **/
+    void endVectorQuery();
+    
+    
+    /**
+    * Returns a valid TimeArr for given parameters, reading it from the result cache, from the result db 
+    * or running the channel simulator at the requested time
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value const reference to a valid Time object
+    * @returns valid TimeArr value
+    **/
+    virtual TimeArr* computeWossTimeArr( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value );
+    
+    /**
+    * Returns a valid Pressure for given parameters, reading it from the result cache, from the result db 
+    * or running the channel simulator at the requested time
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value const reference to a valid Time object
+    * @returns valid Pressure value
+    **/
+    virtual Pressure* computeWossPressure( const CoordZ& tx_coordz, const CoordZ& rx_coordz, double start_frequency, double end_frequency, const Time& time_value );
+    
+    
   };
   
   
-  /**
-  * Function used for TimeArr thread creation
-  * @param ptr void pointer
-  * @returns void pointer
-  **/
-  void* WMSMTcreateThreadTimeArr( void* ptr );
-  
-  /**
-  * Function used for Pressure thread creation
-  * @param ptr void pointer
-  * @returns void pointer
-  **/
-  void* WMSMTcreateThreadPressure( void* ptr );
-  
-  
 #endif // WOSS_MULTITHREAD
   
   
@@ -0,0 +1,283 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   woss-metrics.cpp
+ * @author Federico Guerra
+ * 
+ * \brief Provides the implementation of woss::WossMetrics class
+ *
+ * Provides the implementation of woss::WossMetrics class
+ */
+
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <time.h>
+#include "woss-metrics.h"
+
+
+using namespace woss;
+
+
+bool WossMetrics::enabled = false;
+
+WossMetrics::BlockVector WossMetrics::blocks;
+
+#ifdef WOSS_MULTITHREAD
+
+pthread_mutex_t WossMetrics::blocks_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+pthread_key_t WossMetrics::block_key;
+
+pthread_once_t WossMetrics::block_key_once = PTHREAD_ONCE_INIT;
+
+#endif // WOSS_MULTITHREAD
+
+
+static const char* const woss_metrics_timer_names[WOSS_METRICS_TOTAL_TIMERS] = {
+  "manager_query", "res_db_read", "env_db_read", "woss_run", "write_cfg", "solver_run", "res_read" 
+};
+
+static const char* const woss_metrics_counter_names[WOSS_METRICS_TOTAL_COUNTERS] = {
+  "res_db_hits", "res_db_misses", "res_cache_hits", "solver_failures", "snapshot_interpolations", "snapshot_recomputations",
+  "solver_cache_hits", "solver_cache_misses"
+};
+
+
+void WossMetrics::Block::clear() {
+  ::std::memset( this, 0, sizeof(Block) );
+}
+
+
+void WossMetrics::Block::add( const Block& block ) {
+  for ( int i = 0; i < WOSS_METRICS_TOTAL_TIMERS; i++ ) {
+    timer_count[i] += block.timer_count[i];
+    timer_total[i] += block.timer_total[i];
+    if ( block.timer_max[i] > timer_max[i] ) timer_max[i] = block.timer_max[i];
+    
+    for ( int j = 0; j < WOSS_METRICS_HISTOGRAM_BUCKETS; j++ ) histogram[i][j] += block.histogram[i][j];
+  }
+  
+  for ( int i = 0; i < WOSS_METRICS_TOTAL_COUNTERS; i++ ) counters[i] += block.counters[i];
+}
+
+
+const char* WossMetrics::getTimerName( WossMetricsTimerType type ) {
+  return woss_metrics_timer_names[type];
+}
+
+
+const char* WossMetrics::getCounterName( WossMetricsCounterType type ) {
+  return woss_metrics_counter_names[type];
+}
+
+
+int64_t WossMetrics::getTime() {
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return (int64_t)now.tv_sec * 1000000000LL + (int64_t)now.tv_nsec;
+}
+
+
+#ifdef WOSS_MULTITHREAD
+
+void WossMetrics::createBlockKey() {
+  // blocks are kept in blocks after their thread exits
+  pthread_key_create( &block_key, NULL );
+}
+
+#endif // WOSS_MULTITHREAD
+
+
+WossMetrics::Block* WossMetrics::getBlock() {
+#ifdef WOSS_MULTITHREAD
+  pthread_once( &block_key_once, createBlockKey );
+  
+  Block* block = static_cast< Block* >( pthread_getspecific( block_key ) );
+  
+  if ( block == NULL ) {
+    block = new Block;
+    block->clear();
+    
+    pthread_mutex_lock( &blocks_mutex );
+    blocks.push_back( block );
+    pthread_mutex_unlock( &blocks_mutex );
+    
+    pthread_setspecific( block_key, block );
+  }
+  return block;
+#else
+  if ( blocks.empty() ) {
+    blocks.push_back( new Block );
+    blocks.back()->clear();
+  }
+  return blocks.back();
+#endif // WOSS_MULTITHREAD
+}
+
+
+void WossMetrics::addTime( WossMetricsTimerType type, int64_t nanoseconds ) {
+  Block* block = getBlock();
+  
+  if ( nanoseconds < 0 ) nanoseconds = 0;
+  
+  block->timer_count[type]++;
+  block->timer_total[type] += nanoseconds;
+  if ( nanoseconds > block->timer_max[type] ) block->timer_max[type] = nanoseconds;
+  
+  int bucket = 0;
+  for ( int64_t micros = nanoseconds / 1000; micros > 1 && bucket < WOSS_METRICS_HISTOGRAM_BUCKETS - 1; micros >>= 1 ) bucket++;
+  
+  block->histogram[type][bucket]++;
+}
+
+
+void WossMetrics::recordCount( WossMetricsCounterType type, int64_t value ) {
+  getBlock()->counters[type] += value;
+}
+
+
+void WossMetrics::reset() {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &blocks_mutex );
+#endif // WOSS_MULTITHREAD
+  
+  for ( int i = 0; i < (int)blocks.size(); i++ ) blocks[i]->clear();
+  
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &blocks_mutex );
+#endif // WOSS_MULTITHREAD
+}
+
+
+::std::vector< WossMetrics::Block > WossMetrics::getBlocks() {
+  ::std::vector< Block > ret_value;
+  Block total;
+  total.clear();
+  
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &blocks_mutex );
+#endif // WOSS_MULTITHREAD
+  
+  for ( int i = 0; i < (int)blocks.size(); i++ ) {
+    ret_value.push_back( *blocks[i] );
+    total.add( *blocks[i] );
+  }
+  
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &blocks_mutex );
+#endif // WOSS_MULTITHREAD
+  
+  ret_value.push_back( total );
+  return ret_value;
+}
+
+
+bool WossMetrics::writeCsv( const ::std::string& filename ) {
+  ::std::ofstream f_out( filename.c_str() );
+  if ( !f_out.is_open() ) return false;
+  
+  ::std::vector< Block > thread_blocks = getBlocks();
+  
+  f_out << "thread,metric,count,total_ns,mean_ns,max_ns";
+  for ( int j = 0; j < WOSS_METRICS_HISTOGRAM_BUCKETS; j++ ) f_out << ",hist_" << j;
+  f_out << ::std::endl;
+  
+  for ( int i = 0; i < (int)thread_blocks.size(); i++ ) {
+    const Block& block = thread_blocks[i];
+    
+    // the last block is the total of all threads
+    ::std::string thread = "total";
+    if ( i < (int)thread_blocks.size() - 1 ) {
+      ::std::ostringstream str_out;
+      str_out << i;
+      thread = str_out.str();
+    }
+    
+    for ( int t = 0; t < WOSS_METRICS_TOTAL_TIMERS; t++ ) {
+      f_out << thread << "," << woss_metrics_timer_names[t] << "," << block.timer_count[t] << "," << block.timer_total[t] 
+            << "," << ( block.timer_count[t] > 0 ? block.timer_total[t] / block.timer_count[t] : 0 ) << "," << block.timer_max[t];
+      
+      for ( int j = 0; j < WOSS_METRICS_HISTOGRAM_BUCKETS; j++ ) f_out << "," << block.histogram[t][j];
+      f_out << ::std::endl;
+    }
+    
+    for ( int c = 0; c < WOSS_METRICS_TOTAL_COUNTERS; c++ ) {
+      f_out << thread << "," << woss_metrics_counter_names[c] << "," << block.counters[c] << ",,,";
+      for ( int j = 0; j < WOSS_METRICS_HISTOGRAM_BUCKETS; j++ ) f_out << ",";
+      f_out << ::std::endl;
+    }
+  }
+  
+  return true;
+}
+
+
+bool WossMetrics::writeJson( const ::std::string& filename ) {
+  ::std::ofstream f_out( filename.c_str() );
+  if ( !f_out.is_open() ) return false;
+  
+  ::std::vector< Block > thread_blocks = getBlocks();
+  
+  f_out << "{" << ::std::endl << "  \"histogram_bucket_us\": \"[2^i, 2^(i+1))\"," << ::std::endl << "  \"threads\": [" << ::std::endl;
+  
+  for ( int i = 0; i < (int)thread_blocks.size(); i++ ) {
+    const Block& block = thread_blocks[i];
+    
+    if ( i < (int)thread_blocks.size() - 1 ) f_out << "    { \"thread\": " << i << "," << ::std::endl;
+    else f_out << "    { \"thread\": \"total\"," << ::std::endl;
+    
+    f_out << "      \"timers\": {" << ::std::endl;
+    
+    for ( int t = 0; t < WOSS_METRICS_TOTAL_TIMERS; t++ ) {
+      f_out << "        \"" << woss_metrics_timer_names[t] << "\": { \"count\": " << block.timer_count[t] 
+            << ", \"total_ns\": " << block.timer_total[t] << ", \"max_ns\": " << block.timer_max[t] << ", \"histogram\": [";
+      
+      for ( int j = 0; j < WOSS_METRICS_HISTOGRAM_BUCKETS; j++ ) f_out << ( j > 0 ? ", " : "" ) << block.histogram[t][j];
+      
+      f_out << "] }" << ( t < WOSS_METRICS_TOTAL_TIMERS - 1 ? "," : "" ) << ::std::endl;
+    }
+    
+    f_out << "      }," << ::std::endl << "      \"counters\": {";
+    
+    for ( int c = 0; c < WOSS_METRICS_TOTAL_COUNTERS; c++ ) {
+      f_out << ( c > 0 ? ", " : " " ) << "\"" << woss_metrics_counter_names[c] << "\": " << block.counters[c];
+    }
+    
+    f_out << " }" << ::std::endl << "    }" << ( i < (int)thread_blocks.size() - 1 ? "," : "" ) << ::std::endl;
+  }
+  
+  f_out << "  ]" << ::std::endl << "}" << ::std::endl;
+  
+  return true;
+}
+
+
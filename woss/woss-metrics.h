@@ -0,0 +1,279 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   woss-metrics.h
+ * @author Federico Guerra
+ * 
+ * \brief Provides the interface for woss::WossMetrics and woss::WossMetricsTimer classes
+ *
+ * Provides the interface for woss::WossMetrics and woss::WossMetricsTimer classes
+ */
+
+
+#ifndef WOSS_METRICS_DEFINITIONS_H
+#define WOSS_METRICS_DEFINITIONS_H
+
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#ifdef WOSS_MULTITHREAD
+#include <pthread.h>
+#endif // WOSS_MULTITHREAD
+
+
+namespace woss {
+  
+  
+  /**
+  * Number of histogram buckets of a timer. Bucket i counts the samples in [ 2^i, 2^(i+1) ) microseconds, 
+  * bucket 0 also counts faster samples and the last bucket also counts slower ones
+  */
+  #define WOSS_METRICS_HISTOGRAM_BUCKETS (32)
+  
+  
+  /**
+  * Timed stages of the WOSS query pipeline
+  */
+  typedef enum {
+    WOSS_METRICS_MANAGER_QUERY = 0, ///< single link channel query of a WossManagerResDb
+    WOSS_METRICS_RES_DB_READ, ///< result db lookup
+    WOSS_METRICS_ENV_DB_READ, ///< WossDbManager environmental lookup
+    WOSS_METRICS_WOSS_RUN, ///< Woss::run()
+    WOSS_METRICS_WRITE_CFG, ///< acoustic toolbox configuration files writing
+    WOSS_METRICS_SOLVER_RUN, ///< acoustic toolbox system() call
+    WOSS_METRICS_RES_READ, ///< acoustic toolbox result files parsing
+    WOSS_METRICS_TOTAL_TIMERS
+  } WossMetricsTimerType;
+  
+  
+  /**
+  * Counted events of the WOSS query pipeline
+  */
+  typedef enum {
+    WOSS_METRICS_RES_DB_HITS = 0, ///< channel queries answered by the result db
+    WOSS_METRICS_RES_DB_MISSES, ///< channel queries that needed a Woss run
+    WOSS_METRICS_RES_CACHE_HITS, ///< channel queries answered by the WossManagerResDbMT result cache
+    WOSS_METRICS_SOLVER_FAILURES, ///< acoustic toolbox runs that failed
+    WOSS_METRICS_SNAPSHOT_INTERPOLATIONS, ///< channel queries interpolated between two evolution snapshots
+    WOSS_METRICS_SNAPSHOT_RECOMPUTATIONS, ///< channel queries recomputed because the evolution snapshots were too different
+    WOSS_METRICS_SOLVER_CACHE_HITS, ///< acoustic toolbox runs answered by the BellhopCacheSolver
+    WOSS_METRICS_SOLVER_CACHE_MISSES, ///< acoustic toolbox runs not found by the BellhopCacheSolver
+    WOSS_METRICS_TOTAL_COUNTERS
+  } WossMetricsCounterType;
+  
+  
+  /**
+  * \brief Built-in metrics of the WOSS query pipeline
+  *
+  * WossMetrics collects monotonic-clock timers, with their latency histograms, and counters for each stage 
+  * of the query pipeline. Each thread records into its own block, so no lock is taken on the recording path. 
+  * When metrics are disabled, recording costs a single branch. Metrics should be written and reset 
+  * when no query is running.
+  **/
+  class WossMetrics {
+    
+    
+    public:
+    
+    
+    /**
+    * Enables or disables the collection of metrics
+    * @param flag <i>true</i> to collect metrics
+    **/
+    static void setEnabled( bool flag ) { enabled = flag; }
+    
+    /**
+    * Returns the collection status
+    * @return <i>true</i> if metrics are collected
+    **/
+    static bool isEnabled() { return enabled; }
+    
+    
+    /**
+    * Returns the monotonic clock
+    * @return current monotonic time [ns]
+    **/
+    static int64_t getTime();
+    
+    
+    /**
+    * Records a timer sample in the calling thread block
+    * @param type timer type
+    * @param nanoseconds sample duration [ns]
+    **/
+    static void addTime( WossMetricsTimerType type, int64_t nanoseconds );
+    
+    /**
+    * Adds to a counter of the calling thread block, if metrics are enabled
+    * @param type counter type
+    * @param value value to add
+    **/
+    static void addCount( WossMetricsCounterType type, int64_t value = 1 ) { if ( enabled ) recordCount( type, value ); }
+    
+    
+    /**
+    * Clears all recorded metrics
+    **/
+    static void reset();
+    
+    
+    /**
+    * Writes the metrics of each thread and their total to a CSV file
+    * @param filename output file name
+    * @return <i>true</i> if the file was written
+    **/
+    static bool writeCsv( const ::std::string& filename );
+    
+    /**
+    * Writes the metrics of each thread and their total to a JSON file
+    * @param filename output file name
+    * @return <i>true</i> if the file was written
+    **/
+    static bool writeJson( const ::std::string& filename );
+    
+    
+    static const char* getTimerName( WossMetricsTimerType type );
+    
+    static const char* getCounterName( WossMetricsCounterType type );
+    
+    
+    protected:
+    
+    
+    /**
+    * \brief Metrics recorded by a single thread
+    **/
+    struct Block {
+      
+      int64_t timer_count[WOSS_METRICS_TOTAL_TIMERS];
+      
+      int64_t timer_total[WOSS_METRICS_TOTAL_TIMERS]; // [ns]
+      
+      int64_t timer_max[WOSS_METRICS_TOTAL_TIMERS]; // [ns]
+      
+      int64_t histogram[WOSS_METRICS_TOTAL_TIMERS][WOSS_METRICS_HISTOGRAM_BUCKETS];
+      
+      int64_t counters[WOSS_METRICS_TOTAL_COUNTERS];
+      
+      
+      void clear();
+      
+      void add( const Block& block );
+      
+    };
+    
+    typedef ::std::vector< Block* > BlockVector;
+    
+    
+    static bool enabled;
+    
+    /**
+    * Blocks of all the threads that recorded metrics, in order of first record. They live until the program ends.
+    **/
+    static BlockVector blocks;
+    
+#ifdef WOSS_MULTITHREAD
+    
+    static pthread_mutex_t blocks_mutex;
+    
+    static pthread_key_t block_key;
+    
+    static pthread_once_t block_key_once;
+    
+    static void createBlockKey();
+    
+#endif // WOSS_MULTITHREAD
+    
+    
+    static void recordCount( WossMetricsCounterType type, int64_t value );
+    
+    
+    /**
+    * Returns the block of the calling thread, creating it on first use
+    * @return block pointer
+    **/
+    static Block* getBlock();
+    
+    /**
+    * Returns a copy of the thread blocks followed by their total
+    * @return blocks
+    **/
+    static ::std::vector< Block > getBlocks();
+    
+    
+  };
+  
+  
+  /**
+  * \brief Scoped timer of a WossMetrics stage
+  *
+  * WossMetricsTimer records the time elapsed between its construction and its destruction, or stop()
+  **/
+  class WossMetricsTimer {
+    
+    
+    public:
+    
+    
+    WossMetricsTimer( WossMetricsTimerType type )
+    : timer_type(type), 
+      start_time( WossMetrics::isEnabled() ? WossMetrics::getTime() : -1 )
+    { }
+    
+    ~WossMetricsTimer() { stop(); }
+    
+    
+    /**
+    * Records the time elapsed since construction, further calls do nothing
+    **/
+    void stop() {
+      if ( start_time >= 0 ) WossMetrics::addTime( timer_type, WossMetrics::getTime() - start_time ); 
+      start_time = -1;
+    }
+    
+    
+    protected:
+    
+    
+    WossMetricsTimerType timer_type;
+    
+    int64_t start_time;
+    
+    
+  };
+  
+  
+}
+
+
+#endif /* WOSS_METRICS_DEFINITIONS_H */
+
+
@@ -0,0 +1,422 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   woss-result-cache.h
+ * @author Federico Guerra
+ *
+ * \brief Provides the interface for woss::WossResultKey and woss::WossResultCache classes
+ *
+ * Provides the interface for woss::WossResultKey and woss::WossResultCache classes
+ */
+
+
+#ifndef WOSS_RESULT_CACHE_H
+#define WOSS_RESULT_CACHE_H
+
+
+#ifdef WOSS_MULTITHREAD
+
+
+#include <map>
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <stdint.h>
+#include <pthread.h>
+#include <coordinates-definitions.h>
+#include <time-definitions.h>
+
+
+namespace woss {
+
+
+  /**
+  * Default number of shards of a WossResultCache, must be a power of two
+  */
+  #define WOSS_RESULT_CACHE_SHARDS 64
+
+  /**
+  * Default total number of results held by a WossResultCache
+  */
+  #define WOSS_RESULT_CACHE_DEFAULT_SIZE 8192
+
+  /**
+  * Size in decimal degrees of the tx/rx cells used to pick a shard
+  */
+  #define WOSS_RESULT_CACHE_CELL_SIZE (1.0e-2)
+
+
+  /**
+  * \brief Key of a channel result
+  *
+  * WossResultKey identifies a result computed for a transmitter, a receiver, a frequency range and 
+  * a result db time. Coordinates are compared exactly.
+  */
+  class WossResultKey {
+
+
+    public:
+
+
+    /**
+    * WossResultKey constructor
+    * @param tx const reference to a valid CoordZ object ( transmitter )
+    * @param rx const reference to a valid CoordZ object ( receiver )
+    * @param start_freq start frequency [Hz]
+    * @param end_freq end frequency [Hz]
+    * @param time_value const reference to the result db Time object
+    **/
+    WossResultKey( const CoordZ& tx, const CoordZ& rx, double start_freq, double end_freq, const Time& time_value );
+
+
+    /**
+    * Returns the index of the shard holding this key. The index only depends on the tx and rx cells
+    * of WOSS_RESULT_CACHE_CELL_SIZE degrees, so all queries of a link land in the same shard
+    * @param total_shards number of shards, must be a power of two
+    * @returns shard index
+    **/
+    size_t getShard( size_t total_shards ) const;
+
+
+    friend bool operator<( const WossResultKey& left, const WossResultKey& right );
+
+
+    protected:
+
+
+    double tx_lat;
+
+    double tx_long;
+
+    double tx_depth;
+
+    double rx_lat;
+
+    double rx_long;
+
+    double rx_depth;
+
+    double start_frequency;
+
+    double end_frequency;
+
+    time_t time;
+
+
+  };
+
+
+  /**
+  * \brief Sharded read-mostly cache of channel results
+  *
+  * WossResultCache keeps a copy of the results returned by the result dbs or computed by the channel
+  * simulators. Keys are spread over WOSS_RESULT_CACHE_SHARDS shards by tx/rx cell, each shard has its own 
+  * read-write lock: concurrent lookups only take the shared read lock of their shard and never contend 
+  * with lookups or insertions made on other shards.
+  * When a shard is full a victim is chosen with the CLOCK policy: lookups mark their entry as referenced 
+  * with an atomic store made under the read lock, the clock hand of the shard clears the marks it meets 
+  * and evicts the first entry that wasn't referenced since its last visit.
+  */
+  template < typename Value >
+  class WossResultCache {
+
+
+    public:
+
+
+    /**
+    * WossResultCache constructor
+    * @param size total number of results held, <= 0 disables the cache
+    **/
+    WossResultCache( int size = WOSS_RESULT_CACHE_DEFAULT_SIZE );
+
+    ~WossResultCache();
+
+
+    /**
+    * Sets the total number of results held. The cache is cleared.
+    * @param size total number of results held, <= 0 disables the cache
+    **/
+    void setSize( int size );
+
+    /**
+    * Returns the total number of results held
+    * @returns total number of results
+    **/
+    int getSize() const { return total_size; }
+
+    /**
+    * Checks if the cache is enabled
+    * @returns <i>true</i> if size > 0, <i>false</i> otherwise
+    **/
+    bool isEnabled() const { return total_size > 0; }
+
+
+    /**
+    * Copies the value stored for given key
+    * @param key const reference to a valid WossResultKey
+    * @param value reference to the Value that will hold the copy
+    * @returns <i>true</i> if the key was found, <i>false</i> otherwise
+    **/
+    bool find( const WossResultKey& key, Value& value ) const;
+
+    /**
+    * Stores a copy of given value
+    * @param key const reference to a valid WossResultKey
+    * @param value const reference to the Value to be stored
+    **/
+    void insert( const WossResultKey& key, const Value& value );
+
+    /**
+    * Erases all stored values
+    **/
+    void clear();
+
+
+    protected:
+
+
+    /**
+    * \brief Stored value and its CLOCK reference bit
+    **/
+    struct Entry {
+
+      Entry( const Value& val ) : value(val), referenced(0) { }
+
+      Value value;
+
+      /**
+      * Set by find() under the read lock, cleared by the clock hand under the write lock
+      **/
+      mutable volatile int referenced;
+
+    };
+
+    typedef ::std::map< WossResultKey, Entry > ValueMap;
+    typedef typename ValueMap::iterator VMIter;
+    typedef typename ValueMap::const_iterator VMCIter;
+
+
+    /**
+    * \brief Shard of a WossResultCache
+    **/
+    struct Shard {
+
+      Shard() : values(), clock(), hand(0) { }
+
+      mutable pthread_rwlock_t lock;
+
+      ValueMap values;
+
+      /**
+      * Clock of the stored entries, in insertion order
+      **/
+      ::std::vector< VMIter > clock;
+
+      /**
+      * Current position of the clock hand
+      **/
+      size_t hand;
+
+    };
+
+
+    /**
+    * Total number of results held
+    **/
+    int total_size;
+
+    /**
+    * Max number of results per shard
+    **/
+    size_t shard_size;
+
+    /**
+    * Shards, allocated once
+    **/
+    ::std::vector< Shard* > shards;
+
+
+    private:
+
+
+    WossResultCache( const WossResultCache& copy );
+
+    WossResultCache& operator=( const WossResultCache& copy );
+
+
+  };
+
+
+  //inline functions
+  //////////
+  inline WossResultKey::WossResultKey( const CoordZ& tx, const CoordZ& rx, double start_freq, double end_freq, const Time& time_value )
+  : tx_lat( tx.getLatitude() ),
+    tx_long( tx.getLongitude() ),
+    tx_depth( tx.getDepth() ),
+    rx_lat( rx.getLatitude() ),
+    rx_long( rx.getLongitude() ),
+    rx_depth( rx.getDepth() ),
+    start_frequency( start_freq ),
+    end_frequency( end_freq ),
+    time( (time_t)time_value )
+  {
+
+  }
+
+
+  inline size_t WossResultKey::getShard( size_t total_shards ) const {
+    uint64_t hash = (uint64_t)(int64_t) ::std::floor( tx_lat / WOSS_RESULT_CACHE_CELL_SIZE ) * 0x9E3779B97F4A7C15ULL;
+    hash ^= (uint64_t)(int64_t) ::std::floor( tx_long / WOSS_RESULT_CACHE_CELL_SIZE ) * 0xC2B2AE3D27D4EB4FULL + (hash << 6) + (hash >> 2);
+    hash ^= (uint64_t)(int64_t) ::std::floor( rx_lat / WOSS_RESULT_CACHE_CELL_SIZE ) * 0x165667B19E3779F9ULL + (hash << 6) + (hash >> 2);
+    hash ^= (uint64_t)(int64_t) ::std::floor( rx_long / WOSS_RESULT_CACHE_CELL_SIZE ) * 0x27D4EB2F165667C5ULL + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 29;
+    return (size_t)( hash & (uint64_t)( total_shards - 1 ) );
+  }
+
+
+  inline bool operator<( const WossResultKey& left, const WossResultKey& right ) {
+    if ( left.tx_lat != right.tx_lat ) return left.tx_lat < right.tx_lat;
+    if ( left.tx_long != right.tx_long ) return left.tx_long < right.tx_long;
+    if ( left.tx_depth != right.tx_depth ) return left.tx_depth < right.tx_depth;
+    if ( left.rx_lat != right.rx_lat ) return left.rx_lat < right.rx_lat;
+    if ( left.rx_long != right.rx_long ) return left.rx_long < right.rx_long;
+    if ( left.rx_depth != right.rx_depth ) return left.rx_depth < right.rx_depth;
+    if ( left.start_frequency != right.start_frequency ) return left.start_frequency < right.start_frequency;
+    if ( left.end_frequency != right.end_frequency ) return left.end_frequency < right.end_frequency;
+    return left.time < right.time;
+  }
+
+
+  template < typename Value >
+  WossResultCache< Value >::WossResultCache( int size )
+  : total_size(0),
+    shard_size(0),
+    shards( WOSS_RESULT_CACHE_SHARDS, (Shard*)NULL )
+  {
+    for ( size_t i = 0; i < shards.size(); i++ ) {
+      shards[i] = new Shard();
+      int ret = pthread_rwlock_init( &(shards[i]->lock), NULL );
+      assert( ret == 0 );
+    }
+    setSize( size );
+  }
+
+
+  template < typename Value >
+  WossResultCache< Value >::~WossResultCache() {
+    for ( size_t i = 0; i < shards.size(); i++ ) {
+      pthread_rwlock_destroy( &(shards[i]->lock) );
+      delete shards[i];
+    }
+    shards.clear();
+  }
+
+
+  template < typename Value >
+  void WossResultCache< Value >::setSize( int size ) {
+    clear();
+
+    // total_size and shard_size are written before any concurrent use of the cache
+    total_size = ( size > 0 ) ? size : 0;
+    shard_size = ( total_size + shards.size() - 1 ) / shards.size();
+  }
+
+
+  template < typename Value >
+  bool WossResultCache< Value >::find( const WossResultKey& key, Value& value ) const {
+    if ( total_size <= 0 ) return false;
+
+    const Shard* shard = shards[ key.getShard( shards.size() ) ];
+
+    pthread_rwlock_rdlock( &(shard->lock) );
+    VMCIter it = shard->values.find( key );
+    bool is_found = ( it != shard->values.end() );
+    if ( is_found ) {
+      value = it->second.value;
+      if ( it->second.referenced == 0 ) __sync_fetch_and_or( &(it->second.referenced), 1 );
+    }
+    pthread_rwlock_unlock( &(shard->lock) );
+
+    return is_found;
+  }
+
+
+  template < typename Value >
+  void WossResultCache< Value >::insert( const WossResultKey& key, const Value& value ) {
+    if ( total_size <= 0 ) return;
+
+    Shard* shard = shards[ key.getShard( shards.size() ) ];
+
+    pthread_rwlock_wrlock( &(shard->lock) );
+    VMIter it = shard->values.find( key );
+    if ( it != shard->values.end() ) {
+      it->second.value = value;
+      it->second.referenced = 1;
+    }
+    else {
+      it = shard->values.insert( ::std::make_pair( key, Entry( value ) ) ).first;
+      
+      if ( shard->clock.size() < shard_size ) shard->clock.push_back( it );
+      else {
+        // referenced entries get a second chance, so the hand stops within a full turn
+        while ( shard->clock[ shard->hand ]->second.referenced != 0 ) {
+          shard->clock[ shard->hand ]->second.referenced = 0;
+          shard->hand = ( shard->hand + 1 ) % shard->clock.size();
+        }
+        shard->values.erase( shard->clock[ shard->hand ] );
+        shard->clock[ shard->hand ] = it;
+        shard->hand = ( shard->hand + 1 ) % shard->clock.size();
+      }
+    }
+    pthread_rwlock_unlock( &(shard->lock) );
+  }
+
+
+  template < typename Value >
+  void WossResultCache< Value >::clear() {
+    for ( size_t i = 0; i < shards.size(); i++ ) {
+      pthread_rwlock_wrlock( &(shards[i]->lock) );
+      shards[i]->values.clear();
+      shards[i]->clock.clear();
+      shards[i]->hand = 0;
+      pthread_rwlock_unlock( &(shards[i]->lock) );
+    }
+  }
+
+
+}
+
+
+#endif // WOSS_MULTITHREAD
+
+
+#endif /* WOSS_RESULT_CACHE_H */
+
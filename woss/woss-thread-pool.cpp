@@ -0,0 +1,217 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   woss-thread-pool.cpp
+ * @author Federico Guerra
+ * 
+ * \brief Provides the implementation of woss::WossThreadTask and woss::WossThreadPool classes
+ *
+ * Provides the implementation of woss::WossThreadTask and woss::WossThreadPool classes
+ */
+
+
+#ifdef WOSS_MULTITHREAD
+
+
+#include <cassert>
+#include "woss-thread-pool.h"
+
+
+using namespace woss;
+
+
+WossThreadTask::WossThreadTask()
+: is_done(false)
+{
+  pthread_mutex_init( &mutex, NULL );
+  pthread_cond_init( &condition, NULL );
+}
+
+
+WossThreadTask::~WossThreadTask() {
+  pthread_mutex_destroy( &mutex );
+  pthread_cond_destroy( &condition );
+}
+
+
+void WossThreadTask::wait() {
+  pthread_mutex_lock( &mutex );
+  while ( !is_done ) pthread_cond_wait( &condition, &mutex );
+  pthread_mutex_unlock( &mutex );
+}
+
+
+bool WossThreadTask::isDone() {
+  pthread_mutex_lock( &mutex );
+  bool ret_value = is_done;
+  pthread_mutex_unlock( &mutex );
+  return ret_value;
+}
+
+
+void WossThreadTask::setDone() {
+  pthread_mutex_lock( &mutex );
+  is_done = true;
+  pthread_cond_broadcast( &condition );
+  pthread_mutex_unlock( &mutex );
+}
+
+
+WossThreadPool::WossThreadPool( int threads )
+: workers(),
+  pending_tasks(0),
+  next_worker(0),
+  is_stopping(false)
+{
+  assert( threads >= 1 );
+  
+  pthread_mutex_init( &pool_mutex, NULL );
+  pthread_cond_init( &pool_condition, NULL );
+
+  workers.reserve( threads );
+  for ( int i = 0; i < threads; i++ ) {
+    Worker* worker = new Worker();
+    worker->pool = this;
+    worker->index = i;
+    pthread_mutex_init( &(worker->mutex), NULL );
+    workers.push_back( worker );
+  }
+  
+  // all Worker structs must exist before any thread is allowed to steal
+  for ( int i = 0; i < threads; i++ ) {
+    int ret = pthread_create( &(workers[i]->thread_id), NULL, WTPworkerLoop, (void*)workers[i] );
+    assert( ret == 0 );
+  }
+}
+
+
+WossThreadPool::~WossThreadPool() {
+  pthread_mutex_lock( &pool_mutex );
+  is_stopping = true;
+  pthread_cond_broadcast( &pool_condition );
+  pthread_mutex_unlock( &pool_mutex );
+  
+  for ( int i = 0; i < (int) workers.size(); i++ ) {
+    int ret = pthread_join( workers[i]->thread_id, NULL );
+    assert( ret == 0 );
+  }
+  
+  for ( int i = 0; i < (int) workers.size(); i++ ) {
+    assert( workers[i]->tasks.empty() );
+    pthread_mutex_destroy( &(workers[i]->mutex) );
+    delete workers[i];
+  }
+  workers.clear();
+  
+  pthread_mutex_destroy( &pool_mutex );
+  pthread_cond_destroy( &pool_condition );
+}
+
+
+void WossThreadPool::submit( WossThreadTask* const task ) {
+  assert( task != NULL );
+
+  pthread_mutex_lock( &pool_mutex );
+  assert( !is_stopping );
+  Worker* worker = workers[next_worker];
+  next_worker = ( next_worker + 1 ) % workers.size();
+  pthread_mutex_unlock( &pool_mutex );
+  
+  pthread_mutex_lock( &(worker->mutex) );
+  worker->tasks.push_back( task );
+  pthread_mutex_unlock( &(worker->mutex) );
+  
+  // the task is visible in a deque before it is accounted as pending
+  pthread_mutex_lock( &pool_mutex );
+  pending_tasks++;
+  pthread_cond_signal( &pool_condition );
+  pthread_mutex_unlock( &pool_mutex );
+}
+
+
+WossThreadTask* WossThreadPool::popTask( int index ) {
+  WossThreadTask* ret_value = NULL;
+  int total_workers = workers.size();
+  
+  while ( ret_value == NULL ) {
+    for ( int i = 0; i < total_workers && ret_value == NULL; i++ ) {
+      Worker* worker = workers[ (index + i) % total_workers ];
+      
+      pthread_mutex_lock( &(worker->mutex) );
+      if ( !worker->tasks.empty() ) {
+        if ( i == 0 ) {
+          ret_value = worker->tasks.back();
+          worker->tasks.pop_back();
+        }
+        else {
+          ret_value = worker->tasks.front();
+          worker->tasks.pop_front();
+        }
+      }
+      pthread_mutex_unlock( &(worker->mutex) );
+    }
+  }
+  return ret_value;
+}
+
+
+void WossThreadPool::workerLoop( int index ) {
+  while ( true ) {
+    pthread_mutex_lock( &pool_mutex );
+    while ( pending_tasks == 0 && !is_stopping ) pthread_cond_wait( &pool_condition, &pool_mutex );
+    
+    if ( pending_tasks == 0 ) { // is_stopping and nothing left to do
+      pthread_mutex_unlock( &pool_mutex );
+      return;
+    }
+    
+    // reserve one task: a task is now guaranteed to be found in one of the deques 
+    pending_tasks--;
+    pthread_mutex_unlock( &pool_mutex );
+    
+    WossThreadTask* task = popTask( index );
+    task->execute();
+    task->setDone();
+  }
+}
+
+
+void* woss::WTPworkerLoop( void* ptr ) {
+  WossThreadPool::Worker* worker = reinterpret_cast< WossThreadPool::Worker* >( ptr );
+  assert( worker != NULL );
+  
+  worker->pool->workerLoop( worker->index );
+  
+  return NULL;
+}
+
+
+#endif // WOSS_MULTITHREAD
+
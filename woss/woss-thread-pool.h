@@ -0,0 +1,269 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   woss-thread-pool.h
+ * @author Federico Guerra
+ * 
+ * \brief Provides the interface for woss::WossThreadTask and woss::WossThreadPool classes
+ *
+ * Provides the interface for woss::WossThreadTask and woss::WossThreadPool classes
+ */
+
+
+#ifndef WOSS_THREAD_POOL_DEFINITIONS_H
+#define WOSS_THREAD_POOL_DEFINITIONS_H
+
+
+#ifdef WOSS_MULTITHREAD
+
+
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+
+namespace woss {
+  
+  
+  /**
+  * \brief Abstract unit of work executed by a WossThreadPool
+  *
+  * WossThreadTask is the unit of work submitted to a WossThreadPool. It also acts as a future: 
+  * the submitting thread keeps ownership of the object, calls wait() and then reads the result
+  * stored by the derived class in execute(). 
+  */
+  class WossThreadTask {
+    
+    
+    public:
+    
+    
+    /**
+    * WossThreadTask default constructor
+    */
+    WossThreadTask();
+    
+    virtual ~WossThreadTask();
+    
+    
+    /**
+    * Performs the actual work. It is called by a worker thread of the pool
+    **/
+    virtual void execute() = 0;
+    
+    
+    /**
+    * Blocks the calling thread until execute() has completed
+    **/
+    void wait();
+    
+    /**
+    * Checks if execute() has completed
+    * @return <i>true</i> if the task is done, <i>false</i> otherwise
+    **/
+    bool isDone();
+    
+    
+    friend class WossThreadPool;
+    
+    
+    protected:
+    
+    
+    /**
+    * Mutex that protects is_done
+    **/
+    pthread_mutex_t mutex;
+    
+    /**
+    * Condition signaled on completion
+    **/
+    pthread_cond_t condition;
+    
+    /**
+    * Completion flag
+    **/
+    bool is_done;
+    
+    
+    /**
+    * Marks the task as completed and wakes up all waiting threads
+    **/
+    void setDone();
+    
+    
+  };
+  
+  
+  /**
+  * \brief Persistent pool of worker threads with work-stealing
+  *
+  * WossThreadPool keeps a fixed number of pthread workers alive for its whole lifetime.
+  * Each worker owns a deque of WossThreadTask: submitted tasks are spread round-robin over the deques,
+  * a worker pops from the back of its own deque and, when empty, steals from the front 
+  * of the other workers' deques. Idle workers sleep on a condition variable.
+  */
+  class WossThreadPool {
+    
+    
+    public:
+    
+    
+    /**
+    * WossThreadPool constructor. It creates and starts all worker threads
+    * @param threads number of worker threads (>= 1)
+    */
+    WossThreadPool( int threads );
+    
+    /**
+    * WossThreadPool destructor. It waits for all queued tasks and joins all workers
+    */
+    ~WossThreadPool();
+    
+    
+    /**
+    * Submits a task. <b>Ownership of the pointer is not transferred</b>, the caller should 
+    * call WossThreadTask::wait() before deleting it
+    * @param task pointer to a valid WossThreadTask
+    **/
+    void submit( WossThreadTask* const task );
+    
+    
+    /**
+    * Returns the number of worker threads
+    * @returns number of worker threads
+    **/
+    int getTotalThreads() const { return workers.size(); }
+    
+    
+    friend void* WTPworkerLoop( void* ptr );
+    
+    
+    protected:
+    
+    
+    typedef ::std::deque< WossThreadTask* > TaskDeque;
+    
+    
+    /**
+    * Worker thread data
+    */
+    struct Worker {
+      
+      
+      WossThreadPool* pool;
+      
+      int index;
+      
+      pthread_t thread_id;
+      
+      /**
+      * Mutex that protects tasks
+      **/
+      pthread_mutex_t mutex;
+      
+      /**
+      * Worker own queue of tasks
+      **/
+      TaskDeque tasks;
+      
+      
+    };
+    
+    
+    typedef ::std::vector< Worker* > WorkerVector;
+    
+    
+    /**
+    * Worker threads
+    **/
+    WorkerVector workers;
+    
+    
+    /**
+    * Mutex that protects pending_tasks, is_stopping and next_worker
+    **/
+    pthread_mutex_t pool_mutex;
+    
+    /**
+    * Condition signaled when new tasks are available or the pool is stopping
+    **/
+    pthread_cond_t pool_condition;
+    
+    /**
+    * Number of submitted tasks not yet reserved by a worker
+    **/
+    int pending_tasks;
+    
+    /**
+    * Index of the next worker deque for round-robin submission
+    **/
+    int next_worker;
+    
+    /**
+    * Stop flag
+    **/
+    bool is_stopping;
+    
+    
+    /**
+    * Pops a task previously reserved by worker <i>index</i>, first from its own deque,
+    * then stealing from the other ones
+    * @param index worker index
+    * @returns pointer to a valid WossThreadTask
+    **/
+    WossThreadTask* popTask( int index );
+    
+    /**
+    * Main loop of the worker thread <i>index</i>
+    * @param index worker index
+    **/
+    void workerLoop( int index );
+    
+    
+  };
+  
+  
+  /**
+  * Function used for worker thread creation
+  * @param ptr void pointer to a WossThreadPool::Worker
+  * @returns void pointer
+  **/
+  void* WTPworkerLoop( void* ptr );
+  
+  
+}
+
+
+#endif // WOSS_MULTITHREAD
+
+
+#endif /* WOSS_THREAD_POOL_DEFINITIONS_H */
+
@@ -89,6 +89,7 @@ Woss::Woss()
   total_runs(1),
   debug(false),
   has_run_once(false),
+  is_run_needed(true),
   is_running(false),
   clean_workdir(false)
 {
@@ -121,6 +122,7 @@ Woss::Woss( const CoordZ& tx, const CoordZ& rx, const Time& start_t, const Time&
   total_runs(1),
   debug(false),
   has_run_once(false),
+  is_run_needed(true),
   is_running(false),
   clean_workdir(false)
 {
@@ -131,9 +131,17 @@ namespace woss {
     * Performs a time evoulion of all time-dependant parameters
     * @param time_value constant reference to a valid Time object ( between start_time and end_time)
     * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    * @see isRunNeeded()
     **/   
     virtual bool timeEvolve( const Time& time_value ) = 0;
     
+    /**
+    * Checks if the channel simulator has to be (re)run after the last timeEvolve() call,
+    * i.e. if the stored results don't match the current environment
+    * @return <i>true</i> if run() has to be called, <i>false</i> otherwise
+    **/
+    bool isRunNeeded() const { return is_run_needed; }
+    
 
     /**
     * Checks the validity of Woss
@@ -175,6 +183,14 @@ namespace woss {
     **/
     virtual TimeArr* getTimeArr( double frequency, double tx_depth, double rx_depth, double rx_range ) const = 0;
 
+    /**
+    * Checks if given receiver depth lies inside the receiver grid computed by run(), 
+    * so that it's served without a new run. By default only the receiver depth is covered
+    * @param rx_depth receiver depth [m]
+    * @return <i>true</i> if the depth is covered, <i>false</i> otherwise
+    **/
+    virtual bool isRxDepthCovered( double rx_depth ) const { return( rx_depth == rx_coordz.getDepth() ); }
+
 
     /**
     * Sets debug flag
@@ -538,6 +554,11 @@ namespace woss {
     
     bool has_run_once;
     
+    /**
+    * Flag set by timeEvolve() when results have to be recomputed, cleared by run()
+    **/
+    bool is_run_needed;
+    
     
     /**
     * Running flag
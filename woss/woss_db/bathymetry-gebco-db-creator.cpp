@@ -46,7 +46,10 @@ using namespace woss;
 
 
 BathyGebcoDbCreator::BathyGebcoDbCreator()
-:  gebco_type( GEBCO_2D_30_SECONDS_BATHY_TYPE )
+:  gebco_type( GEBCO_2D_30_SECONDS_BATHY_TYPE ),
+   tile_size( GEBCO_DEFAULT_TILE_SIZE ),
+   tile_cache_budget( GEBCO_DEFAULT_TILE_CACHE_BUDGET ),
+   bilinear_interpolation( false )
 {
 
 }
@@ -63,6 +66,9 @@ WossDb* const BathyGebcoDbCreator::createWossDb() {
   BathyGebcoDb* woss_db = new BathyGebcoDb( pathname );
   
   woss_db->setGebcoType( gebco_type );
+  woss_db->setTileSize( tile_size );
+  woss_db->setTileCacheBudget( tile_cache_budget );
+  woss_db->setBilinearInterpolation( bilinear_interpolation );
   
   assert( initializeDb( woss_db ) );
   return( woss_db );
@@ -92,6 +92,45 @@ namespace woss {
     */
     GEBCO_BATHY_TYPE getGebcoBathyType() { return gebco_type; }
 
+    /**
+    * Sets the side of the GEBCO 2D cache tiles of the db that will be opened
+    * @param size tile side [cells]
+    * @return reference to <b>*this</b>
+    */
+    BathyGebcoDbCreator& setTileSize( int size ) { tile_size = size; return *this; }
+
+    /**
+    * Gets the side of the GEBCO 2D cache tiles of the db that will be opened
+    * @return tile_size
+    */
+    int getTileSize() { return tile_size; }
+
+    /**
+    * Sets the GEBCO 2D tile cache memory budget of the db that will be opened. Zero disables the cache
+    * @param budget memory budget [MB]
+    * @return reference to <b>*this</b>
+    */
+    BathyGebcoDbCreator& setTileCacheBudget( double budget ) { tile_cache_budget = budget; return *this; }
+
+    /**
+    * Gets the GEBCO 2D tile cache memory budget of the db that will be opened
+    * @return tile_cache_budget
+    */
+    double getTileCacheBudget() { return tile_cache_budget; }
+
+    /**
+    * Enables or disables the bilinear interpolation of GEBCO 2D depths of the db that will be opened
+    * @param flag <i>true</i> for bilinear interpolation, <i>false</i> for the nearest cell
+    * @return reference to <b>*this</b>
+    */
+    BathyGebcoDbCreator& setBilinearInterpolation( bool flag ) { bilinear_interpolation = flag; return *this; }
+
+    /**
+    * Gets the bilinear interpolation flag of the db that will be opened
+    * @return bilinear_interpolation
+    */
+    bool getBilinearInterpolation() { return bilinear_interpolation; }
+
     protected:
 
       
@@ -101,6 +140,21 @@ namespace woss {
     **/
     GEBCO_BATHY_TYPE gebco_type; 
 
+    /**
+    * Side of the GEBCO 2D cache tiles [cells]
+    **/
+    int tile_size;
+
+    /**
+    * GEBCO 2D tile cache memory budget [MB]
+    **/
+    double tile_cache_budget;
+
+    /**
+    * GEBCO 2D bilinear interpolation flag
+    **/
+    bool bilinear_interpolation;
+
     
     /**
     * Initializes the pointed object
@@ -40,7 +40,10 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <climits>
 #include <cmath>
+#include <vector>
+#include <algorithm>
 #include <definitions.h>
 #include "bathymetry-gebco-db.h"
 
@@ -50,11 +53,19 @@ using namespace woss;
 #define GEBCO_1D_INVALID_INDEX (-1)
 #define GEBCO_2D_INVALID_INDEXES woss::Gebco2DIndexes( GEBCO_1D_INVALID_INDEX, GEBCO_1D_INVALID_INDEX )
 #define GEBCO_NOT_FOUND (-HUGE_VAL)
+#define GEBCO_MAX_HYPERSLAB_CELLS (1048576)
 
 
 BathyGebcoDb::BathyGebcoDb( const ::std::string& name ) 
 : WossNetcdfDb(name),
   gebco_type(GEBCO_2D_30_SECONDS_BATHY_TYPE),
+  tile_size(GEBCO_DEFAULT_TILE_SIZE),
+  tile_cache_budget(GEBCO_DEFAULT_TILE_CACHE_BUDGET),
+  bilinear_interpolation(false),
+  tile_map(),
+  tile_lru_list(),
+  cache_hits(0),
+  cache_misses(0),
 #if defined(WOSS_NETCDF4_SUPPORT)
   bathy_var(),
   lat_var(),
@@ -65,7 +76,16 @@ BathyGebcoDb::BathyGebcoDb( const ::std::string& name )
   lon_var(NULL)
 #endif // defined(WOSS_NETCDF4_SUPPORT)
 {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_init( &tile_mutex, NULL );
+#endif // WOSS_MULTITHREAD
+}
+
 
+BathyGebcoDb::~BathyGebcoDb() {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_destroy( &tile_mutex );
+#endif // WOSS_MULTITHREAD
 }
 
 
@@ -187,6 +207,10 @@ double BathyGebcoDb::getValue( const Coord& coords ) const {
     }
 #endif // defined (WOSS_NETCDF4_SUPPORT)
   }
+  else if (((gebco_type == GEBCO_2D_1_MINUTE_BATHY_TYPE) || (gebco_type == GEBCO_2D_30_SECONDS_BATHY_TYPE) || (gebco_type == GEBCO_2D_15_SECONDS_BATHY_TYPE))
+           && (isTileCacheEnabled() || bilinear_interpolation)) {
+    depth = get2DAltitude(coords);
+  }
   else if ((gebco_type == GEBCO_2D_1_MINUTE_BATHY_TYPE) || (gebco_type == GEBCO_2D_30_SECONDS_BATHY_TYPE) || (gebco_type == GEBCO_2D_15_SECONDS_BATHY_TYPE)) {
     Gebco2DIndexes indexes = get2DBathyIndexes(coords);
     double lat = GEBCO_NOT_FOUND;
@@ -315,8 +339,344 @@ double BathyGebcoDb::getValue( const Coord& coords ) const {
     return (HUGE_VAL);
   }
 }
+
+
+void BathyGebcoDb::getValues( CoordZVector& coordz_vector ) const {
+  if ((gebco_type != GEBCO_2D_1_MINUTE_BATHY_TYPE) && (gebco_type != GEBCO_2D_30_SECONDS_BATHY_TYPE) && (gebco_type != GEBCO_2D_15_SECONDS_BATHY_TYPE)) {
+    // 1D variables store whole latitude rows, a transect hyperslab would span most of them
+    WossBathymetryDb::getValues( coordz_vector );
+    return;
+  }
+
+  if ( isTileCacheEnabled() || bilinear_interpolation ) {
+    // every lookup is answered by the cached tiles
+    WossBathymetryDb::getValues( coordz_vector );
+    return;
+  }
+
+  NetcdfIndexesVector indexes;
+  indexes.reserve( coordz_vector.size() );
+
+  for ( int i = 0; i < (int) coordz_vector.size(); i++ ) {
+    indexes.push_back( get2DBathyIndexes( coordz_vector[i] ) );
+  }
+
+  ::std::vector< double > hyperslab;
+  int start = 0;
+
+  while ( start < (int) coordz_vector.size() ) {
+    NetcdfIndexes min_indexes;
+    NetcdfIndexes max_indexes;
+
+    int end = getHyperslabEnd( indexes, start, GEBCO_MAX_HYPERSLAB_CELLS, min_indexes, max_indexes );
+
+    long lat_count = max_indexes.first - min_indexes.first + 1;
+    long lon_count = max_indexes.second - min_indexes.second + 1;
+    bool is_read = false;
+
+    if ( min_indexes != GEBCO_2D_INVALID_INDEXES ) {
+      is_read = read2DHyperslab( min_indexes, lat_count, lon_count, hyperslab );
+    }
+
+    if (debug)
+      ::std::cout << "BathyGebcoDb::getValues() coordinates from " << start << " to " << end << "; hyperslab indexes = " 
+                  << min_indexes.first << "," << min_indexes.second << "; counts = " << lat_count << "," << lon_count << ::std::endl;
+
+    for ( int i = start; i < end; i++ ) {
+      if ( indexes[i] == GEBCO_2D_INVALID_INDEXES || !is_read ) {
+        ::std::cout << "BathyGebcoDb::getValues() WARNING no depth extracted for coords = " << coordz_vector[i] << ::std::endl;
+        coordz_vector[i].setDepth( HUGE_VAL );
+        continue;
+      }
+
+      double depth = hyperslab[ ( indexes[i].first - min_indexes.first ) * lon_count + indexes[i].second - min_indexes.second ];
+
+      if (debug)
+        ::std::cout << "BathyGebcoDb::getValues() coordinates = " << coordz_vector[i] << "; altitude = " << depth << ::std::endl;
+
+      if ( depth != GEBCO_NOT_FOUND && depth <= 0.0 ) coordz_vector[i].setDepth( ::std::abs(depth) );
+      else {
+        ::std::cout << "BathyGebcoDb::getValues() WARNING current coordinates are on land : " << coordz_vector[i] << "; altitude = " << depth << ::std::endl;
+        coordz_vector[i].setDepth( HUGE_VAL );
+      }
+    }
+
+    start = end;
+  }
+}
  
 
+bool BathyGebcoDb::read2DHyperslab( const Gebco2DIndexes& start_indexes, long lat_count, long lon_count, ::std::vector< double >& altitudes ) const {
+  altitudes.assign( lat_count * lon_count, GEBCO_NOT_FOUND );
+
+#if defined (WOSS_NETCDF4_SUPPORT)
+  ::std::vector<size_t> index_vector;
+  ::std::vector<size_t> count_vector;
+
+  index_vector.push_back((size_t)start_indexes.first);
+  index_vector.push_back((size_t)start_indexes.second);
+  count_vector.push_back((size_t)lat_count);
+  count_vector.push_back((size_t)lon_count);
+
+  bathy_var.getVar(index_vector, count_vector, &altitudes[0]);
+  bool is_read = true;
+#else
+  bool is_read = bathy_var->set_cur(start_indexes.first, start_indexes.second) 
+                 && bathy_var->get(&altitudes[0], lat_count, lon_count);
+#endif // defined (WOSS_NETCDF4_SUPPORT)
+
+  if (!is_read) 
+    ::std::cout << "BathyGebcoDb::read2DHyperslab() Couldn't extract hyperslab at indexes = " << start_indexes.first << "," 
+                << start_indexes.second << "; counts = " << lat_count << "," << lon_count << ::std::endl;
+
+  return is_read;
+}
+
+
+double BathyGebcoDb::get2DCellAltitude( const Gebco2DIndexes& indexes ) const {
+  Gebco2DIndexes grid_size = get2DBathySize();
+
+  if ( indexes.first < 0 || indexes.second < 0 || indexes.first >= grid_size.first || indexes.second >= grid_size.second ) {
+    ::std::cout << "BathyGebcoDb::get2DCellAltitude() WARNING indexes out of grid = " << indexes.first << "," << indexes.second << ::std::endl;
+    return GEBCO_NOT_FOUND;
+  }
+
+  if ( !isTileCacheEnabled() ) {
+    ::std::vector< double > altitude;
+
+#ifdef WOSS_MULTITHREAD
+    pthread_mutex_lock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+    if ( !read2DHyperslab( indexes, 1, 1, altitude ) ) altitude.assign( 1, GEBCO_NOT_FOUND );
+
+#ifdef WOSS_MULTITHREAD
+    pthread_mutex_unlock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+    return altitude[0];
+  }
+
+  Gebco2DIndexes tile_indexes( indexes.first / tile_size, indexes.second / tile_size );
+  double altitude = GEBCO_NOT_FOUND;
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  TMIter it = tile_map.find( tile_indexes );
+
+  if ( it != tile_map.end() ) {
+    cache_hits++;
+    tile_lru_list.splice( tile_lru_list.begin(), tile_lru_list, it->second.lru_iter );
+  }
+  else {
+    cache_misses++;
+
+    GebcoTile tile;
+
+    tile.start_indexes = Gebco2DIndexes( tile_indexes.first * tile_size, tile_indexes.second * tile_size );
+    tile.lon_count = ::std::min( (long) tile_size, grid_size.second - tile.start_indexes.second );
+    long lat_count = ::std::min( (long) tile_size, grid_size.first - tile.start_indexes.first );
+
+    if ( read2DHyperslab( tile.start_indexes, lat_count, tile.lon_count, tile.altitudes ) ) {
+      evictTiles( getMaxTiles() - 1 );
+
+      it = tile_map.insert( ::std::make_pair( tile_indexes, GebcoTile() ) ).first;
+      it->second.altitudes.swap( tile.altitudes );
+      it->second.start_indexes = tile.start_indexes;
+      it->second.lon_count = tile.lon_count;
+      it->second.lru_iter = tile_lru_list.insert( tile_lru_list.begin(), tile_indexes );
+
+      if (debug)
+        ::std::cout << "BathyGebcoDb::get2DCellAltitude() loaded tile = " << tile_indexes.first << "," << tile_indexes.second 
+                    << "; counts = " << lat_count << "," << tile.lon_count << "; cached tiles = " << tile_map.size() << ::std::endl;
+    }
+    else it = tile_map.end();
+  }
+
+  if ( it != tile_map.end() ) {
+    const GebcoTile& tile = it->second;
+    altitude = tile.altitudes[ ( indexes.first - tile.start_indexes.first ) * tile.lon_count + indexes.second - tile.start_indexes.second ];
+  }
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  return altitude;
+}
+
+
+double BathyGebcoDb::get2DAltitude( const Coord& coords ) const {
+  Gebco2DIndexes indexes = get2DBathyIndexes(coords);
+
+  if (indexes == GEBCO_2D_INVALID_INDEXES) {
+    ::std::cout << "BathyGebcoDb::get2DAltitude() WARNING invalid 2D indexes returned for coords = " << coords << ::std::endl;
+    return GEBCO_NOT_FOUND;
+  }
+
+  if ( !bilinear_interpolation ) return get2DCellAltitude( indexes );
+
+  double start_lat;
+  double start_lon;
+  double spacing;
+
+  if (gebco_type == GEBCO_2D_1_MINUTE_BATHY_TYPE) {
+    start_lat = GEBCO_2D_1_MINUTE_BATHY_START_LAT;
+    start_lon = GEBCO_2D_1_MINUTE_BATHY_START_LONG;
+    spacing = GEBCO_1_MINUTE_BATHY_SPACING;
+  }
+  else if (gebco_type == GEBCO_2D_30_SECONDS_BATHY_TYPE) {
+    start_lat = GEBCO_2D_30_SECONDS_BATHY_START_LAT;
+    start_lon = GEBCO_2D_30_SECONDS_BATHY_START_LONG;
+    spacing = GEBCO_30_SECONDS_BATHY_SPACING;
+  }
+  else {
+    start_lat = GEBCO_2D_15_SECONDS_BATHY_START_LAT;
+    start_lon = GEBCO_2D_15_SECONDS_BATHY_START_LONG;
+    spacing = GEBCO_15_SECONDS_BATHY_SPACING;
+  }
+
+  Gebco2DIndexes grid_size = get2DBathySize();
+
+  double lat_position = ( coords.getLatitude() - start_lat ) / spacing;
+  double lon_position = ( coords.getLongitude() - start_lon ) / spacing;
+
+  long lat_index = (long) floor( lat_position );
+  long lon_index = (long) floor( lon_position );
+
+  // cells on the grid border have no complete neighbourhood
+  if ( lat_index < 0 || lon_index < 0 || lat_index >= grid_size.first - 1 || lon_index >= grid_size.second - 1 ) 
+    return get2DCellAltitude( indexes );
+
+  double lat_weight = lat_position - lat_index;
+  double lon_weight = lon_position - lon_index;
+
+  double south_west = get2DCellAltitude( Gebco2DIndexes( lat_index, lon_index ) );
+  double south_east = get2DCellAltitude( Gebco2DIndexes( lat_index, lon_index + 1 ) );
+  double north_west = get2DCellAltitude( Gebco2DIndexes( lat_index + 1, lon_index ) );
+  double north_east = get2DCellAltitude( Gebco2DIndexes( lat_index + 1, lon_index + 1 ) );
+
+  if ( south_west == GEBCO_NOT_FOUND || south_west > 0.0 || south_east == GEBCO_NOT_FOUND || south_east > 0.0 
+       || north_west == GEBCO_NOT_FOUND || north_west > 0.0 || north_east == GEBCO_NOT_FOUND || north_east > 0.0 ) {
+    if (debug)
+      ::std::cout << "BathyGebcoDb::get2DAltitude() coords = " << coords << " next to land, using nearest cell" << ::std::endl;
+
+    return get2DCellAltitude( indexes );
+  }
+
+  return ( ( 1.0 - lat_weight ) * ( ( 1.0 - lon_weight ) * south_west + lon_weight * south_east )
+           + lat_weight * ( ( 1.0 - lon_weight ) * north_west + lon_weight * north_east ) );
+}
+
+
+int BathyGebcoDb::getMaxTiles() const {
+  if ( tile_size <= 0 || tile_cache_budget <= 0.0 ) return 0;
+
+  double tile_bytes = (double) tile_size * tile_size * sizeof(double);
+
+  return (int) ::std::min( tile_cache_budget * 1024.0 * 1024.0 / tile_bytes, (double) INT_MAX );
+}
+
+
+void BathyGebcoDb::evictTiles( int max_tiles ) const {
+  while ( (int) tile_map.size() > ::std::max( max_tiles, 0 ) ) {
+    tile_map.erase( tile_lru_list.back() );
+    tile_lru_list.pop_back();
+  }
+}
+
+
+void BathyGebcoDb::setTileSize( int size ) {
+  assert( size > 0 );
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  tile_size = size;
+  evictTiles( 0 );
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+}
+
+
+void BathyGebcoDb::setTileCacheBudget( double budget ) {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  tile_cache_budget = budget;
+  evictTiles( getMaxTiles() );
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+}
+
+
+unsigned long BathyGebcoDb::getCacheHits() const {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  unsigned long hits = cache_hits;
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  return hits;
+}
+
+
+unsigned long BathyGebcoDb::getCacheMisses() const {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  unsigned long misses = cache_misses;
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  return misses;
+}
+
+
+int BathyGebcoDb::getTotalCachedTiles() const {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  int total_tiles = tile_map.size();
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  return total_tiles;
+}
+
+
+void BathyGebcoDb::resetCacheStats() {
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_lock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+
+  cache_hits = 0;
+  cache_misses = 0;
+
+#ifdef WOSS_MULTITHREAD
+  pthread_mutex_unlock( &tile_mutex );
+#endif // WOSS_MULTITHREAD
+}
+
+
 long BathyGebcoDb::get1DBathyIndex( const Coord& coords ) const {
   if (gebco_type == GEBCO_1D_1_MINUTE_BATHY_TYPE) {
     double quantized_latitude = ::std::abs( coords.getLatitude() / GEBCO_1_MINUTE_BATHY_SPACING ); 
@@ -425,5 +785,18 @@ Gebco2DIndexes BathyGebcoDb::get2DBathyIndexes( const Coord& coords ) const
 }
 
 
+Gebco2DIndexes BathyGebcoDb::get2DBathySize() const {
+  if (gebco_type == GEBCO_2D_1_MINUTE_BATHY_TYPE) 
+    return Gebco2DIndexes(GEBCO_1_MINUTE_BATHY_NLAT, GEBCO_1_MINUTE_BATHY_NLON);
+  else if (gebco_type == GEBCO_2D_30_SECONDS_BATHY_TYPE) 
+    return Gebco2DIndexes(GEBCO_30_SECONDS_BATHY_NLAT, GEBCO_30_SECONDS_BATHY_NLON);
+  else if (gebco_type == GEBCO_2D_15_SECONDS_BATHY_TYPE) 
+    return Gebco2DIndexes(GEBCO_15_SECONDS_BATHY_NLAT, GEBCO_15_SECONDS_BATHY_NLON);
+
+  ::std::cout << "BathyGebcoDb::get2DBathySize() ERROR wrong GEBCO type " << gebco_type << ::std::endl;
+  return GEBCO_2D_INVALID_INDEXES;
+}
+
+
 #endif // WOSS_NETCDF_SUPPORT
 
@@ -43,6 +43,12 @@
 
 #include "woss-db.h"
 #include <utility>
+#include <list>
+#include <map>
+#include <vector>
+#ifdef WOSS_MULTITHREAD
+#include <pthread.h>
+#endif // WOSS_MULTITHREAD
 #if defined (WOSS_NETCDF4_SUPPORT)
 #include <ncVar.h>
 #endif // defined (WOSS_NETCDF4_SUPPORT)
@@ -124,6 +130,11 @@ namespace woss {
 
 
 
+  static const int GEBCO_DEFAULT_TILE_SIZE = 256;  /**< GEBCO 2D default tile side [cells] */
+
+  static const double GEBCO_DEFAULT_TILE_CACHE_BUDGET = 64.0;  /**< GEBCO 2D default tile cache memory budget [MB] */
+
+
   typedef std::pair< long, long > Gebco2DIndexes; /**< GEBCO 2D netcdf indexes */
 
   /**
@@ -143,7 +154,11 @@ namespace woss {
   * \brief NetCDF specialization of WossNetcdfDb for GEBCO database
   *
   * NetCDF specialization of WossNetcdfDb for GEBCO database. It creates a NetCDF variable used to get requested bathymetry 
-  * values
+  * values. 
+  *
+  * GEBCO 2D variables are read through an in-memory cache of square tiles: every tile is loaded by a single hyperslab read, 
+  * it is shared by all the threads querying the database and it is evicted in least recently used order once the
+  * configured memory budget is exceeded. Depths can optionally be bilinearly interpolated between the four surrounding cells
   **/
   class BathyGebcoDb : public WossNetcdfDb, public WossBathymetryDb {
 
@@ -157,7 +172,7 @@ namespace woss {
     **/
     BathyGebcoDb( const ::std::string& name );
 
-    virtual ~BathyGebcoDb() { }
+    virtual ~BathyGebcoDb();
 
   
     /**
@@ -177,6 +192,14 @@ namespace woss {
     **/
     virtual double getValue( const Coord& coords ) const ;
 
+    /**
+    * Sets the positive depth value ( bathymetry ) of every CoordZ of the given transect, as getValue() would.
+    * Each group of consecutive coordinates is answered by a single hyperslab read of the GEBCO 2D variable. 
+    * GEBCO 1D variables are answered point by point
+    * @param coordz_vector reference to a CoordZVector
+    **/
+    virtual void getValues( CoordZVector& coordz_vector ) const ;
+
     
     /**
     * Post openConnection() actions. It create and initializes a NetCDF variable
@@ -198,14 +221,164 @@ namespace woss {
     GEBCO_BATHY_TYPE getGebcoType() { return gebco_type; }
 
 
+    /**
+    * Sets the side of the square tiles of the GEBCO 2D cache. Already cached tiles are discarded
+    * @param size tile side [cells]
+    **/
+    void setTileSize( int size );
+
+    /**
+    * Returns the side of the square tiles of the GEBCO 2D cache
+    * @return tile side [cells]
+    **/
+    int getTileSize() const { return tile_size; }
+
+    /**
+    * Sets the memory budget of the GEBCO 2D tile cache. A budget of zero disables the cache.
+    * Least recently used tiles are discarded to fit the new budget
+    * @param budget memory budget [MB]
+    **/
+    void setTileCacheBudget( double budget );
+
+    /**
+    * Returns the memory budget of the GEBCO 2D tile cache
+    * @return memory budget [MB]
+    **/
+    double getTileCacheBudget() const { return tile_cache_budget; }
+
+    /**
+    * Returns <i>true</i> if the GEBCO 2D tile cache is in use
+    * @return <i>true</i> if the memory budget can hold at least one tile, <i>false</i> otherwise
+    **/
+    bool isTileCacheEnabled() const { return ( getMaxTiles() > 0 ); }
+
+    /**
+    * Enables or disables the bilinear interpolation of GEBCO 2D depths. If any of the four surrounding cells
+    * is on land the nearest cell is used
+    * @param flag <i>true</i> for bilinear interpolation, <i>false</i> for the nearest cell
+    **/
+    void setBilinearInterpolation( bool flag ) { bilinear_interpolation = flag; }
+
+    /**
+    * Returns <i>true</i> if GEBCO 2D depths are bilinearly interpolated
+    * @return bilinear interpolation flag
+    **/
+    bool getBilinearInterpolation() const { return bilinear_interpolation; }
+
+
+    /**
+    * Returns the number of cell lookups answered by an already cached tile
+    * @return total cache hits
+    **/
+    unsigned long getCacheHits() const;
+
+    /**
+    * Returns the number of cell lookups that required a tile to be loaded
+    * @return total cache misses
+    **/
+    unsigned long getCacheMisses() const;
+
+    /**
+    * Returns the number of tiles currently held by the cache
+    * @return total cached tiles
+    **/
+    int getTotalCachedTiles() const;
+
+    /**
+    * Resets the cache hits and misses counters
+    **/
+    void resetCacheStats();
+
+
     protected:
 
 
+    /**
+    * \brief GEBCO 2D cached tile
+    *
+    * Depths of a rectangular block of GEBCO 2D cells, stored by latitude rows
+    **/
+    class GebcoTile {
+
+      public:
+
+      GebcoTile() : altitudes(), start_indexes(), lon_count(0), lru_iter() { }
+
+      /**
+      * Retrieved altitudes [m]
+      **/
+      ::std::vector< double > altitudes;
+
+      /**
+      * Indexes of the first cell
+      **/
+      Gebco2DIndexes start_indexes;
+
+      /**
+      * Number of cells of every latitude row
+      **/
+      long lon_count;
+
+      /**
+      * Position of the tile in the least recently used list
+      **/
+      ::std::list< Gebco2DIndexes >::iterator lru_iter;
+
+    };
+
+    typedef ::std::list< Gebco2DIndexes > TileLruList;
+    typedef TileLruList::iterator TLLIter;
+
+    /**
+    * Map that links the tile indexes to the cached tile
+    **/
+    typedef ::std::map< Gebco2DIndexes, GebcoTile > TileMap;
+    typedef TileMap::iterator TMIter;
+    typedef TileMap::const_iterator TMCIter;
+
+
     /**
     * GEBCO version in use
     **/
     GEBCO_BATHY_TYPE gebco_type;
 
+
+    /**
+    * Side of the cached tiles [cells]
+    **/
+    int tile_size;
+
+    /**
+    * Memory budget of the tile cache [MB]
+    **/
+    double tile_cache_budget;
+
+    /**
+    * Bilinear interpolation flag
+    **/
+    bool bilinear_interpolation;
+
+    /**
+    * Cached tiles
+    **/
+    mutable TileMap tile_map;
+
+    /**
+    * Tile indexes sorted from the most to the least recently used
+    **/
+    mutable TileLruList tile_lru_list;
+
+    mutable unsigned long cache_hits;
+
+    mutable unsigned long cache_misses;
+
+#ifdef WOSS_MULTITHREAD
+    /**
+    * Mutex guarding the tile cache and the NetCDF variable
+    **/
+    mutable pthread_mutex_t tile_mutex;
+#endif // WOSS_MULTITHREAD
+
     
     /**
     * NetCDF bathymetry variable
@@ -251,6 +424,50 @@ namespace woss {
     * @return Gebco2DIndexes value 
     **/
     Gebco2DIndexes get2DBathyIndexes( const Coord& coords ) const ;
+
+    /**
+    * Returns the total number of latitudes and longitudes of the GEBCO 2D variable in use
+    * @return Gebco2DIndexes value
+    **/
+    Gebco2DIndexes get2DBathySize() const ;
+
+
+    /**
+    * Reads a block of the GEBCO 2D variable with a single hyperslab read
+    * @param start_indexes indexes of the first cell
+    * @param lat_count number of latitudes to read
+    * @param lon_count number of longitudes to read
+    * @param altitudes vector filled by latitude rows with the retrieved altitudes [m]
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    bool read2DHyperslab( const Gebco2DIndexes& start_indexes, long lat_count, long lon_count, ::std::vector< double >& altitudes ) const ;
+
+    /**
+    * Returns the altitude of the given GEBCO 2D cell, loading its tile in the cache if needed
+    * @param indexes valid cell indexes
+    * @return altitude [m], -HUGE_VAL if it couldn't be retrieved
+    **/
+    double get2DCellAltitude( const Gebco2DIndexes& indexes ) const ;
+
+    /**
+    * Returns the GEBCO 2D altitude of the given coordinates, nearest cell or bilinearly interpolated
+    * @param coords const reference to a valid Coord object
+    * @return altitude [m], -HUGE_VAL if it couldn't be retrieved
+    **/
+    double get2DAltitude( const Coord& coords ) const ;
+
+    /**
+    * Returns the number of tiles that fit in the memory budget
+    * @return maximum number of cached tiles
+    **/
+    int getMaxTiles() const ;
+
+    /**
+    * Discards the least recently used tiles until at most <i>max_tiles</i> are cached. 
+    * The caller must hold tile_mutex
+    * @param max_tiles number of tiles to keep
+    **/
+    void evictTiles( int max_tiles ) const ;
   };
 
 }
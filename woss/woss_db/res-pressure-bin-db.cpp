@@ -46,7 +46,6 @@ using namespace woss;
 
 
 #define RES_NOT_SET (-2000)
-#define RES_PRESSURE_FREQ_PRECISION (1e-5)
 
 
 
@@ -94,7 +93,7 @@ bool ResPressureBinDb::importMap() {
       assert(press_real != RES_NOT_SET); assert(press_imag != RES_NOT_SET); assert(frequency != RES_NOT_SET);
       assert(time != 0); 
       
-      pressure_map[CoordZ(tx_lat, tx_long, ::std::abs(tx_z))][CoordZ(rx_lat, rx_long, ::std::abs(rx_z))][PDouble(frequency, RES_PRESSURE_FREQ_PRECISION)][time] = 
+      pressure_map[CoordZ(tx_lat, tx_long, ::std::abs(tx_z))][CoordZ(rx_lat, rx_long, ::std::abs(rx_z))][FreqKey(frequency)][time] = 
                ::std::complex<double> (press_real, press_imag);
                
       initial_pressmap_size++;
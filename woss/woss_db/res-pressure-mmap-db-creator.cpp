@@ -0,0 +1,89 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   res-pressure-mmap-db-creator.cpp
+ * @author Federico Guerra
+ * 
+ * \brief Provides the implementation of woss::ResPressureMmapDbCreator class
+ *
+ * Provides the implementation of the woss::ResPressureMmapDbCreator class
+ */
+
+
+#include <cassert>
+#include "res-pressure-mmap-db-creator.h"
+#include "res-pressure-mmap-db.h"
+
+
+using namespace woss;
+
+
+ResPressureMmapDbCreator::ResPressureMmapDbCreator()
+: space_sampling(0.0),
+  compaction_threshold(4096),
+  import_pathname(),
+  import_binary(true)
+{
+
+}
+
+
+ResPressureMmapDbCreator::~ResPressureMmapDbCreator() {
+
+}
+  
+
+WossDb* const ResPressureMmapDbCreator::createWossDb() {
+  assert( pathname.length() > 0 );
+  
+  if ( debug ) ::std::cout << "ResPressureMmapDbCreator::createWossDb() pathname = " << pathname << ::std::endl;
+
+  ResPressureMmapDb* woss_db = new ResPressureMmapDb( pathname );
+  
+  woss_db->setSpaceSampling(space_sampling);
+  woss_db->setCompactionThreshold(compaction_threshold);
+  bool ok = initializeDb( woss_db );  
+  assert( ok );
+  
+  return( woss_db );
+}
+
+
+bool ResPressureMmapDbCreator::initializeDb( WossDb* const woss_db ) {
+  if ( !WossDbCreator::initializeDb( woss_db ) ) return false;
+  
+  if ( import_pathname.length() > 0 ) {
+    if ( debug ) ::std::cout << "ResPressureMmapDbCreator::initializeDb() importing " << import_pathname << ::std::endl;
+    
+    return( static_cast< ResPressureMmapDb* >( woss_db )->importDb( import_pathname, import_binary ) );
+  }
+  return true;
+}
+
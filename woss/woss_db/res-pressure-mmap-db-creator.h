@@ -0,0 +1,134 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   res-pressure-mmap-db-creator.h
+ * @author Federico Guerra
+ * 
+ * \brief Provides the interface for woss::ResPressureMmapDbCreator class
+ *
+ * Provides the interface for the woss::ResPressureMmapDbCreator class
+ */
+
+
+#ifndef WOSS_RES_PRESSURE_MMAP_DB_CREATOR_H 
+#define WOSS_RES_PRESSURE_MMAP_DB_CREATOR_H
+
+
+#include "woss-db-creator.h"
+
+
+namespace woss {
+  
+    
+  /**
+  * \brief DbCreator for memory mapped Pressure database
+  *
+  * ResPressureMmapDbCreator implements WossDbCreator for memory mapped Pressure database
+  **/
+  class ResPressureMmapDbCreator : public WossDbCreator {
+
+    
+    public:
+    
+
+    /**
+    * ResPressureMmapDbCreator default constructor
+    **/
+    ResPressureMmapDbCreator();
+    
+    virtual ~ResPressureMmapDbCreator();
+    
+
+    /**
+    * This method is called to create and initialize a ResPressureMmapDb
+    * @return a pointer to a properly initialized ResPressureMmapDb object
+    **/
+    virtual WossDb* const createWossDb();
+
+    
+    void setSpaceSampling( double value ) { space_sampling = value; }
+    
+    double getSpaceSampling() { return space_sampling; }
+    
+    /**
+    * Sets the number of appended records that triggers a compaction
+    * @param threshold number of records, a value <= 0 disables automatic compaction
+    **/
+    void setCompactionThreshold( int threshold ) { compaction_threshold = threshold; }
+    
+    int getCompactionThreshold() { return compaction_threshold; }
+    
+    /**
+    * Sets a textual or binary ResPressureTxtDb to be imported into the created database
+    * @param name pathname of the source database, an empty string disables the import
+    * @param is_binary <i>true</i> if the source is binary, <i>false</i> if it is textual
+    **/
+    void setImportPathName( const ::std::string& name, bool is_binary ) { import_pathname = name; import_binary = is_binary; }
+    
+    ::std::string getImportPathName() { return import_pathname; }
+    
+
+    protected:
+        
+
+    double space_sampling;   
+    
+    /**
+    * Number of appended records that triggers a compaction
+    **/
+    int compaction_threshold;
+    
+    /**
+    * Pathname of the database to be imported, empty if not set
+    **/
+    ::std::string import_pathname;
+    
+    /**
+    * <i>true</i> if the database to be imported is binary
+    **/
+    bool import_binary;
+    
+    
+    /**
+    * Initializes the pointed object
+    * @param woss_db pointer to a recently created ResPressureMmapDb
+    * @return <i>true</i> if the method succeed, <i>false</i> otherwise
+    **/
+    virtual bool initializeDb( WossDb* const woss_db );
+    
+    
+  };
+
+  
+}
+
+
+#endif /* WOSS_RES_PRESSURE_MMAP_DB_CREATOR_H */
+
@@ -0,0 +1,117 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   res-pressure-mmap-db.cpp
+ * @author Federico Guerra
+ * 
+ * \brief Provides the implementation of woss::ResPressureMmapDb class
+ *
+ * Provides the implementation of the woss::ResPressureMmapDb class
+ */
+
+
+#include <cassert>
+#include <definitions.h>
+#include <definitions-handler.h>
+#include "res-pressure-bin-db.h"
+#include "res-pressure-mmap-db.h"
+
+
+using namespace woss;
+
+
+#define RES_PRESSURE_FREQ_PRECISION (1e-5)
+
+
+double ResPressureMmapDb::space_sampling = 0.0;
+
+
+Pressure* ResPressureMmapDb::getValue( const CoordZ& coord_tx, const CoordZ& coord_rx, const double frequency, const Time& time_value ) const {
+  const double* values = NULL;
+  uint64_t count = 0;
+  
+  if ( !time_value.isValid() 
+       || !readValues( coord_tx, coord_rx, frequency, RES_PRESSURE_FREQ_PRECISION, time_value, space_sampling, values, count ) 
+       || count < 2 ) {
+    
+    if (debug) ::std::cout << "ResPressureMmapDb::getValue() tx coords " << coord_tx << "; rx coords " << coord_rx 
+                           << "; frequency = " << frequency << "; time = " << time_value << " not found" << ::std::endl;
+    
+    return SDefHandler::instance()->getPressure()->create( Pressure::createNotValid() );
+  }
+  
+  return SDefHandler::instance()->getPressure()->create( values[0], values[1] );
+}
+
+
+bool ResPressureMmapDb::insertValue( const CoordZ& coord_tx, const CoordZ& coord_rx, const double frequency, const Time& time_value, const Pressure& pressure ) {
+  ::std::vector< double > values( 2 );
+  values[0] = pressure.real();
+  values[1] = pressure.imag();
+  
+  return appendValues( coord_tx, coord_rx, frequency, time_value, values );
+}
+
+
+bool ResPressureMmapDb::importDb( const ::std::string& name, bool is_binary ) {
+  ResPressureTxtDb* source_db = NULL;
+  
+  if ( is_binary ) source_db = new ResPressureBinDb( name );
+  else source_db = new ResPressureTxtDb( name );
+  
+  if ( !source_db->openConnection() || !source_db->finalizeConnection() ) {
+    ::std::cerr << "ResPressureMmapDb::importDb() ERROR, can't import " << name << ::std::endl;
+    delete source_db;
+    return false;
+  }
+  
+  TailVector records;
+  ::std::vector< double > values( 2 );
+  
+  for ( ResPressureTxtDb::PMCIter it = source_db->pressure_map.begin(); it != source_db->pressure_map.end(); it++ ) {
+    for ( ResPressureTxtDb::RxMap::const_iterator it2 = it->second.begin(); it2 != it->second.end(); it2++ ) {
+      for ( ResPressureTxtDb::FreqMap::const_iterator it3 = it2->second.begin(); it3 != it2->second.end(); it3++ ) {
+        for ( ResPressureTxtDb::TMCIter it4 = it3->second.begin(); it4 != it3->second.end(); it4++ ) {
+          values[0] = it4->second.real();
+          values[1] = it4->second.imag();
+          records.push_back( createTailRecord( it->first, it2->first, it3->first, it4->first, values ) );
+        }
+      }
+    }
+  }
+  
+  source_db->closeConnection();
+  delete source_db;
+  
+  if (debug) ::std::cout << "ResPressureMmapDb::importDb() imported " << records.size() << " values from " << name << ::std::endl;
+  
+  return importRecords( records );
+}
+
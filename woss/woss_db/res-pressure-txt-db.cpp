@@ -51,7 +51,6 @@ using namespace woss;
 
 #define WOSS_CMM_WRITE_GAIN_MARGIN (4)
 #define RES_NOT_SET (-2000)
-#define RES_PRESSURE_FREQ_PRECISION (1e-5)
 
 
 double ResPressureTxtDb::space_sampling = 0.0;
@@ -106,7 +105,7 @@ bool ResPressureTxtDb::importMap() {
       assert(press_real != RES_NOT_SET); assert(press_imag != RES_NOT_SET); assert(frequency != RES_NOT_SET);
       assert(time != 0);
 
-      pressure_map[CoordZ(tx_lat, tx_long, ::std::abs(tx_z))][CoordZ(rx_lat, rx_long, ::std::abs(rx_z))][PDouble(frequency, RES_PRESSURE_FREQ_PRECISION)][time] = 
+      pressure_map[CoordZ(tx_lat, tx_long, ::std::abs(tx_z))][CoordZ(rx_lat, rx_long, ::std::abs(rx_z))][FreqKey(frequency)][time] = 
 							 ::std::complex<double> (press_real, press_imag);
                
       initial_pressmap_size++;
@@ -135,7 +134,7 @@ bool ResPressureTxtDb::importMap() {
 
     if ( it2 != it->second.end() ) {
       
-      FreqMap::const_iterator it3 = it2->second.find( PDouble(freq,RES_PRESSURE_FREQ_PRECISION) );
+      FreqMap::const_iterator it3 = it2->second.find( FreqKey(freq) );
       
       if ( it3 != it2->second.end() ) {
         
@@ -342,7 +341,7 @@ bool ResPressureTxtDb::insertValue( const CoordZ& coord_tx, const CoordZ& coord_
 
     if (debug) ::std::cout << "ResPressureTxtDb::insertValue() no tx CoordZ found" << ::std::endl;
     
-    pressure_map[coord_tx][coord_rx][PDouble(frequency, RES_PRESSURE_FREQ_PRECISION)][time_value] = pressure;
+    pressure_map[coord_tx][coord_rx][FreqKey(frequency)][time_value] = pressure;
   }
   else { // start CoordZ found
     RxMIter it2 = (it1->second).find( coord_rx );
@@ -351,16 +350,16 @@ bool ResPressureTxtDb::insertValue( const CoordZ& coord_tx, const CoordZ& coord_
 
       if (debug) ::std::cout << "ResPressureTxtDb::insertValue() no rx CoordZ found" << ::std::endl;
 
-      (it1->second)[coord_rx][PDouble(frequency, RES_PRESSURE_FREQ_PRECISION)][time_value] = pressure;
+      (it1->second)[coord_rx][FreqKey(frequency)][time_value] = pressure;
     }
     else {
-      FMIter it3 = it2->second.find( PDouble(frequency, RES_PRESSURE_FREQ_PRECISION) );
+      FMIter it3 = it2->second.find( FreqKey(frequency) );
       
       if ( it3 == it2->second.end() ) {
         
         if (debug) ::std::cout << "ResPressureTxtDb::insertValue() no frequency found" << ::std::endl;
 
-        (it2->second)[PDouble(frequency, RES_PRESSURE_FREQ_PRECISION)][time_value] = pressure;
+        (it2->second)[FreqKey(frequency)][time_value] = pressure;
       }
       else {
         TMIter it4 = it3->second.find( time_value );
@@ -43,7 +43,8 @@
 
 #include <map>
 #include <complex>
-#include <custom-precision-double.h>
+#include <quantized-double.h>
+#include <coordinates-spatial-map.h>
 #include "woss-db.h"
 
 
@@ -114,6 +115,9 @@ namespace woss {
     static double getSpaceSampling() { return space_sampling; }
     
     
+    friend class ResPressureMmapDb;
+    
+    
     protected:
   
       
@@ -122,19 +126,24 @@ namespace woss {
     typedef TimeMap::const_iterator TMCIter;
     typedef TimeMap::reverse_iterator TMRIter;
     
-    typedef ::std::map< PDouble, TimeMap > FreqMap;
+    /**
+    * Frequency key, quantized at 1e-5 Hz
+    **/
+    typedef QDouble< 100000 > FreqKey;
+    
+    typedef ::std::map< FreqKey, TimeMap > FreqMap;
     typedef FreqMap::iterator FMIter;
     typedef FreqMap::reverse_iterator FMRIter;
     
-    typedef ::std::map< CoordZ, FreqMap, CoordComparator< ResPressureTxtDb, CoordZ > > RxMap;
+    typedef CoordZSpatialMap< FreqMap, ResPressureTxtDb > RxMap;
     typedef RxMap::iterator RxMIter;
     typedef RxMap::reverse_iterator RxMRIter;
        
     /**
-    * Multidimensional map that links a transmitter CoordZ to a receiver CoordZ to a frequency PDouble value 
+    * Multidimensional map that links a transmitter CoordZ to a receiver CoordZ to a frequency FreqKey value 
     * and finally to a Pressure value
     **/
-    typedef ::std::map< CoordZ, RxMap, CoordComparator< ResPressureTxtDb, CoordZ > > PressureMatrix;
+    typedef CoordZSpatialMap< RxMap, ResPressureTxtDb > PressureMatrix;
     typedef PressureMatrix::iterator PMIter;
     typedef PressureMatrix::const_iterator PMCIter;
     typedef PressureMatrix::reverse_iterator PMRIter;
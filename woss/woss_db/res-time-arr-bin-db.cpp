@@ -45,7 +45,6 @@ using namespace woss;
 
 
 #define RES_NOT_SET (-2000)
-#define RES_TIME_ARR_FREQ_PRECISION (1e-5)
 
 
 bool ResTimeArrBinDb::importMap() {
@@ -105,7 +104,7 @@ bool ResTimeArrBinDb::importMap() {
       }
 //       ::std::cout << ::std::endl;
 
-      arrivals_map[CoordZ(tx_lat, tx_long, tx_z)][CoordZ(rx_lat, rx_long, rx_z)][PDouble(frequency, RES_TIME_ARR_FREQ_PRECISION)][time] = value;
+      arrivals_map[CoordZ(tx_lat, tx_long, tx_z)][CoordZ(rx_lat, rx_long, rx_z)][FreqKey(frequency)][time] = value;
 //       insertValue(CoordZ(tx_lat, tx_long, tx_z), CoordZ(rx_lat, rx_long, rx_z), frequency, value );
 
       initial_arrmap_size++;
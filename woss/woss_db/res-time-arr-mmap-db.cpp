@@ -0,0 +1,131 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   res-time-arr-mmap-db.cpp
+ * @author Federico Guerra
+ * 
+ * \brief Provides the implementation of woss::ResTimeArrMmapDb class
+ *
+ * Provides the implementation of the woss::ResTimeArrMmapDb class
+ */
+
+
+#include <cassert>
+#include <definitions.h>
+#include <definitions-handler.h>
+#include "res-time-arr-bin-db.h"
+#include "res-time-arr-mmap-db.h"
+
+
+using namespace woss;
+
+
+#define RES_TIME_ARR_FREQ_PRECISION (1e-5)
+
+
+double ResTimeArrMmapDb::space_sampling = 0.0;
+
+
+TimeArr* ResTimeArrMmapDb::getValue( const CoordZ& coord_tx, const CoordZ& coord_rx, const double frequency, const Time& time_value ) const {
+  const double* values = NULL;
+  uint64_t count = 0;
+  
+  if ( !time_value.isValid() 
+       || !readValues( coord_tx, coord_rx, frequency, RES_TIME_ARR_FREQ_PRECISION, time_value, space_sampling, values, count ) ) {
+    
+    if (debug) ::std::cout << "ResTimeArrMmapDb::getValue() tx coords " << coord_tx << "; rx coords " << coord_rx 
+                           << "; frequency = " << frequency << "; time = " << time_value << " not found" << ::std::endl;
+    
+    return SDefHandler::instance()->getTimeArr()->create( TimeArr::createNotValid() );
+  }
+  
+  TimeArr* ret_value = SDefHandler::instance()->getTimeArr()->create();
+  
+  for ( uint64_t i = 0; i + 2 < count; i += 3 ) {
+    ret_value->insertValue( values[i], Pressure( values[i + 1], values[i + 2] ) );
+  }
+  return ret_value;
+}
+
+
+bool ResTimeArrMmapDb::insertValue( const CoordZ& coord_tx, const CoordZ& coord_rx, const double frequency, const Time& time_value, const TimeArr& channel ) {
+  ::std::vector< double > values;
+  values.reserve( 3 * channel.size() );
+  
+  for ( TimeArrCIt it = channel.begin(); it != channel.end(); it++ ) {
+    values.push_back( it->first );
+    values.push_back( it->second.real() );
+    values.push_back( it->second.imag() );
+  }
+  
+  return appendValues( coord_tx, coord_rx, frequency, time_value, values );
+}
+
+
+bool ResTimeArrMmapDb::importDb( const ::std::string& name, bool is_binary ) {
+  ResTimeArrTxtDb* source_db = NULL;
+  
+  if ( is_binary ) source_db = new ResTimeArrBinDb( name );
+  else source_db = new ResTimeArrTxtDb( name );
+  
+  if ( !source_db->openConnection() || !source_db->finalizeConnection() ) {
+    ::std::cerr << "ResTimeArrMmapDb::importDb() ERROR, can't import " << name << ::std::endl;
+    delete source_db;
+    return false;
+  }
+  
+  TailVector records;
+  ::std::vector< double > values;
+  
+  for ( ResTimeArrTxtDb::AMXCIter it = source_db->arrivals_map.begin(); it != source_db->arrivals_map.end(); it++ ) {
+    for ( ResTimeArrTxtDb::RxMCIter it2 = it->second.begin(); it2 != it->second.end(); it2++ ) {
+      for ( ResTimeArrTxtDb::FMCIter it3 = it2->second.begin(); it3 != it2->second.end(); it3++ ) {
+        for ( ResTimeArrTxtDb::TMCIter it4 = it3->second.begin(); it4 != it3->second.end(); it4++ ) {
+          values.clear();
+          
+          for ( TimeArrCIt it5 = it4->second.begin(); it5 != it4->second.end(); it5++ ) {
+            values.push_back( it5->first );
+            values.push_back( it5->second.real() );
+            values.push_back( it5->second.imag() );
+          }
+          records.push_back( createTailRecord( it->first, it2->first, it3->first, it4->first, values ) );
+        }
+      }
+    }
+  }
+  
+  source_db->closeConnection();
+  delete source_db;
+  
+  if (debug) ::std::cout << "ResTimeArrMmapDb::importDb() imported " << records.size() << " values from " << name << ::std::endl;
+  
+  return importRecords( records );
+}
+
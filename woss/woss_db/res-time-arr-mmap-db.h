@@ -0,0 +1,125 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   res-time-arr-mmap-db.h
+ * @author Federico Guerra
+ * 
+ * \brief Provides the interface for woss::ResTimeArrMmapDb class
+ *
+ * Provides the interface for the woss::ResTimeArrMmapDb class
+ */
+
+
+#ifndef WOSS_RES_TIME_ARR_MMAP_DB_H
+#define WOSS_RES_TIME_ARR_MMAP_DB_H
+
+
+#include <coordinates-definitions.h>
+#include <time-arrival-definitions.h>
+#include "woss-mmap-db.h"
+
+
+namespace woss {
+
+
+  /**
+  * \brief Memory mapped WossDb for TimeArr
+  *
+  * ResTimeArrMmapDb implements WossMmapDb and WossResTimeArrDb for storing calculated TimeArr into an indexed, memory mapped file.
+  * The values of each sample are: \n
+  * <b>delay-<i>i-th</i>, real pressure-<i>i-th</i>, imag pressure-<i>i-th</i></b>
+  **/
+  class ResTimeArrMmapDb : public WossMmapDb, public WossResTimeArrDb {
+    
+    
+    public:
+
+
+    /**
+    * ResTimeArrMmapDb constructor
+    * @param name pathname of database
+    **/
+    ResTimeArrMmapDb( const ::std::string& name ) : WossMmapDb( name, WOSS_MMAP_DB_TYPE_TIME_ARR ) { }
+
+    virtual ~ResTimeArrMmapDb() { }
+    
+    
+    /**
+    * Returns a pointer to a heap-created TimeArr value for given frequency, 
+    * transmitter and receiver coordinates if present in the database.
+    * <b>User is responsible of pointer's ownership</b>
+    * @param coord_tx const reference to a valid CoordZ object
+    * @param coord_rx const reference to a valid CoordZ object
+    * @param frequency used frequency [hz]
+    * @param time_value const reference to a valid Time object
+    * @return <i>valid</i> TimeArr if parameters are found, <i>not valid</i> otherwise
+    **/  
+    virtual TimeArr* getValue( const CoordZ& coord_tx, const CoordZ& coord_rx, const double frequency, const Time& time_value ) const;
+
+    /**
+    * Appends the given TimeArr value to the database at given frequency, transmitter and receiver coordinates
+    * @param coord_tx const reference to a valid CoordZ object
+    * @param coord_rx const reference to a valid CoordZ object
+    * @param frequency used frequency [hz]
+    * @param time_value const reference to a valid Time object
+    * @param channel computed TimeArr
+    * @returns <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    virtual bool insertValue( const CoordZ& coord_tx, const CoordZ& coord_rx, const double frequency, const Time& time_value, const TimeArr& channel );
+    
+    
+    /**
+    * Imports all values of a textual or binary ResTimeArrTxtDb into the database
+    * @param name pathname of the source database
+    * @param is_binary <i>true</i> if the source is binary, <i>false</i> if it is textual
+    * @returns <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    bool importDb( const ::std::string& name, bool is_binary );
+    
+
+    static void setSpaceSampling( double value ) { space_sampling = value; }
+    
+    static double getSpaceSampling() { return space_sampling; }
+    
+    
+    protected:
+    
+    
+    static double space_sampling;
+    
+    
+  };
+
+
+}
+
+
+#endif /* WOSS_RES_TIME_ARR_MMAP_DB_H */
+
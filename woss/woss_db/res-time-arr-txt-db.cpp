@@ -51,7 +51,6 @@ using namespace woss;
 
 #define WOSS_CMM_WRITE_GAIN_MARGIN (4)
 #define RES_NOT_SET (-2000)
-#define RES_TIME_ARR_FREQ_PRECISION (1e-5)
 
 
 double ResTimeArrTxtDb::space_sampling = 0.0;
@@ -119,7 +118,7 @@ bool ResTimeArrTxtDb::importMap() {
       }
 //       if (debug) ::std::cout << ::std::endl;
 
-      arrivals_map[CoordZ(tx_lat, tx_long, tx_z)][CoordZ(rx_lat, rx_long, rx_z)][PDouble(frequency, RES_TIME_ARR_FREQ_PRECISION)][time] = value;
+      arrivals_map[CoordZ(tx_lat, tx_long, tx_z)][CoordZ(rx_lat, rx_long, rx_z)][FreqKey(frequency)][time] = value;
 //       insertValue(CoordZ(tx_lat, tx_long, tx_z), CoordZ(rx_lat, rx_long, rx_z), frequency, value );
 
       initial_arrmap_size++;
@@ -153,7 +152,7 @@ const TimeArr* ResTimeArrTxtDb::readMap( const CoordZ& tx, const CoordZ& rx, con
       
       if(debug) ::std::cout << "ResTimeArrTxtDb::readMap() rx coords found." << ::std::endl;
       
-      FMCIter it3 = it2->second.find( PDouble( freq, RES_TIME_ARR_FREQ_PRECISION ) );
+      FMCIter it3 = it2->second.find( FreqKey(freq) );
       
       if ( it3 != it2->second.end() ) {
         
@@ -403,7 +402,7 @@ bool ResTimeArrTxtDb::insertValue( const CoordZ& coord_tx, const CoordZ& coord_r
 
     if (debug) ::std::cout << "ResTimeArrTxtDb::insertValue() no tx CoordZ found" << ::std::endl;
     
-    arrivals_map[coord_tx][coord_rx][PDouble(frequency, RES_TIME_ARR_FREQ_PRECISION)][time_value] = channel;
+    arrivals_map[coord_tx][coord_rx][FreqKey(frequency)][time_value] = channel;
     
 //     debugWaitForUser();
   }
@@ -414,18 +413,18 @@ bool ResTimeArrTxtDb::insertValue( const CoordZ& coord_tx, const CoordZ& coord_r
 
       if (debug) ::std::cout << "ResTimeArrTxtDb::insertValue() no rx CoordZ found" << ::std::endl;
 
-      (it1->second)[coord_rx][PDouble(frequency, RES_TIME_ARR_FREQ_PRECISION)][time_value] = channel;
+      (it1->second)[coord_rx][FreqKey(frequency)][time_value] = channel;
       
 //       debugWaitForUser();
     }
     else {
-      FMIter it3 = it2->second.find( PDouble(frequency, RES_TIME_ARR_FREQ_PRECISION) );
+      FMIter it3 = it2->second.find( FreqKey(frequency) );
       
       if ( it3 == it2->second.end() ) { // no freq found
         
         if (debug) ::std::cout << "ResTimeArrTxtDb::insertValue() no frequency found" << ::std::endl;
 
-        (it2->second)[PDouble(frequency, RES_TIME_ARR_FREQ_PRECISION)][time_value] = channel;
+        (it2->second)[FreqKey(frequency)][time_value] = channel;
         
 //         debugWaitForUser();
       }
@@ -42,6 +42,8 @@
 
 
 #include <coordinates-definitions.h>
+#include <quantized-double.h>
+#include <coordinates-spatial-map.h>
 #include <time-arrival-definitions.h>
 #include "woss-db.h"
 
@@ -112,6 +114,9 @@ namespace woss {
     static double getSpaceSampling() { return space_sampling; }
     
     
+    friend class ResTimeArrMmapDb;
+    
+    
     protected:
   
       
@@ -120,22 +125,27 @@ namespace woss {
     typedef TimeMap::const_iterator TMCIter;
     typedef TimeMap::reverse_iterator TMRIter;
     
-    typedef ::std::map< PDouble, TimeMap > FreqMap;
+    /**
+    * Frequency key, quantized at 1e-5 Hz
+    **/
+    typedef QDouble< 100000 > FreqKey;
+    
+    typedef ::std::map< FreqKey, TimeMap > FreqMap;
     typedef FreqMap::iterator FMIter;
     typedef FreqMap::const_iterator FMCIter;
     typedef FreqMap::reverse_iterator FMRIter;
     
-    typedef ::std::map< CoordZ, FreqMap, CoordComparator< ResTimeArrTxtDb, CoordZ > > RxMap;
+    typedef CoordZSpatialMap< FreqMap, ResTimeArrTxtDb > RxMap;
 //     typedef ::std::map< CoordZ, FreqMap > RxMap;
     typedef RxMap::iterator RxMIter;
     typedef RxMap::const_iterator RxMCIter;
     typedef RxMap::reverse_iterator RxMRIter;
     
     /**
-    * Multidimensional map that links a transmitter CoordZ to a receiver CoordZ to a frequency PDouble value 
+    * Multidimensional map that links a transmitter CoordZ to a receiver CoordZ to a frequency FreqKey value 
     * and finally to a TimeArr value
     **/
-    typedef ::std::map< CoordZ, RxMap, CoordComparator< ResTimeArrTxtDb, CoordZ > > ArrMatrix;
+    typedef CoordZSpatialMap< RxMap, ResTimeArrTxtDb > ArrMatrix;
 //     typedef ::std::map< CoordZ, RxMap > ArrMatrix;
     typedef ArrMatrix::iterator AMXIter;
     typedef ArrMatrix::const_iterator AMXCIter;
@@ -41,9 +41,11 @@
 #include <cmath>
 #include <cstdlib>
 #include <cassert>
+#include <vector>
 #include "sediment-deck41-coord-db.h" 
 
 #define SEDIMENT_NOT_FOUND (-100000000)
+#define DECK41_MAX_HYPERSLAB_CELLS (1048576)
 
 using namespace woss;
 
@@ -290,4 +292,80 @@ Deck41Types SedimDeck41CoordDb::getSeaFloorType( const Coord& coordinates ) cons
   return( ::std::make_pair( main_type, secondary_type ) );
 }
 
+
+Deck41TypesVector SedimDeck41CoordDb::getSeaFloorTypes( const CoordZVector& coordz_vector ) const {
+  Deck41TypesVector types_vector;
+  types_vector.reserve( coordz_vector.size() );
+
+#if defined (WOSS_NETCDF4_SUPPORT)
+  if (deck41_db_type == DECK41_DB_V2_TYPE) {
+    NetcdfIndexesVector indexes;
+    indexes.reserve( coordz_vector.size() );
+
+    for ( int i = 0; i < (int) coordz_vector.size(); i++ ) {
+      ::std::pair<int, int> curr_indexes = getSedimIndexes( coordz_vector[i] );
+      indexes.push_back( NetcdfIndexes( curr_indexes.first, curr_indexes.second ) );
+    }
+
+    ::std::vector<int> main_hyperslab;
+    ::std::vector<int> sec_hyperslab;
+    int start = 0;
+
+    while ( start < (int) coordz_vector.size() ) {
+      NetcdfIndexes min_indexes;
+      NetcdfIndexes max_indexes;
+
+      int end = getHyperslabEnd( indexes, start, DECK41_MAX_HYPERSLAB_CELLS, min_indexes, max_indexes );
+
+      long lat_count = max_indexes.first - min_indexes.first + 1;
+      long lon_count = max_indexes.second - min_indexes.second + 1;
+
+      main_hyperslab.assign( lat_count * lon_count, SEDIMENT_NOT_FOUND );
+      sec_hyperslab.assign( lat_count * lon_count, SEDIMENT_NOT_FOUND );
+
+      ::std::vector<size_t> index_vector;
+      ::std::vector<size_t> count_vector;
+
+      index_vector.push_back((size_t)min_indexes.first);
+      index_vector.push_back((size_t)min_indexes.second);
+      count_vector.push_back((size_t)lat_count);
+      count_vector.push_back((size_t)lon_count);
+
+      main_sedim_var_coord.getVar(index_vector, count_vector, &main_hyperslab[0]);
+      sec_sedim_var_coord.getVar(index_vector, count_vector, &sec_hyperslab[0]);
+
+      if (debug)
+        ::std::cout << "SedimDeck41CoordDb::getSeaFloorTypes() coordinates from " << start << " to " << end << "; hyperslab indexes = " 
+                    << min_indexes.first << "," << min_indexes.second << "; counts = " << lat_count << "," << lon_count << ::std::endl;
+
+      for ( int i = start; i < end; i++ ) {
+        long offset = ( indexes[i].first - min_indexes.first ) * lon_count + indexes[i].second - min_indexes.second;
+
+        if (main_hyperslab[offset] == SEDIMENT_NOT_FOUND) {
+          ::std::cout << "SedimDeck41CoordDb::getSeaFloorTypes() Couldn't extract current main_type" << ::std::endl;
+          exit(1);
+        }
+
+        if (sec_hyperslab[offset] == SEDIMENT_NOT_FOUND) {
+          ::std::cout << "SedimDeck41CoordDb::getSeaFloorTypes() Couldn't extract current secondary_type" << ::std::endl;
+          exit(1);
+        }
+
+        types_vector.push_back( ::std::make_pair( main_hyperslab[offset], sec_hyperslab[offset] ) );
+      }
+
+      start = end;
+    }
+
+    return types_vector;
+  }
+#endif // defined (WOSS_NETCDF4_SUPPORT)
+
+  // DECK41 V1 variables are 1D, a transect hyperslab would span whole latitude rows
+  for ( int i = 0; i < (int) coordz_vector.size(); i++ ) {
+    types_vector.push_back( getSeaFloorType( coordz_vector[i] ) );
+  }
+  return types_vector;
+}
+
 #endif // WOSS_NETCDF_SUPPORT
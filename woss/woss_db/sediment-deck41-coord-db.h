@@ -52,6 +52,12 @@
 namespace woss {
 
     
+  /**
+  * Vector of Deck41Types, one for each CoordZ of a transect
+  **/
+  typedef ::std::vector< Deck41Types > Deck41TypesVector;
+
+
   static const int DECK41_MINUTES_SEDIM_NLAT = 10801; /**< Custom made NetCDF DECK41 total number of latitudes */
 
   static const int DECK41_MINUTES_SEDIM_NLON = 21601; /**< Custom made NetCDF DECK41 total number of longitudes */
@@ -120,6 +126,14 @@ namespace woss {
     **/
     Deck41Types getSeaFloorType( const Coord& coordinates ) const ;
 
+    /**
+    * Returns a Deck41Types for each CoordZ of the given transect, as getSeaFloorType() would.
+    * DECK41 V2 databases answer each group of consecutive coordinates with a single hyperslab read
+    * @param coordz_vector const reference to a valid CoordZ vector
+    * @returns a Deck41TypesVector with the same size of <i>coordz_vector</i>
+    **/
+    Deck41TypesVector getSeaFloorTypes( const CoordZVector& coordz_vector ) const ;
+
 
     /**
     * Post openConnection() actions, used to create and initialize NetCDF variables
@@ -245,8 +245,13 @@ Deck41Types SedimDeck41Db::getDeck41TypesFromMarsdenSquare( const CoordZVector&
 
 
 Deck41Types SedimDeck41Db::calculateDeck41Types( const CoordZVector& coordz_vector ) const {
+  return( calculateDeck41Types( coordz_vector, getDeck41TypesFromCoords(coordz_vector) ) );
+}
+
+
+Deck41Types SedimDeck41Db::calculateDeck41Types( const CoordZVector& coordz_vector, const Deck41Types& coord_types ) const {
 
-  Deck41Types floor_types = getDeck41TypesFromCoords(coordz_vector);
+  Deck41Types floor_types = coord_types;
 
   if (debug) ::std::cout << "SedimDeck41Db::calculateDeck41Types() coord main type = " << floor_types.first << "; second type = "
                         << floor_types.second << ::std::endl;
@@ -367,6 +372,23 @@ Sediment* SedimDeck41Db::getValue( const CoordZ& coordz ) const {
 }
 
 
+SedimentVector SedimDeck41Db::getValues( const CoordZVector& coordz_vector ) const {
+  SedimentVector sediment_vector;
+  sediment_vector.reserve( coordz_vector.size() );
+
+  Deck41TypesVector coord_types = sediment_coord_db.getSeaFloorTypes( coordz_vector );
+
+  for ( int i = 0; i < (int) coordz_vector.size(); i++ ) {
+    // a single coordinate is its own most frequent type
+    Deck41Types curr_types( coord_types[i] );
+    CoordZVector curr_vector( 1, coordz_vector[i] );
+
+    sediment_vector.push_back( calculateSediment( calculateDeck41Types( curr_vector, curr_types ), coordz_vector[i].getDepth() ) );
+  }
+  return sediment_vector;
+}
+
+
 #endif // WOSS_NETCDF_SUPPORT
 
 
@@ -142,6 +142,15 @@ namespace woss {
     **/
     virtual Sediment* getValue( const CoordZVector& coordz_vector ) const ;
 
+    /**
+    * Returns a pointer to a heap-based Sediment for each CoordZ of the given transect, as getValue( const CoordZ& ) would.
+    * The DECK41 coordinates database is queried once for the whole transect.
+    * <b>User is responsible of pointers' ownership</b>
+    * @param coordz_vector const reference to a valid CoordZ vector
+    * @return SedimentVector with the same size of <i>coordz_vector</i>
+    **/
+    virtual SedimentVector getValues( const CoordZVector& coordz_vector ) const ;
+
 
     protected:
 
@@ -225,6 +234,14 @@ namespace woss {
     **/
     Deck41Types calculateDeck41Types( const CoordZVector& coordz_vector ) const;
 
+    /**
+    * Same as calculateDeck41Types( const CoordZVector& ), with the coord db search already done
+    * @param coordz_vector a vector of <i>valid</i> CoordZ
+    * @param coord_types the Deck41Types returned by getDeck41TypesFromCoords() for <i>coordz_vector</i>
+    * @returns the corresponding Deck41Types (main sediment type, second sediment type) of the vector
+    **/
+    Deck41Types calculateDeck41Types( const CoordZVector& coordz_vector, const Deck41Types& coord_types ) const;
+
 
     /**
     * Creates the corresponding Sediment from the searched Deck41Types returned by calculateDeck41Types
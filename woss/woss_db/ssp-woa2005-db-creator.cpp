@@ -49,7 +49,11 @@ using namespace woss;
 
 SspWoa2005DbCreator::SspWoa2005DbCreator()
 : WossDbCreator(),
-  woa_db_type(WOA_DB_TYPE_2005)
+  woa_db_type(WOA_DB_TYPE_2005),
+  preload_south_west(),
+  preload_north_east(),
+  monthly_pathnames(),
+  bilinear_interpolation(false)
 {
 
 }
@@ -57,7 +61,11 @@ SspWoa2005DbCreator::SspWoa2005DbCreator()
 #if defined (WOSS_NETCDF4_SUPPORT)
 SspWoa2005DbCreator::SspWoa2005DbCreator( WOADbType db_type )
 : WossDbCreator(),
-  woa_db_type(db_type)
+  woa_db_type(db_type),
+  preload_south_west(),
+  preload_north_east(),
+  monthly_pathnames(),
+  bilinear_interpolation(false)
 {
 
 }
@@ -77,6 +85,13 @@ WossDb* const SspWoa2005DbCreator::createWossDb() {
   SspWoa2005Db* woss_db = new SspWoa2005Db( pathname );
 #endif // defined (WOSS_NETCDF4_SUPPORT)
 
+  woss_db->setPreloadRegion( preload_south_west, preload_north_east );
+  woss_db->setBilinearInterpolation( bilinear_interpolation );
+
+  for ( ::std::map< int, ::std::string >::const_iterator it = monthly_pathnames.begin(); it != monthly_pathnames.end(); it++ ) {
+    woss_db->setMonthlyDbPathName( it->first, it->second );
+  }
+
   assert( initializeDb( woss_db ) );
   
   return( woss_db );
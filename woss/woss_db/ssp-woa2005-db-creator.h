@@ -99,6 +99,37 @@ namespace woss {
     SspWoa2005DbCreator& setWoaDbType(WOADbType type) { woa_db_type = type; return *this; }
 #endif // defined (WOSS_NETCDF4_SUPPORT)
 
+    /**
+    * Sets the region that will be preloaded by the db at connection time
+    * @param south_west const reference to a valid Coord, south west corner of the region
+    * @param north_east const reference to a valid Coord, north east corner of the region
+    * @return reference to <b>*this</b>
+    **/
+    SspWoa2005DbCreator& setPreloadRegion( const Coord& south_west, const Coord& north_east ) { 
+      preload_south_west = south_west; preload_north_east = north_east; return *this; }
+
+    /**
+    * Sets the pathname of the monthly average database that will be preloaded for the given month
+    * @param month month value between 1 and 12
+    * @param name pathname of the monthly average database
+    * @return reference to <b>*this</b>
+    **/
+    SspWoa2005DbCreator& setMonthlyDbPathName( int month, const ::std::string& name ) { 
+      monthly_pathnames[month] = name; return *this; }
+
+    /**
+    * Enables or disables the bilinear interpolation of preloaded SSPs
+    * @param flag <i>true</i> for bilinear interpolation, <i>false</i> for the nearest cell
+    * @return reference to <b>*this</b>
+    **/
+    SspWoa2005DbCreator& setBilinearInterpolation( bool flag ) { bilinear_interpolation = flag; return *this; }
+
+    /**
+    * Gets the bilinear interpolation flag of the db that will be opened
+    * @return bilinear_interpolation
+    **/
+    bool getBilinearInterpolation() const { return bilinear_interpolation; }
+
     protected:
     
     
@@ -110,6 +141,26 @@ namespace woss {
     virtual bool initializeDb( WossDb* const woss_db );
 
     WOADbType woa_db_type;
+
+    /**
+    * South west corner of the region to be preloaded
+    **/
+    Coord preload_south_west;
+
+    /**
+    * North east corner of the region to be preloaded
+    **/
+    Coord preload_north_east;
+
+    /**
+    * Map that links a month value between 1 and 12 to the pathname of its monthly average database
+    **/
+    ::std::map< int, ::std::string > monthly_pathnames;
+
+    /**
+    * Bilinear interpolation flag
+    **/
+    bool bilinear_interpolation;
   };
 
 }
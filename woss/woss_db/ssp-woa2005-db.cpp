@@ -39,6 +39,8 @@
 #ifdef WOSS_NETCDF_SUPPORT
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
 #include <stdlib.h>
 #include <definitions-handler.h>
 #include "ssp-woa2005-db.h"
@@ -47,11 +49,20 @@
 using namespace woss;
 
 #define SSP_NOT_VALID (-1000)
+#define SSP_MAX_HYPERSLAB_CELLS (32768)
 
 
 SspWoa2005Db::SspWoa2005Db( const ::std::string& name ) 
 : WossNetcdfDb(name),
   woa_db_type(WOA_DB_TYPE_2005),
+  preload_south_west(),
+  preload_north_east(),
+  monthly_pathnames(),
+  bilinear_interpolation(false),
+  preload_start(0, 0),
+  preload_count(0, 0),
+  preload_cube(),
+  monthly_cubes(),
 #if defined (WOSS_NETCDF4_SUPPORT)
   ssp_var(),
   lat_var(),
@@ -66,6 +77,14 @@ SspWoa2005Db::SspWoa2005Db( const ::std::string& name )
 SspWoa2005Db::SspWoa2005Db( const ::std::string& name, WOADbType db_type )
 : WossNetcdfDb(name),
   woa_db_type(db_type),
+  preload_south_west(),
+  preload_north_east(),
+  monthly_pathnames(),
+  bilinear_interpolation(false),
+  preload_start(0, 0),
+  preload_count(0, 0),
+  preload_cube(),
+  monthly_cubes(),
   ssp_var(),
   lat_var(),
   lon_var()
@@ -82,10 +101,10 @@ bool SspWoa2005Db::finalizeConnection() {
       ::std::cout << "SspWoa2005Db::finalizeConnection() 2005 ssp_var is not valid" << ::std::endl;
       return false;
     }
-    return true;
+    return preloadRegion();
   #else
     ssp_var = netcdf_db->get_var( "ssp" );
-    return (ssp_var != 0);
+    return (ssp_var != 0 && preloadRegion());
 #endif // defined (WOSS_NETCDF4_SUPPORT)
   }
 #if defined (WOSS_NETCDF4_SUPPORT)
@@ -108,7 +127,7 @@ bool SspWoa2005Db::finalizeConnection() {
       return false;
     }
 
-    return true;
+    return preloadRegion();
   }
 #endif // defined (WOSS_NETCDF4_SUPPORT)
   else {
@@ -263,11 +282,226 @@ void SspWoa2005Db::getSSPValue( const SSPIndexes& indexes, double* ssp_values )
 }
 
 
+void SspWoa2005Db::setMonthlyDbPathName( int month, const ::std::string& name ) {
+  assert( month >= 1 && month <= SSP_WOA_TOTAL_MONTHS );
+
+  monthly_pathnames[month - 1] = name;
+}
+
+
+SSPIndexes SspWoa2005Db::getSSPGrid( double& start_lat, double& start_lon, double& lat_step, double& lon_step ) const {
+  if (woa_db_type == WOA_DB_TYPE_2013) {
+    start_lat = SSP_WOA2013_STD_START_LAT;
+    start_lon = SSP_WOA2013_STD_START_LON;
+    lat_step = SSP_WOA2013_STD_SPACING;
+    lon_step = SSP_WOA2013_STD_SPACING;
+
+    return ( ::std::make_pair(SSP_WOA2013_STD_NLAT, SSP_WOA2013_STD_NLON) );
+  }
+
+  // WOA2005 latitudes go from north to south
+  start_lat = SSP_WOA2005_STD_START_LAT;
+  start_lon = SSP_WOA2005_STD_START_LON;
+  lat_step = -SSP_WOA2005_STD_SPACING;
+  lon_step = SSP_WOA2005_STD_SPACING;
+
+  return ( ::std::make_pair(SSP_WOA2005_STD_NLAT, SSP_WOA2005_STD_NLON) );
+}
+
+
+bool SspWoa2005Db::preloadRegion() {
+  preload_cube.clear();
+  monthly_cubes.clear();
+
+  if ( !preload_south_west.isValid() || !preload_north_east.isValid() ) return true;
+
+  double start_lat, start_lon, lat_step, lon_step;
+  SSPIndexes grid_size = getSSPGrid( start_lat, start_lon, lat_step, lon_step );
+
+  SSPIndexes corner_a = getSSPIndexes( preload_south_west );
+  SSPIndexes corner_b = getSSPIndexes( preload_north_east );
+
+  if ( corner_a.first == SSP_NOT_VALID || corner_b.first == SSP_NOT_VALID ) {
+    ::std::cout << "SspWoa2005Db::preloadRegion() invalid preload region " << preload_south_west << " , " << preload_north_east << ::std::endl;
+    return false;
+  }
+
+  // one more cell on each side for the bilinear interpolation
+  int min_lat = ::std::max( ::std::min( corner_a.first, corner_b.first ) - 1, 0 );
+  int max_lat = ::std::min( ::std::max( corner_a.first, corner_b.first ) + 1, grid_size.first - 1 );
+  int min_lon = ::std::max( ::std::min( corner_a.second, corner_b.second ) - 1, 0 );
+  int max_lon = ::std::min( ::std::max( corner_a.second, corner_b.second ) + 1, grid_size.second - 1 );
+
+  preload_start = ::std::make_pair( min_lat, min_lon );
+  preload_count = ::std::make_pair( max_lat - min_lat + 1, max_lon - min_lon + 1 );
+
+  if ( !readSSPCube( ssp_var, preload_cube ) ) return false;
+
+  if (debug) ::std::cout << "SspWoa2005Db::preloadRegion() start indexes = " << preload_start.first << " , " << preload_start.second 
+                        << "; counts = " << preload_count.first << " , " << preload_count.second << ::std::endl;
+
+  if ( monthly_pathnames.empty() ) return true;
+
+  monthly_cubes.resize( SSP_WOA_TOTAL_MONTHS );
+
+  for ( MPMCIter it = monthly_pathnames.begin(); it != monthly_pathnames.end(); it++ ) {
+    if (debug) ::std::cout << "SspWoa2005Db::preloadRegion() month = " << it->first + 1 << "; pathname = " << it->second << ::std::endl;
+
+#if defined (WOSS_NETCDF4_SUPPORT)
+    netCDF::NcFile monthly_db( it->second, netCDF::NcFile::read );
+    netCDF::NcVar monthly_var = monthly_db.getVar("ssp");
+
+    if ( monthly_var.isNull() || !readSSPCube( monthly_var, monthly_cubes[it->first] ) ) {
+#else
+    NcFile monthly_db( it->second.c_str() );
+
+    if ( !monthly_db.is_valid() || !readSSPCube( monthly_db.get_var( "ssp" ), monthly_cubes[it->first] ) ) {
+#endif // defined (WOSS_NETCDF4_SUPPORT)
+      ::std::cout << "SspWoa2005Db::preloadRegion() couldn't preload month = " << it->first + 1 << "; pathname = " << it->second << ::std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+#if defined (WOSS_NETCDF4_SUPPORT)
+bool SspWoa2005Db::readSSPCube( const netCDF::NcVar& var, SSPCube& cube ) const {
+  ::std::vector<size_t> index_vector, count_vector;
+
+  index_vector.push_back((size_t)preload_start.first);
+  index_vector.push_back((size_t)preload_start.second);
+  index_vector.push_back((size_t)0);
+
+  count_vector.push_back((size_t)preload_count.first);
+  count_vector.push_back((size_t)preload_count.second);
+  count_vector.push_back((size_t)SSP_STD_NDEPTH);
+
+  cube.assign( preload_count.first * preload_count.second * SSP_STD_NDEPTH, SSP_NOT_VALID );
+
+  var.getVar(index_vector, count_vector, &cube[0]);
+  if (cube[0] == SSP_NOT_VALID) {
+    ::std::cerr << "SspWoa2005Db::readSSPCube() Couldn't extract ssp region" << ::std::endl;
+    cube.clear();
+    return false;
+  }
+  return true;
+}
+#else
+bool SspWoa2005Db::readSSPCube( NcVar* var, SSPCube& cube ) const {
+  if ( var == NULL ) return false;
+
+  cube.assign( preload_count.first * preload_count.second * SSP_STD_NDEPTH, SSP_NOT_VALID );
+
+  if ( !var->set_cur(preload_start.first, preload_start.second, 0) 
+       || !var->get(&cube[0], preload_count.first, preload_count.second, SSP_STD_NDEPTH) ) {
+    ::std::cerr << "SspWoa2005Db::readSSPCube() Couldn't extract ssp region" << ::std::endl;
+    cube.clear();
+    return false;
+  }
+  return true;
+}
+#endif // defined (WOSS_NETCDF4_SUPPORT)
+
+
+bool SspWoa2005Db::getPreloadedSSPValue( const SSPIndexes& indexes, const Time& time, double ssp_values[] ) const {
+  int lat_offset = indexes.first - preload_start.first;
+  int lon_offset = indexes.second - preload_start.second;
+
+  if ( lat_offset < 0 || lon_offset < 0 || lat_offset >= preload_count.first || lon_offset >= preload_count.second ) return false;
+
+  long offset = ( (long) lat_offset * preload_count.second + lon_offset ) * SSP_STD_NDEPTH;
+
+  const SSPCube* prev_cube = &preload_cube;
+  const SSPCube* next_cube = &preload_cube;
+  double next_weight = 0.0;
+
+  if ( !monthly_cubes.empty() && time.isValid() ) {
+    static const int month_days[SSP_WOA_TOTAL_MONTHS] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    int month = time.getMonth();
+    int year = time.getYear() + 1900;
+    int days = month_days[month];
+    if ( month == 1 && ( ( year % 4 == 0 && year % 100 != 0 ) || year % 400 == 0 ) ) days++;
+
+    // monthly averages are centered in the middle of their month
+    double month_position = ( time.getDay() - 1 + ( time.getHours() + time.getMinutes() / 60.0 ) / 24.0 ) / days;
+    int prev_month = ( month_position < 0.5 ) ? ( month + SSP_WOA_TOTAL_MONTHS - 1 ) % SSP_WOA_TOTAL_MONTHS : month;
+    int next_month = ( prev_month + 1 ) % SSP_WOA_TOTAL_MONTHS;
+    next_weight = ( month_position < 0.5 ) ? month_position + 0.5 : month_position - 0.5;
+
+    if ( monthly_cubes[prev_month].size() > 0 ) prev_cube = &monthly_cubes[prev_month];
+    if ( monthly_cubes[next_month].size() > 0 ) next_cube = &monthly_cubes[next_month];
+
+    if ( prev_cube == &preload_cube && next_cube != &preload_cube ) prev_cube = next_cube;
+    else if ( next_cube == &preload_cube && prev_cube != &preload_cube ) next_cube = prev_cube;
+
+    if (debug) ::std::cout << "SspWoa2005Db::getPreloadedSSPValue() month = " << month + 1 << "; prev month = " << prev_month + 1 
+                          << "; next month = " << next_month + 1 << "; next weight = " << next_weight << ::std::endl;
+  }
+
+  for ( int i = 0; i < SSP_STD_NDEPTH; i++ ) {
+    double prev_value = (*prev_cube)[offset + i];
+    double next_value = (*next_cube)[offset + i];
+
+    // land values stay on land
+    if ( prev_value == 0.0 || next_value == 0.0 ) ssp_values[i] = 0.0;
+    else ssp_values[i] = ( 1.0 - next_weight ) * prev_value + next_weight * next_value;
+  }
+  return true;
+}
+
+
+bool SspWoa2005Db::getPreloadedSSP( const Coord& coordinates, const Time& time, double ssp_values[] ) const {
+  SSPIndexes nearest = getSSPIndexes( coordinates );
+
+  if ( !bilinear_interpolation ) return getPreloadedSSPValue( nearest, time, ssp_values );
+
+  double start_lat, start_lon, lat_step, lon_step;
+  getSSPGrid( start_lat, start_lon, lat_step, lon_step );
+
+  double lat_position = ( coordinates.getLatitude() - start_lat ) / lat_step;
+  double lon_position = ( coordinates.getLongitude() - start_lon ) / lon_step;
+
+  int lat_index = (int) floor( lat_position );
+  int lon_index = (int) floor( lon_position );
+
+  double lat_weight = lat_position - lat_index;
+  double lon_weight = lon_position - lon_index;
+
+  double corners[4][SSP_STD_NDEPTH];
+
+  if ( !getPreloadedSSPValue( ::std::make_pair( lat_index, lon_index ), time, corners[0] ) 
+       || !getPreloadedSSPValue( ::std::make_pair( lat_index, lon_index + 1 ), time, corners[1] ) 
+       || !getPreloadedSSPValue( ::std::make_pair( lat_index + 1, lon_index ), time, corners[2] ) 
+       || !getPreloadedSSPValue( ::std::make_pair( lat_index + 1, lon_index + 1 ), time, corners[3] ) ) {
+    return getPreloadedSSPValue( nearest, time, ssp_values );
+  }
+
+  for ( int i = 0; i < SSP_STD_NDEPTH; i++ ) {
+    if ( corners[0][i] == 0.0 || corners[1][i] == 0.0 || corners[2][i] == 0.0 || corners[3][i] == 0.0 ) {
+      if (debug) ::std::cout << "SspWoa2005Db::getPreloadedSSP() coordinates = " << coordinates << " next to land, using nearest cell" << ::std::endl;
+
+      return getPreloadedSSPValue( nearest, time, ssp_values );
+    }
+
+    ssp_values[i] = ( 1.0 - lat_weight ) * ( ( 1.0 - lon_weight ) * corners[0][i] + lon_weight * corners[1][i] )
+                    + lat_weight * ( ( 1.0 - lon_weight ) * corners[2][i] + lon_weight * corners[3][i] );
+  }
+  return true;
+}
+
+
 SSP* SspWoa2005Db::getValue( const Coord& coordinates, const Time& time, long double ssp_depth_precision ) const {
   double curr_ssp[SSP_STD_NDEPTH];
 
-  DepthMap ssp_map;
-  
+  if ( isPreloaded() && getPreloadedSSP( coordinates, time, curr_ssp ) ) {
+    if(debug) ::std::cout << "SspWoa2005Db::getValue() coordinates = " << coordinates << " preloaded" << ::std::endl;
+
+    return( createSSP( coordinates, curr_ssp, ssp_depth_precision ) );
+  }
+
   SSPIndexes curr_ind = getSSPIndexes(coordinates);
   
   if(debug) ::std::cout << "SspWoa2005Db::getValue() coordinates = " << coordinates << "; indexes = " << curr_ind.first << " , " 
@@ -279,22 +513,116 @@ SSP* SspWoa2005Db::getValue( const Coord& coordinates, const Time& time, long do
   getSSPValue( curr_ind, curr_ssp );
 #endif // defined (WOSS_NETCDF4_SUPPORT)
   
+  return( createSSP( coordinates, curr_ssp, ssp_depth_precision ) );
+}
+
+
+SSP* SspWoa2005Db::createSSP( const Coord& coordinates, const double ssp_values[], long double ssp_depth_precision ) const {
+  DepthMap ssp_map;
+
   for (int i = 0; i < SSP_STD_NDEPTH; i++) {
     
-    if(debug) ::std::cout << "SspWoa2005Db::getValue() depth = " << ssp_std_depths[i] << "; ssp value = " << curr_ssp[i] << ::std::endl;
+    if(debug) ::std::cout << "SspWoa2005Db::createSSP() depth = " << ssp_std_depths[i] << "; ssp value = " << ssp_values[i] << ::std::endl;
 
     // if ssp_values = 0.0 ===> coords are quantized on land
-    if ( curr_ssp[i] == 0.0 ) {
+    if ( ssp_values[i] == 0.0 ) {
       
       ::std::cerr << "SspWoa2005Db::getValue() coordinates = " << coordinates << " are quantized on land. " << ::std::endl; // trial no " << tries_counter << ::std::endl;
 
       return SDefHandler::instance()->getSSP()->create();
     }
-    ssp_map.insert( ::std::make_pair( PDouble( ssp_std_depths[i], ssp_depth_precision ), curr_ssp[i] ) );
+    ssp_map.insert( ::std::make_pair( PDouble( ssp_std_depths[i], ssp_depth_precision ), ssp_values[i] ) );
   }
 
   return( SDefHandler::instance()->getSSP()->create( ssp_map, ssp_depth_precision ) );
 }
 
+
+SSPVector SspWoa2005Db::getValues( const CoordZVector& coordz_vector, const Time& time, long double ssp_depth_precision ) const {
+  if ( isPreloaded() ) {
+    // preloaded coordinates need no NetCDF access
+    return WossSSPDb::getValues( coordz_vector, time, ssp_depth_precision );
+  }
+
+  SSPVector ssp_vector;
+  ssp_vector.reserve( coordz_vector.size() );
+
+  NetcdfIndexesVector indexes;
+  indexes.reserve( coordz_vector.size() );
+
+  for ( int i = 0; i < (int) coordz_vector.size(); i++ ) {
+    SSPIndexes curr_ind = getSSPIndexes( coordz_vector[i] );
+
+    if ( curr_ind.first == SSP_NOT_VALID || curr_ind.second == SSP_NOT_VALID ) indexes.push_back( NetcdfIndexes( -1, -1 ) );
+    else indexes.push_back( NetcdfIndexes( curr_ind.first, curr_ind.second ) );
+  }
+
+  ::std::vector< double > hyperslab;
+  int start = 0;
+
+  while ( start < (int) coordz_vector.size() ) {
+    NetcdfIndexes min_indexes;
+    NetcdfIndexes max_indexes;
+
+    int end = getHyperslabEnd( indexes, start, SSP_MAX_HYPERSLAB_CELLS, min_indexes, max_indexes );
+
+    long lat_count = max_indexes.first - min_indexes.first + 1;
+    long lon_count = max_indexes.second - min_indexes.second + 1;
+
+    if ( min_indexes.first >= 0 ) {
+      hyperslab.assign( lat_count * lon_count * SSP_STD_NDEPTH, SSP_NOT_VALID );
+
+#if defined (WOSS_NETCDF4_SUPPORT)
+      ::std::vector<size_t> index_vector, count_vector;
+
+      index_vector.push_back((size_t)min_indexes.first);
+      index_vector.push_back((size_t)min_indexes.second);
+      index_vector.push_back((size_t)0);
+
+      count_vector.push_back((size_t)lat_count);
+      count_vector.push_back((size_t)lon_count);
+      count_vector.push_back((size_t)SSP_STD_NDEPTH);
+
+      ssp_var.getVar(index_vector, count_vector, &hyperslab[0]);
+      if (hyperslab[0] == SSP_NOT_VALID) {
+        ::std::cerr << "SspWoa2005Db::getValues() Couldn't extract ssp hyperslab" << ::std::endl;
+        exit(1);
+      }
+#else
+      NcBool ret_value = ssp_var->set_cur(min_indexes.first, min_indexes.second, 0);
+      if (!ret_value) {
+        ::std::cerr << "SspWoa2005Db::getValues() Couldn't set_cur() " << min_indexes.first << " , " << min_indexes.second << ::std::endl;
+        exit(1);
+      }
+
+      ret_value = ssp_var->get(&hyperslab[0], lat_count, lon_count, SSP_STD_NDEPTH);
+      if (!ret_value) {
+        ::std::cerr << "SspWoa2005Db::getValues() Couldn't extract ssp hyperslab" << ::std::endl;
+        exit(1);
+      }
+#endif // defined (WOSS_NETCDF4_SUPPORT)
+    }
+
+    if(debug) ::std::cout << "SspWoa2005Db::getValues() coordinates from " << start << " to " << end << "; hyperslab indexes = " 
+                          << min_indexes.first << " , " << min_indexes.second << "; counts = " << lat_count << " , " << lon_count << ::std::endl;
+
+    for ( int i = start; i < end; i++ ) {
+      if ( indexes[i].first < 0 ) {
+        // not valid indexes are handled as getValue() does
+        ssp_vector.push_back( getValue( coordz_vector[i], time, ssp_depth_precision ) );
+        continue;
+      }
+
+      long offset = ( ( indexes[i].first - min_indexes.first ) * lon_count + indexes[i].second - min_indexes.second ) * SSP_STD_NDEPTH;
+
+      ssp_vector.push_back( createSSP( coordz_vector[i], &hyperslab[offset], ssp_depth_precision ) );
+    }
+
+    start = end;
+  }
+
+  return ssp_vector;
+}
+
 #endif // WOSS_NETCDF_SUPPORT
 
@@ -44,6 +44,8 @@
 #ifdef WOSS_NETCDF_SUPPORT
 
 
+#include <map>
+#include <vector>
 #include <ssp-definitions.h>
 #include "woss-db.h"
 #if defined (WOSS_NETCDF4_SUPPORT)
@@ -115,10 +117,17 @@ namespace woss {
     WOA_DB_TYPE_INVALID ///< Must always be the last
   };
 
+  static const int SSP_WOA_TOTAL_MONTHS = 12; /**< Total number of WOA monthly averages */
+
   /**
   * \brief WossDb for the custom made NetCDF WOA2005 SSP database
   *
-  * WossDb for the custom made NetCDF WOA2005 SSP database
+  * WossDb for the custom made NetCDF WOA2005 SSP database. 
+  *
+  * Optionally a region of the database can be preloaded at connection time into a contiguous float array, so 
+  * that SSP queries falling inside the region need no NetCDF access. Additional monthly average databases can 
+  * be preloaded as well, in order to linearly interpolate the SSP between the two nearest months. 
+  * Preloaded SSPs can also be bilinearly interpolated between the four surrounding cells
   */
   class SspWoa2005Db : public WossNetcdfDb, public WossSSPDb {
 
@@ -171,6 +180,17 @@ namespace woss {
     **/  
     virtual SSP* getValue( const Coord& coordinates, const Time& time, long double ssp_depth_precision ) const ;
 
+    /**
+    * Returns a pointer to a heap-based SSP for each CoordZ of the given transect, as getValue() would.
+    * Each group of consecutive coordinates is answered by a single hyperslab read of the SSP variable.
+    * <b>User is responsible of pointers' ownership</b>
+    * @param coordz_vector const reference to a valid CoordZ vector
+    * @param time const reference to a valid Time object
+    * @param ssp_depth_precision ssp depth precision [m]
+    * @return SSPVector with the same size of <i>coordz_vector</i>
+    **/  
+    virtual SSPVector getValues( const CoordZVector& coordz_vector, const Time& time, long double ssp_depth_precision ) const ;
+
     /**
     * Returns current WOADbType
     * @return current WOADbType
@@ -178,13 +198,102 @@ namespace woss {
     WOADbType getWoaDbType() const { return woa_db_type; }
 
 
+    /**
+    * Sets the region that will be preloaded by finalizeConnection()
+    * @param south_west const reference to a valid Coord, south west corner of the region
+    * @param north_east const reference to a valid Coord, north east corner of the region
+    **/
+    void setPreloadRegion( const Coord& south_west, const Coord& north_east ) { preload_south_west = south_west; preload_north_east = north_east; }
+
+    /**
+    * Sets the pathname of the monthly average database that will be preloaded for the given month
+    * by finalizeConnection(). A preload region has to be set.
+    * @param month month value between 1 and 12
+    * @param name pathname of the monthly average database
+    **/
+    void setMonthlyDbPathName( int month, const ::std::string& name );
+
+    /**
+    * Returns <i>true</i> if a region has been preloaded
+    * @return <i>true</i> if SSP queries inside the region need no NetCDF access
+    **/
+    bool isPreloaded() const { return ( preload_cube.size() > 0 ); }
+
+    /**
+    * Enables or disables the bilinear interpolation of preloaded SSPs. If any of the four surrounding cells
+    * is on land the nearest cell is used
+    * @param flag <i>true</i> for bilinear interpolation, <i>false</i> for the nearest cell
+    **/
+    void setBilinearInterpolation( bool flag ) { bilinear_interpolation = flag; }
+
+    /**
+    * Returns <i>true</i> if preloaded SSPs are bilinearly interpolated
+    * @return bilinear interpolation flag
+    **/
+    bool getBilinearInterpolation() const { return bilinear_interpolation; }
+
+
     protected:
 
+
+    /**
+    * Preloaded SSP values, stored by latitude, longitude and standard depth
+    **/
+    typedef ::std::vector< float > SSPCube;
+
+    /**
+    * Map that links a month value between 0 and 11 to the pathname of its monthly average database
+    **/
+    typedef ::std::map< int, ::std::string > MonthlyPathMap;
+    typedef MonthlyPathMap::const_iterator MPMCIter;
+
+
   /**
     * WOA Db type
     **/
     WOADbType woa_db_type;
 
+
+    /**
+    * South west corner of the region to be preloaded
+    **/
+    Coord preload_south_west;
+
+    /**
+    * North east corner of the region to be preloaded
+    **/
+    Coord preload_north_east;
+
+    /**
+    * Pathnames of the monthly average databases to be preloaded
+    **/
+    MonthlyPathMap monthly_pathnames;
+
+    /**
+    * Bilinear interpolation flag
+    **/
+    bool bilinear_interpolation;
+
+    /**
+    * Indexes of the first preloaded cell
+    **/
+    SSPIndexes preload_start;
+
+    /**
+    * Number of preloaded latitudes and longitudes
+    **/
+    SSPIndexes preload_count;
+
+    /**
+    * Preloaded region of the database connected by openConnection()
+    **/
+    SSPCube preload_cube;
+
+    /**
+    * Preloaded region of the monthly average databases, indexed by month value between 0 and 11
+    **/
+    ::std::vector< SSPCube > monthly_cubes;
+
   /**
     * NetCDF variable representing SSP
     **/
@@ -229,6 +338,64 @@ namespace woss {
     void getSSPValue( const SSPIndexes& indexes, double ssp_values[] ) const;
 #endif // defined (WOSS_NETCDF4_SUPPORT)
 
+    /**
+    * Returns a pointer to a heap-based SSP made from the given standard depths SSP values
+    * @param coordinates const reference to a valid Coord object
+    * @param ssp_values[] array holding SSP_STD_NDEPTH SSP values
+    * @param ssp_depth_precision ssp depth precision [m]
+    * @return <i>valid</i> SSP if coordinates are not on land, <i>not valid</i> otherwise
+    **/
+    SSP* createSSP( const Coord& coordinates, const double ssp_values[], long double ssp_depth_precision ) const;
+
+
+    /**
+    * Loads the preload region of the database connected by openConnection() and of the monthly average databases
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    bool preloadRegion();
+
+    /**
+    * Reads the preload region of the given SSP variable with a single hyperslab read
+    * @param var SSP variable
+    * @param cube SSPCube that will hold the region
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+#if defined (WOSS_NETCDF4_SUPPORT)
+    bool readSSPCube( const netCDF::NcVar& var, SSPCube& cube ) const;
+#else
+    bool readSSPCube( NcVar* var, SSPCube& cube ) const;
+#endif // defined (WOSS_NETCDF4_SUPPORT)
+
+    /**
+    * Inserts the preloaded SSP values of the given indexes into the given array, linearly interpolated 
+    * between the two nearest monthly averages if available
+    * @param indexes const reference to a valid SSPIndexes object
+    * @param time const reference to a Time object
+    * @param ssp_values[] array that will hold SSP values
+    * @return <i>true</i> if the indexes have been preloaded, <i>false</i> otherwise
+    **/
+    bool getPreloadedSSPValue( const SSPIndexes& indexes, const Time& time, double ssp_values[] ) const;
+
+    /**
+    * Inserts the preloaded SSP values of the given coordinates into the given array, 
+    * nearest cell or bilinearly interpolated
+    * @param coordinates const reference to a valid Coord object
+    * @param time const reference to a Time object
+    * @param ssp_values[] array that will hold SSP values
+    * @return <i>true</i> if the coordinates have been preloaded, <i>false</i> otherwise
+    **/
+    bool getPreloadedSSP( const Coord& coordinates, const Time& time, double ssp_values[] ) const;
+
+    /**
+    * Returns the grid geometry of the database in use
+    * @param start_lat latitude of the first cell [decimal degrees]
+    * @param start_lon longitude of the first cell [decimal degrees]
+    * @param lat_step latitude increment between consecutive indexes [decimal degrees]
+    * @param lon_step longitude increment between consecutive indexes [decimal degrees]
+    * @return total number of latitudes and longitudes
+    **/
+    SSPIndexes getSSPGrid( double& start_lat, double& start_lon, double& lat_step, double& lon_step ) const;
+
     
   };
 
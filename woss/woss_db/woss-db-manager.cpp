@@ -258,6 +258,48 @@ Sediment* WossDbManager::getSediment( const CoordZ& tx_coord, const CoordZVector
 }
 
 
+SedimentVector WossDbManager::getSedimentVector( const CoordZ& tx_coord, const CoordZVector& rx_coordz_vector ) const {
+  SedimentVector sediment_vector( rx_coordz_vector.size(), (Sediment*)NULL );
+
+  if ( !sediment_db ) {
+    for ( int i = 0; i < (int) rx_coordz_vector.size(); i++ ) {
+      sediment_vector[i] = getSediment( tx_coord, rx_coordz_vector[i] );
+    }
+    return sediment_vector;
+  }
+
+  CoordZVector db_coordz_vector;
+  ::std::vector< int > db_indexes;
+
+  for ( int i = 0; i < (int) rx_coordz_vector.size(); i++ ) {
+    if ( !ccsediment_map.empty() ) {
+      Sediment* ptr = ccsediment_map.get( tx_coord, rx_coordz_vector[i] );
+      
+      if ( ptr != NULL ) {
+        sediment_vector[i] = ptr;
+        continue;
+      }
+    }
+    db_indexes.push_back( i );
+    db_coordz_vector.push_back( rx_coordz_vector[i] );
+  }
+
+  if (debug) 
+    ::std::cout << "WossDbManager::getSedimentVector() tx_coord = " << tx_coord << "; CoordZVector size = " << rx_coordz_vector.size() 
+                << "; db queries = " << db_coordz_vector.size() << ::std::endl;
+
+  if ( db_coordz_vector.empty() ) return sediment_vector;
+
+  SedimentVector db_sediment_vector = sediment_db->getValues( db_coordz_vector );
+  assert( db_sediment_vector.size() == db_coordz_vector.size() );
+  
+  for ( int i = 0; i < (int) db_indexes.size(); i++ ) {
+    sediment_vector[ db_indexes[i] ] = db_sediment_vector[i];
+  }
+  return sediment_vector;
+}
+
+
 Bathymetry WossDbManager::getBathymetry( const Coord& tx_coord, const Coord& rx_coord ) const {
   
   if(debug) 
@@ -282,8 +324,39 @@ Bathymetry WossDbManager::getBathymetry( const Coord& tx_coord, const Coord& rx_
 
 
 void WossDbManager::getBathymetry( const Coord& tx_coord, CoordZVector& rx_coordz_vector ) const {
-  for (int i = 0; i < (int) rx_coordz_vector.size(); i++) {
+  if ( !bathymetry_db ) {
+    for (int i = 0; i < (int) rx_coordz_vector.size(); i++) {
       rx_coordz_vector[i].setDepth( getBathymetry( tx_coord, rx_coordz_vector[i] ) ) ;
+    }
+    return;
+  }
+
+  CoordZVector db_coordz_vector;
+  ::std::vector< int > db_indexes;
+
+  for (int i = 0; i < (int) rx_coordz_vector.size(); i++) {
+    if ( !ccbathy_map.empty() ) {
+      const Bathymetry* ptr = ccbathy_map.get( tx_coord, rx_coordz_vector[i] );
+
+      if ( ptr != NULL ) {
+        rx_coordz_vector[i].setDepth( *ptr );
+        continue;
+      }
+    }
+    db_indexes.push_back( i );
+    db_coordz_vector.push_back( rx_coordz_vector[i] );
+  }
+
+  if (debug) 
+    ::std::cout << "WossDbManager::getBathymetry() tx_coord = " << tx_coord << "; CoordZVector size = " << rx_coordz_vector.size() 
+                << "; db queries = " << db_coordz_vector.size() << ::std::endl;
+
+  if ( db_coordz_vector.empty() ) return;
+
+  bathymetry_db->getValues( db_coordz_vector );
+
+  for (int i = 0; i < (int) db_indexes.size(); i++) {
+    rx_coordz_vector[ db_indexes[i] ].setDepth( db_coordz_vector[i].getDepth() );
   }
 }
 
@@ -303,6 +376,48 @@ SSP* WossDbManager::getSSP( const Coord& tx_coord, const Coord& rx_coord, const
 }
 
 
+SSPVector WossDbManager::getSSPVector( const Coord& tx_coord, const CoordZVector& rx_coordz_vector, const Time& time, long double ssp_depth_precision ) const {
+  SSPVector ssp_vector( rx_coordz_vector.size(), (SSP*)NULL );
+
+  if ( !ssp_db ) {
+    for ( int i = 0; i < (int) rx_coordz_vector.size(); i++ ) {
+      ssp_vector[i] = getSSP( tx_coord, rx_coordz_vector[i], time, ssp_depth_precision );
+    }
+    return ssp_vector;
+  }
+
+  CoordZVector db_coordz_vector;
+  ::std::vector< int > db_indexes;
+
+  for ( int i = 0; i < (int) rx_coordz_vector.size(); i++ ) {
+    if ( !ccssp_map.empty() ) {
+      SSP* ptr = ccssp_map.get( tx_coord, rx_coordz_vector[i], time );
+
+      if ( ptr != NULL ) {
+        ssp_vector[i] = ptr;
+        continue;
+      }
+    }
+    db_indexes.push_back( i );
+    db_coordz_vector.push_back( rx_coordz_vector[i] );
+  }
+
+  if (debug) 
+    ::std::cout << "WossDbManager::getSSPVector() tx_coord = " << tx_coord << "; CoordZVector size = " << rx_coordz_vector.size() 
+                << "; db queries = " << db_coordz_vector.size() << ::std::endl;
+
+  if ( db_coordz_vector.empty() ) return ssp_vector;
+
+  SSPVector db_ssp_vector = ssp_db->getValues( db_coordz_vector, time, ssp_depth_precision );
+  assert( db_ssp_vector.size() == db_coordz_vector.size() );
+
+  for ( int i = 0; i < (int) db_indexes.size(); i++ ) {
+    ssp_vector[ db_indexes[i] ] = db_ssp_vector[i];
+  }
+  return ssp_vector;
+}
+
+
 SSP* WossDbManager::getAverageSSP( const Coord& tx_coord, const Coord& rx_coord, const Time& time_start, const Time& time_end, 
 				  int max_time_values, long double ssp_depth_precision ) const {
 
@@ -203,6 +203,16 @@ namespace woss {
     **/
     virtual Sediment* getSediment( const CoordZ& tx, const CoordZVector& rx_coordz_vector ) const;
 
+    /**
+    * Returns a pointer to a heap-created Sediment value for each CoordZ of the given vector, as 
+    * getSediment( const CoordZ&, const CoordZ& ) would. Coordinates without a custom Sediment are 
+    * answered by the Sediment database with a single query.
+    * <b>User is responsible of pointers' ownership</b>
+    * @param coordz_vector const reference to a valid CoordZ vector
+    * @return SedimentVector with the same size of <i>rx_coordz_vector</i>
+    **/
+    virtual SedimentVector getSedimentVector( const CoordZ& tx, const CoordZVector& rx_coordz_vector ) const;
+
 
     /**
     * Returns the positive depth value ( bathymetry ) of given coordinates, if present in the database
@@ -212,7 +222,8 @@ namespace woss {
     virtual Bathymetry getBathymetry( const Coord& tx, const Coord& rx ) const;
 
     /**
-    * Sets the positive depth for each CoordZ present in the vector, HUGE_VAL is set if coordinates are not present in the database
+    * Sets the positive depth for each CoordZ present in the vector, HUGE_VAL is set if coordinates are not present in the database.
+    * Coordinates without a custom Bathymetry are answered by the bathymetry database with a single query
     * @param coords reference to a CoordZVector
     **/
     virtual void getBathymetry( const Coord& tx, CoordZVector& rx_coordz_vector ) const;
@@ -228,6 +239,17 @@ namespace woss {
     **/  
     virtual SSP* getSSP( const Coord& tx, const Coord& rx, const Time& time, long double ssp_depth_precision = SSP_CUSTOM_DEPTH_PRECISION ) const;
 
+    /**
+    * Returns a pointer to a heap-created SSP for each CoordZ of the given vector, as getSSP() would.
+    * Coordinates without a custom SSP are answered by the SSP database with a single query.
+    * <b>User is responsible of pointers' ownership</b>
+    * @param coordz_vector const reference to a valid CoordZ vector
+    * @param time const reference to a valid Time object
+    * @param ssp_depth_precision ssp depth precision [m]
+    * @return SSPVector with the same size of <i>rx_coordz_vector</i>
+    **/  
+    virtual SSPVector getSSPVector( const Coord& tx, const CoordZVector& rx_coordz_vector, const Time& time, long double ssp_depth_precision = SSP_CUSTOM_DEPTH_PRECISION ) const;
+
     /**
     * Returns a pointer a heap-created average SSP for given coordinates, start and end time date 
     * if they are present in the database.
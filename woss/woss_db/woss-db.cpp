@@ -38,6 +38,7 @@
 
 
 #include <cassert>
+#include <algorithm>
 #include "woss-db.h"
 
 
@@ -117,6 +118,34 @@ bool WossNetcdfDb::closeConnection() {
   }
   return true;
 }
+
+
+int WossNetcdfDb::getHyperslabEnd( const NetcdfIndexesVector& indexes, int start, long max_cells, NetcdfIndexes& min_indexes, NetcdfIndexes& max_indexes ) {
+  min_indexes = NetcdfIndexes( -1, -1 );
+  max_indexes = NetcdfIndexes( -1, -1 );
+
+  int end = start;
+  for ( ; end < (int) indexes.size(); end++ ) {
+    const NetcdfIndexes& curr_indexes = indexes[end];
+
+    if ( curr_indexes.first < 0 || curr_indexes.second < 0 ) continue;
+
+    if ( min_indexes.first < 0 ) {
+      min_indexes = curr_indexes;
+      max_indexes = curr_indexes;
+      continue;
+    }
+
+    NetcdfIndexes new_min( ::std::min( min_indexes.first, curr_indexes.first ), ::std::min( min_indexes.second, curr_indexes.second ) );
+    NetcdfIndexes new_max( ::std::max( max_indexes.first, curr_indexes.first ), ::std::max( max_indexes.second, curr_indexes.second ) );
+
+    if ( ( new_max.first - new_min.first + 1 ) * ( new_max.second - new_min.second + 1 ) > max_cells ) break;
+
+    min_indexes = new_min;
+    max_indexes = new_max;
+  }
+  return end;
+}
 #endif // WOSS_NETCDF_SUPPORT
 ////////////////////////////
 
@@ -145,3 +174,31 @@ bool WossTextualDb::closeConnection() {
 }
 
 
+void WossBathymetryDb::getValues( CoordZVector& coordz_vector ) const {
+  for ( int i = 0; i < (int) coordz_vector.size(); i++ ) {
+    coordz_vector[i].setDepth( getValue( coordz_vector[i] ) );
+  }
+}
+
+
+SedimentVector WossSedimentDb::getValues( const CoordZVector& coordz_vector ) const {
+  SedimentVector sediment_vector;
+  sediment_vector.reserve( coordz_vector.size() );
+
+  for ( int i = 0; i < (int) coordz_vector.size(); i++ ) {
+    sediment_vector.push_back( getValue( coordz_vector[i] ) );
+  }
+  return sediment_vector;
+}
+
+
+SSPVector WossSSPDb::getValues( const CoordZVector& coordz_vector, const Time& time, long double ssp_depth_precision ) const {
+  SSPVector ssp_vector;
+  ssp_vector.reserve( coordz_vector.size() );
+
+  for ( int i = 0; i < (int) coordz_vector.size(); i++ ) {
+    ssp_vector.push_back( getValue( coordz_vector[i], time, ssp_depth_precision ) );
+  }
+  return ssp_vector;
+}
+
@@ -50,6 +50,8 @@
 
 #include <definitions.h>
 #include <coordinates-definitions.h>
+#include <sediment-definitions.h>
+#include <ssp-definitions.h>
 
 
 namespace woss {
@@ -75,7 +77,6 @@ namespace woss {
   **/
   typedef ::std::pair< ::std::string, ::std::string > PathName; // path , filename
 
-
   /**
   * \brief Abstract class that provides the interface of databases
   *
@@ -222,6 +223,28 @@ namespace woss {
     protected:
       
 
+    /**
+    * NetCDF ( latitude index, longitude index ) pair. Negative indexes are not valid
+    **/
+    typedef ::std::pair< long, long > NetcdfIndexes;
+    
+    typedef ::std::vector< NetcdfIndexes > NetcdfIndexesVector;
+    
+
+    /**
+    * Groups the consecutive indexes starting at <i>start</i> whose bounding box holds at most <i>max_cells</i> cells,
+    * so that the whole group can be read with a single hyperslab. Not valid indexes belong to the group 
+    * but don't extend its bounding box
+    * @param indexes const reference to the transect indexes
+    * @param start first index of the group
+    * @param max_cells maximum number of ( latitude, longitude ) cells of the bounding box
+    * @param min_indexes returns the lower corner of the bounding box, not valid if the group has no valid indexes
+    * @param max_indexes returns the upper corner of the bounding box, not valid if the group has no valid indexes
+    * @return one past the last index of the group
+    **/
+    static int getHyperslabEnd( const NetcdfIndexesVector& indexes, int start, long max_cells, NetcdfIndexes& min_indexes, NetcdfIndexes& max_indexes );
+    
+
     /**
     * NcFile pointer to a NetCDF database descriptor. It will be properly initialized by openConnection()
     **/
@@ -315,6 +338,14 @@ namespace woss {
     **/
     virtual Bathymetry getValue( const Coord& coords ) const = 0;
 
+    /**
+    * Sets the positive depth value ( woss::Bathymetry ) of every CoordZ of the given transect. 
+    * Not found coordinates get a <i>HUGE_VAL</i> depth. The default implementation calls getValue() for each CoordZ, 
+    * databases should override it to answer the whole transect with a single query
+    * @param coordz_vector reference to a CoordZVector
+    **/
+    virtual void getValues( CoordZVector& coordz_vector ) const;
+
     
   };
 
@@ -361,6 +392,16 @@ namespace woss {
     * @return <i>valid</i> Sediment if at least one set of coordinates is found, <i>not valid</i> otherwise
     **/
     virtual Sediment* getValue( const CoordZVector& coordz_vector ) const = 0; 
+
+    /**
+    * Returns a heap-created Sediment value for each CoordZ of the given transect, as getValue( const CoordZ& ) would.
+    * The default implementation calls getValue() for each CoordZ, databases should override it 
+    * to answer the whole transect with a single query.
+    * <b>User is responsible of pointers' ownership</b>
+    * @param coordz_vector const reference to a valid CoordZ vector
+    * @return SedimentVector with the same size of <i>coordz_vector</i>
+    **/
+    virtual SedimentVector getValues( const CoordZVector& coordz_vector ) const;
     
     
   };
@@ -403,6 +444,18 @@ namespace woss {
     **/  
     virtual SSP* getValue( const Coord& coords, const Time& time, long double ssp_depth_precision ) const = 0;
 
+    /**
+    * Returns a heap-created SSP object for each CoordZ of the given transect, as getValue() would.
+    * The default implementation calls getValue() for each CoordZ, databases should override it 
+    * to answer the whole transect with a single query.
+    * <b>User is responsible of pointers' ownership</b>
+    * @param coordz_vector const reference to a valid CoordZ vector
+    * @param time const reference to a valid Time object
+    * @param ssp_depth_precision ssp depth precision [m]
+    * @return SSPVector with the same size of <i>coordz_vector</i>
+    **/
+    virtual SSPVector getValues( const CoordZVector& coordz_vector, const Time& time, long double ssp_depth_precision ) const;
+
     
   };
 
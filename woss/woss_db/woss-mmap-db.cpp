@@ -0,0 +1,686 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   woss-mmap-db.cpp
+ * @author Federico Guerra
+ * 
+ * \brief Provides the implementation of woss::WossMmapDb class
+ *
+ * Provides the implementation of the woss::WossMmapDb class
+ */
+
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "woss-mmap-db.h"
+
+
+using namespace woss;
+
+
+static const char WOSS_MMAP_DB_MAGIC[8] = { 'W', 'O', 'S', 'S', 'M', 'M', 'D', 'B' }; /**< file signature */
+
+static const uint32_t WOSS_MMAP_DB_VERSION = 1; /**< file format version */
+
+static const int WOSS_MMAP_DB_DEFAULT_COMPACTION_THRESHOLD = 4096; /**< default number of appended records that triggers a compaction */
+
+static const int WOSS_MMAP_DB_DEFAULT_CHECK_INTERVAL = 256; /**< default number of reads between two checks of the file on disk */
+
+static const double WOSS_MMAP_DB_RADIUS_MARGIN = 0.95; /**< earth radius margin used for the latitude window */
+
+
+/**
+* Entry to be written by a compaction
+**/
+struct WossMmapDbEntry {
+  
+  WossMmapDbRecord key;
+  
+  const double* values;
+  
+};
+
+typedef ::std::vector< WossMmapDbEntry > WossMmapDbEntryVector;
+
+
+static inline bool isLessCoord( double lat1, double long1, double z1, double lat2, double long2, double z2 ) {
+  return ( ( lat1 < lat2 ) || ( ( lat1 == lat2 ) && ( long1 < long2 ) ) || ( ( lat1 == lat2 ) && ( long1 == long2 ) && ( z1 < z2 ) ) );
+}
+
+
+static bool isLessEntry( const WossMmapDbEntry& left, const WossMmapDbEntry& right ) {
+  const WossMmapDbRecord& l = left.key;
+  const WossMmapDbRecord& r = right.key;
+  
+  if ( isLessCoord( l.tx_latitude, l.tx_longitude, l.tx_depth, r.tx_latitude, r.tx_longitude, r.tx_depth ) ) return true;
+  if ( isLessCoord( r.tx_latitude, r.tx_longitude, r.tx_depth, l.tx_latitude, l.tx_longitude, l.tx_depth ) ) return false;
+  if ( isLessCoord( l.rx_latitude, l.rx_longitude, l.rx_depth, r.rx_latitude, r.rx_longitude, r.rx_depth ) ) return true;
+  if ( isLessCoord( r.rx_latitude, r.rx_longitude, r.rx_depth, l.rx_latitude, l.rx_longitude, l.rx_depth ) ) return false;
+  if ( l.frequency != r.frequency ) return ( l.frequency < r.frequency );
+  return ( l.time < r.time );
+}
+
+
+static inline bool isEqualEntry( const WossMmapDbEntry& left, const WossMmapDbEntry& right ) {
+  return ( !isLessEntry( left, right ) && !isLessEntry( right, left ) );
+}
+
+
+static inline bool isLessCoordEntry( const WossMmapDbCoord& entry, const CoordZ& coordz ) {
+  return isLessCoord( entry.latitude, entry.longitude, entry.depth, coordz.getLatitude(), coordz.getLongitude(), coordz.getDepth() );
+}
+
+
+static inline bool isLessLatitude( const WossMmapDbCoord& entry, double latitude ) {
+  return ( entry.latitude < latitude );
+}
+
+
+static inline bool isLessFrequency( const WossMmapDbSample& entry, double frequency ) {
+  return ( entry.frequency < frequency );
+}
+
+
+/**
+* Writes an indexed file with given sorted entries, without duplicates
+**/
+static bool writeIndexedFile( const ::std::string& name, WossMmapDbType type, const WossMmapDbEntryVector& entries ) {
+  ::std::vector< WossMmapDbCoord > tx_vector;
+  ::std::vector< WossMmapDbCoord > rx_vector;
+  ::std::vector< WossMmapDbSample > sample_vector;
+  
+  sample_vector.reserve( entries.size() );
+  
+  for ( WossMmapDbEntryVector::const_iterator it = entries.begin(); it != entries.end(); it++ ) {
+    const WossMmapDbRecord& key = it->key;
+    
+    bool is_new_tx = tx_vector.empty() || tx_vector.back().latitude != key.tx_latitude 
+                     || tx_vector.back().longitude != key.tx_longitude || tx_vector.back().depth != key.tx_depth;
+    
+    if ( is_new_tx ) {
+      WossMmapDbCoord tx_entry = { key.tx_latitude, key.tx_longitude, key.tx_depth, rx_vector.size(), 0 };
+      tx_vector.push_back( tx_entry );
+    }
+    
+    if ( is_new_tx || rx_vector.back().latitude != key.rx_latitude 
+         || rx_vector.back().longitude != key.rx_longitude || rx_vector.back().depth != key.rx_depth ) {
+      WossMmapDbCoord rx_entry = { key.rx_latitude, key.rx_longitude, key.rx_depth, sample_vector.size(), 0 };
+      rx_vector.push_back( rx_entry );
+      tx_vector.back().count++;
+    }
+    
+    WossMmapDbSample sample = { key.frequency, key.time, 0, key.count };
+    sample_vector.push_back( sample );
+    rx_vector.back().count++;
+  }
+  
+  uint64_t offset = sizeof(WossMmapDbHeader) + ( tx_vector.size() + rx_vector.size() ) * sizeof(WossMmapDbCoord) 
+                    + sample_vector.size() * sizeof(WossMmapDbSample);
+  
+  for ( ::std::vector< WossMmapDbSample >::iterator it = sample_vector.begin(); it != sample_vector.end(); it++ ) {
+    it->offset = offset;
+    offset += it->count * sizeof(double);
+  }
+  
+  WossMmapDbHeader file_header;
+  ::std::memset( &file_header, 0, sizeof(WossMmapDbHeader) );
+  ::std::memcpy( file_header.magic, WOSS_MMAP_DB_MAGIC, sizeof(WOSS_MMAP_DB_MAGIC) );
+  file_header.version = WOSS_MMAP_DB_VERSION;
+  file_header.data_type = type;
+  file_header.total_tx = tx_vector.size();
+  file_header.total_rx = rx_vector.size();
+  file_header.total_samples = sample_vector.size();
+  file_header.compacted_size = offset;
+  
+  ::std::ofstream file_out( name.c_str(), ::std::ios::out | ::std::ios::trunc | ::std::ios::binary );
+  if ( !file_out.is_open() ) return false;
+  
+  file_out.write( reinterpret_cast< const char* > (&file_header), sizeof(WossMmapDbHeader) );
+  if ( !tx_vector.empty() ) file_out.write( reinterpret_cast< const char* > (&tx_vector[0]), tx_vector.size() * sizeof(WossMmapDbCoord) );
+  if ( !rx_vector.empty() ) file_out.write( reinterpret_cast< const char* > (&rx_vector[0]), rx_vector.size() * sizeof(WossMmapDbCoord) );
+  if ( !sample_vector.empty() ) file_out.write( reinterpret_cast< const char* > (&sample_vector[0]), sample_vector.size() * sizeof(WossMmapDbSample) );
+  
+  for ( WossMmapDbEntryVector::const_iterator it = entries.begin(); it != entries.end(); it++ ) {
+    if ( it->key.count > 0 ) file_out.write( reinterpret_cast< const char* > (it->values), it->key.count * sizeof(double) );
+  }
+  
+  file_out.flush();
+  return file_out.good();
+}
+
+
+WossMmapDb::WossMmapDb( const ::std::string& name, WossMmapDbType type ) 
+: WossDb( name ),
+  data_type(type),
+  compaction_threshold(WOSS_MMAP_DB_DEFAULT_COMPACTION_THRESHOLD),
+  check_interval(WOSS_MMAP_DB_DEFAULT_CHECK_INTERVAL),
+  reads_to_check(WOSS_MMAP_DB_DEFAULT_CHECK_INTERVAL),
+  append_fd(-1),
+  mapped_data(NULL),
+  mapped_size(0),
+  header(NULL),
+  tx_table(NULL),
+  rx_table(NULL),
+  sample_table(NULL),
+  file_device(0),
+  file_inode(0),
+  valid_size(0),
+  tail_records(),
+  tail_index()
+{
+  
+}
+
+
+WossMmapDb::~WossMmapDb() {
+  unmapFile();
+  if ( append_fd >= 0 ) close( append_fd );
+}
+
+
+int WossMmapDb::lockFile() const {
+  ::std::string lock_name = db_name + ".lock";
+  
+  int lock_fd = open( lock_name.c_str(), O_RDWR | O_CREAT, 0644 );
+  if ( lock_fd < 0 ) return -1;
+  
+  if ( flock( lock_fd, LOCK_EX ) != 0 ) {
+    close( lock_fd );
+    return -1;
+  }
+  return lock_fd;
+}
+
+
+void WossMmapDb::unlockFile( int lock_fd ) const {
+  if ( lock_fd < 0 ) return;
+  flock( lock_fd, LOCK_UN );
+  close( lock_fd );
+}
+
+
+bool WossMmapDb::isFileReplaced() const {
+  struct stat file_stat;
+  if ( stat( db_name.c_str(), &file_stat ) != 0 ) return true;
+  return ( file_stat.st_dev != file_device || file_stat.st_ino != file_inode );
+}
+
+
+bool WossMmapDb::refreshFile() const {
+  struct stat file_stat;
+  
+  bool is_replaced = ( stat( db_name.c_str(), &file_stat ) != 0 || file_stat.st_dev != file_device || file_stat.st_ino != file_inode );
+  
+  if ( !is_replaced && (uint64_t)file_stat.st_size <= valid_size ) return ( mapped_data != NULL );
+  
+  // reads are const, the mapping is a cache of the file on disk
+  WossMmapDb* const db = const_cast< WossMmapDb* >( this );
+  
+  int lock_fd = lockFile();
+  if ( lock_fd < 0 ) return ( mapped_data != NULL );
+  
+  db->unmapFile();
+  bool ok = db->mapFile();
+  
+  if ( ok && append_fd >= 0 && is_replaced ) {
+    close( append_fd );
+    db->append_fd = open( db_name.c_str(), O_WRONLY | O_APPEND );
+  }
+  
+  unlockFile( lock_fd );
+  
+  if ( debug ) ::std::cout << "WossMmapDb::refreshFile() " << db_name << " remapped" << ::std::endl;
+  return ok;
+}
+
+
+double WossMmapDb::getLatitudeWindow( double space_sampling ) {
+  return ( space_sampling / ( Coord::EARTH_RADIUS * WOSS_MMAP_DB_RADIUS_MARGIN ) * 180.0 / M_PI );
+}
+
+
+bool WossMmapDb::mapFile() {
+  int fd = open( db_name.c_str(), O_RDONLY );
+  if ( fd < 0 ) return false;
+  
+  struct stat file_stat;
+  WossMmapDbHeader file_header;
+  
+  if ( fstat( fd, &file_stat ) != 0 || (uint64_t)file_stat.st_size < sizeof(WossMmapDbHeader) 
+       || pread( fd, &file_header, sizeof(WossMmapDbHeader), 0 ) != (ssize_t)sizeof(WossMmapDbHeader) ) {
+    close( fd );
+    return false;
+  }
+  
+  uint64_t file_size = file_stat.st_size;
+  uint64_t tables_size = sizeof(WossMmapDbHeader) + ( file_header.total_tx + file_header.total_rx ) * sizeof(WossMmapDbCoord) 
+                         + file_header.total_samples * sizeof(WossMmapDbSample);
+  
+  if ( ::std::memcmp( file_header.magic, WOSS_MMAP_DB_MAGIC, sizeof(WOSS_MMAP_DB_MAGIC) ) != 0 
+       || file_header.version != WOSS_MMAP_DB_VERSION || file_header.data_type != (uint32_t)data_type 
+       || file_header.compacted_size < tables_size || file_header.compacted_size > file_size ) {
+    ::std::cerr << "WossMmapDb::mapFile() ERROR, " << db_name << " is not a valid database of type " << data_type << ::std::endl;
+    close( fd );
+    return false;
+  }
+  
+  void* address = mmap( NULL, file_header.compacted_size, PROT_READ, MAP_SHARED, fd, 0 );
+  
+  if ( address == MAP_FAILED ) {
+    ::std::cerr << "WossMmapDb::mapFile() ERROR, can't map " << db_name << ::std::endl;
+    close( fd );
+    return false;
+  }
+  
+  mapped_data = static_cast< char* >( address );
+  mapped_size = file_header.compacted_size;
+  header = reinterpret_cast< const WossMmapDbHeader* >( mapped_data );
+  tx_table = reinterpret_cast< const WossMmapDbCoord* >( mapped_data + sizeof(WossMmapDbHeader) );
+  rx_table = tx_table + header->total_tx;
+  sample_table = reinterpret_cast< const WossMmapDbSample* >( rx_table + header->total_rx );
+  file_device = file_stat.st_dev;
+  file_inode = file_stat.st_ino;
+  
+  uint64_t position = header->compacted_size;
+  
+  while ( position + sizeof(WossMmapDbRecord) <= file_size ) {
+    TailRecord record;
+    
+    if ( pread( fd, &record.key, sizeof(WossMmapDbRecord), position ) != (ssize_t)sizeof(WossMmapDbRecord) ) break;
+    if ( position + sizeof(WossMmapDbRecord) + record.key.count * sizeof(double) > file_size ) break;
+    
+    record.values.resize( record.key.count );
+    
+    if ( record.key.count > 0 && pread( fd, &record.values[0], record.key.count * sizeof(double), position + sizeof(WossMmapDbRecord) ) 
+                                 != (ssize_t)( record.key.count * sizeof(double) ) ) break;
+    
+    tail_index.insert( ::std::make_pair( record.key.tx_latitude, (int)tail_records.size() ) );
+    tail_records.push_back( record );
+    
+    position += sizeof(WossMmapDbRecord) + record.key.count * sizeof(double);
+  }
+  valid_size = position;
+  
+  close( fd );
+  
+  if ( debug ) ::std::cout << "WossMmapDb::mapFile() " << db_name << "; transmitters = " << header->total_tx 
+                           << "; receivers = " << header->total_rx << "; samples = " << header->total_samples 
+                           << "; appended records = " << tail_records.size() << ::std::endl;
+  return true;
+}
+
+
+void WossMmapDb::unmapFile() {
+  if ( mapped_data != NULL ) munmap( mapped_data, mapped_size );
+  
+  mapped_data = NULL;
+  mapped_size = 0;
+  header = NULL;
+  tx_table = NULL;
+  rx_table = NULL;
+  sample_table = NULL;
+  valid_size = 0;
+  tail_records.clear();
+  tail_index.clear();
+}
+
+
+bool WossMmapDb::openConnection() {
+  assert( data_type != WOSS_MMAP_DB_TYPE_INVALID );
+  
+  int lock_fd = lockFile();
+  
+  if ( lock_fd < 0 ) {
+    ::std::cerr << "WossMmapDb::openConnection() ERROR, can't lock " << db_name << ::std::endl;
+    return false;
+  }
+  
+  bool ok = true;
+  struct stat file_stat;
+  
+  if ( stat( db_name.c_str(), &file_stat ) != 0 ) {
+    if ( debug ) ::std::cout << "WossMmapDb::openConnection() creating " << db_name << ::std::endl;
+    ok = writeIndexedFile( db_name, data_type, WossMmapDbEntryVector() );
+  }
+  
+  ok = ok && mapFile();
+  
+  // a truncated record would hide all following appends
+  if ( ok && stat( db_name.c_str(), &file_stat ) == 0 && (uint64_t)file_stat.st_size > valid_size ) {
+    ::std::cerr << "WossMmapDb::openConnection() WARNING, discarding truncated record at the end of " << db_name << ::std::endl;
+    ok = ( truncate( db_name.c_str(), valid_size ) == 0 );
+  }
+  
+  if ( ok ) {
+    append_fd = open( db_name.c_str(), O_WRONLY | O_APPEND );
+    ok = ( append_fd >= 0 );
+  }
+  
+  if ( ok && compaction_threshold > 0 && (int)tail_records.size() >= compaction_threshold ) ok = compactFile();
+  
+  unlockFile( lock_fd );
+  
+  if ( !ok ) ::std::cerr << "WossMmapDb::openConnection() ERROR, can't open " << db_name << ::std::endl;
+  return ok;
+}
+
+
+bool WossMmapDb::finalizeConnection() {
+  return ( mapped_data != NULL );
+}
+
+
+bool WossMmapDb::closeConnection() {
+  bool ok = true;
+  
+  if ( append_fd >= 0 && compaction_threshold > 0 && (int)tail_records.size() >= compaction_threshold ) ok = compact();
+  
+  unmapFile();
+  if ( append_fd >= 0 ) close( append_fd );
+  append_fd = -1;
+  
+  return ok;
+}
+
+
+bool WossMmapDb::compact() {
+  int lock_fd = lockFile();
+  if ( lock_fd < 0 ) return false;
+  
+  bool ok = compactFile();
+  
+  unlockFile( lock_fd );
+  return ok;
+}
+
+
+bool WossMmapDb::importRecords( const TailVector& records ) {
+  int lock_fd = lockFile();
+  if ( lock_fd < 0 ) return false;
+  
+  bool ok = compactFile( &records );
+  
+  unlockFile( lock_fd );
+  return ok;
+}
+
+
+bool WossMmapDb::compactFile( const TailVector* const records ) {
+  // other processes may have appended records or replaced the file
+  unmapFile();
+  if ( !mapFile() ) return false;
+  
+  WossMmapDbEntryVector entries;
+  entries.reserve( header->total_samples + tail_records.size() + ( records == NULL ? 0 : records->size() ) );
+  
+  for ( uint64_t i = 0; i < header->total_tx; i++ ) {
+    const WossMmapDbCoord& tx_entry = tx_table[i];
+    
+    for ( uint64_t j = tx_entry.first; j < tx_entry.first + tx_entry.count; j++ ) {
+      const WossMmapDbCoord& rx_entry = rx_table[j];
+      
+      for ( uint64_t k = rx_entry.first; k < rx_entry.first + rx_entry.count; k++ ) {
+        const WossMmapDbSample& sample = sample_table[k];
+        
+        WossMmapDbEntry entry;
+        entry.key.tx_latitude = tx_entry.latitude;
+        entry.key.tx_longitude = tx_entry.longitude;
+        entry.key.tx_depth = tx_entry.depth;
+        entry.key.rx_latitude = rx_entry.latitude;
+        entry.key.rx_longitude = rx_entry.longitude;
+        entry.key.rx_depth = rx_entry.depth;
+        entry.key.frequency = sample.frequency;
+        entry.key.time = sample.time;
+        entry.key.count = sample.count;
+        entry.values = reinterpret_cast< const double* >( mapped_data + sample.offset );
+        entries.push_back( entry );
+      }
+    }
+  }
+  
+  for ( TailVector::const_iterator it = tail_records.begin(); it != tail_records.end(); it++ ) {
+    WossMmapDbEntry entry;
+    entry.key = it->key;
+    entry.values = it->values.empty() ? NULL : &it->values[0];
+    entries.push_back( entry );
+  }
+  
+  if ( records != NULL ) {
+    for ( TailVector::const_iterator it = records->begin(); it != records->end(); it++ ) {
+      WossMmapDbEntry entry;
+      entry.key = it->key;
+      entry.values = it->values.empty() ? NULL : &it->values[0];
+      entries.push_back( entry );
+    }
+  }
+  
+  // stable sort: among equal keys the last appended value is kept
+  ::std::stable_sort( entries.begin(), entries.end(), isLessEntry );
+  
+  WossMmapDbEntryVector::iterator last = entries.begin();
+  for ( WossMmapDbEntryVector::iterator it = entries.begin(); it != entries.end(); it++ ) {
+    if ( ( it + 1 ) != entries.end() && isEqualEntry( *it, *( it + 1 ) ) ) continue;
+    *last = *it;
+    last++;
+  }
+  entries.erase( last, entries.end() );
+  
+  if ( debug ) ::std::cout << "WossMmapDb::compactFile() " << db_name << "; total samples = " << entries.size() << ::std::endl;
+  
+  ::std::string temp_name = db_name + ".tmp";
+  
+  bool ok = writeIndexedFile( temp_name, data_type, entries );
+  
+  if ( ok ) ok = ( rename( temp_name.c_str(), db_name.c_str() ) == 0 );
+  else unlink( temp_name.c_str() );
+  
+  unmapFile();
+  
+  if ( append_fd >= 0 ) close( append_fd );
+  append_fd = -1;
+  
+  if ( mapFile() ) append_fd = open( db_name.c_str(), O_WRONLY | O_APPEND );
+  
+  if ( !ok ) ::std::cerr << "WossMmapDb::compactFile() ERROR, can't compact " << db_name << ::std::endl;
+  return ( ok && append_fd >= 0 );
+}
+
+
+WossMmapDb::TailRecord WossMmapDb::createTailRecord( const CoordZ& tx, const CoordZ& rx, double frequency, time_t time_value, const ::std::vector< double >& values ) {
+  TailRecord record;
+  record.key.tx_latitude = tx.getLatitude();
+  record.key.tx_longitude = tx.getLongitude();
+  record.key.tx_depth = tx.getDepth();
+  record.key.rx_latitude = rx.getLatitude();
+  record.key.rx_longitude = rx.getLongitude();
+  record.key.rx_depth = rx.getDepth();
+  record.key.frequency = frequency;
+  record.key.time = time_value;
+  record.key.count = values.size();
+  record.values = values;
+  return record;
+}
+
+
+bool WossMmapDb::appendValues( const CoordZ& tx, const CoordZ& rx, double frequency, time_t time_value, const ::std::vector< double >& values ) {
+  TailRecord record = createTailRecord( tx, rx, frequency, time_value, values );
+  
+  ::std::vector< char > buffer( sizeof(WossMmapDbRecord) + values.size() * sizeof(double) );
+  ::std::memcpy( &buffer[0], &record.key, sizeof(WossMmapDbRecord) );
+  if ( !values.empty() ) ::std::memcpy( &buffer[sizeof(WossMmapDbRecord)], &values[0], values.size() * sizeof(double) );
+  
+  int lock_fd = lockFile();
+  if ( lock_fd < 0 ) return false;
+  
+  bool ok = true;
+  
+  // the file has been compacted by another process
+  if ( append_fd < 0 || isFileReplaced() ) {
+    unmapFile();
+    if ( append_fd >= 0 ) close( append_fd );
+    append_fd = -1;
+    
+    ok = mapFile();
+    if ( ok ) append_fd = open( db_name.c_str(), O_WRONLY | O_APPEND );
+    ok = ok && ( append_fd >= 0 );
+  }
+  
+  if ( ok ) ok = ( write( append_fd, &buffer[0], buffer.size() ) == (ssize_t)buffer.size() );
+  
+  unlockFile( lock_fd );
+  
+  if ( !ok ) {
+    ::std::cerr << "WossMmapDb::appendValues() ERROR, can't write on " << db_name << ::std::endl;
+    return false;
+  }
+  
+  tail_index.insert( ::std::make_pair( record.key.tx_latitude, (int)tail_records.size() ) );
+  tail_records.push_back( record );
+  valid_size += buffer.size();
+  return true;
+}
+
+
+int64_t WossMmapDb::findCoord( const WossMmapDbCoord* table, uint64_t first, uint64_t count, const CoordZ& coordz, double space_sampling ) {
+  const WossMmapDbCoord* begin = table + first;
+  const WossMmapDbCoord* end = begin + count;
+  
+  if ( space_sampling <= 0.0 ) {
+    const WossMmapDbCoord* it = ::std::lower_bound( begin, end, coordz, isLessCoordEntry );
+    
+    if ( it != end && it->latitude == coordz.getLatitude() && it->longitude == coordz.getLongitude() && it->depth == coordz.getDepth() ) 
+      return ( it - table );
+    return -1;
+  }
+  
+  double window = getLatitudeWindow( space_sampling );
+  double max_latitude = coordz.getLatitude() + window;
+  
+  int64_t ret_value = -1;
+  double min_distance = HUGE_VAL;
+  
+  for ( const WossMmapDbCoord* it = ::std::lower_bound( begin, end, coordz.getLatitude() - window, isLessLatitude ); 
+        it != end && it->latitude <= max_latitude; it++ ) {
+    double distance = CoordZ( it->latitude, it->longitude, it->depth ).getCartDistance( coordz );
+    
+    if ( distance <= space_sampling && distance < min_distance ) {
+      min_distance = distance;
+      ret_value = it - table;
+    }
+  }
+  return ret_value;
+}
+
+
+bool WossMmapDb::readValues( const CoordZ& tx, const CoordZ& rx, double frequency, double frequency_precision, time_t time_value, 
+                             double space_sampling, const double*& values, uint64_t& count ) const {
+  values = NULL;
+  count = 0;
+  
+  if ( check_interval > 0 && --reads_to_check <= 0 ) {
+    reads_to_check = check_interval;
+    if ( !refreshFile() ) return false;
+  }
+  
+  // appended records are newer than the indexed section
+  if ( !tail_records.empty() ) {
+    double window = ( space_sampling > 0.0 ) ? getLatitudeWindow( space_sampling ) : 0.0;
+    double max_latitude = tx.getLatitude() + window;
+    
+    const TailRecord* found = NULL;
+    double min_distance = HUGE_VAL;
+    
+    for ( TICIter it = tail_index.lower_bound( tx.getLatitude() - window ); it != tail_index.end() && it->first <= max_latitude; it++ ) {
+      const WossMmapDbRecord& key = tail_records[it->second].key;
+      
+      if ( key.time != (int64_t)time_value || ::std::abs( key.frequency - frequency ) > frequency_precision ) continue;
+      
+      double distance = 0.0;
+      
+      if ( space_sampling <= 0.0 ) {
+        if ( key.tx_latitude != tx.getLatitude() || key.tx_longitude != tx.getLongitude() || key.tx_depth != tx.getDepth()
+             || key.rx_latitude != rx.getLatitude() || key.rx_longitude != rx.getLongitude() || key.rx_depth != rx.getDepth() ) continue;
+      }
+      else {
+        double tx_distance = CoordZ( key.tx_latitude, key.tx_longitude, key.tx_depth ).getCartDistance( tx );
+        if ( tx_distance > space_sampling ) continue;
+        
+        double rx_distance = CoordZ( key.rx_latitude, key.rx_longitude, key.rx_depth ).getCartDistance( rx );
+        if ( rx_distance > space_sampling ) continue;
+        
+        distance = tx_distance + rx_distance;
+      }
+      
+      // on ties the last appended record wins
+      if ( distance <= min_distance ) {
+        min_distance = distance;
+        found = &tail_records[it->second];
+      }
+    }
+    
+    if ( found != NULL ) {
+      values = found->values.empty() ? NULL : &found->values[0];
+      count = found->key.count;
+      return true;
+    }
+  }
+  
+  if ( header == NULL || header->total_tx == 0 ) return false;
+  
+  int64_t tx_index = findCoord( tx_table, 0, header->total_tx, tx, space_sampling );
+  if ( tx_index < 0 ) return false;
+  
+  int64_t rx_index = findCoord( rx_table, tx_table[tx_index].first, tx_table[tx_index].count, rx, space_sampling );
+  if ( rx_index < 0 ) return false;
+  
+  const WossMmapDbSample* begin = sample_table + rx_table[rx_index].first;
+  const WossMmapDbSample* end = begin + rx_table[rx_index].count;
+  
+  for ( const WossMmapDbSample* it = ::std::lower_bound( begin, end, frequency - frequency_precision, isLessFrequency ); 
+        it != end && it->frequency <= frequency + frequency_precision; it++ ) {
+    if ( it->time == (int64_t)time_value ) {
+      values = reinterpret_cast< const double* >( mapped_data + it->offset );
+      count = it->count;
+      return true;
+    }
+  }
+  return false;
+}
+
@@ -0,0 +1,467 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   woss-mmap-db.h
+ * @author Federico Guerra
+ * 
+ * \brief Provides the interface for woss::WossMmapDb class
+ *
+ * Provides the interface for the woss::WossMmapDb class
+ */
+
+
+#ifndef WOSS_MMAP_DB_H
+#define WOSS_MMAP_DB_H
+
+
+#include <stdint.h>
+#include <ctime>
+#include <sys/types.h>
+#include <map>
+#include <vector>
+#include "woss-db.h"
+
+
+namespace woss {
+  
+  
+  /**
+  * Type of the values stored in a WossMmapDb
+  **/
+  enum WossMmapDbType {
+    WOSS_MMAP_DB_TYPE_INVALID = 0,
+    WOSS_MMAP_DB_TYPE_TIME_ARR = 1, ///< each value is a sequence of (delay, real pressure, imag pressure) triplets
+    WOSS_MMAP_DB_TYPE_PRESSURE = 2  ///< each value is a (real pressure, imag pressure) couple
+  };
+  
+  
+  /**
+  * \brief Header of a WossMmapDb file
+  **/
+  struct WossMmapDbHeader {
+    
+    char magic[8]; ///< file signature
+    
+    uint32_t version; ///< file format version
+    
+    uint32_t data_type; ///< WossMmapDbType of the values
+    
+    uint64_t total_tx; ///< number of entries of the transmitter table
+    
+    uint64_t total_rx; ///< number of entries of the receiver table
+    
+    uint64_t total_samples; ///< number of entries of the sample table
+    
+    uint64_t compacted_size; ///< size in bytes of the indexed section. Appended records follow it
+    
+    uint64_t reserved[2];
+    
+  };
+  
+  
+  /**
+  * \brief Entry of the transmitter and receiver tables of a WossMmapDb file
+  **/
+  struct WossMmapDbCoord {
+    
+    double latitude; ///< latitude [decimal degrees]
+    
+    double longitude; ///< longitude [decimal degrees]
+    
+    double depth; ///< depth [m]
+    
+    uint64_t first; ///< index of the first child entry (receiver or sample)
+    
+    uint64_t count; ///< number of child entries
+    
+  };
+  
+  
+  /**
+  * \brief Entry of the sample table of a WossMmapDb file
+  **/
+  struct WossMmapDbSample {
+    
+    double frequency; ///< frequency [Hz]
+    
+    int64_t time; ///< time_t of the sample
+    
+    uint64_t offset; ///< file offset of the first value
+    
+    uint64_t count; ///< number of doubles
+    
+  };
+  
+  
+  /**
+  * \brief Header of a record appended to a WossMmapDb file, followed by <i>count</i> doubles
+  **/
+  struct WossMmapDbRecord {
+    
+    double tx_latitude; ///< transmitter latitude [decimal degrees]
+    
+    double tx_longitude; ///< transmitter longitude [decimal degrees]
+    
+    double tx_depth; ///< transmitter depth [m]
+    
+    double rx_latitude; ///< receiver latitude [decimal degrees]
+    
+    double rx_longitude; ///< receiver longitude [decimal degrees]
+    
+    double rx_depth; ///< receiver depth [m]
+    
+    double frequency; ///< frequency [Hz]
+    
+    int64_t time; ///< time_t of the sample
+    
+    uint64_t count; ///< number of doubles
+    
+  };
+  
+  
+  /**
+  * \brief Memory mapped, indexed implementation of WossDb
+  *
+  * WossMmapDb is the memory mapped specialization of WossDb class, meant for results databases. 
+  * The file is made of an indexed section and of a list of appended records: \n
+  * <b>WossMmapDbHeader, transmitter table, receiver table, sample table, values, appended records</b> \n
+  * Transmitters are sorted by latitude, longitude and depth; the receivers of each transmitter are sorted the same way 
+  * and the samples of each receiver are sorted by frequency and time. The indexed section is mmap'ed and queried in place, 
+  * so opening the database costs a few system calls and the page cache is shared between processes.
+  * New values are appended to the file and kept in memory, until the number of appended records reaches the compaction threshold: 
+  * then the whole file is rewritten as an indexed section. Appends and compactions are serialized 
+  * between processes by a lock on the file <i>db_name</i>.lock. All numbers are stored with native byte order.
+  * Derived classes provide the data behaviour.
+  * @see ResTimeArrMmapDb, ResPressureMmapDb
+  **/
+  class WossMmapDb : public WossDb {
+    
+    
+    public:
+    
+    
+    /**
+    * WossMmapDb constructor
+    * @param name pathname of database
+    * @param type type of the stored values
+    **/
+    WossMmapDb( const ::std::string& name, WossMmapDbType type );
+    
+    virtual ~WossMmapDb();
+    
+    
+    /**
+    * Opens the connection to the file provided, creating it if needed
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    virtual bool openConnection();
+    
+    /**
+    * Post openConnection() actions
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    virtual bool finalizeConnection();
+    
+    /**
+    * Closes the connection to the file provided. The file is compacted if the compaction threshold has been reached
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    virtual bool closeConnection();
+    
+    
+    /**
+    * Rewrites the file merging the appended records into the indexed section
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    bool compact();
+    
+    
+    /**
+    * Sets the number of appended records that triggers a compaction
+    * @param threshold number of records, a value <= 0 disables automatic compaction
+    **/
+    void setCompactionThreshold( int threshold ) { compaction_threshold = threshold; }
+    
+    /**
+    * Gets the number of appended records that triggers a compaction
+    * @return number of records
+    **/
+    int getCompactionThreshold() const { return compaction_threshold; }
+    
+    /**
+    * Sets the number of reads between two checks of the file on disk
+    * @param interval number of reads, a value <= 0 disables the check
+    **/
+    void setCheckInterval( int interval ) { check_interval = interval; reads_to_check = interval; }
+    
+    /**
+    * Gets the number of reads between two checks of the file on disk
+    * @return number of reads
+    **/
+    int getCheckInterval() const { return check_interval; }
+    
+    /**
+    * Gets the number of records appended after the indexed section
+    * @return number of records
+    **/
+    int getTotalAppendedRecords() const { return tail_records.size(); }
+    
+    
+    protected:
+    
+    
+    /**
+    * \brief In memory copy of an appended record
+    **/
+    struct TailRecord {
+      
+      WossMmapDbRecord key; ///< record header
+      
+      ::std::vector< double > values; ///< record values
+      
+    };
+    
+    typedef ::std::vector< TailRecord > TailVector;
+    
+    /**
+    * Multimap that links a transmitter latitude to the position of a TailRecord
+    **/
+    typedef ::std::multimap< double, int > TailIndex;
+    typedef TailIndex::const_iterator TICIter;
+    
+    
+    /**
+    * Type of the stored values
+    **/
+    WossMmapDbType data_type;
+    
+    /**
+    * Number of appended records that triggers a compaction
+    **/
+    int compaction_threshold;
+    
+    /**
+    * Number of reads between two checks of the file on disk
+    **/
+    int check_interval;
+    
+    /**
+    * Number of reads left before the next check of the file on disk
+    **/
+    mutable int reads_to_check;
+    
+    /**
+    * Descriptor of the file opened in append mode, -1 if not open
+    **/
+    int append_fd;
+    
+    /**
+    * Base address of the mapped indexed section, NULL if not mapped
+    **/
+    char* mapped_data;
+    
+    /**
+    * Size in bytes of the mapped indexed section
+    **/
+    size_t mapped_size;
+    
+    /**
+    * Pointer to the mapped header
+    **/
+    const WossMmapDbHeader* header;
+    
+    /**
+    * Pointer to the mapped transmitter table
+    **/
+    const WossMmapDbCoord* tx_table;
+    
+    /**
+    * Pointer to the mapped receiver table
+    **/
+    const WossMmapDbCoord* rx_table;
+    
+    /**
+    * Pointer to the mapped sample table
+    **/
+    const WossMmapDbSample* sample_table;
+    
+    /**
+    * Device of the mapped file
+    **/
+    dev_t file_device;
+    
+    /**
+    * Inode of the mapped file
+    **/
+    ino_t file_inode;
+    
+    /**
+    * Size in bytes of the indexed section plus all complete appended records
+    **/
+    uint64_t valid_size;
+    
+    /**
+    * Records appended after the indexed section
+    **/
+    TailVector tail_records;
+    
+    /**
+    * Spatial index of tail_records
+    **/
+    TailIndex tail_index;
+    
+    
+    /**
+    * Returns the values stored for given parameters. If space_sampling is > 0 the closest transmitter and receiver 
+    * whose cartesian distance is less or equal to space_sampling are used. 
+    * Compactions and appends of other processes are seen within <i>check_interval</i> reads.
+    * @param tx valid transmitter coordinates
+    * @param rx valid receiver coordinates
+    * @param frequency frequency [hz]
+    * @param frequency_precision frequency precision [hz]
+    * @param time_value time_t of the sample
+    * @param space_sampling space sampling [m]
+    * @param values reference to the returned pointer to the first value. It is valid until the next read, insertion or compaction
+    * @param count reference to the returned number of doubles
+    * @return <i>true</i> if the sample has been found, <i>false</i> otherwise
+    **/
+    bool readValues( const CoordZ& tx, const CoordZ& rx, double frequency, double frequency_precision, time_t time_value, 
+                     double space_sampling, const double*& values, uint64_t& count ) const;
+    
+    /**
+    * Appends given values to the file. A compaction is performed if the compaction threshold is reached
+    * @param tx valid transmitter coordinates
+    * @param rx valid receiver coordinates
+    * @param frequency frequency [hz]
+    * @param time_value time_t of the sample
+    * @param values values to be stored
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    bool appendValues( const CoordZ& tx, const CoordZ& rx, double frequency, time_t time_value, const ::std::vector< double >& values );
+    
+    
+    /**
+    * Maps the indexed section of the file and loads the appended records
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    bool mapFile();
+    
+    /**
+    * Unmaps the file and clears the appended records
+    **/
+    void unmapFile();
+    
+    /**
+    * Checks if the file on disk has been replaced by another process (e.g. by a compaction)
+    * @return <i>true</i> if the file has been replaced, <i>false</i> otherwise
+    **/
+    bool isFileReplaced() const;
+    
+    /**
+    * Remaps the file if it has been replaced or extended by another process. 
+    * Called by readValues() every <i>check_interval</i> reads
+    * @return <i>true</i> if the mapping is valid, <i>false</i> otherwise
+    **/
+    bool refreshFile() const;
+    
+    /**
+    * Locks the file <i>db_name</i>.lock
+    * @return lock descriptor, -1 on failure
+    **/
+    int lockFile() const;
+    
+    /**
+    * Releases a lock obtained with lockFile()
+    * @param lock_fd lock descriptor
+    **/
+    void unlockFile( int lock_fd ) const;
+    
+    /**
+    * Rewrites the file, merging the indexed section, the appended records and the given records. 
+    * The lock has to be held by the caller
+    * @param records pointer to additional records, they win over stored values with the same key. It can be NULL
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    bool compactFile( const TailVector* const records = NULL );
+    
+    /**
+    * Merges the given records into the file with a compaction. Used to convert databases of other formats
+    * @param records records to be stored
+    * @return <i>true</i> if method was successful, <i>false</i> otherwise
+    **/
+    bool importRecords( const TailVector& records );
+    
+    
+    /**
+    * Creates a TailRecord with given parameters
+    * @param tx valid transmitter coordinates
+    * @param rx valid receiver coordinates
+    * @param frequency frequency [hz]
+    * @param time_value time_t of the sample
+    * @param values values to be stored
+    * @return TailRecord
+    **/
+    static TailRecord createTailRecord( const CoordZ& tx, const CoordZ& rx, double frequency, time_t time_value, const ::std::vector< double >& values );
+    
+    /**
+    * Finds the closest entry of given table matching given coordinates
+    * @param table pointer to a sorted table
+    * @param first index of the first entry
+    * @param count number of entries
+    * @param coordz coordinates to be found
+    * @param space_sampling space sampling [m]
+    * @return index of the entry, -1 if not found
+    **/
+    static int64_t findCoord( const WossMmapDbCoord* table, uint64_t first, uint64_t count, const CoordZ& coordz, double space_sampling );
+    
+    /**
+    * Returns the latitude window that contains all coordinates within given space sampling
+    * @param space_sampling space sampling [m]
+    * @return latitude window [decimal degrees]
+    **/
+    static double getLatitudeWindow( double space_sampling );
+    
+    
+    private:
+    
+    
+    WossMmapDb( const WossMmapDb& copy );
+    
+    WossMmapDb& operator=( const WossMmapDb& copy );
+    
+    
+  };
+  
+  
+}
+
+
+#endif /* WOSS_MMAP_DB_H */
+
@@ -375,7 +375,11 @@ Altimetry& woss::operator*=( Altimetry& left, double right ) {
 AltimBretschneider::AltimBretschneider() 
 : Altimetry(),
   char_height(ALTIMETRY_CHAR_HEIGHT_INVALID),
-  average_period(ALTIMETRY_AVG_PERIOD_INVALID)
+  average_period(ALTIMETRY_AVG_PERIOD_INVALID),
+  spectrum_omegas(),
+  spectrum_amplitudes(),
+  spectrum_height(ALTIMETRY_CHAR_HEIGHT_INVALID),
+  spectrum_period(ALTIMETRY_AVG_PERIOD_INVALID)
 {
   
 }
@@ -384,7 +388,11 @@ AltimBretschneider::AltimBretschneider()
 AltimBretschneider::AltimBretschneider( AltimetryMap& map ) 
 : Altimetry(map),
   char_height(ALTIMETRY_CHAR_HEIGHT_INVALID),
-  average_period(ALTIMETRY_AVG_PERIOD_INVALID)
+  average_period(ALTIMETRY_AVG_PERIOD_INVALID),
+  spectrum_omegas(),
+  spectrum_amplitudes(),
+  spectrum_height(ALTIMETRY_CHAR_HEIGHT_INVALID),
+  spectrum_period(ALTIMETRY_AVG_PERIOD_INVALID)
 {
     
 }
@@ -393,7 +401,11 @@ AltimBretschneider::AltimBretschneider( AltimetryMap& map )
 AltimBretschneider::AltimBretschneider( double ch_height, double avg_per, int total_r_steps, double d )
 : Altimetry(),
   char_height(ch_height),
-  average_period(avg_per)
+  average_period(avg_per),
+  spectrum_omegas(),
+  spectrum_amplitudes(),
+  spectrum_height(ALTIMETRY_CHAR_HEIGHT_INVALID),
+  spectrum_period(ALTIMETRY_AVG_PERIOD_INVALID)
 {
   depth = d;
   total_range_steps = total_r_steps;
@@ -403,7 +415,11 @@ AltimBretschneider::AltimBretschneider( double ch_height, double avg_per, int to
 AltimBretschneider::AltimBretschneider( const AltimBretschneider& copy ) 
 : Altimetry(copy),
   char_height(copy.char_height),
-  average_period(copy.average_period)
+  average_period(copy.average_period),
+  spectrum_omegas(copy.spectrum_omegas),
+  spectrum_amplitudes(copy.spectrum_amplitudes),
+  spectrum_height(copy.spectrum_height),
+  spectrum_period(copy.spectrum_period)
 {
   
 }
@@ -414,6 +430,10 @@ AltimBretschneider& AltimBretschneider::operator=( const AltimBretschneider& cop
   
   char_height = copy.char_height;
   average_period = copy.average_period;
+  spectrum_omegas = copy.spectrum_omegas;
+  spectrum_amplitudes = copy.spectrum_amplitudes;
+  spectrum_height = copy.spectrum_height;
+  spectrum_period = copy.spectrum_period;
 
   return *this;
 }
@@ -477,6 +497,39 @@ AltimBretschneider* AltimBretschneider::randomize( double ratio_incr_value ) con
 }
 
 
+void AltimBretschneider::initSpectrum() {
+  if ( spectrum_height == char_height && spectrum_period == average_period && !spectrum_amplitudes.empty() ) return;
+  
+  double delta_omega = 2.0 * M_PI * 0.0125; 
+  double A_bret = 172.75 * std::pow(char_height, 2.0) / std::pow(average_period, 4.0); 
+  double B_bret = 691.0 / std::pow(average_period, 4.0);
+
+  spectrum_omegas.clear();
+  spectrum_amplitudes.clear();
+  
+  for ( double cur_omega = delta_omega; cur_omega <= 2.0 * M_PI + 0.01; cur_omega += delta_omega ) {
+    double spec = A_bret / std::pow(cur_omega, 5.0) * std::exp((-1.0 * B_bret) / std::pow(cur_omega, 4.0));
+    
+    spectrum_omegas.push_back( cur_omega );
+    spectrum_amplitudes.push_back( ::std::sqrt( spec * delta_omega ) );
+  }
+  
+  spectrum_height = char_height;
+  spectrum_period = average_period;
+}
+
+
+double AltimBretschneider::getCounterRand( uint64_t key, uint64_t counter ) {
+  // splitmix64 finalizer
+  uint64_t z = key + ( counter + 1 ) * 0x9E3779B97F4A7C15ULL;
+  z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+  z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+  z ^= ( z >> 31 );
+  
+  return( ( (double)( z >> 11 ) + 1.0 ) / 9007199254740992.0 );
+}
+
+
 AltimBretschneider& AltimBretschneider::createWaveSpectrum() {
   altimetry_map.clear();
 
@@ -486,13 +539,11 @@ AltimBretschneider& AltimBretschneider::createWaveSpectrum() {
     exit(1);
   }
 
-  double delta_omega = 2.0 * M_PI * 0.0125; 
+  initSpectrum();
+  
   double dep = ::std::abs(depth);  
   double c = std::sqrt(G * dep);
 
-  double A_bret = 172.75 * std::pow(char_height, 2.0) / std::pow(average_period, 4.0); 
-  double B_bret = 691.0 / std::pow(average_period, 4.0);
-
   int peak_ratio = SDefHandler::instance()->getRandInt();
   while ( (peak_ratio == 0) || ((peak_ratio % 100) == 0) ) {
     peak_ratio = SDefHandler::instance()->getRandInt();
@@ -500,27 +551,31 @@ AltimBretschneider& AltimBretschneider::createWaveSpectrum() {
   peak_ratio %= 100;
   double peak_offset = range/(double)peak_ratio; 
   
+  // one draw from the simulator generator seeds the whole spectrum
+  uint64_t key = (uint64_t) SDefHandler::instance()->getRandInt() * 0xD6E8FEB86659FD93ULL;
+  uint64_t counter = 0;
+  
+  int total_omegas = spectrum_omegas.size();
+  const double* omegas = &spectrum_omegas[0];
+  const double* amplitudes = &spectrum_amplitudes[0];
+  ::std::vector< double > magnitudes( total_omegas );
+  ::std::vector< double > phases( total_omegas );
+  
   for ( double cur_range = 0.0 - peak_offset; cur_range <= (range - peak_offset); cur_range += range_precision ) {
     double cur_t = cur_range / c;
 
-    double sum = 0;
-    for ( double cur_omega = delta_omega; cur_omega <= 2.0 * M_PI + 0.01; cur_omega += delta_omega ) {
-      double spec = A_bret / std::pow(cur_omega, 5.0) * std::exp((-1.0 * B_bret) / std::pow(cur_omega, 4.0));
-      double a = SDefHandler::instance()->getRand();
-      while ( a == 0.0 ) {
-        a = SDefHandler::instance()->getRand();
-      }
-      a *= ::std::sqrt( spec * delta_omega );
-      double b = SDefHandler::instance()->getRand();
-      while ( b == 0.0 ) {
-        b = SDefHandler::instance()->getRand();
-      }
-      b -= 0.5;
-      b *= ::std::sqrt( spec * delta_omega );
+    for ( int i = 0; i < total_omegas; i++, counter += 2 ) {
+      double a = getCounterRand( key, counter );
+      double b = getCounterRand( key, counter + 1 ) - 0.5;
       
-      double A = std::sqrt(std::pow(a, 2.0) + std::pow(b, 2.0));
-      double phi = std::atan2( b, a );
-      sum += A * std::cos(cur_t * cur_omega * phi);
+      // the phase doesn't depend on the amplitude scaling
+      magnitudes[i] = amplitudes[i] * ::std::sqrt( a * a + b * b );
+      phases[i] = cur_t * omegas[i] * std::atan2( b, a );
+    }
+    
+    double sum = 0;
+    for ( int i = 0; i < total_omegas; i++ ) {
+      sum += magnitudes[i] * std::cos( phases[i] );
     }
 
     if (debug) ::std::cout << "AltimBretschneider::createWaveSpectrum() range " << (cur_range+peak_offset) 
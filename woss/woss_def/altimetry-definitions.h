@@ -43,7 +43,9 @@
 
 #include <cassert>
 #include <climits>
+#include <stdint.h>
 #include <map>
+#include <vector>
 #include "custom-precision-double.h"
 #include "time-definitions.h"
 
@@ -741,6 +743,21 @@ namespace woss {
     
     virtual AltimBretschneider& createWaveSpectrum();
     
+    /**
+    * Computes the spectrum amplitude of every frequency bin, if char_height or average_period have changed
+    * since the last call
+    **/
+    void initSpectrum();
+    
+    /**
+    * Returns the uniform random value associated to given key and counter. Every key identifies 
+    * an independent stream, so a whole spectrum can be drawn with a single call to the random generator
+    * @param key stream key
+    * @param counter position in the stream
+    * @returns random value in (0, 1]
+    **/
+    static double getCounterRand( uint64_t key, uint64_t counter );
+    
     /**
      * H - Model's characteristic height [m]
      * Refer to:
@@ -754,6 +771,26 @@ namespace woss {
      * G. J. Komen et al., Dynamics and modeling of ocean waves. Cambridge University Press, 1994. 
      */
     double average_period;
+    
+    /**
+    * Frequency bins of the spectrum [rad/s]
+    **/
+    ::std::vector< double > spectrum_omegas;
+    
+    /**
+    * Spectrum amplitude of every frequency bin
+    **/
+    ::std::vector< double > spectrum_amplitudes;
+    
+    /**
+    * char_height used to compute spectrum_amplitudes
+    **/
+    double spectrum_height;
+    
+    /**
+    * average_period used to compute spectrum_amplitudes
+    **/
+    double spectrum_period;
 
   };
   
@@ -0,0 +1,533 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   coordinates-spatial-map.h
+ * @author Federico Guerra
+ *
+ * \brief Provides the interface for woss::CoordZSpatialMap class
+ *
+ * Provides the interface for the woss::CoordZSpatialMap class
+ */
+
+
+#ifndef WOSS_COORDINATES_SPATIAL_MAP_H
+#define WOSS_COORDINATES_SPATIAL_MAP_H
+
+
+#include <list>
+#include <vector>
+#include <cmath>
+#include <stdint.h>
+#include "coordinates-definitions.h"
+
+
+namespace woss {
+
+
+  /**
+  * \brief Associative container keyed by CoordZ and backed by a spatial hash grid
+  *
+  * CoordZSpatialMap stores its keys in a uniform grid of cartesian cells. A lookup hashes the cells
+  * that can contain a coordinate within CompUser::getSpaceSampling() meters of the query and checks
+  * the cartesian distance of the few keys found there, so it costs O(1) instead of the O(log(n))
+  * chain of getCartDistance() evaluations made by CoordComparator.
+  * If more than one stored key lies within the space sampling, the closest one is returned.
+  * If the space sampling is <= 0 only exactly equal coordinates match.
+  *
+  * The interface mimics a ::std::map< CoordZ, Value >; iteration follows insertion order and
+  * iterators are not invalidated by insertions or by erasure of other elements.
+  * The user class has to provide a <i>static</i> method called <b>getSpaceSampling()</b>
+  * that returns the threshold distance in meters
+  */
+  template < typename Value, class CompUser >
+  class CoordZSpatialMap {
+
+
+    public:
+
+
+    typedef ::std::pair< const CoordZ, Value > value_type;
+
+    typedef ::std::list< value_type > EntryList;
+    typedef typename EntryList::iterator iterator;
+    typedef typename EntryList::const_iterator const_iterator;
+    typedef typename EntryList::reverse_iterator reverse_iterator;
+    typedef typename EntryList::const_reverse_iterator const_reverse_iterator;
+    typedef typename EntryList::size_type size_type;
+
+
+    /**
+    * CoordZSpatialMap default constructor
+    **/
+    CoordZSpatialMap();
+
+    /**
+    * CoordZSpatialMap copy constructor
+    * @param copy const reference to a CoordZSpatialMap object
+    **/
+    CoordZSpatialMap( const CoordZSpatialMap& copy );
+
+    ~CoordZSpatialMap() { }
+
+
+    /**
+    * Assignment operator
+    * @param copy const reference to a CoordZSpatialMap object
+    * @returns reference to <b>this</b>
+    **/
+    CoordZSpatialMap& operator=( const CoordZSpatialMap& copy );
+
+
+    iterator begin() { return entries.begin(); }
+    const_iterator begin() const { return entries.begin(); }
+
+    iterator end() { return entries.end(); }
+    const_iterator end() const { return entries.end(); }
+
+    reverse_iterator rbegin() { return entries.rbegin(); }
+    const_reverse_iterator rbegin() const { return entries.rbegin(); }
+
+    reverse_iterator rend() { return entries.rend(); }
+    const_reverse_iterator rend() const { return entries.rend(); }
+
+    size_type size() const { return total_entries; }
+
+    bool empty() const { return total_entries == 0; }
+
+    /**
+    * Erases all the stored elements
+    **/
+    void clear();
+
+
+    /**
+    * Finds the stored key closest to given coordinates, within CompUser::getSpaceSampling() meters
+    * @param coordz const reference to a valid CoordZ object
+    * @returns an iterator to the element found, end() otherwise
+    **/
+    iterator find( const CoordZ& coordz );
+
+    /**
+    * Finds the stored key closest to given coordinates, within CompUser::getSpaceSampling() meters
+    * @param coordz const reference to a valid CoordZ object
+    * @returns a const_iterator to the element found, end() otherwise
+    **/
+    const_iterator find( const CoordZ& coordz ) const;
+
+    /**
+    * Returns the value associated to given coordinates. If no stored key is within
+    * CompUser::getSpaceSampling() meters a new default constructed value is inserted with key <i>coordz</i>
+    * @param coordz const reference to a valid CoordZ object
+    * @returns reference to the value
+    **/
+    Value& operator[]( const CoordZ& coordz );
+
+    /**
+    * Erases the pointed element
+    * @param it iterator to a valid element
+    **/
+    void erase( iterator it );
+
+
+    protected:
+
+
+    /**
+    * Cell size in meters used when the space sampling is <= 0; keys are then only hashed
+    **/
+    static const double EXACT_CELL_SIZE;
+
+    /**
+    * Initial number of hash buckets
+    **/
+    static const size_t INITIAL_BUCKETS = 64;
+
+    /**
+    * End of a bucket chain
+    **/
+    static const size_t NO_CELL = (size_t)-1;
+
+
+    /**
+    * \brief Indexed key
+    *
+    * Grid cell and cartesian coordinates of a stored key
+    **/
+    struct CellEntry {
+
+      int64_t cell_x;
+      int64_t cell_y;
+      int64_t cell_z;
+
+      double cart_x;
+      double cart_y;
+      double cart_z;
+
+      iterator entry;
+
+      size_t next; ///< index of the next CellEntry in the same bucket
+
+    };
+
+
+    typedef ::std::vector< size_t > BucketVector;
+    typedef ::std::vector< CellEntry > CellVector;
+
+
+    /**
+    * Stored elements, in insertion order
+    **/
+    EntryList entries;
+
+    /**
+    * Number of stored elements
+    **/
+    size_type total_entries;
+
+    /**
+    * Hash buckets of the grid cells, each one the head of a chain in <i>cells</i>
+    **/
+    mutable BucketVector buckets;
+
+    /**
+    * Indexed keys, chained by bucket
+    **/
+    mutable CellVector cells;
+
+    /**
+    * Space sampling in use when the buckets have been built
+    **/
+    mutable double index_sampling;
+
+    /**
+    * Cell size in use when the buckets have been built
+    **/
+    mutable double cell_size;
+
+
+    /**
+    * Rebuilds the buckets if CompUser::getSpaceSampling() has changed since the last call
+    **/
+    void checkIndex() const;
+
+    /**
+    * Rebuilds all the buckets
+    * @param total_buckets number of buckets to allocate, must be a power of two
+    **/
+    void rebuildIndex( size_t total_buckets ) const;
+
+    /**
+    * Fills the cell and cartesian coordinates of given CellEntry
+    * @param coordz const reference to a valid CoordZ object
+    * @param cell_entry reference to the CellEntry to be filled
+    **/
+    void computeCell( const CoordZ& coordz, CellEntry& cell_entry ) const;
+
+    /**
+    * Adds given element to the buckets, growing them if needed
+    * @param it iterator to a stored element
+    **/
+    void indexEntry( iterator it ) const;
+
+    /**
+    * Links given CellEntry into its bucket
+    * @param cell_entry const reference to a CellEntry with computed cell
+    **/
+    void linkCell( const CellEntry& cell_entry ) const;
+
+    /**
+    * Searches the buckets
+    * @param coordz const reference to a valid CoordZ object
+    * @param found reference to the iterator that will point to the element found
+    * @returns <i>true</i> if an element was found, <i>false</i> otherwise
+    **/
+    bool search( const CoordZ& coordz, iterator& found ) const;
+
+    /**
+    * Returns the bucket index of given cell
+    **/
+    size_t getBucket( int64_t cell_x, int64_t cell_y, int64_t cell_z ) const;
+
+
+  };
+
+
+  template < typename Value, class CompUser >
+  const double CoordZSpatialMap< Value, CompUser >::EXACT_CELL_SIZE = 1.0;
+
+  template < typename Value, class CompUser >
+  const size_t CoordZSpatialMap< Value, CompUser >::INITIAL_BUCKETS;
+
+  template < typename Value, class CompUser >
+  const size_t CoordZSpatialMap< Value, CompUser >::NO_CELL;
+
+
+  template < typename Value, class CompUser >
+  CoordZSpatialMap< Value, CompUser >::CoordZSpatialMap()
+  : entries(),
+    total_entries(0),
+    buckets(),
+    cells(),
+    index_sampling(0.0),
+    cell_size(EXACT_CELL_SIZE)
+  {
+
+  }
+
+
+  template < typename Value, class CompUser >
+  CoordZSpatialMap< Value, CompUser >::CoordZSpatialMap( const CoordZSpatialMap< Value, CompUser >& copy )
+  : entries(copy.entries),
+    total_entries(copy.total_entries),
+    buckets(),
+    cells(),
+    index_sampling(0.0),
+    cell_size(EXACT_CELL_SIZE)
+  {
+    rebuildIndex( copy.buckets.size() );
+  }
+
+
+  template < typename Value, class CompUser >
+  CoordZSpatialMap< Value, CompUser >& CoordZSpatialMap< Value, CompUser >::operator=( const CoordZSpatialMap< Value, CompUser >& copy ) {
+    if (this == &copy) return *this;
+    entries = copy.entries;
+    total_entries = copy.total_entries;
+    rebuildIndex( copy.buckets.size() );
+    return *this;
+  }
+
+
+  template < typename Value, class CompUser >
+  void CoordZSpatialMap< Value, CompUser >::clear() {
+    entries.clear();
+    buckets.clear();
+    cells.clear();
+    total_entries = 0;
+  }
+
+
+  template < typename Value, class CompUser >
+  inline size_t CoordZSpatialMap< Value, CompUser >::getBucket( int64_t cell_x, int64_t cell_y, int64_t cell_z ) const {
+    uint64_t hash = (uint64_t)cell_x * 0x9E3779B97F4A7C15ULL;
+    hash ^= (uint64_t)cell_y * 0xC2B2AE3D27D4EB4FULL + (hash << 6) + (hash >> 2);
+    hash ^= (uint64_t)cell_z * 0x165667B19E3779F9ULL + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 29;
+    return (size_t)( hash & (uint64_t)( buckets.size() - 1 ) );
+  }
+
+
+  template < typename Value, class CompUser >
+  inline void CoordZSpatialMap< Value, CompUser >::computeCell( const CoordZ& coordz, CellEntry& cell_entry ) const {
+    CoordZ::CartCoords cart_coords = coordz.getCartCoords();
+
+    cell_entry.cart_x = cart_coords.getX();
+    cell_entry.cart_y = cart_coords.getY();
+    cell_entry.cart_z = cart_coords.getZ();
+
+    cell_entry.cell_x = (int64_t) ::std::floor( cell_entry.cart_x / cell_size );
+    cell_entry.cell_y = (int64_t) ::std::floor( cell_entry.cart_y / cell_size );
+    cell_entry.cell_z = (int64_t) ::std::floor( cell_entry.cart_z / cell_size );
+  }
+
+
+  template < typename Value, class CompUser >
+  void CoordZSpatialMap< Value, CompUser >::rebuildIndex( size_t total_buckets ) const {
+    index_sampling = CompUser::getSpaceSampling();
+
+    // with cells twice as large as the space sampling, the sphere around any point
+    // intersects at most two cells per axis
+    if ( index_sampling > 0.0 ) cell_size = 2.0 * index_sampling;
+    else cell_size = EXACT_CELL_SIZE;
+
+    if ( total_buckets < INITIAL_BUCKETS ) total_buckets = INITIAL_BUCKETS;
+    while ( total_buckets < total_entries ) total_buckets *= 2;
+
+    buckets.assign( total_buckets, NO_CELL );
+    cells.clear();
+    cells.reserve( total_entries );
+
+    iterator it = const_cast< EntryList& >( entries ).begin();
+    for ( ; it != const_cast< EntryList& >( entries ).end(); ++it ) {
+      CellEntry cell_entry;
+      computeCell( it->first, cell_entry );
+      cell_entry.entry = it;
+      linkCell( cell_entry );
+    }
+  }
+
+
+  template < typename Value, class CompUser >
+  inline void CoordZSpatialMap< Value, CompUser >::linkCell( const CellEntry& cell_entry ) const {
+    size_t bucket = getBucket( cell_entry.cell_x, cell_entry.cell_y, cell_entry.cell_z );
+
+    cells.push_back( cell_entry );
+    cells.back().next = buckets[bucket];
+    buckets[bucket] = cells.size() - 1;
+  }
+
+
+  template < typename Value, class CompUser >
+  inline void CoordZSpatialMap< Value, CompUser >::checkIndex() const {
+    if ( buckets.empty() || index_sampling != CompUser::getSpaceSampling() ) rebuildIndex( buckets.size() );
+  }
+
+
+  template < typename Value, class CompUser >
+  void CoordZSpatialMap< Value, CompUser >::indexEntry( iterator it ) const {
+    if ( total_entries > buckets.size() ) rebuildIndex( 2 * buckets.size() );
+    else {
+      CellEntry cell_entry;
+      computeCell( it->first, cell_entry );
+      cell_entry.entry = it;
+      linkCell( cell_entry );
+    }
+  }
+
+
+  template < typename Value, class CompUser >
+  bool CoordZSpatialMap< Value, CompUser >::search( const CoordZ& coordz, iterator& found ) const {
+    if ( total_entries == 0 ) return false;
+    checkIndex();
+
+    CellEntry query;
+    computeCell( coordz, query );
+
+    if ( index_sampling <= 0.0 ) {
+      size_t curr = buckets[ getBucket( query.cell_x, query.cell_y, query.cell_z ) ];
+
+      for ( ; curr != NO_CELL; curr = cells[curr].next ) {
+        if ( cells[curr].entry->first == coordz ) {
+          found = cells[curr].entry;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // neighbour cell along each axis, on the side of the closest cell border
+    int64_t next_x = query.cell_x + ( ( query.cart_x / cell_size - query.cell_x ) < 0.5 ? -1 : 1 );
+    int64_t next_y = query.cell_y + ( ( query.cart_y / cell_size - query.cell_y ) < 0.5 ? -1 : 1 );
+    int64_t next_z = query.cell_z + ( ( query.cart_z / cell_size - query.cell_z ) < 0.5 ? -1 : 1 );
+
+    double max_distance = index_sampling * index_sampling;
+    double best_distance = max_distance;
+    bool is_found = false;
+
+    for ( int i = 0; i < 8; ++i ) {
+      int64_t cell_x = ( i & 1 ) ? next_x : query.cell_x;
+      int64_t cell_y = ( i & 2 ) ? next_y : query.cell_y;
+      int64_t cell_z = ( i & 4 ) ? next_z : query.cell_z;
+
+      for ( size_t curr = buckets[ getBucket( cell_x, cell_y, cell_z ) ]; curr != NO_CELL; curr = cells[curr].next ) {
+        const CellEntry& cell = cells[curr];
+
+        if ( cell.cell_x != cell_x || cell.cell_y != cell_y || cell.cell_z != cell_z ) continue;
+
+        double dx = cell.cart_x - query.cart_x;
+        double dy = cell.cart_y - query.cart_y;
+        double dz = cell.cart_z - query.cart_z;
+        double distance = dx * dx + dy * dy + dz * dz;
+
+        if ( distance <= max_distance && ( !is_found || distance < best_distance ) ) {
+          best_distance = distance;
+          found = cell.entry;
+          is_found = true;
+        }
+      }
+    }
+    return is_found;
+  }
+
+
+  template < typename Value, class CompUser >
+  typename CoordZSpatialMap< Value, CompUser >::iterator CoordZSpatialMap< Value, CompUser >::find( const CoordZ& coordz ) {
+    iterator it = entries.end();
+    search( coordz, it );
+    return it;
+  }
+
+
+  template < typename Value, class CompUser >
+  typename CoordZSpatialMap< Value, CompUser >::const_iterator CoordZSpatialMap< Value, CompUser >::find( const CoordZ& coordz ) const {
+    iterator it;
+    if ( search( coordz, it ) ) return it;
+    return entries.end();
+  }
+
+
+  template < typename Value, class CompUser >
+  Value& CoordZSpatialMap< Value, CompUser >::operator[]( const CoordZ& coordz ) {
+    iterator it;
+    if ( search( coordz, it ) ) return it->second;
+
+    checkIndex();
+    it = entries.insert( entries.end(), value_type( coordz, Value() ) );
+    total_entries++;
+    indexEntry( it );
+    return it->second;
+  }
+
+
+  template < typename Value, class CompUser >
+  void CoordZSpatialMap< Value, CompUser >::erase( iterator it ) {
+    checkIndex();
+
+    CellEntry cell_entry;
+    computeCell( it->first, cell_entry );
+
+    size_t* link = &buckets[ getBucket( cell_entry.cell_x, cell_entry.cell_y, cell_entry.cell_z ) ];
+    while ( *link != NO_CELL && cells[*link].entry != it ) link = &cells[*link].next;
+
+    if ( *link != NO_CELL ) {
+      size_t removed = *link;
+      *link = cells[removed].next;
+
+      // move the last CellEntry into the freed slot and fix the link pointing to it
+      size_t last = cells.size() - 1;
+      if ( removed != last ) {
+        const CellEntry& moved = cells[last];
+        size_t* moved_link = &buckets[ getBucket( moved.cell_x, moved.cell_y, moved.cell_z ) ];
+        while ( *moved_link != last ) moved_link = &cells[*moved_link].next;
+        *moved_link = removed;
+        cells[removed] = moved;
+      }
+      cells.pop_back();
+    }
+    entries.erase( it );
+    total_entries--;
+  }
+
+
+}
+
+
+#endif /* WOSS_COORDINATES_SPATIAL_MAP_H */
+
@@ -70,9 +70,7 @@ Pressure::Pressure( const Pressure& copy ) {
 Pressure::Pressure( const TimeArr& time_arr ) {
   if ( !time_arr.isValid() ) complex_pressure = Pressure::createNotValid();
   
-  for ( TimeArrCIt it = time_arr.begin(); it != time_arr.end(); it++ ) {
-    complex_pressure += it->second;
-  }
+  complex_pressure += ::std::complex<double>( time_arr );
 }
 
 
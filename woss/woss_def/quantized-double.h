@@ -0,0 +1,206 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   quantized-double.h
+ * @author Federico Guerra
+ * 
+ * \brief Provides the interface for the woss::QDouble class
+ *
+ * Provides the interface for the QDouble class. QDouble stands for QuantizedDouble: the value is stored as an
+ * integer number of ticks, whose size is a template parameter. It is meant as a container key for values that 
+ * have a precision fixed at compile time, where it replaces woss::PDouble keys: comparisons are single integer 
+ * compares and each instance takes 8 bytes instead of the 32 bytes of a PDouble.
+ */
+
+
+#ifndef WOSS_QUANTIZED_DOUBLE_H
+#define WOSS_QUANTIZED_DOUBLE_H
+
+
+#include <iostream>
+#include <cmath>
+#include <stdint.h>
+
+
+
+namespace woss {
+    
+    
+  /**
+  * \brief Fixed-point key class.
+  *
+  * The QDouble class stores a value rounded to the closest multiple of 1 / TicksPerUnit, as an int64_t number of ticks.
+  * Two values closer than half a tick become the same key, i.e. QDouble< 100000 > matches the behaviour of a PDouble
+  * with 1e-5 precision for values that lie on the tick grid.
+  **/
+  template < int64_t TicksPerUnit >
+  class QDouble {
+
+    
+    public:
+    
+    /**
+    * QDouble default constructor
+    **/     
+    QDouble() : ticks(0) { }
+    
+    /**
+    * QDouble constructor
+    * @param input value to be quantized
+    **/     
+    explicit QDouble( const long double input ) : ticks( quantize(input) ) { }
+
+
+    /**
+    * Returns the precision of all instances
+    * @return long double precision
+    **/
+    static long double getPrecision() { return( 1.0L / (long double) TicksPerUnit ); }
+
+    /**
+    * Returns the quantized value
+    * @return long double value
+    **/
+    long double getValue() const { return( (long double) ticks / (long double) TicksPerUnit ); }
+
+    /**
+    * Returns the stored number of ticks
+    * @return int64_t ticks
+    **/
+    int64_t getTicks() const { return ticks; }
+
+    
+    /**
+    * double cast operator
+    * @return a copy of the quantized value casted to double
+    **/
+    operator double() const { return( (double) getValue() ); }
+    
+    /**
+    * long double cast operator
+    * @return a copy of the quantized value
+    **/
+    operator long double() const { return getValue(); }
+
+
+    /**
+    * Equality operator
+    * @param left left operand const reference
+    * @param right right operand const reference
+    * @return true if <i>left == right</i>, false otherwise
+    **/  
+    friend bool operator==( const QDouble& left, const QDouble& right ) { return( left.ticks == right.ticks ); }
+
+    /**
+    * Inequality operator
+    * @param left left operand const reference
+    * @param right right operand const reference
+    * @return true if <i>left != right</i>, false otherwise
+    **/  
+    friend bool operator!=( const QDouble& left, const QDouble& right ) { return( left.ticks != right.ticks ); }
+    
+    /**
+    * Greater than operator
+    * @param left left operand const reference
+    * @param right right operand const reference
+    * @return true if <i>left > right</i>, false otherwise
+    **/ 
+    friend bool operator>( const QDouble& left, const QDouble& right ) { return( left.ticks > right.ticks ); }
+
+    /**
+    * Less than operator
+    * @param left left operand const reference
+    * @param right right operand const reference
+    * @return true if <i>left < right</i>, false otherwise
+    **/ 
+    friend bool operator<( const QDouble& left, const QDouble& right ) { return( left.ticks < right.ticks ); }
+
+    /**
+    * Greater than or equal to operator
+    * @param left left operand const reference
+    * @param right right operand const reference
+    * @return true if <i>left >= right</i>, false otherwise
+    **/    
+    friend bool operator>=( const QDouble& left, const QDouble& right ) { return( left.ticks >= right.ticks ); }
+
+    /**
+    * Less than or equal to operator
+    * @param left left operand const reference
+    * @param right right operand const reference
+    * @return true if <i>left <= right</i>, false otherwise
+    **/ 
+    friend bool operator<=( const QDouble& left, const QDouble& right ) { return( left.ticks <= right.ticks ); }
+    
+
+    /**
+    * << operator
+    * @param os left operand ostream reference
+    * @param instance right operand const QDouble reference
+    * @return <i>os</i> reference after the operation
+    **/ 
+    friend ::std::ostream& operator<<( ::std::ostream& os, const QDouble& instance ) {
+      os << instance.getValue();
+      return os;
+    }
+
+    /**
+    * >> operator
+    * @param is left operand istream reference
+    * @param instance right operand QDouble reference. It will take the quantized value provided by <i>is</i>
+    * @return <i>is</i> reference after the operation
+    **/ 
+    friend ::std::istream& operator>>( ::std::istream& is, QDouble& instance ) {
+      long double value = 0.0;
+      is >> value;
+      instance.ticks = quantize(value);
+      return is;
+    }
+    
+
+    protected:
+
+    /**
+    * Rounds a value to the closest number of ticks
+    * @param input value to be quantized
+    * @return int64_t number of ticks
+    **/
+    static int64_t quantize( const long double input ) { return( (int64_t) ::std::floor( input * (long double) TicksPerUnit + 0.5L ) ); }
+
+
+    /**
+    * stored number of ticks
+    **/ 
+    int64_t ticks;
+
+  };
+
+}
+
+#endif /* WOSS_QUANTIZED_DOUBLE_H */
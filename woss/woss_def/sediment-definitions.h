@@ -501,6 +501,13 @@ namespace woss {
     
   };
 
+
+  /**
+  * Vector of heap-created Sediment pointers, one for each CoordZ of a transect
+  **/
+  typedef ::std::vector< Sediment* > SedimentVector;
+
+
   // non-inline friend operator declarations
   //////////
   const Sediment operator/( const double left, const Sediment& right );
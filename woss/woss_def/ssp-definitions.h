@@ -1214,6 +1214,12 @@ namespace woss {
 
   };
 
+
+  /**
+  * Vector of heap-created SSP pointers, one for each CoordZ of a transect
+  **/
+  typedef ::std::vector< SSP* > SSPVector;
+
   //non-inline operator declarations
   /////////////
   
@@ -37,19 +37,60 @@
  */
 
 
-#include <iterator>
+#include <algorithm>
 #include "time-arrival-definitions.h"
 
 
 using namespace woss;
 
 
+/**
+* Sums values[begin, end) over four independent accumulators, so that the loop maps on SIMD lanes
+* and doesn't wait on a single addition chain
+**/
+static inline double sumRange( const double* values, int begin, int end ) {
+  double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0;
+  int i = begin;
+
+  for ( ; i + 4 <= end; i += 4 ) {
+    acc0 += values[i];
+    acc1 += values[i + 1];
+    acc2 += values[i + 2];
+    acc3 += values[i + 3];
+  }
+  for ( ; i < end; ++i ) acc0 += values[i];
+
+  return( ( acc0 + acc1 ) + ( acc2 + acc3 ) );
+}
+
+
+/**
+* Sums the squared magnitudes of complex values[begin, end) stored as separate real and imaginary arrays
+**/
+static inline double sumSquaresRange( const double* real, const double* imag, int begin, int end ) {
+  double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0;
+  int i = begin;
+
+  for ( ; i + 4 <= end; i += 4 ) {
+    acc0 += real[i] * real[i] + imag[i] * imag[i];
+    acc1 += real[i + 1] * real[i + 1] + imag[i + 1] * imag[i + 1];
+    acc2 += real[i + 2] * real[i + 2] + imag[i + 2] * imag[i + 2];
+    acc3 += real[i + 3] * real[i + 3] + imag[i + 3] * imag[i + 3];
+  }
+  for ( ; i < end; ++i ) acc0 += real[i] * real[i] + imag[i] * imag[i];
+
+  return( ( acc0 + acc1 ) + ( acc2 + acc3 ) );
+}
+
+
 bool TimeArr::debug = false;
 
 
 TimeArr::TimeArr( long double custom_delay_prec )
 : delay_precision(custom_delay_prec),
-  time_arr_map()
+  delays(),
+  real_values(),
+  imag_values()
 {
 
 }
@@ -57,39 +98,62 @@ TimeArr::TimeArr( long double custom_delay_prec )
 
 TimeArr::TimeArr( const TimeArr& copy ) {
   delay_precision = copy.delay_precision;
-  time_arr_map = copy.time_arr_map;
+  delays = copy.delays;
+  real_values = copy.real_values;
+  imag_values = copy.imag_values;
 }
 
 
 TimeArr::TimeArr( TimeArrMap& map, long double custom_delay_prec )
 : delay_precision(custom_delay_prec),
-  time_arr_map()
+  delays(),
+  real_values(),
+  imag_values()
 {
-  time_arr_map.swap(map);
+  importMap(map);
+  map.clear();
 }
 
 
 TimeArr::TimeArr( const Pressure& pressure, double delay, long double custom_delay_prec ) 
 : delay_precision(custom_delay_prec),
-  time_arr_map()
+  delays(),
+  real_values(),
+  imag_values()
 {
-  if ( !pressure.isValid() ) time_arr_map[0.0] = Pressure::createNotValid();
-  else time_arr_map.insert( std::make_pair( delay, pressure ) );
+  if ( !pressure.isValid() ) appendTap( 0.0, Pressure::createNotValid() );
+  else appendTap( delay, pressure );
 }
 
 
-TimeArr::operator std::complex<double>() const { 
-  std::complex<double> value;
-  for ( TimeArrCIt it = time_arr_map.begin(); it != time_arr_map.end(); it++) {
-    value += it->second;
+void TimeArr::importMap( const TimeArrMap& map ) {
+  delays.reserve( map.size() );
+  real_values.reserve( map.size() );
+  imag_values.reserve( map.size() );
+
+  for ( TimeArrMap::const_iterator it = map.begin(); it != map.end(); it++ ) {
+    double delay = (double) it->first.getValue();
+
+    // map keys closer than the delay precision are the same tap
+    if ( !delays.empty() && ( delay - delays.back() ) <= delay_precision ) {
+      real_values.back() += it->second.real();
+      imag_values.back() += it->second.imag();
+    }
+    else appendTap( delay, it->second );
   }
-  return value;
+}
+
+
+TimeArr::operator std::complex<double>() const { 
+  if ( delays.empty() ) return std::complex<double>();
+  return std::complex<double>( sumRange( &real_values[0], 0, size() ), sumRange( &imag_values[0], 0, size() ) );
 }
 
 
 bool TimeArr::isValid() const { 
-  if ( time_arr_map.size() < 1 ) return false; 
-  if ( time_arr_map.find(0.0) != time_arr_map.end() && time_arr_map.find(0.0)->second == Pressure::createNotValid() ) return false; 
+  if ( delays.size() < 1 ) return false; 
+  int index = findIndex( 0.0 );
+  if ( index >= 0 && std::complex<double>( real_values[index], imag_values[index] ) == Pressure::createNotValid() ) return false; 
   return true;
 }
 
@@ -97,60 +161,142 @@ bool TimeArr::isValid() const {
 TimeArr& TimeArr::operator=( const TimeArr& copy ) {
   if (this == &copy) return *this;
   delay_precision = copy.delay_precision;
-  time_arr_map = copy.time_arr_map;
+  delays = copy.delays;
+  real_values = copy.real_values;
+  imag_values = copy.imag_values;
   return( *this );
 }
 
 
-TimeArrCIt TimeArr::at( const int position ) const {
-  if ( position >= (int) time_arr_map.size() || position < 0 ) return time_arr_map.end();
-  if ( position == 0 ) return time_arr_map.begin();
+int TimeArr::lowerBoundIndex( double delay ) const {
+  return( std::lower_bound( delays.begin(), delays.end(), delay - (double) delay_precision ) - delays.begin() );
+}
 
-  TimeArrCIt ret_val = time_arr_map.begin();
-  ::std::advance( ret_val, position );
 
-  return ret_val;
+int TimeArr::findIndex( double delay ) const {
+  int index = lowerBoundIndex( delay );
+  if ( index < size() && std::abs( delays[index] - delay ) <= delay_precision ) return index;
+  return -1;
+}
+
+
+void TimeArr::insertTap( int index, double delay, const std::complex<double>& value ) {
+  if ( index == size() ) {
+    appendTap( delay, value );
+    return;
+  }
+  delays.insert( delays.begin() + index, delay );
+  real_values.insert( real_values.begin() + index, value.real() );
+  imag_values.insert( imag_values.begin() + index, value.imag() );
+}
+
+
+TimeArr& TimeArr::insertValue( double delay, const Pressure& pressure ) { 
+  assert( pressure.isValid() ); 
+  assert( delay >= 0.0 );
+
+  int index = lowerBoundIndex( delay );
+
+  // the first value inserted at a delay wins
+  if ( index < size() && std::abs( delays[index] - delay ) <= delay_precision ) return *this;
+
+  insertTap( index, delay, pressure );
+  return *this;
+}
+
+
+void TimeArr::sumValue( double delay, const Pressure& pressure ) {
+  assert( pressure.isValid() ); 
+  assert( delay >= 0.0 );
+
+  std::complex<double> value = pressure;
+
+  // arrivals are mostly read in increasing delay order
+  if ( delays.empty() || ( delay - delays.back() ) > delay_precision ) {
+    appendTap( delay, value );
+    return;
+  }
+
+  int index = lowerBoundIndex( delay );
+
+  if ( index < size() && std::abs( delays[index] - delay ) <= delay_precision ) {
+    real_values[index] += value.real();
+    imag_values[index] += value.imag();
+  }
+  else insertTap( index, delay, value );
+}
+
+
+TimeArrCIt TimeArr::findValue( double delay ) const {
+  int index = findIndex( delay );
+  if ( index < 0 ) return end();
+  return TimeArrCIt( this, index );
+}
+
+
+TimeArr& TimeArr::eraseValue( double delay ) {
+  int index = findIndex( delay );
+  if ( index < 0 ) return *this;
+
+  delays.erase( delays.begin() + index );
+  real_values.erase( real_values.begin() + index );
+  imag_values.erase( imag_values.begin() + index );
+  return *this;
+}
+
+
+TimeArrCIt TimeArr::at( const int position ) const {
+  if ( position >= size() || position < 0 ) return end();
+  return TimeArrCIt( this, position );
 }
 
 
 TimeArrCIt TimeArr::lowerBoundTxLoss( double threshold_db ) const {
-	TimeArrCIt it;
-	
-	for ( it = time_arr_map.begin(); it != time_arr_map.end(); it++ ) {
-    if ( Pressure::getTxLossDb(it->second) <= threshold_db ) {
-			
-// 			std::cout << "TimeArr::lowerBoundTxLoss() threshold_db curr tx loss val "
-// 			          << Pressure::getTxLossDb(it->second) << " <=  threshold_db " << threshold_db 
-// 			          << "; time " << it->first << ::std::endl;
-								
-			return it;
-		}
+  // tx loss <= threshold_db  <=>  |pressure|^2 >= 10^(-threshold_db / 10)
+  double min_power = pow( 10.0, -threshold_db / 10.0 );
+  int total = size();
+
+  for ( int i = 0; i < total; ++i ) {
+    if ( ( real_values[i] * real_values[i] + imag_values[i] * imag_values[i] ) >= min_power ) return TimeArrCIt( this, i );
   }
   
-  return time_arr_map.end();
+  return end();
 }
 
 
-// keeps the last value of each overridden PDouble
+// keeps the first delay and the last value of each overridden delay
 woss::TimeArr& TimeArr::setDelayPrecision( long double precision ) {
-  TimeArrMap temp_map;
-  
-  for ( TimeArrIt it = time_arr_map.begin(); it != time_arr_map.end(); it++ ) {
-    temp_map[ PDouble( it->first.getValue(), precision) ] = it->second;
+  int total = size();
+  int last = -1;
+
+  for ( int i = 0; i < total; ++i ) {
+    if ( last < 0 || std::abs( delays[i] - delays[last] ) > precision ) {
+      ++last;
+      delays[last] = delays[i];
+    }
+    real_values[last] = real_values[i];
+    imag_values[last] = imag_values[i];
   }
-  time_arr_map.swap(temp_map);
-  
+  delays.resize( last + 1 );
+  real_values.resize( last + 1 );
+  imag_values.resize( last + 1 );
+
+  delay_precision = precision;
   return *this;
 }
 
 
 bool TimeArr::checkPressureAttenuation( double distance, double frequency ) {
   bool ret_val = false;
+  int total = size();
   
-  for ( TimeArrIt it = time_arr_map.begin(); it != time_arr_map.end(); it++) {
-    Pressure temp = Pressure(it->second);
+  for ( int i = 0; i < total; ++i ) {
+    Pressure temp = Pressure( real_values[i], imag_values[i] );
     ret_val = ret_val || temp.checkAttenuation( distance, frequency ) ;
-    it->second = temp;
+
+    std::complex<double> value = temp;
+    real_values[i] = value.real();
+    imag_values[i] = value.imag();
   }
   
   return ret_val;
@@ -158,52 +304,101 @@ bool TimeArr::checkPressureAttenuation( double distance, double frequency ) {
 
 
 TimeArr* TimeArr::coherentSumSample( double time_resolution ) {
-  TimeArrMap temp_map;
-  
-  PDouble curr_ch_time = time_arr_map.begin()->first;
-  for ( TimeArrIt it = time_arr_map.begin(); it != time_arr_map.end(); it++) {
-    if ( it->first > (curr_ch_time + PDouble(time_resolution, delay_precision) ) ) curr_ch_time = it->first;
-    temp_map[curr_ch_time] += it->second;
+  TimeArr* ret_val = create( delay_precision );
+  int total = size();
+  int begin = 0;
+
+  // each bin starts at the first delay past the previous bin start + time_resolution
+  while ( begin < total ) {
+    int end = std::upper_bound( delays.begin() + begin, delays.end(), delays[begin] + time_resolution + (double) delay_precision ) - delays.begin();
+
+    ret_val->appendTap( delays[begin], std::complex<double>( sumRange( &real_values[0], begin, end ), sumRange( &imag_values[0], begin, end ) ) );
+    begin = end;
   }
-  return( create(temp_map) );
+  return( ret_val );
 }
   
 
 TimeArr* TimeArr::incoherentSumSample( double time_resolution ) {
-  TimeArrMap temp_map;
-  
-  PDouble curr_ch_time = time_arr_map.begin()->first;
-  for ( TimeArrIt it = time_arr_map.begin(); it != time_arr_map.end(); it++) {
-    if ( it->first > (curr_ch_time + PDouble(time_resolution, delay_precision) ) ) curr_ch_time = it->first;
-    temp_map[curr_ch_time] += pow( abs( it->second ), 2.0 );
-  }
-  
-  for ( TimeArrIt it = temp_map.begin(); it != temp_map.end(); it++) {
-    temp_map[it->first] = sqrt( it->second ) ;
+  TimeArr* ret_val = create( delay_precision );
+  int total = size();
+  int begin = 0;
+
+  while ( begin < total ) {
+    int end = std::upper_bound( delays.begin() + begin, delays.end(), delays[begin] + time_resolution + (double) delay_precision ) - delays.begin();
+
+    ret_val->appendTap( delays[begin], std::complex<double>( sqrt( sumSquaresRange( &real_values[0], &imag_values[0], begin, end ) ), 0.0 ) );
+    begin = end;
   }
-  return( create(temp_map) );
+  return( ret_val );
 }
 
 
 TimeArr* TimeArr::crop( double time_start, double time_end ) {
-	TimeArrMap temp_map;
-	
-// 	int i = 0;
-  for ( TimeArrIt it = time_arr_map.begin(); it != time_arr_map.end(); it++) {
-    if ( it->first >= PDouble(time_start, delay_precision) 
-			&& it->first < PDouble(time_end, delay_precision) ) {
-				
-// 			std::cout << "TimeArr::crop() index " << i << "; time_start " << time_start << "; time_end " << time_end 
-// 			          << "; time value " << it->first << "; att " << it->second << std::endl;
-
-			temp_map[it->first] = it->second;
-		}
-// 		++i;
-	}
-  return( create(temp_map) );	
+  TimeArr* ret_val = create( delay_precision );
+
+  // delays in [time_start, time_end) within delay precision
+  int begin = lowerBoundIndex( time_start );
+  int end = lowerBoundIndex( time_end );
+
+  if ( begin < end ) {
+    ret_val->delays.assign( delays.begin() + begin, delays.begin() + end );
+    ret_val->real_values.assign( real_values.begin() + begin, real_values.begin() + end );
+    ret_val->imag_values.assign( imag_values.begin() + begin, imag_values.begin() + end );
+  }
+  return( ret_val );
+}
+
+
+void TimeArr::mergeTaps( const TimeArr& right, double sign ) {
+  int left_size = size();
+  int right_size = right.size();
+
+  std::vector< double > new_delays;
+  std::vector< double > new_real_values;
+  std::vector< double > new_imag_values;
+
+  new_delays.reserve( left_size + right_size );
+  new_real_values.reserve( left_size + right_size );
+  new_imag_values.reserve( left_size + right_size );
+
+  int i = 0;
+  int j = 0;
+
+  while ( i < left_size || j < right_size ) {
+    double delay;
+    double real;
+    double imag;
+
+    if ( j >= right_size || ( i < left_size && delays[i] <= right.delays[j] ) ) {
+      delay = delays[i];
+      real = real_values[i];
+      imag = imag_values[i];
+      ++i;
+    }
+    else {
+      delay = right.delays[j];
+      real = sign * right.real_values[j];
+      imag = sign * right.imag_values[j];
+      ++j;
+    }
+
+    if ( !new_delays.empty() && ( delay - new_delays.back() ) <= delay_precision ) {
+      new_real_values.back() += real;
+      new_imag_values.back() += imag;
+    }
+    else {
+      new_delays.push_back( delay );
+      new_real_values.push_back( real );
+      new_imag_values.push_back( imag );
+    }
+  }
+
+  delays.swap( new_delays );
+  real_values.swap( new_real_values );
+  imag_values.swap( new_imag_values );
 }
 
-  
 const TimeArr woss::operator+( const TimeArr& left, const TimeArr& right ) { 
   TimeArr ret_val ( left );
   ret_val += right;
@@ -274,52 +469,62 @@ const TimeArr woss::operator*( const double left, const TimeArr& right ) {
 }
 
 
-TimeArr& woss::operator+=( TimeArr& left, const TimeArr& right ) { 
-  for ( TimeArrCIt it = right.time_arr_map.begin(); it != right.time_arr_map.end(); it++ ) {
-    left.time_arr_map[it->first] += it->second;
+bool woss::operator==( const TimeArr& left, const TimeArr& right ) { 
+  if ( &left == &right ) return true; 
+  if ( left.size() != right.size() ) return false;
+
+  for ( int i = 0; i < left.size(); ++i ) {
+    if ( std::abs( left.delays[i] - right.delays[i] ) > left.delay_precision 
+         || left.real_values[i] != right.real_values[i] || left.imag_values[i] != right.imag_values[i] ) return false;
   }
+  return true;
+}
+
+
+TimeArr& woss::operator+=( TimeArr& left, const TimeArr& right ) { 
+  if ( &left == &right ) return( left *= 2.0 );
+  left.mergeTaps( right, 1.0 );
   return left;
 }
 
 
 TimeArr& woss::operator-=( TimeArr& left, const TimeArr& right ) { 
-  for ( TimeArrCIt it = right.time_arr_map.begin(); it != right.time_arr_map.end(); it++ ) {
-    left.time_arr_map[it->first] -= it->second;
-  }
+  if ( &left == &right ) return( left *= 0.0 );
+  left.mergeTaps( right, -1.0 );
   return left;
 }
 
 
 TimeArr& woss::operator+=( TimeArr& left, double right ) { 
-  for ( TimeArrCIt it = left.time_arr_map.begin(); it != left.time_arr_map.end(); it++ ) {
-    left.time_arr_map[it->first] += right;
-  }
+  int total = left.size();
+  for ( int i = 0; i < total; ++i ) left.real_values[i] += right;
   return left;
 }
 
 
 TimeArr& woss::operator-=( TimeArr& left, double right ) { 
-  for ( TimeArrCIt it = left.time_arr_map.begin(); it != left.time_arr_map.end(); it++ ) {
-    left.time_arr_map[it->first] -= right;
-  }
+  int total = left.size();
+  for ( int i = 0; i < total; ++i ) left.real_values[i] -= right;
   return left;
 }
 
 
 TimeArr& woss::operator/=( TimeArr& left, double right ) { 
-  for ( TimeArrCIt it = left.time_arr_map.begin(); it != left.time_arr_map.end(); it++ ) {
-    left.time_arr_map[it->first] /= right;
+  int total = left.size();
+  for ( int i = 0; i < total; ++i ) {
+    left.real_values[i] /= right;
+    left.imag_values[i] /= right;
   }
   return left;
 }
 
 
 TimeArr& woss::operator*=( TimeArr& left, double right ) { 
-  for ( TimeArrCIt it = left.time_arr_map.begin(); it != left.time_arr_map.end(); it++ ) {
-    left.time_arr_map[it->first] *= right;
+  int total = left.size();
+  for ( int i = 0; i < total; ++i ) {
+    left.real_values[i] *= right;
+    left.imag_values[i] *= right;
   }
   return left;
 }
 
-
-
@@ -43,7 +43,10 @@
 
 #include <cassert>
 #include <climits>
+#include <cstddef>
 #include <map>
+#include <vector>
+#include <iterator>
 #include "pressure-definitions.h"
 #include "custom-precision-double.h"
 
@@ -55,10 +58,108 @@ namespace woss {
   * Map that links a PDouble delay [s] to a complex Pressure
   **/ 
   typedef std::map < PDouble , std::complex<double> > TimeArrMap; 
-  typedef TimeArrMap::iterator TimeArrIt;
-  typedef TimeArrMap::const_iterator TimeArrCIt;
-  typedef TimeArrMap::reverse_iterator TimeArrRIt;
-  typedef TimeArrMap::const_reverse_iterator TimeArrCRIt;
+
+
+  class TimeArr;
+
+
+  /**
+  * \brief Const iterator over the taps of a TimeArr
+  *
+  * TimeArrTapIterator walks the flat storage of a TimeArr and presents each tap as a pair of PDouble delay [s] 
+  * and complex Pressure, the same way a TimeArrMap iterator does. The pointed pair is a copy of the stored tap,
+  * therefore taps can't be modified through the iterator.
+  **/
+  class TimeArrTapIterator {
+
+
+    public:
+
+
+    typedef ::std::bidirectional_iterator_tag iterator_category;
+    typedef ::std::pair< PDouble, ::std::complex<double> > value_type;
+    typedef ::std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+
+    /**
+    * TimeArrTapIterator default constructor
+    **/
+    TimeArrTapIterator() : time_arr(NULL), index(0), step(1), tap() { }
+
+    /**
+    * TimeArrTapIterator constructor
+    * @param arr pointer to the iterated TimeArr
+    * @param position index of the pointed tap
+    * @param direction +1 for a forward iterator, -1 for a reverse iterator
+    **/
+    TimeArrTapIterator( const TimeArr* arr, int position, int direction = 1 ) : time_arr(arr), index(position), step(direction), tap() { }
+
+
+    reference operator*() const { loadTap(); return tap; }
+
+    pointer operator->() const { loadTap(); return &tap; }
+
+
+    TimeArrTapIterator& operator++() { index += step; return *this; }
+
+    TimeArrTapIterator operator++( int ) { TimeArrTapIterator ret_val(*this); index += step; return ret_val; }
+
+    TimeArrTapIterator& operator--() { index -= step; return *this; }
+
+    TimeArrTapIterator operator--( int ) { TimeArrTapIterator ret_val(*this); index -= step; return ret_val; }
+
+
+    /**
+    * Returns the index of the pointed tap in the TimeArr storage
+    * @return index
+    **/
+    int getIndex() const { return index; }
+
+
+    friend bool operator==( const TimeArrTapIterator& left, const TimeArrTapIterator& right ) { return( left.index == right.index && left.time_arr == right.time_arr ); }
+
+    friend bool operator!=( const TimeArrTapIterator& left, const TimeArrTapIterator& right ) { return( left.index != right.index || left.time_arr != right.time_arr ); }
+
+
+    protected:
+
+
+    /**
+    * Copies the pointed tap into <i>tap</i>
+    **/
+    void loadTap() const;
+
+
+    /**
+    * Iterated TimeArr
+    **/
+    const TimeArr* time_arr;
+
+    /**
+    * Index of the pointed tap
+    **/
+    int index;
+
+    /**
+    * Iteration direction
+    **/
+    int step;
+
+    /**
+    * Copy of the pointed tap
+    **/
+    mutable value_type tap;
+
+
+  };
+
+
+  typedef TimeArrTapIterator TimeArrIt;
+  typedef TimeArrTapIterator TimeArrCIt;
+  typedef TimeArrTapIterator TimeArrRIt;
+  typedef TimeArrTapIterator TimeArrCRIt;
 
 
   /**
@@ -77,10 +178,15 @@ namespace woss {
   * \brief Channel power delay profile class
   *
   * TimeArr class offers the possibility to store and manipulate channel power delay profiles, e.g. a collection of time delay 
-  * values associated to a Pressure attenuation value.
+  * values associated to a Pressure attenuation value. 
+  * Taps are kept sorted by delay in contiguous arrays of delays, real and imaginary parts; delays closer than the
+  * delay precision are the same tap.
   **/ 
   class TimeArr {
 
+
+    friend class TimeArrTapIterator;
+
     
     public:
 
@@ -182,7 +288,8 @@ namespace woss {
 
 		
     /**
-    * Inserts and replace a Pressure value at given delay
+    * Inserts a Pressure value at given delay. If a tap within delay_precision of given delay already exists 
+    * it is kept and given value is discarded, as std::map::insert() does. Use sumValue() to accumulate values
     * @param delay delay value [s]
     * @param pressure Pressure value
     * @return reference to <b>*this</b>
@@ -202,7 +309,7 @@ namespace woss {
     * @param delay delay value [s]
     * @returns const iterator to end() if <i>delay</i> is not found
     **/
-    TimeArrCIt findValue( double delay ) const { return( time_arr_map.find(delay) ); }
+    TimeArrCIt findValue( double delay ) const;
     
     
     /**
@@ -210,7 +317,7 @@ namespace woss {
     * @param delay delay value [s]
     * @return reference to <b>*this</b>
     **/
-    TimeArr& eraseValue( double delay ) { time_arr_map.erase(delay); return *this; }
+    TimeArr& eraseValue( double delay );
     
     
     /**
@@ -252,25 +359,25 @@ namespace woss {
     * Returns a const iterator to the beginning of the time arrival map
     * @returns const iterator 
     **/
-    TimeArrCIt begin() const { return time_arr_map.begin(); }
+    TimeArrCIt begin() const { return TimeArrCIt( this, 0 ); }
     
     /**
     * Returns a const iterator to the end of the time arrival map
     * @returns const iterator 
     **/
-    TimeArrCIt end() const { return time_arr_map.end(); }
+    TimeArrCIt end() const { return TimeArrCIt( this, size() ); }
     
     /**
     * Returns a const reverse iterator to the reverse beginning of the time arrival map
     * @returns const iterator 
     **/
-    TimeArrCRIt rbegin() const { return time_arr_map.rbegin(); }
+    TimeArrCRIt rbegin() const { return TimeArrCRIt( this, size() - 1, -1 ); }
     
     /**
     * Returns a const reverse iterator to the reverse end of the time arrival map
     * @returns const iterator 
     **/
-    TimeArrCRIt rend() const { return time_arr_map.rend(); }
+    TimeArrCRIt rend() const { return TimeArrCRIt( this, -1, -1 ); }
     
     /**
     * Returns a const iterator to the Pressure value at i-th position 
@@ -290,19 +397,19 @@ namespace woss {
     * Returns the number of Pressure stored
     * @return number of Pressure values stored
     **/
-    int size() const { return time_arr_map.size(); }
+    int size() const { return delays.size(); }
 
     /**
     * Checks if the instance has stored values
     * @return <i>true</i> if condition applies, <i>false</i> otherwise
     **/
-    bool empty() const { return time_arr_map.empty(); } 
+    bool empty() const { return delays.empty(); } 
 
 
     /**
     * Erase all values of Pressure
     **/
-    void clear() { time_arr_map.clear(); }
+    void clear() { delays.clear(); real_values.clear(); imag_values.clear(); }
     
     
     /**
@@ -325,13 +432,13 @@ namespace woss {
     * Returns the maximum delay value
     * @returns maximum delay [s]
     **/
-    double getMaxDelayValue() const { return( time_arr_map.rbegin()->first ); }
+    double getMaxDelayValue() const { return( delays.back() ); }
 
     /**
     * Returns the maximum delay value
     * @returns maximum delay [s]
     **/
-    double getMinDelayValue() const { return( time_arr_map.begin()->first ); }
+    double getMinDelayValue() const { return( delays.front() ); }
     
     /**
     * Returns the delay precision
@@ -351,7 +458,7 @@ namespace woss {
     * Checks if the TimeArr was constructed from a Pressure value, therefore not carrying a valid delay information
     * @return <i>true</i> if it has at least one value, <i>false</i> otherwise
     **/
-    virtual bool isConvertedFromPressure() const { return( time_arr_map.size() == 1 && ( time_arr_map.begin()->first == PDouble(TIMEARR_PRESSURE_CONVERSION_DELAY) ) ); }
+    virtual bool isConvertedFromPressure() const { return( delays.size() == 1 && ::std::abs( delays[0] - TIMEARR_PRESSURE_CONVERSION_DELAY ) <= delay_precision ); }
 
 
   /**
@@ -537,15 +644,72 @@ namespace woss {
 
     
     /**
-    * Pressure values map 
+    * Sorted tap delays [s]
+    **/ 
+    ::std::vector< double > delays;
+
+    /**
+    * Real parts of the tap Pressure values, same order of <i>delays</i>
     **/ 
-    TimeArrMap time_arr_map;
+    ::std::vector< double > real_values;
+
+    /**
+    * Imaginary parts of the tap Pressure values, same order of <i>delays</i>
+    **/ 
+    ::std::vector< double > imag_values;
+
+
+    /**
+    * Returns the index of the first tap whose delay is not lower than <i>delay</i> within delay precision
+    * @param delay delay value [s]
+    * @return tap index, size() if all delays are lower
+    **/
+    int lowerBoundIndex( double delay ) const;
+
+    /**
+    * Returns the index of the tap with given delay
+    * @param delay delay value [s]
+    * @return tap index, -1 if not found
+    **/
+    int findIndex( double delay ) const;
+
+    /**
+    * Inserts a new tap at given index
+    * @param index insertion index, as returned by lowerBoundIndex()
+    * @param delay delay value [s]
+    * @param value complex Pressure value
+    **/
+    void insertTap( int index, double delay, const ::std::complex<double>& value );
+
+    /**
+    * Appends a tap, the delay must be greater than the last one
+    * @param delay delay value [s]
+    * @param value complex Pressure value
+    **/
+    void appendTap( double delay, const ::std::complex<double>& value ) { 
+      delays.push_back( delay ); real_values.push_back( value.real() ); imag_values.push_back( value.imag() ); }
+
+    /**
+    * Copies the given map into the flat storage
+    * @param map time arrival map
+    **/
+    void importMap( const TimeArrMap& map );
+
+    /**
+    * Merges the taps of given TimeArr, summing taps closer than the delay precision
+    * @param right const reference to the TimeArr to merge
+    * @param sign +1.0 to sum, -1.0 to subtract <i>right</i> values
+    **/
+    void mergeTaps( const TimeArr& right, double sign );
     
     
   };
 
   //non-inline operator declarations
   /////////////////
+  bool operator==( const TimeArr& left, const TimeArr& right );
+
+
   const TimeArr operator+( const TimeArr& left, const TimeArr& right ); 
 
   const TimeArr operator-( const TimeArr& left, const TimeArr& right ); 
@@ -601,44 +765,23 @@ namespace woss {
   }
 
 
-  inline TimeArr& TimeArr::insertValue( double delay, const Pressure& pressure ) { 
-    assert( pressure.isValid() ); 
-    assert( delay >= 0.0 );
-    
-    time_arr_map.insert( std::make_pair( delay, pressure ) ); 
-    
-    return *this;
-  }
-
-
-  inline void TimeArr::sumValue( double delay, const Pressure& pressure ) {
-    assert( pressure.isValid() ); 
-    assert( delay >= 0.0 );
-    
-    TimeArrIt it = time_arr_map.find( delay );
-    if ( it == time_arr_map.end() ) time_arr_map.insert( std::make_pair( delay, pressure ) );
-    else it->second += std::complex<double>( pressure ); 
+  inline void TimeArrTapIterator::loadTap() const {
+    tap.first = PDouble( time_arr->delays[index], time_arr->delay_precision );
+    tap.second = ::std::complex<double>( time_arr->real_values[index], time_arr->imag_values[index] );
   }
 
 
   inline std::ostream& operator<<( std::ostream& os, const TimeArr& instance ) {
-    os << "size = " << instance.time_arr_map.size() << "; min time_arr = " << instance.time_arr_map.begin()->first 
+    os << "size = " << instance.size() << "; min time_arr = " << instance.begin()->first 
                     << "; pressure db = " << Pressure::getTxLossDb(instance.begin()->second)  
-                    << "; max time_arr = " << instance.time_arr_map.rbegin()->first 
-                    << "; pressure db = " << Pressure::getTxLossDb(instance.time_arr_map.rbegin()->second);
+                    << "; max time_arr = " << instance.rbegin()->first 
+                    << "; pressure db = " << Pressure::getTxLossDb(instance.rbegin()->second);
     return os;
   }
 
 
-  inline bool operator==( const TimeArr& left, const TimeArr& right ) { 
-    if ( &left == &right ) return true; 
-    return( left.time_arr_map == right.time_arr_map );
-  }
-
-
   inline bool operator!=( const TimeArr& left, const TimeArr& right ) { 
-    if ( &left == &right ) return false; 
-    return( left.time_arr_map != right.time_arr_map );
+    return( !( left == right ) );
   }
 
 }
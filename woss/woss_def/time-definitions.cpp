@@ -49,18 +49,42 @@ using namespace woss;
 bool Time::debug = false;
 
 
+/**
+* Days between 1970-01-01 and the given proleptic gregorian date
+* @param y year value
+* @param m month value between 1 and 12
+* @param d day value, it may exceed the month's length
+* @return days since the UTC epoch
+**/
+static int64_t daysFromCivil( int64_t y, int m, int64_t d ) {
+  y -= ( m <= 2 );
+  int64_t era = ( y >= 0 ? y : y - 399 ) / 400;
+  int64_t yoe = y - era * 400;
+  int64_t doy = ( 153 * ( m + ( m > 2 ? -3 : 9 ) ) + 2 ) / 5 + d - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return( era * 146097 + doe - 719468 );
+}
+
+
+/**
+* Floored integer division, for negative epochs
+**/
+static int64_t floorDiv( int64_t num, int64_t den ) {
+  int64_t quot = num / den;
+  if ( ( num % den ) != 0 && ( ( num < 0 ) != ( den < 0 ) ) ) quot--;
+  return quot;
+}
+
+
 Time::Time() 
-  : timeinfo(),
-    raw_time(TIME_NOT_SET_VALUE)
+  : epoch(TIME_NOT_SET_VALUE)
 { 
-  time( &raw_time );
-  timeinfo = *( localtime( &raw_time ) );
+  epoch = (int64_t)time( NULL );
 }
 
 
 Time::Time(int d, int mth, int y, int h, int m, int s) 
-  : timeinfo(),
-    raw_time(TIME_NOT_SET_VALUE) 
+  : epoch(TIME_NOT_SET_VALUE) 
 { 
   assert( d >= 1 && d <= 31 );
   assert( mth >= 1 && mth <= 12 );
@@ -74,67 +98,92 @@ Time::Time(int d, int mth, int y, int h, int m, int s)
 //                << "; m " << m << "; s " << s
 //                << ::std::endl; 
   
-  time( &raw_time );
-  timeinfo = *( localtime( &raw_time ) );
- 
-  timeinfo.tm_mon = mth - 1;
-  timeinfo.tm_mday = d;
-  timeinfo.tm_year = y - 1900;
-  timeinfo.tm_hour = h;
-  timeinfo.tm_min = m;
-  timeinfo.tm_sec = s;
-
-  raw_time = mktime(&timeinfo);
+  struct tm fields = tm();
+  fields.tm_mon = mth - 1;
+  fields.tm_mday = d;
+  fields.tm_year = y - 1900;
+  fields.tm_hour = h;
+  fields.tm_min = m;
+  fields.tm_sec = s;
+
+  epoch = toEpoch( fields );
   
-//   ::std::cout << "Time::Time() raw_time " << raw_time << "; tm mon " << timeinfo.tm_mon
-//               << "; tm mday " << timeinfo.tm_mday << "; tm year " << timeinfo.tm_year
-//               << "; tm hour " << timeinfo.tm_hour << "; tm min " << timeinfo.tm_min
-//               << "; tm sec " << timeinfo.tm_sec << ::std::endl;
+//   ::std::cout << "Time::Time() epoch " << epoch << ::std::endl;
 }
 
 
 Time::Time(const Time& time) {
-  timeinfo = time.timeinfo;
-  raw_time = time.raw_time;
+  epoch = time.epoch;
 }
 
 
 Time::Time(struct tm* time) {
-  timeinfo = *time;
-  raw_time = mktime(&timeinfo);
+  epoch = toEpoch( *time );
 }
 
 
 Time& Time::operator=( const Time& time ) {
   if (this == &time) return *this;
-  timeinfo=time.timeinfo;
-  raw_time = time.raw_time;
+  epoch = time.epoch;
   return *this;
 }
 
 
+int64_t Time::toEpoch( const struct tm& fields ) {
+  int64_t year = fields.tm_year + 1900 + floorDiv( fields.tm_mon, 12 );
+  int month = (int)( fields.tm_mon - floorDiv( fields.tm_mon, 12 ) * 12 ) + 1;
+
+  int64_t days = daysFromCivil( year, month, 1 ) + fields.tm_mday - 1;
+
+  return( days * 86400 + (int64_t)fields.tm_hour * 3600 + (int64_t)fields.tm_min * 60 + fields.tm_sec );
+}
+
+
+struct tm Time::getTm() const {
+  struct tm fields = tm();
+
+  int64_t days = floorDiv( epoch, 86400 );
+  int64_t secs = epoch - days * 86400;
+
+  fields.tm_hour = (int)( secs / 3600 );
+  fields.tm_min = (int)( ( secs % 3600 ) / 60 );
+  fields.tm_sec = (int)( secs % 60 );
+  fields.tm_wday = (int)( ( days % 7 + 11 ) % 7 ); // 1970-01-01 was a Thursday
+
+  int64_t z = days + 719468;
+  int64_t era = ( z >= 0 ? z : z - 146096 ) / 146097;
+  int64_t doe = z - era * 146097;
+  int64_t yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+  int64_t doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+  int64_t mp = ( 5 * doy + 2 ) / 153;
+  int month = (int)( mp < 10 ? mp + 3 : mp - 9 );
+  int64_t year = yoe + era * 400 + ( month <= 2 );
+
+  fields.tm_mday = (int)( doy - ( 153 * mp + 2 ) / 5 + 1 );
+  fields.tm_mon = month - 1;
+  fields.tm_year = (int)( year - 1900 );
+  fields.tm_yday = (int)( days - daysFromCivil( year, 1, 1 ) );
+  fields.tm_isdst = 0;
+
+  return fields;
+}
+
+
 Time& woss::operator+=( Time& left, time_t right ) {
-  time_t sum_time = mktime( &left.timeinfo ) + right;
-  left.timeinfo = *( localtime( &sum_time ) );
-  left.raw_time = mktime(&(left.timeinfo));
+  left.epoch += right;
   return left;
 }
 
 
 Time& woss::operator-=( Time& left, time_t right ) {
-  time_t diff_time = mktime( &left.timeinfo ) - right;
-  left.timeinfo = *( localtime( &diff_time ) );
-  left.raw_time = mktime(&(left.timeinfo));
+  left.epoch -= right;
   return left;
 }
 
 
 double woss::operator-( const Time& left, const Time& right ) {
-  time_t time_x = mktime( &left.timeinfo );
-  time_t time_y = mktime( &right.timeinfo );
- 
-  if (time_x > time_y) return( difftime(time_x, time_y) );
-  else return( difftime( time_y, time_x) );
+  if (left.epoch > right.epoch) return( (double)( left.epoch - right.epoch ) );
+  else return( (double)( right.epoch - left.epoch ) );
 }
 
 
@@ -46,6 +46,7 @@
 #include <cassert>
 #include <cmath>
 #include <climits>
+#include <stdint.h>
 
 
 namespace woss {
@@ -87,10 +88,12 @@ namespace woss {
 
   /**
   * \brief a class for time date manipulation
-  *
   * Time class offers the possibility to store and manipulate date time.
   * A time date consists of a day, month, year, hours,
-  * minutes and seconds.
+  * minutes and seconds, always referred to UTC.
+  * The date time is stored as a 64 bit count of seconds since the UTC epoch, so that comparisons
+  * and arithmetics are plain integer operations. The calendar fields are computed on demand
+  * without calling into the libc timezone functions, hence without taking any process-wide lock.
   **/ 
   class Time {
 
@@ -105,7 +108,7 @@ namespace woss {
 
     /**
     * Time constructor
-    * @param time <b>struct tm</b> from ctime library
+    * @param time <b>struct tm</b> from ctime library, interpreted as UTC
     **/
     Time( struct tm* time );
 
@@ -138,43 +141,42 @@ namespace woss {
     * @param m month value. Should be between 1 and 12
     * @return reference to <b>*this</b>
     **/
-    Time& setMonth( int m ) { assert( m >= 1 && m <= 12 ); timeinfo.tm_mon = m - 1; raw_time = mktime(&timeinfo); 
-                              return *this; }
+    Time& setMonth( int m ) { assert( m >= 1 && m <= 12 ); struct tm fields = getTm(); fields.tm_mon = m - 1; epoch = toEpoch( fields ); return *this; }
 
     /**
     * Sets day 
     * @param d day value. Should be between 1 and 31
     * @return reference to <b>*this</b>
     **/
-    Time& setDay( int d ) { assert( d >= 1 && d <= 31 ); timeinfo.tm_mday = d; raw_time = mktime(&timeinfo); return *this; }
+    Time& setDay( int d ) { assert( d >= 1 && d <= 31 ); struct tm fields = getTm(); fields.tm_mday = d; epoch = toEpoch( fields ); return *this; }
 
     /**
     * Sets year 
     * @param y year value
     * @return reference to <b>*this</b>
     **/
-    Time& setYear( int y ) { assert( y >= 1900 ); timeinfo.tm_year = y - 1900; raw_time = mktime(&timeinfo); return *this; }
+    Time& setYear( int y ) { assert( y >= 1900 ); struct tm fields = getTm(); fields.tm_year = y - 1900; epoch = toEpoch( fields ); return *this; }
 
     /**
     * Sets hours 
     * @param m hours value. Should be between 0 and 23
     * @return reference to <b>*this</b>
     **/
-    Time& setHours( int h ) { assert( h >= 0 && h <= 23 ); timeinfo.tm_hour = h; raw_time = mktime(&timeinfo); return *this; }
+    Time& setHours( int h ) { assert( h >= 0 && h <= 23 ); struct tm fields = getTm(); fields.tm_hour = h; epoch = toEpoch( fields ); return *this; }
 
     /**
     * Sets minutes 
     * @param m minutes value. Should be between 0 and 59
     * @return reference to <b>*this</b>
     **/
-    Time& setMinutes( int m ) { assert( m >= 0 && m <= 59 ); timeinfo.tm_min = m; raw_time = mktime(&timeinfo); return *this; }
+    Time& setMinutes( int m ) { assert( m >= 0 && m <= 59 ); struct tm fields = getTm(); fields.tm_min = m; epoch = toEpoch( fields ); return *this; }
 
     /**
     * Sets seconds 
     * @param s seconds value. Should be between 0 and 59
     * @return reference to <b>*this</b>
     **/
-    Time& setSeconds( int s ) { assert( s >= 0 && s <= 59 ); timeinfo.tm_sec = s; raw_time = mktime(&timeinfo); return *this; }
+    Time& setSeconds( int s ) { assert( s >= 0 && s <= 59 ); struct tm fields = getTm(); fields.tm_sec = s; epoch = toEpoch( fields ); return *this; }
 
 
     /**
@@ -188,44 +190,57 @@ namespace woss {
     * Checks the validity of Time
     * @return <i>true</i> if it has a initialized date time, <i>false</i> otherwise
     **/
-    bool isValid() const { return ( raw_time != TIME_NOT_SET_VALUE ); }
+    bool isValid() const { return ( epoch != TIME_NOT_SET_VALUE ); }
 
 
     /**
     * Returns month value
     * @return month value between 1 and 12
     **/
-    int getMonth() const { return timeinfo.tm_mon; }
+    int getMonth() const { return getTm().tm_mon; }
 
     /**
     * Returns day value
     * @return day value between 1 and 31
     **/
-    int getDay() const { return timeinfo.tm_mday; }
+    int getDay() const { return getTm().tm_mday; }
 
     /**
     * Returns hours value
     * @return hours value between 0 and 23
     **/
-    int getHours() const { return timeinfo.tm_hour; }
+    int getHours() const { return getTm().tm_hour; }
 
     /**
     * Returns year value
     * @return year value
     **/
-    int getYear() const { return timeinfo.tm_year; }
+    int getYear() const { return getTm().tm_year; }
 
     /**
     * Returns minutes value
     * @return minutes value between 0 and 59
     **/
-    int getMinutes() const { return timeinfo.tm_min; }
+    int getMinutes() const { return getTm().tm_min; }
 
     /**
     * Returns seconds value
     * @return seconds value between 0 and 59
     **/
-    int getSeconds() const { return timeinfo.tm_sec; }
+    int getSeconds() const { return getTm().tm_sec; }
+
+
+    /**
+    * Returns the broken-down UTC date time. It is reentrant and lock-free
+    * @return <b>struct tm</b> with all fields set, <i>tm_isdst</i> included
+    **/
+    struct tm getTm() const;
+
+    /**
+    * Returns the number of seconds since the UTC epoch
+    * @return seconds since 1970-01-01 00:00:00 UTC
+    **/
+    int64_t getEpoch() const { return epoch; }
 
 
     /**
@@ -347,14 +362,18 @@ namespace woss {
 
 
     /**
-    * Struct tm from ctime library
+    * Converts the given UTC broken-down date time into seconds since the UTC epoch.
+    * Out of range fields are normalized as mktime() does
+    * @param fields const reference to a <b>struct tm</b>
+    * @return seconds since 1970-01-01 00:00:00 UTC
     **/
-    mutable struct tm timeinfo;
+    static int64_t toEpoch( const struct tm& fields );
+
 
     /**
-    * Number of seconds corresponding to date time <i>timeinfo</i>
+    * Number of seconds since 1970-01-01 00:00:00 UTC
     **/
-    time_t raw_time;
+    int64_t epoch;
     
 
     /**
@@ -397,59 +416,59 @@ namespace woss {
   //inline functions
   //////////
   inline Time::operator time_t() const {
-    return( mktime(&timeinfo) );
+    return( (time_t)epoch );
   }
   
   
   inline bool operator==( const Time& left, const Time& right ) {
-    if ( &left == &right ) return true; 
-    return( mktime(const_cast<tm*>(&left.timeinfo)) == mktime(const_cast<tm*>(&right.timeinfo)) );
+    return( left.epoch == right.epoch );
   }
 
 
   inline bool operator!=( const Time& left, const Time& right ) {
-    if ( &left == &right ) return false; 
-    return( mktime(const_cast<tm*>(&left.timeinfo)) != mktime(const_cast<tm*>(&right.timeinfo)) );
+    return( left.epoch != right.epoch );
   }
 
 
   inline bool operator>( const Time& left, const Time& right ) {
-    if ( &left == &right ) return false; 
-    return( mktime(const_cast<tm*>(&left.timeinfo)) > mktime(const_cast<tm*>(&right.timeinfo)) );
+    return( left.epoch > right.epoch );
   }
 
 
   inline bool operator<( const Time& left, const Time& right ) {
-    if ( &left == &right ) return false; 
-    return( mktime(const_cast<tm*>(&left.timeinfo)) < mktime(const_cast<tm*>(&right.timeinfo)) );
+    return( left.epoch < right.epoch );
   }
 
 
   inline bool operator<=( const Time& left, const Time& right ) {
-    return( mktime(const_cast<tm*>(&left.timeinfo)) <= mktime(const_cast<tm*>(&right.timeinfo)) );
+    return( left.epoch <= right.epoch );
   }
 
 
   inline bool operator>=( const Time& left, const Time& right ) {
-    return( mktime(const_cast<tm*>(&left.timeinfo)) >= mktime(const_cast<tm*>(&right.timeinfo)) );
+    return( left.epoch >= right.epoch );
   }
 
 
   inline std::ostream& operator<<( std::ostream& os, const Time& time ) {
-    os << asctime(const_cast<tm*>(&time.timeinfo)) ;
+    struct tm fields = time.getTm();
+    char buffer[32];
+    os << asctime_r( &fields, buffer );
     return os;
   }
 
 
   inline const Time operator+( const Time& left, const time_t right ) {
-    time_t sum_time = mktime(const_cast<tm*>(&left.timeinfo)) + right;
-    return( Time( localtime( &sum_time ) ) );
+    Time sum_time( left );
+    sum_time.epoch += right;
+    return( sum_time );
   }
 
 
   inline const Time operator-( const Time& left, const time_t right ) {
-    time_t diff_time = mktime(const_cast<tm*>(&left.timeinfo)) - right;
-    return( Time( localtime( &diff_time ) ) );
+    Time diff_time( left );
+    diff_time.epoch -= right;
+    return( diff_time );
   }
 
 
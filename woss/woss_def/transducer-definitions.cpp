@@ -138,6 +138,94 @@ double linInterp( double start_var, double end_var, double start_val, double end
 using namespace woss;
 
 
+TransducerLookupTable::TransducerLookupTable()
+: keys(),
+  values(),
+  buckets(),
+  precision( 0.0 ),
+  origin( 0.0 ),
+  step( 0.0 )
+{
+
+}
+
+
+void TransducerLookupTable::build( const ::std::map< PDouble, double >& map, long double prec, bool use_linear, double lin_costant ) {
+  clear();
+  
+  precision = prec;
+  keys.reserve( map.size() );
+  values.reserve( map.size() );
+  
+  for ( ::std::map< PDouble, double >::const_iterator it = map.begin(); it != map.end(); ++it ) {
+    keys.push_back( it->first.getValue() );
+    
+    if ( use_linear ) values.push_back( ::std::pow( 10.0, it->second / lin_costant ) );
+    else values.push_back( it->second );
+  }
+  
+  if ( keys.size() < 2 ) return;
+  
+  origin = keys.front();
+  step = keys.back() - keys.front();
+  
+  for ( int i = 1; i < (int)keys.size(); ++i ) {
+    step = ::std::min( step, keys[i] - keys[i - 1] );
+  }
+  
+  long double range = keys.back() - keys.front();
+  
+  if ( step <= 0.0 || range / step >= TRANSDUCER_LOOKUP_MAX_BUCKETS ) step = range / ( TRANSDUCER_LOOKUP_MAX_BUCKETS - 1 );
+  
+  int total_buckets = (int)( range / step ) + 1;
+  buckets.resize( total_buckets );
+  
+  int index = 0;
+  for ( int b = 0; b < total_buckets; ++b ) {
+    long double bucket_start = origin + step * b;
+    
+    while ( index < (int)keys.size() && keys[index] < bucket_start ) ++index;
+    buckets[b] = index;
+  }
+}
+
+
+void TransducerLookupTable::clear() {
+  keys.clear();
+  values.clear();
+  buckets.clear();
+  precision = 0.0;
+  origin = 0.0;
+  step = 0.0;
+}
+
+
+double TransducerLookupTable::getValue( double key ) const {
+  assert( !keys.empty() );
+  
+  int total_keys = keys.size();
+  int index = 0;
+
+  if ( !buckets.empty() ) {
+    long double bucket = ::std::floor( ( (long double)key - precision - origin ) / step );
+    
+    if ( bucket >= (long double)buckets.size() ) index = total_keys - 1;
+    else if ( bucket > 0.0 ) index = buckets[(int)bucket];
+  }
+  
+  // at most one step in either direction, as bucket width does not exceed the keys spacing
+  while ( index > 0 && !isLower( index - 1, key ) ) --index;
+  while ( index < total_keys && isLower( index, key ) ) ++index;
+  
+  if ( index == total_keys ) return values.back();
+  
+  if ( index == 0 || ::std::abs( keys[index] - (long double)key ) <= precision ) return values[index];
+  
+  return( values[index - 1] + ( values[index] - values[index - 1] ) / ( (double)keys[index] - (double)keys[index - 1] ) 
+                              * ( key - (double)keys[index - 1] ) );
+}
+
+
 bool Transducer::debug = false;
 
 
@@ -160,7 +248,10 @@ Transducer::Transducer( long double beam_prec, long double cond_prec, long doubl
   beam_power_map(),
   conductance_map(),
   tvr_map(),
-  ocv_map()
+  ocv_map(),
+  beam_table(),
+  conductance_table(),
+  tvr_table()
 {
 
 }
@@ -180,7 +271,10 @@ Transducer::Transducer( const Transducer& copy )
   beam_power_map( copy.beam_power_map ),
   conductance_map( copy.conductance_map ),
   tvr_map( copy.tvr_map ),
-  ocv_map( copy.ocv_map )
+  ocv_map( copy.ocv_map ),
+  beam_table( copy.beam_table ),
+  conductance_table( copy.conductance_table ),
+  tvr_table( copy.tvr_table )
 {
 
 }
@@ -207,6 +301,8 @@ Transducer::Transducer( BeamPowerMap& beam_map, ConductanceMap& cond_map, TVRMap
   if ( !conductance_map.empty() ) conductance_precision = conductance_map.begin()->first.getPrecision();
   if ( !tvr_map.empty() ) tvr_precision = tvr_map.begin()->first.getPrecision();
   if ( !ocv_map.empty() ) ocv_precision = ocv_map.begin()->first.getPrecision();
+
+  updateLookupTables();
 }
 
 
@@ -255,6 +351,10 @@ Transducer& Transducer::operator=( const Transducer& copy )  {
   tvr_map = copy.tvr_map;
   ocv_map = copy.ocv_map;
 
+  beam_table = copy.beam_table;
+  conductance_table = copy.conductance_table;
+  tvr_table = copy.tvr_table;
+
   return( *this );
 }
 
@@ -268,6 +368,7 @@ Transducer& Transducer::setBeamPrecision( long double prec ) {
     beam_power_temp.insert( ::std::make_pair( PDouble( it->first.getValue(), prec), it->second ) );
   }
   beam_power_map.swap(beam_power_temp);
+  beam_table.clear();
   return *this;
 }
 
@@ -294,6 +395,7 @@ Transducer& Transducer::setConductancePrecision( long double prec ) {
     conductance_temp.insert( ::std::make_pair( PDouble( it->first.getValue(), prec), it->second ) );
   }
   conductance_map.swap(conductance_temp);
+  conductance_table.clear();
   return *this;
 }
 
@@ -307,6 +409,7 @@ Transducer& Transducer::setTVRPrecision( long double prec ) {
     tvr_temp.insert( ::std::make_pair( PDouble( it->first.getValue(), prec), it->second ) );
   }
   tvr_map.swap(tvr_temp);
+  tvr_table.clear();
   return *this;
 }
 
@@ -424,11 +527,37 @@ double Transducer::getValue( double key, const ::std::map< PDouble, double >& ma
 }
 
 
+Transducer& Transducer::updateLookupTables() {
+  if ( !beam_power_map.empty() ) beam_table.build( beam_power_map, beam_precision, true, 10.0 );
+  else beam_table.clear();
+  
+  if ( !conductance_map.empty() ) conductance_table.build( conductance_map, conductance_precision );
+  else conductance_table.clear();
+  
+  if ( !tvr_map.empty() ) tvr_table.build( tvr_map, tvr_precision, true, 20.0 );
+  else tvr_table.clear();
+  
+  return *this;
+}
+
+
+double Transducer::getTVRValue( double frequency ) const {
+  if ( !tvr_table.empty() ) return tvr_table.getValue( frequency );
+  return getValue( frequency, tvr_map, tvr_precision, true, 20.0 );
+}
+
+
+double Transducer::getConductanceValue( double frequency ) const {
+  if ( !conductance_table.empty() ) return conductance_table.getValue( frequency );
+  return getValue( frequency, conductance_map, conductance_precision );
+}
+
+
 double Transducer::getSPL( double frequency, double power ) const {
   if ( power > max_power ) power = max_power;
 
-  double tvr = 20.0*log10( getValue( frequency, tvr_map, tvr_precision, true, 20.0 ) ); 
-  double g = getValue( frequency, conductance_map, conductance_precision ) * 1.0e-6; // [uS]
+  double tvr = 20.0*log10( getTVRValue( frequency ) ); 
+  double g = getConductanceValue( frequency ) * 1.0e-6; // [uS]
   double spl = 10.0*log10(power) - 10.0*log10(g) + tvr;
   
   if (debug) ::std::cout << "Transducer::getSPL() freq " << frequency << "; power " << power
@@ -439,8 +568,8 @@ double Transducer::getSPL( double frequency, double power ) const {
 
 
 double Transducer::getPowerFromSPL( double frequency, double spl ) const {  
-  double tvr = 20.0*log10( getValue( frequency, tvr_map, tvr_precision, true, 20.0 ) ); 
-  double g = getValue( frequency, conductance_map, conductance_precision ) * 1.0e-6;
+  double tvr = 20.0*log10( getTVRValue( frequency ) ); 
+  double g = getConductanceValue( frequency ) * 1.0e-6;
   
   double min_power = ::std::min( ::std::pow( 10.0, ( spl - tvr + 10.0*log10(g) ) / 10.0 ), max_power );
   
@@ -495,6 +624,8 @@ bool Transducer::import( std::istream& stream_in ) {
   
   stream_in.precision(old_precision);  
   
+  updateLookupTables();
+  
   return true;
 }
 
@@ -558,6 +689,8 @@ bool Transducer::importBinary( std::fstream& file_in ) {
   is_ok = importBinary( file_in, beam_power_map, beam_precision, true );
   assert( is_ok );
   
+  updateLookupTables();
+  
   return true;
 }
 
@@ -893,8 +1026,12 @@ bool Transducer::writeVertBeamPattern( ::std::ostream& stream_out, const CoordZ&
     
   for ( double curr_theta = 0; curr_theta <= M_PI; curr_theta += theta_step ) {
 
-    if ( has_conical_symmetry ) curr_gain = getValue( curr_theta*180.0/M_PI, beam_power_map, beam_precision, true, 10.0 );
-    else curr_gain = getValue( (M_PI/2.0 - curr_theta)*180.0/M_PI, beam_power_map, beam_precision, true, 10.0 );
+    double curr_angle;
+    if ( has_conical_symmetry ) curr_angle = curr_theta*180.0/M_PI;
+    else curr_angle = (M_PI/2.0 - curr_theta)*180.0/M_PI;
+
+    if ( !beam_table.empty() ) curr_gain = beam_table.getValue( curr_angle );
+    else curr_gain = getValue( curr_angle, beam_power_map, beam_precision, true, 10.0 );
 
     for ( double curr_phi = -M_PI; curr_phi <= M_PI; curr_phi += phi_step ) {
       
@@ -44,6 +44,7 @@
 #include <iostream>
 #include <complex>
 #include <map>
+#include <vector>
 #include <cmath>
 #include <cassert>
 #include "custom-precision-double.h"
@@ -60,6 +61,100 @@ namespace woss {
   #define TVR_CUSTOM_FREQUENCY_PRECISION (1.0)
   #define OCV_CUSTOM_FREQUENCY_PRECISION (1.0)
   #define TRANSDUCER_NOT_SET (-1000)
+  #define TRANSDUCER_LOOKUP_MAX_BUCKETS (1048576)
+
+
+  /**
+  * \brief Flat lookup table of a Transducer map
+  *
+  * woss::TransducerLookupTable is the compiled form of one of the woss::Transducer maps. Keys and values are
+  * stored in dense arrays, values already converted to the linear domain if requested. A uniform-step bucket
+  * array maps a key to its interpolation interval, so a lookup costs O(1) instead of a map lower bound and
+  * returns the same value as Transducer::getValue()
+  **/
+  class TransducerLookupTable {
+
+
+    public:
+
+
+    TransducerLookupTable();
+
+
+    /**
+    * Compiles the given map
+    * @param map one of the transducer's map
+    * @param precision map PDouble keys precision
+    * @param use_linear if <i>true</i> values are stored as 10^(value/costant)
+    * @param costant decibel costant of the linear conversion
+    **/
+    void build( const ::std::map< PDouble, double >& map, long double precision, bool use_linear = false, double costant = 20.0 );
+
+    /**
+    * Drops the compiled values
+    **/
+    void clear();
+
+    /**
+    * Checks if the table has been compiled
+    * @return <i>true</i> if no values are stored, <i>false</i> otherwise
+    **/
+    bool empty() const { return keys.empty(); }
+
+    /**
+    * Returns the value linearly interpolated at given key
+    * @param key key value
+    * @return value in the domain chosen by build()
+    **/
+    double getValue( double key ) const;
+
+
+    protected:
+
+
+    /**
+    * Sorted map keys
+    **/
+    ::std::vector< long double > keys;
+
+    /**
+    * Values of the keys, in the linear domain if so requested
+    **/
+    ::std::vector< double > values;
+
+    /**
+    * For each bucket, the index of the first key not lower than the bucket start
+    **/
+    ::std::vector< int > buckets;
+
+    /**
+    * Keys precision
+    **/
+    long double precision;
+
+    /**
+    * Key of the first bucket
+    **/
+    long double origin;
+
+    /**
+    * Bucket width
+    **/
+    long double step;
+
+
+    /**
+    * Checks if given key index is lower than key, as map::lower_bound() would with PDouble keys
+    * @param index key index
+    * @param key key value
+    * @return <i>true</i> if keys[index] is lower than <i>key</i>
+    **/
+    bool isLower( int index, long double key ) const { 
+      return( ::std::abs( keys[index] - key ) > precision && keys[index] < key );
+    }
+
+  };
+
 
   
   /**
@@ -638,6 +733,15 @@ namespace woss {
     Transducer& clearAll();
     
     
+    /**
+    * Compiles the TVR, conductance and beam pattern maps into flat lookup tables, used by getSPL(), 
+    * getPowerFromSPL() and writeVertBeamPattern(). It is called by the import methods; any later map change 
+    * drops the affected table and lookups fall back to the map until this method is called again
+    * @return reference to <b>*this</b>
+    **/
+    Transducer& updateLookupTables();
+
+
     /**
     * Imports values in from the given stream
     * @param stream_in const reference to an istream instance
@@ -923,6 +1027,21 @@ namespace woss {
     * OCV map
     **/     
     OCVMap ocv_map;
+
+    /**
+    * compiled beam pattern map, linear power gains
+    **/
+    TransducerLookupTable beam_table;
+
+    /**
+    * compiled conductance map
+    **/
+    TransducerLookupTable conductance_table;
+
+    /**
+    * compiled TVR map, linear values
+    **/
+    TransducerLookupTable tvr_table;
           
   
     /**
@@ -941,6 +1060,20 @@ namespace woss {
     * @return value found
     **/        
     virtual double getValue( double frequency, const ::std::map< PDouble, double >& map, long double precision, bool use_linear = false, double costant = 20.0 ) const;
+
+    /**
+    * Returns the linear TVR at given frequency, through the lookup table if compiled
+    * @param frequency frequency [hz]
+    * @return linear TVR value
+    **/
+    double getTVRValue( double frequency ) const;
+
+    /**
+    * Returns the conductance at given frequency, through the lookup table if compiled
+    * @param frequency frequency [hz]
+    * @return conductance [uS]
+    **/
+    double getConductanceValue( double frequency ) const;
     
     
     /**
@@ -1079,29 +1212,34 @@ namespace woss {
 
   
   inline Transducer& Transducer::beampattern_rotate( double angle ) {
+    beam_table.clear();
     beampattern_rotate( angle, beam_power_map );
     return *this;
   }
   
   
   inline Transducer& Transducer::beampattern_sum( double value ) { 
+    beam_table.clear();
     beampattern_sum( value, beam_power_map );
     return *this;    
   }
 
 
   inline Transducer& Transducer::beampattern_multiply( double value ) {
+    beam_table.clear();
     beampattern_multiply( value, beam_power_map );
     return *this;  
   }
 
   
   inline bool Transducer::beampattern_insert( double angle, double power ) { 
+    beam_table.clear();
     return beam_power_map.insert( ::std::make_pair( PDouble( normalizeAngle(angle), beam_precision), power ) ).second;
   }
  
  
   inline Transducer& Transducer::beampattern_replace( double angle, double power ) { 
+    beam_table.clear();
     normalizeAngle(angle);
     beam_power_map[PDouble(angle, beam_precision)] = power;
     return *this;
@@ -1114,6 +1252,7 @@ namespace woss {
   
 
   inline Transducer& Transducer::beampattern_erase( double angle ) { 
+    beam_table.clear();
     beam_power_map.erase(angle);
     return *this;
   }
@@ -1129,6 +1268,7 @@ namespace woss {
   
 
   inline Transducer& Transducer::beampattern_clear() { 
+    beam_table.clear();
     beam_power_map.clear();
     return *this;
   }
@@ -1166,23 +1306,27 @@ namespace woss {
   
 
   inline bool Transducer::conductance_insert( double frequency, double conductance ) { 
+    conductance_table.clear();
     return conductance_map.insert( ::std::make_pair( PDouble( frequency, conductance_precision ), conductance ) ).second;
   }
   
   
   inline bool Transducer::conductance_insert( double frequency, const ::std::complex< double >& impedance ) { 
+    conductance_table.clear();
     return conductance_map.insert( ::std::make_pair( PDouble( frequency, conductance_precision ), impedance.real() 
                                                                / ( ::std::pow( ::std::abs(impedance), 2.0 ) ) ) ).second;
   }  
  
  
   inline Transducer& Transducer::conductance_replace( double frequency, double conductance ) { 
+    conductance_table.clear();
     conductance_map[PDouble(frequency, conductance_precision)] = conductance;
     return *this;
   }
   
   
   inline Transducer& Transducer::conductance_replace( double frequency, const ::std::complex< double >& impedance ) { 
+    conductance_table.clear();
     conductance_map[PDouble(frequency, conductance_precision)] = impedance.real() 
                                                                / ( ::std::pow( ::std::abs(impedance), 2.0 ) ) ;
     return *this;
@@ -1195,6 +1339,7 @@ namespace woss {
   
 
   inline Transducer& Transducer::conductance_erase( double frequency ) { 
+    conductance_table.clear();
     conductance_map.erase(frequency);
     return *this;
   }
@@ -1210,6 +1355,7 @@ namespace woss {
   
 
   inline Transducer& Transducer::conductance_clear() { 
+    conductance_table.clear();
     conductance_map.clear();
     return *this;
   }
@@ -1248,11 +1394,13 @@ namespace woss {
 
 
   inline bool Transducer::tvr_insert( double frequency, double tvr ) { 
+    tvr_table.clear();
     return tvr_map.insert( ::std::make_pair( PDouble( frequency, tvr_precision ), tvr ) ).second;
   }
  
  
   inline Transducer& Transducer::tvr_replace( double frequency, double tvr ) { 
+    tvr_table.clear();
     tvr_map[PDouble(frequency, tvr_precision)] = tvr;
     return *this;
   }
@@ -1264,6 +1412,7 @@ namespace woss {
   
 
   inline Transducer& Transducer::tvr_erase( double frequency ) { 
+    tvr_table.clear();
     tvr_map.erase(frequency);
     return *this;
   }
@@ -1279,6 +1428,7 @@ namespace woss {
   
 
   inline Transducer& Transducer::tvr_clear() { 
+    tvr_table.clear();
     tvr_map.clear();
     return *this;
   }
@@ -1387,6 +1537,9 @@ namespace woss {
     ocv_map.clear();
     tvr_map.clear();
     conductance_map.clear();
+    beam_table.clear();
+    tvr_table.clear();
+    conductance_table.clear();
     return *this;
   }
   
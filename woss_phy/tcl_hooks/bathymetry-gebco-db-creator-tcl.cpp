@@ -61,9 +61,15 @@ BathyGebcoDbCreatorTcl::BathyGebcoDbCreatorTcl()
 {
   bind("debug", &debug_);
   bind("woss_db_debug", &woss_db_debug_);
+  bind("tile_size", &tile_size_);
+  bind("tile_cache_budget", &tile_cache_budget_);
+  bind("bilinear_interpolation", &bilinear_interpolation_);
   
   debug = (bool) debug_;
   woss_db_debug = (bool) woss_db_debug_;
+  tile_size = (int) tile_size_;
+  tile_cache_budget = tile_cache_budget_;
+  bilinear_interpolation = (bool) bilinear_interpolation_;
 }
 
 
@@ -78,6 +78,9 @@ namespace woss {
     *     notifies the database that the GEBCO version with thirty seconds of arc precision is in use 
     * </ul>
     * 
+    * GEBCO 2D tile cache is configured through the bound variables <b>tile_size</b> [cells], 
+    * <b>tile_cache_budget</b> [MB] and <b>bilinear_interpolation</b>
+    * 
     * Moreover it inherits all the OTcl method of WossDbCreator
     * 
     * 
@@ -97,6 +100,12 @@ namespace woss {
     
     double woss_db_debug_;
     
+    double tile_size_;
+    
+    double tile_cache_budget_;
+    
+    double bilinear_interpolation_;
+    
   };
 
 }
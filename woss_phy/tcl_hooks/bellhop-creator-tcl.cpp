@@ -83,12 +83,17 @@ BellhopCreatorTcl::BellhopCreatorTcl()
   bind( "total_runs", &cctotal_runs.accessAllLocations());
   bind( "bellhop_arr_syntax", &bellhop_arr_syntax_);
   bind( "bellhop_shd_syntax", &bellhop_shd_syntax_); 
+  bind( "concurrent_runs", &concurrent_runs);
+  bind( "shd_mmap_read", &shd_mmap_read_);
+  bind( "fan_depth_step", &fan_depth_step);
+  bind( "fan_range_step", &fan_range_step);
   
   if ( ccfrequency_step.accessAllLocations() <= 0.0 ) ccfrequency_step.accessAllLocations() = WOSS_CREATOR_MAX_FREQ_STEP;
   
   woss_debug = (bool) woss_debug_;
   debug = (bool) debug_;
   woss_clean_workdir = (bool) woss_clean_workdir_;
+  shd_mmap_read = (bool) shd_mmap_read_;
   bellhop_arr_syntax = (BellhopArrSyntax) bellhop_arr_syntax_;
   bellhop_shd_syntax = (BellhopShdSyntax) bellhop_shd_syntax_;
   updateDebugFlag();  
@@ -529,6 +534,43 @@ int BellhopCreatorTcl::command( int argc, const char*const* argv ) {
       
       if (debug) ::std::cout << "BellhopCreatorTcl::command() setBellhopPath called, path = " << argv[2] << ::std::endl;
 
+      return TCL_OK;
+    }
+    else if(strcasecmp(argv[1], "usePipeSolver") == 0) { 
+
+      setBellhopSolver(new BellhopPipeSolver(argv[2]));
+      
+      if (debug) ::std::cout << "BellhopCreatorTcl::command() usePipeSolver called, command = " << argv[2] << ::std::endl;
+
+      return TCL_OK;
+    }
+    else if(strcasecmp(argv[1], "useReplaySolver") == 0) { 
+
+      setBellhopSolver(new BellhopReplaySolver(argv[2]));
+      
+      if (debug) ::std::cout << "BellhopCreatorTcl::command() useReplaySolver called, path = " << argv[2] << ::std::endl;
+
+      return TCL_OK;
+    }
+    else if(strcasecmp(argv[1], "useCacheSolver") == 0) { 
+
+      // the current solver is handed over to the cache
+      BellhopSolver* curr_solver = bellhop_solver;
+      bellhop_solver = NULL;
+      setBellhopSolver(new BellhopCacheSolver(argv[2], curr_solver));
+      
+      if (debug) ::std::cout << "BellhopCreatorTcl::command() useCacheSolver called, path = " << argv[2] << ::std::endl;
+
+      return TCL_OK;
+    }
+  }
+  else if ( argc == 2 ) {
+    if(strcasecmp(argv[1], "useSystemSolver") == 0) { 
+
+      setBellhopSolver(NULL);
+      
+      if (debug) ::std::cout << "BellhopCreatorTcl::command() useSystemSolver called" << ::std::endl;
+
       return TCL_OK;
     }
   }
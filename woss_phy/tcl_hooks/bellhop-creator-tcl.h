@@ -101,6 +101,14 @@ namespace woss {
     *     sets the Bellhop altimetry type (L, C) for given tx and rx woss::Location. See Bellhop documentation for more info
     *  <li><b>setBellhopPath &lt;<i>bellhop program filesystem path</i>&gt; </b>: 
     *     sets the path of Bellhop program
+    *  <li><b>usePipeSolver &lt;<i>solver process shell command</i>&gt; </b>: 
+    *     runs Bellhop through a persistent solver process. See woss::BellhopPipeSolver for the protocol
+    *  <li><b>useReplaySolver &lt;<i>recorded results directory</i>&gt; </b>: 
+    *     replays recorded .arr/.shd files instead of running Bellhop. See woss::BellhopReplaySolver for the directory layout
+    *  <li><b>useCacheSolver &lt;<i>cache directory</i>&gt; </b>: 
+    *     wraps the current solver, reusing the results of identical environments stored in the cache directory. See woss::BellhopCacheSolver
+    *  <li><b>useSystemSolver</b>: 
+    *     runs Bellhop program through the shell (default)
     *  <li><b>setRangeSteps &lt;<i>tx woss::Location*</i>&gt; &lt;<i>rx woss::Location*</i>&gt; &lt;<i> total range steps </i>&gt; </b>: 
     *     sets the total number of range steps to be used in every Bellhop run, for given tx and rx woss::Location;
     *  <li><b>setTotalTransmitters &lt;<i>tx woss::Location*</i>&gt; &lt;<i>rx woss::Location*</i>&gt; &lt;<i> total transmitting sources </i>&gt; </b>: 
@@ -164,6 +172,8 @@ namespace woss {
     
     double woss_clean_workdir_;
     
+    double shd_mmap_read_;
+    
     int bellhop_arr_syntax_;
 
     int bellhop_shd_syntax_;
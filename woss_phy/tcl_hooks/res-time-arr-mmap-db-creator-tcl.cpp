@@ -0,0 +1,103 @@
+/* WOSS - World Ocean Simulation System -
+ * 
+ * Copyright (C) 2009 Federico Guerra
+ * and regents of the SIGNET lab, University of Padova
+ *
+ * Author: Federico Guerra - federico@guerra-tlc.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */ 
+
+/*
+ * This software has been developed by Federico Guerra and SIGNET lab,
+ * University of Padova, in collaboration with the NATO Centre for 
+ * Maritime Research and Experimentation (http://www.cmre.nato.int ; 
+ * E-mail: pao@cmre.nato.int), whose support is gratefully acknowledged.
+ */
+
+
+/**
+ * @file   res-time-arr-mmap-db-creator-tcl.cpp
+ * @author Federico Guerra
+ * 
+ * \brief Provides the implementation of ResTimeArrMmapDbCreatorTcl class
+ *
+ * Provides the implementation of the ResTimeArrMmapDbCreatorTcl class
+ */
+
+
+#ifdef WOSS_NS_MIRACLE_SUPPORT
+
+
+#include <iostream>
+#include "res-time-arr-mmap-db-creator-tcl.h"
+
+
+using namespace woss;
+
+
+static class ResTimeArrMmapDbCreatorClass : public TclClass {
+public:
+  ResTimeArrMmapDbCreatorClass() : TclClass("WOSS/Creator/Database/Mmap/Results/TimeArr") {}
+  TclObject* create(int, const char*const*) {
+    return( new ResTimeArrMmapDbCreatorTcl() );
+  }
+} class_ResTimeArrMmapDbCreator;
+
+
+ResTimeArrMmapDbCreatorTcl::ResTimeArrMmapDbCreatorTcl()
+: ResTimeArrMmapDbCreator()
+{
+  bind("space_sampling",&space_sampling);
+  bind("compaction_threshold", &compaction_threshold);
+  bind("debug", &debug_);
+  bind("woss_db_debug", &woss_db_debug_);
+  
+  debug = (bool) debug_;
+  woss_db_debug = (bool) woss_db_debug_;
+}
+
+int ResTimeArrMmapDbCreatorTcl::command(int argc, const char*const* argv) {
+  if ( argc == 3 ) {
+    if(strcasecmp(argv[1], "setDbPathName") == 0) {
+      
+      if (debug) ::std::cout << "ResTimeArrMmapDbCreatorTcl::command() setDbPathName " << argv[2] << " called"  << ::std::endl;
+
+      pathname = argv[2];
+      
+      return TCL_OK;
+    }
+    else if(strcasecmp(argv[1], "importBinaryDb") == 0) {
+      
+      if (debug) ::std::cout << "ResTimeArrMmapDbCreatorTcl::command() importBinaryDb " << argv[2] << " called"  << ::std::endl;
+
+      setImportPathName(argv[2], true);
+      
+      return TCL_OK;
+    }
+    else if(strcasecmp(argv[1], "importTextualDb") == 0) {
+      
+      if (debug) ::std::cout << "ResTimeArrMmapDbCreatorTcl::command() importTextualDb " << argv[2] << " called"  << ::std::endl;
+
+      setImportPathName(argv[2], false);
+      
+      return TCL_OK;
+    }
+  }
+  return( TclObject::command(argc,argv) );
+}
+
+
+#endif // WOSS_NS_MIRACLE_SUPPORT
+
@@ -40,6 +40,7 @@
 #ifdef WOSS_NS_MIRACLE_SUPPORT
 
 #include <iostream>
+#include <cstdlib>
 #include "ssp-woa2005-db-creator-tcl.h"
 
 #ifdef WOSS_NETCDF_SUPPORT
@@ -82,9 +83,11 @@ SspWoa2005DbCreatorTcl::SspWoa2005DbCreatorTcl()
 {
   bind("debug", &debug_);
   bind("woss_db_debug", &woss_db_debug_);
+  bind("bilinear_interpolation", &bilinear_interpolation_);
   
   debug = (bool) debug_;
   woss_db_debug = (bool) woss_db_debug_;
+  bilinear_interpolation = (bool) bilinear_interpolation_;
 }
 
 
@@ -94,9 +97,11 @@ SspWoa2005DbCreatorTcl::SspWoa2005DbCreatorTcl( WOADbType db_type )
 {
   bind("debug", &debug_);
   bind("woss_db_debug", &woss_db_debug_);
+  bind("bilinear_interpolation", &bilinear_interpolation_);
 
   debug = (bool) debug_;
   woss_db_debug = (bool) woss_db_debug_;
+  bilinear_interpolation = (bool) bilinear_interpolation_;
 }
 #endif // defined (WOSS_NETCDF4_SUPPORT)
 
@@ -111,6 +116,34 @@ int SspWoa2005DbCreatorTcl::command(int argc, const char*const* argv) {
       return TCL_OK;
     }
   }
+  else if ( argc == 4 ) {
+    if(strcasecmp(argv[1], "setMonthlyDbPathName") == 0) {
+      int month = atoi(argv[2]);
+
+      if (debug) ::std::cout << "SspWoa2005DbCreatorTcl::command() setMonthlyDbPathName month = " << month 
+                             << "; pathname = " << argv[3] << " called"  << ::std::endl;
+
+      if ( month < 1 || month > SSP_WOA_TOTAL_MONTHS ) {
+        ::std::cerr << "SspWoa2005DbCreatorTcl::command() setMonthlyDbPathName invalid month = " << month << ::std::endl;
+        return TCL_ERROR;
+      }
+
+      monthly_pathnames[month] = argv[3];
+
+      return TCL_OK;
+    }
+  }
+  else if ( argc == 6 ) {
+    if(strcasecmp(argv[1], "setPreloadRegion") == 0) {
+      preload_south_west = Coord( atof(argv[2]), atof(argv[3]) );
+      preload_north_east = Coord( atof(argv[4]), atof(argv[5]) );
+
+      if (debug) ::std::cout << "SspWoa2005DbCreatorTcl::command() setPreloadRegion south west = " << preload_south_west 
+                             << "; north east = " << preload_north_east << " called"  << ::std::endl;
+
+      return TCL_OK;
+    }
+  }
   return( TclObject::command(argc,argv) );
 }
 
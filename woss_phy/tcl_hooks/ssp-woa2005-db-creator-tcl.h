@@ -86,8 +86,15 @@ namespace woss {
     * <ul>
     *  <li><b>setDbPathName &lt;<i>pathname or path identifier</i>&gt;</b>: 
     *     sets the pathname or path identifier. Instantiated WossDb objects will have this pathname
+    *  <li><b>setPreloadRegion &lt;<i>south latitude [dec degree]</i>&gt; &lt;<i>west longitude [dec degree]</i>&gt; 
+    *                          &lt;<i>north latitude [dec degree]</i>&gt; &lt;<i>east longitude [dec degree]</i>&gt;</b>: 
+    *     sets the region that will be preloaded at connection time
+    *  <li><b>setMonthlyDbPathName &lt;<i>month [1-12]</i>&gt; &lt;<i>pathname</i>&gt;</b>: 
+    *     sets the monthly average database that will be preloaded for the given month, used for time interpolation
     * </ul>
     * 
+    * Bilinear interpolation of preloaded SSPs is enabled through the bound variable <b>bilinear_interpolation</b>
+    * 
     * Moreover it inherits all the OTcl method of TclObject
     * 
     * 
@@ -107,6 +114,8 @@ namespace woss {
     
     double woss_db_debug_;
     
+    double bilinear_interpolation_;
+    
     
   };
 
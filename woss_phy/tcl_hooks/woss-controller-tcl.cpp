@@ -41,12 +41,14 @@
 
 
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 #include <woss-creator.h>
 #include <woss-manager.h>
 #include <woss-db-creator.h>
 #include <woss-db-manager.h>
 #include <transducer-handler.h>
+#include <woss-metrics.h>
 #include "woss-controller-tcl.h"
 
 
@@ -73,8 +75,30 @@ WossControllerTcl::WossControllerTcl()
 int WossControllerTcl::command( int argc, const char*const* argv ) {
   Tcl& tcl = Tcl::instance();
 
-  if ( argc == 3) {
-    if(strcasecmp(argv[1], "setBathymetryDbCreator") == 0) {
+  if ( argc == 4) {
+    if(strcasecmp(argv[1], "writeMetrics") == 0) {
+      
+      if (debug) ::std::cout << "WossControllerTcl::command() writeMetrics called, file = " << argv[2] 
+                             << "; format = " << argv[3] << ::std::endl;
+      
+      bool is_ok = false;
+      
+      if ( strcasecmp(argv[3], "csv") == 0 ) is_ok = woss::WossMetrics::writeCsv( argv[2] );
+      else if ( strcasecmp(argv[3], "json") == 0 ) is_ok = woss::WossMetrics::writeJson( argv[2] );
+      
+      if ( is_ok ) return TCL_OK;
+      else return TCL_ERROR;
+    }
+  }
+  else if ( argc == 3) {
+    if(strcasecmp(argv[1], "setMetricsEnabled") == 0) {
+      
+      if (debug) ::std::cout << "WossControllerTcl::command() setMetricsEnabled called, value = " << argv[2] << ::std::endl;
+      
+      woss::WossMetrics::setEnabled( atoi(argv[2]) != 0 );
+      return TCL_OK;
+    }
+    else if(strcasecmp(argv[1], "setBathymetryDbCreator") == 0) {
       
       if (debug) ::std::cout << "WossControllerTcl::command() setBathymetryDbCreator called"  << ::std::endl;
 
@@ -208,6 +232,13 @@ int WossControllerTcl::command( int argc, const char*const* argv ) {
       assert( woss::SWossController::instance()->initialize() );
       return TCL_OK;
     }
+    else if(strcasecmp(argv[1], "resetMetrics") == 0) {
+      
+      if (debug) ::std::cout << "WossControllerTcl::command() resetMetrics called"  << ::std::endl;
+      
+      woss::WossMetrics::reset();
+      return TCL_OK;
+    }
   }
   return TclObject::command(argc, argv);
 }
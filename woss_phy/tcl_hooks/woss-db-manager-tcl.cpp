@@ -41,6 +41,9 @@
 
 
 #include <singleton-definitions.h>
+#ifdef WOSS_NETCDF_SUPPORT
+#include <bathymetry-gebco-db.h>
+#endif // WOSS_NETCDF_SUPPORT
 #include "woss-db-manager-tcl.h"
 
 
@@ -206,6 +209,43 @@ int WossDbManagerTcl::command( int argc, const char*const* argv ) {
       if (done) return TCL_OK;
       else return TCL_ERROR;
     }
+    else if(strcasecmp(argv[1], "getBathymetryCacheStats") == 0) {
+#ifdef WOSS_NETCDF_SUPPORT
+      BathyGebcoDb* gebco_db = dynamic_cast< BathyGebcoDb* >( bathymetry_db );
+
+      if ( gebco_db == NULL ) {
+        ::std::cerr << "WossDbManagerTcl::command() getBathymetryCacheStats, bathymetry db is not a GEBCO db" << ::std::endl;
+        return TCL_ERROR;
+      }
+
+      if (debug) ::std::cout << "WossDbManagerTcl::command() getBathymetryCacheStats called, hits = " << gebco_db->getCacheHits() 
+                             << "; misses = " << gebco_db->getCacheMisses() << "; tiles = " << gebco_db->getTotalCachedTiles() << ::std::endl;
+
+      tcl.resultf("%lu %lu %d", gebco_db->getCacheHits(), gebco_db->getCacheMisses(), gebco_db->getTotalCachedTiles());
+      return TCL_OK;
+#else
+      ::std::cerr << "WossDbManagerTcl::command() getBathymetryCacheStats, NETCDF support was not enabled!" << ::std::endl;
+      return TCL_ERROR;
+#endif // WOSS_NETCDF_SUPPORT
+    }
+    else if(strcasecmp(argv[1], "resetBathymetryCacheStats") == 0) {
+#ifdef WOSS_NETCDF_SUPPORT
+      BathyGebcoDb* gebco_db = dynamic_cast< BathyGebcoDb* >( bathymetry_db );
+
+      if ( gebco_db == NULL ) {
+        ::std::cerr << "WossDbManagerTcl::command() resetBathymetryCacheStats, bathymetry db is not a GEBCO db" << ::std::endl;
+        return TCL_ERROR;
+      }
+
+      if (debug) ::std::cout << "WossDbManagerTcl::command() resetBathymetryCacheStats called" << ::std::endl;
+
+      gebco_db->resetCacheStats();
+      return TCL_OK;
+#else
+      ::std::cerr << "WossDbManagerTcl::command() resetBathymetryCacheStats, NETCDF support was not enabled!" << ::std::endl;
+      return TCL_ERROR;
+#endif // WOSS_NETCDF_SUPPORT
+    }
   }
   if(strcasecmp(argv[1], "setCustomBathymetry") == 0) { // setCustomBathymetry lat long bearing total_ranges range bathy_value ...
 
@@ -106,6 +106,10 @@ namespace woss {
     *     is equal to 0, then next token is interpreted as path to a CustomBathymetry file to be imported; @see importCustomBathymetry
     *  <li><b>closeAllConnections &lt; &gt;</b>: 
     *     closes all database connections
+    *  <li><b>getBathymetryCacheStats &lt; &gt;</b>: 
+    *     returns the GEBCO tile cache hits, misses and cached tiles as a list
+    *  <li><b>resetBathymetryCacheStats &lt; &gt;</b>: 
+    *     resets the GEBCO tile cache hits and misses counters
     * </ul>
     * @note an invalid bearing (e.g. bearing < -360.0 or > 360.0 ) will be interpreted as a special value to represent 
     * <b>all bearings</b>. An invalid range (e.g. range < 0.0 ) will be interpreted as a special case value to represent
@@ -96,6 +96,8 @@ namespace woss {
     double debug_;
     
     double is_time_evolution_active_;
+    
+    double is_snapshot_interpolation_active_;
   };
 
   template< typename WMResDb >
@@ -105,9 +107,17 @@ namespace woss {
     TclObject::bind("debug", &this->debug_);
     TclObject::bind("is_time_evolution_active", &this->is_time_evolution_active_);
     TclObject::bind("space_sampling",&this->space_sampling );
+    TclObject::bind("receiver_fan_sector",&this->fan_sector );
+    TclObject::bind("receiver_fan_min_size",&this->fan_min_size );
+    TclObject::bind("tx_stack_min_size",&this->stack_min_size );
+    TclObject::bind("is_snapshot_interpolation_active", &this->is_snapshot_interpolation_active_);
+    TclObject::bind("snapshot_error_bound", &this->snapshot_error_bound );
+    TclObject::bind("snapshot_delay_tolerance", &this->snapshot_delay_tolerance );
+    TclObject::bind("snapshot_delay_error_bound", &this->snapshot_delay_error_bound );
 
     this->debug = (bool) this->debug_;
     this->is_time_evolution_active = (bool) this->is_time_evolution_active_;
+    this->is_snapshot_interpolation_active = (this->is_snapshot_interpolation_active_ > 0.0);
   }
 
   template< typename WMResDb > 
@@ -135,6 +145,14 @@ namespace woss {
         if ( this->reset() ) return TCL_OK;
         else return TCL_ERROR;
       }
+      else if(strcasecmp(argv[1], "flushDbInserts") == 0) {
+
+        if (this->debug) ::std::cout << "WossManagerSimpleTcl::command() flushDbInserts called"  << ::std::endl;
+
+        this->flushDbInserts();
+
+        return TCL_OK;
+      }
     }
     else if (argc==3) {
       if(strcasecmp(argv[1], "setConcurrentThreads") == 0) {
@@ -145,6 +163,26 @@ namespace woss {
 
         this->setConcurrentThreads(threads);
 
+        return TCL_OK;
+      }
+      else if(strcasecmp(argv[1], "setResultCacheSize") == 0) {
+        int size = atoi(argv[2]);
+
+        if (this->debug) ::std::cout << "WossManagerSimpleTcl::command() setResultCacheSize " 
+                                     << size << " called"  << ::std::endl;
+
+        this->setResultCacheSize(size);
+
+        return TCL_OK;
+      }
+      else if(strcasecmp(argv[1], "setDbInsertBatchSize") == 0) {
+        int size = atoi(argv[2]);
+
+        if (this->debug) ::std::cout << "WossManagerSimpleTcl::command() setDbInsertBatchSize " 
+                                     << size << " called"  << ::std::endl;
+
+        this->setDbInsertBatchSize(size);
+
         return TCL_OK;
       }
     }
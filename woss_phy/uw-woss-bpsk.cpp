@@ -47,7 +47,9 @@
 #include <woss-controller.h>
 #include "uw-woss-clmsg-channel-estimation.h"
 #include "uw-woss-channel-estimator.h"
+#include "uw-woss-pkt-hdr.h"
 #include "uw-woss-bpsk.h"
+#include "uw-woss-channel.h"
 #include <phymac-clmsg.h> 
 
 
@@ -78,7 +80,27 @@ UwMPhyBpskTransducer::UwMPhyBpskTransducer()
 
 
 int UwMPhyBpskTransducer::command(int argc, const char*const* argv) {
-  if( argc == 5 ) {
+  if( argc == 2 ) {
+    if(strcasecmp(argv[1], "useTapLists") == 0) {
+      bool is_registered = false;
+      
+      for ( int i = 0; i < getDownLaySAPnum(); i++ ) {
+        ChSAP* chsap = dynamic_cast< ChSAP* >( getDownLaySAP(i) );
+        
+        if ( chsap == NULL ) continue;
+        
+        WossChannelModule::addTapListReceiver( chsap );
+        is_registered = true;
+      }
+      
+      if ( !is_registered ) {
+        ::std::cerr << "UwMPhyBpskTransducer::command() useTapLists ERROR, PHY is not connected to a channel" << ::std::endl;
+        return TCL_ERROR;
+      }
+      return TCL_OK;
+    }
+  }
+  else if( argc == 5 ) {
     if(strcasecmp(argv[1], "setTransducerType") == 0) {
        
       if (debug_) ::std::cout << NOW << "  UwMPhyBpskTransducer::command() setTransducerType called, low freq " << argv[2]
@@ -94,6 +116,47 @@ int UwMPhyBpskTransducer::command(int argc, const char*const* argv) {
 }
 
 
+void UwMPhyBpskTransducer::recv( Packet* p ) {
+  hdr_cmn* ch = HDR_CMN(p);
+  hdr_woss* hdr_woss = HDR_WOSS(p);
+  
+  if ( ch->direction() == hdr_cmn::UP && hdr_woss->already_processed && hdr_woss->total_taps > 1 ) addTapInterference( p );
+  
+  UnderwaterMPhyBpsk::recv(p);
+}
+
+
+void UwMPhyBpskTransducer::addTapInterference( Packet* p ) {
+  if ( interference_ == NULL ) return;
+  
+  hdr_woss* hdr_woss = HDR_WOSS(p);
+  
+  if ( hdr_woss->tap_power <= 0.0 ) return;
+  
+  Packet* p_interf = p->copy();
+  hdr_MPhy* ph = HDR_MPHY(p_interf);
+  hdr_woss* interf_woss = HDR_WOSS(p_interf);
+  
+  ph->duration += interf_woss->tap_spread;
+  interf_woss->attenuation = ::std::sqrt( interf_woss->tap_power );
+  interf_woss->total_taps = 0;
+  interf_woss->tap_power = 0.0;
+  interf_woss->tap_spread = 0.0;
+  
+  ph->dstSpectralMask = getRxSpectralMask(p_interf);
+  ph->dstPosition = getPosition();
+  ph->dstAntenna = getRxAntenna(p_interf);
+  ph->Pr = getRxPower(p_interf);
+  
+  if (debug_) cout << NOW << "  UwMPhyBpskTransducer::addTapInterference() taps = " << hdr_woss->total_taps 
+                   << "; interference power = " << ph->Pr << "; duration = " << ph->duration << endl;
+  
+  interference_->addToInterference(p_interf);
+  
+  Packet::free(p_interf);
+}
+
+
 
 const woss::Transducer* const UwMPhyBpskTransducer::getTransducer( double frequency ) const
 {
@@ -71,15 +71,37 @@ class UwMPhyBpskTransducer :  public UnderwaterMPhyBpsk {
   virtual ~UwMPhyBpskTransducer() { }
   
   
+  /**
+  * TCL commands: <i>setTransducerType low_freq high_freq type</i>; <i>useTapLists</i>, to be called 
+  * after the PHY has been connected to a WossChannelModule, registers its ChSAP 
+  * with WossChannelModule::addTapListReceiver() so that tap lists are delivered to it
+  */
   virtual int command( int argc, const char*const* argv );
 
   
+  /**
+  * Adds the taps of a tap list Packet delivered by WossChannelModule to the interference before the usual MPhy processing
+  *
+  * @param p pointer to the current Packet being processed
+  */
+  virtual void recv( Packet* p );
+  
+  
   protected:
 
  
   virtual double consumedEnergyTx( double Ptx, double duration );
   
   
+  /**
+  * Adds the power of all the taps but the first one to the interference, as a single interferer 
+  * lasting the Packet duration plus the tap list delay spread
+  *
+  * @param p pointer to the tap list Packet
+  */
+  virtual void addTapInterference( Packet* p );
+  
+  
   virtual const woss::Transducer* const getTransducer( double frequency ) const; 
   
   
@@ -39,6 +39,9 @@
 
 #include <iostream>
 #include <iomanip>
+#include <cmath>
+#include <woss-metrics.h>
+#include <algorithm>
 #include <mphy.h>
 #include "uw-woss-channel.h"
 #include "uw-woss-pkt-hdr.h"
@@ -52,6 +55,13 @@
 using namespace woss;
 
 
+/**
+* Fraction of channel_max_distance added to the spatial index cell size. Moving nodes are re-indexed
+* before they can travel half of this margin
+*/
+#define WOSS_CHANNEL_INDEX_MARGIN (0.5)
+
+
 static class WossChannelModuleClass : public TclClass {
 public:
 	WossChannelModuleClass() : TclClass("WOSS/Module/Channel") {}
@@ -61,18 +71,52 @@ public:
 } class_WossChannelModule_module;
 
 
+WossChannelModule::ChSAPSet WossChannelModule::tap_list_receivers;
+
+
 WossChannelModule::WossChannelModule() 
-: woss_manager(NULL),
+: 
+#ifdef WOSS_MULTITHREAD
+  prefetch_enabled(false),
+  prefetch_release_time(0.0),
+  prefetch_pool(NULL),
+  prefetch_tasks(),
+  prefetch_links(),
+  prefetch_end_times(),
+  prefetch_issued_links(0),
+  prefetch_queried_links(0),
+  prefetch_ready(0),
+  prefetch_saved_stalls(0),
+  prefetch_ready_misses(0),
+  prefetch_in_flight(0),
+  prefetch_mispredicted(0),
+  prefetch_unpredicted(0),
+  prefetch_queries(0),
+  prefetch_query_time(0.0),
+#endif // WOSS_MULTITHREAD
+  index_cell_size(0.0),
+  index_nodes(),
+  index_cells(),
+  index_refresh(),
+  index_max_speed_changes(0),
+  woss_manager(NULL),
   channel_estimator(NULL)
 {
   bind("channel_symbol_resolution_", &channel_symbol_resolution);
   bind("channel_eq_time_", &channel_eq_time);
   bind("channel_eq_snr_threshold_db_", &channel_eq_snr_threshold_db);
   bind("channel_max_distance_", &channel_max_distance);
+  bind("channel_tap_list_", &channel_tap_list);
   bind("windspeed_", &uw.windspeed);
   bind("shipping_", &uw.shipping);
   bind("practical_spreading_", &uw.practical_spreading);
   bind("prop_speed_", &uw.prop_speed);
+#ifdef WOSS_MULTITHREAD
+  bind("prefetch_horizon_", &prefetch_horizon);
+  bind("prefetch_step_", &prefetch_step);
+  bind("prefetch_threads_", &prefetch_threads);
+  bind("prefetch_tolerance_", &prefetch_tolerance);
+#endif // WOSS_MULTITHREAD
 
 //   if (channel_eq_snr_threshold_db < 0) channel_eq_snr_threshold_db = 0;
   if (channel_eq_time < 0.0 ) channel_eq_time = HUGE_VAL;
@@ -83,7 +127,17 @@ WossChannelModule::WossChannelModule()
 
 
 WossChannelModule::~WossChannelModule() {
-  
+#ifdef WOSS_MULTITHREAD
+  // the pool destructor waits for the submitted tasks
+  delete prefetch_pool;
+  prefetch_pool = NULL;
+
+  for ( int i = 0; i < (int)prefetch_tasks.size(); i++ ) {
+    delete prefetch_tasks[i];
+  }
+  prefetch_tasks.clear();
+  prefetch_links.clear();
+#endif // WOSS_MULTITHREAD
 }
 
 
@@ -106,6 +160,23 @@ int WossChannelModule::command(int argc, const char*const* argv) {
       else return TCL_ERROR;
     }
   }  
+  else if (argc==2) {
+    if(strcasecmp(argv[1], "resetSpatialIndex") == 0) {
+      if (debug_) cout << NOW << "  WossChannelModule::command() resetSpatialIndex called"  << endl;
+      
+      // rebuilt on next recv(), needed after a node has been moved by hand
+      index_nodes.clear();
+      return TCL_OK;
+    }
+    else if(strcasecmp(argv[1], "printPrefetchStats") == 0) {
+#ifdef WOSS_MULTITHREAD
+      printPrefetchStats();
+#else
+      cout << NOW << "  WossChannelModule::command() printPrefetchStats, prefetching requires WOSS_MULTITHREAD" << endl;
+#endif // WOSS_MULTITHREAD
+      return TCL_OK;
+    }
+  }
   
   return ChannelModule::command(argc, argv);
 }
@@ -140,7 +211,29 @@ void WossChannelModule::recv(Packet* p, ChSAP* chsap) {
   
   SimFreq sim_freq = computeSimFreq( p );
   
+#ifdef WOSS_MULTITHREAD
+  unsigned long ready_links = 0;
+  
+  if ( prefetch_horizon > 0.0 && ( prefetch_enabled || initPrefetch() ) ) {
+    ready_links = checkPrefetch( chsap, coordinates, sim_freq );
+    issuePrefetch( sim_freq );
+  }
+
+  // only the queries served by a prefetched result count as saved stalls
+  unsigned long prefetch_hits = woss_manager->getPrefetchHits();
+  int64_t query_start = WossMetrics::getTime();
+#endif // WOSS_MULTITHREAD
+
   TimeArrVector channels = computeTimeArrVector( coordinates, sim_freq );
+
+#ifdef WOSS_MULTITHREAD
+  prefetch_queries++;
+  prefetch_query_time += ( WossMetrics::getTime() - query_start ) / 1.0e9;
+  
+  prefetch_hits = woss_manager->getPrefetchHits() - prefetch_hits;
+  prefetch_saved_stalls += prefetch_hits;
+  if ( ready_links > prefetch_hits ) prefetch_ready_misses += ready_links - prefetch_hits;
+#endif // WOSS_MULTITHREAD
   
   assert( channels.size() == coordinates.size() && channels.size() == chsap_vector.size() );
    
@@ -172,7 +265,21 @@ woss::CoordZPairVect WossChannelModule::computeCoordZPairVect( ChSAP* chsap ) {
   
   if (debug_) cout << NOW << " WossChannelModule::computeCoordZPairVect() " << endl;
 
-  for (int i=0; i < getChSAPnum(); i++) {
+  IndexVector receivers;
+  
+  if ( channel_max_distance != HUGE_VAL ) {
+    if ( isIndexStale() ) initIndex();
+    else refreshIndex();
+    
+    receivers = getIndexCandidates( index_cells, tx_coordz );
+  }
+  else {
+    receivers.reserve(getChSAPnum());
+    for (int i=0; i < getChSAPnum(); i++) receivers.push_back(i);
+  }
+
+  for (int j=0; j < (int)receivers.size(); j++) {
+    int i = receivers[j];
     dest = (ChSAP*)getChSAP(i);
           
     if (chsap == dest) { // it's the source node -> skip it
@@ -203,6 +310,118 @@ woss::CoordZPairVect WossChannelModule::computeCoordZPairVect( ChSAP* chsap ) {
 }
 
 
+bool WossChannelModule::isIndexStale() const {
+  return( (int)index_nodes.size() != getChSAPnum() 
+          || index_cell_size != channel_max_distance * ( 1.0 + WOSS_CHANNEL_INDEX_MARGIN ) );
+}
+
+
+void WossChannelModule::initIndex() {
+  index_cell_size = channel_max_distance * ( 1.0 + WOSS_CHANNEL_INDEX_MARGIN );
+  
+  index_nodes.clear();
+  index_cells.clear();
+  index_refresh.clear();
+  index_max_speed_changes = WossPosition::getMaxSpeedChanges();
+  
+  index_nodes.resize(getChSAPnum());
+  
+  for (int i=0; i < getChSAPnum(); i++) {
+    index_nodes[i].position = dynamic_cast< WossPosition* >( ((ChSAP*)getChSAP(i))->getPosition() );
+    index_nodes[i].is_indexed = false;
+    
+    updateIndexNode(i);
+  }
+  
+  if (debug_) cout << NOW << "  WossChannelModule::initIndex() nodes = " << index_nodes.size() 
+                   << "; cells = " << index_cells.size() << "; cell size = " << index_cell_size << endl;
+}
+
+
+void WossChannelModule::refreshIndex() {
+  // nodes may have been given faster waypoints since they were scheduled, or any waypoint at all
+  if ( index_max_speed_changes != WossPosition::getMaxSpeedChanges() ) {
+    index_max_speed_changes = WossPosition::getMaxSpeedChanges();
+    index_refresh.clear();
+    
+    for (int i=0; i < (int)index_nodes.size(); i++) updateIndexNode(i);
+  }
+  
+  while ( !index_refresh.empty() && index_refresh.begin()->first <= NOW ) {
+    int index = index_refresh.begin()->second;
+    index_refresh.erase( index_refresh.begin() );
+    
+    updateIndexNode(index);
+  }
+}
+
+
+void WossChannelModule::updateIndexNode( int index ) {
+  IndexNode& node = index_nodes[index];
+  
+  if ( node.position == NULL ) return;
+  
+  IndexCell cell = getIndexCell( node.position->getLocation() );
+  
+  if ( !node.is_indexed || cell != node.cell ) {
+    if ( node.is_indexed ) {
+      ICMIter it = index_cells.find( node.cell );
+      it->second.erase( ::std::find( it->second.begin(), it->second.end(), index ) );
+      
+      if ( it->second.empty() ) index_cells.erase( it );
+    }
+    
+    index_cells[cell].push_back( index );
+    node.cell = cell;
+    node.is_indexed = true;
+  }
+  
+  double max_speed = node.position->getMaxSpeed();
+  
+  if ( max_speed > 0.0 ) {
+    double refresh_time = NOW + 0.5 * ( index_cell_size - channel_max_distance ) / max_speed;
+    
+    index_refresh.insert( ::std::make_pair( refresh_time, index ) );
+  }
+}
+
+
+WossChannelModule::IndexCell WossChannelModule::getIndexCell( const CoordZ& coordz ) const {
+  // great circle distances are measured on the surface, their chords are never longer
+  CoordZ::CartCoords cart_coords = CoordZ( coordz.getLatitude(), coordz.getLongitude(), 0.0 ).getCartCoords( CoordZ::COORDZ_SPHERE );
+  
+  IndexCell cell;
+  cell.x = (int) ::std::floor( cart_coords.getX() / index_cell_size );
+  cell.y = (int) ::std::floor( cart_coords.getY() / index_cell_size );
+  cell.z = (int) ::std::floor( cart_coords.getZ() / index_cell_size );
+  
+  return cell;
+}
+
+
+WossChannelModule::IndexVector WossChannelModule::getIndexCandidates( const IndexCellMap& cells, const CoordZ& coordz ) const {
+  IndexVector ret_value;
+  IndexCell center = getIndexCell( coordz );
+  IndexCell cell;
+  
+  // a node within index_cell_size lies in one of the 27 neighbouring cells
+  for ( cell.x = center.x - 1; cell.x <= center.x + 1; cell.x++ ) {
+    for ( cell.y = center.y - 1; cell.y <= center.y + 1; cell.y++ ) {
+      for ( cell.z = center.z - 1; cell.z <= center.z + 1; cell.z++ ) {
+        ICMCIter it = cells.find( cell );
+        
+        if ( it != cells.end() ) ret_value.insert( ret_value.end(), it->second.begin(), it->second.end() );
+      }
+    }
+  }
+  
+  // same visiting order of the full scan
+  ::std::sort( ret_value.begin(), ret_value.end() );
+  
+  return ret_value;
+}
+
+
 woss::SimFreq WossChannelModule::computeSimFreq( Packet* p ) {
   hdr_MPhy* ph = HDR_MPHY(p);
 
@@ -317,39 +536,93 @@ void WossChannelModule::checkTimeArrVector( const CoordZPairVect& coords, TimeAr
 
 
 void WossChannelModule::schedulePacketCopies( const woss::CoordZPairVect& coordinates, const woss::TimeArrVector& channels, const woss::SimFreq& sim_freq, Packet* p ) {
+  for( int i = 0; i < (int)coordinates.size(); i++ ) {
+    
+    if ( channel_tap_list != 0 && isTapListReceiver( chsap_vector[i] ) ) scheduleTapList( i, coordinates[i], *channels[i], sim_freq, p );
+    else scheduleTapCopies( i, coordinates[i], *channels[i], sim_freq, p );
+  }
+}
+
+
+void WossChannelModule::scheduleTapCopies( int index, const woss::CoordZPair& coordinates, const woss::TimeArr& channel, const woss::SimFreq& sim_freq, Packet* p ) {
   Scheduler &s = Scheduler::instance();
 
-  for( int i = 0; i < (int)coordinates.size(); i++ ) {
+  double curr_dist = coordinates.first.getCartDistance(coordinates.second);
+  
+  if (debug_) cout << NOW << "  WossChannelModule::scheduleTapCopies() sampled response :" << endl;
+
+  for ( TimeArrCIt it = channel.begin(); it != channel.end(); it++ ) {
+
+    if (debug_) cout << "   delay = " << it->first << "; complex att = " << it->second 
+                      << "; db = " << Pressure::getTxLossDb(it->second) << endl;
+
+    Packet* p_copy = p->copy();
+
+    hdr_woss* hdr_woss = HDR_WOSS(p_copy);
+
+    Pressure* press_temp = SDefHandler::instance()->getPressure()->create( (it->second) );
+    press_temp->checkAttenuation( curr_dist, sim_freq.first );
+        
+    hdr_woss->already_processed = true;
+    hdr_woss->attenuation = *press_temp;
+    hdr_woss->frequency = sim_freq.first;
+    hdr_woss->total_taps = 0;
+    hdr_woss->tap_power = 0.0;
+    hdr_woss->tap_spread = 0.0;
+
+    if (debug_) cout << "  packet pressure db = " << Pressure::getTxLossDb(hdr_woss->attenuation) << endl;
     
-    double curr_dist = coordinates[i].first.getCartDistance(coordinates[i].second);
+    delete press_temp;
+    press_temp = NULL;
     
-    if (debug_) cout << NOW << "  WossChannelModule::schedulePacketCopies() sampled response :" << endl;
-
-    for ( TimeArrCIt it = channels[i]->begin(); it != channels[i]->end(); it++ ) {
+    s.schedule(chsap_vector[index], p_copy, it->first);
+  }
+}
 
-      if (debug_) cout << "   delay = " << it->first << "; complex att = " << it->second 
-                        << "; db = " << Pressure::getTxLossDb(it->second) << endl;
 
-      Packet* p_copy = p->copy();
+void WossChannelModule::scheduleTapList( int index, const woss::CoordZPair& coordinates, const woss::TimeArr& channel, const woss::SimFreq& sim_freq, Packet* p ) {
+  if ( channel.size() <= 0 ) return;
+  
+  double curr_dist = coordinates.first.getCartDistance(coordinates.second);
+  
+  if (debug_) cout << NOW << "  WossChannelModule::scheduleTapList() sampled response :" << endl;
 
-      hdr_woss* hdr_woss = HDR_WOSS(p_copy);
+  // reused for every tap of this receiver
+  Pressure* press_temp = SDefHandler::instance()->getPressure()->create( 0.0, 0.0 );
+  
+  Packet* p_copy = p->copy();
+  hdr_woss* hdr_woss = HDR_WOSS(p_copy);
+  double list_delay = channel.begin()->first;
+  
+  hdr_woss->already_processed = true;
+  hdr_woss->frequency = sim_freq.first;
+  hdr_woss->total_taps = 0;
+  hdr_woss->tap_power = 0.0;
+  hdr_woss->tap_spread = 0.0;
+  
+  for ( TimeArrCIt it = channel.begin(); it != channel.end(); it++ ) {
 
-      Pressure* press_temp = SDefHandler::instance()->getPressure()->create( (it->second) );
-      press_temp->checkAttenuation( curr_dist, sim_freq.first );
-      const_cast< ::std::complex<double>& >( it->second ) = *press_temp;
-          
-      hdr_woss->already_processed = true;
-      hdr_woss->attenuation = *press_temp;
-      hdr_woss->frequency = sim_freq.first;
+    if (debug_) cout << "   delay = " << it->first << "; complex att = " << it->second 
+                      << "; db = " << Pressure::getTxLossDb(it->second) << endl;
 
-      if (debug_) cout << "  packet pressure db = " << Pressure::getTxLossDb(hdr_woss->attenuation) << endl;
-      
-      delete press_temp;
-      press_temp = NULL;
-      
-      s.schedule(chsap_vector[i], p_copy, it->first);
+    *press_temp = Pressure( it->second );
+    press_temp->checkAttenuation( curr_dist, sim_freq.first );
+    
+    if ( hdr_woss->total_taps == 0 ) hdr_woss->attenuation = *press_temp;
+    else {
+      hdr_woss->tap_power += ::std::pow( press_temp->abs(), 2.0 );
+      hdr_woss->tap_spread = (double) it->first - list_delay;
     }
+    hdr_woss->total_taps++;
   }
+  
+  if (debug_) cout << "  packet taps = " << hdr_woss->total_taps << "; lead pressure db = " 
+                   << Pressure::getTxLossDb(hdr_woss->attenuation) << "; tap power = " << hdr_woss->tap_power 
+                   << "; tap spread = " << hdr_woss->tap_spread << endl;
+
+  Scheduler::instance().schedule(chsap_vector[index], p_copy, list_delay);
+  
+  delete press_temp;
 }
 
 
@@ -362,6 +635,225 @@ void WossChannelModule::deleteChannels( woss::TimeArrVector& channels ) {
 }
   
   
+#ifdef WOSS_MULTITHREAD
+
+WossChannelModule::PrefetchTask::PrefetchTask( WossManager* manager, const CoordZPairVect& coords, const SimFreq& freq, double time )
+: WossThreadTask(),
+  woss_manager(manager),
+  coordinates(coords),
+  sim_freq(freq),
+  time_value(time)
+{
+
+}
+
+
+void WossChannelModule::PrefetchTask::execute() {
+  // results land in the manager's database without evolving the Woss objects of the regular queries
+  woss_manager->prefetchWossTimeArr( coordinates, sim_freq.first, sim_freq.second, time_value );
+}
+
+
+bool WossChannelModule::initPrefetch() {
+  // the prefetch tasks query the manager concurrently with the simulation thread
+  if ( dynamic_cast< WossManagerResDbMT* >( woss_manager ) == NULL ) {
+    cout << NOW << "  WossChannelModule::initPrefetch() WARNING, prefetching requires a WossManagerResDbMT"
+         << " based manager, prefetching disabled" << endl;
+
+    prefetch_horizon = 0.0;
+    return false;
+  }
+
+  if ( prefetch_step <= 0.0 ) prefetch_step = prefetch_horizon;
+  if ( prefetch_threads <= 0 ) prefetch_threads = 1;
+  if ( prefetch_tolerance < 0.0 ) prefetch_tolerance = 0.0;
+
+  prefetch_pool = new WossThreadPool( prefetch_threads );
+  prefetch_release_time = NOW;
+  prefetch_enabled = true;
+
+  if (debug_) cout << NOW << "  WossChannelModule::initPrefetch() horizon = " << prefetch_horizon
+                   << "; step = " << prefetch_step << "; threads = " << prefetch_threads
+                   << "; tolerance = " << prefetch_tolerance << endl;
+
+  return true;
+}
+
+
+unsigned long WossChannelModule::checkPrefetch( ChSAP* chsap, const CoordZPairVect& coords, const SimFreq& sim_freq ) {
+  unsigned long ready_links = 0;
+  
+  for ( int i = 0; i < (int)coords.size(); i++ ) {
+    prefetch_queried_links++;
+
+    PLMIter it = prefetch_links.find( ::std::make_pair( chsap, chsap_vector[i] ) );
+
+    const PrefetchLink* best = NULL;
+    double best_delta = prefetch_step;
+
+    if ( it != prefetch_links.end() ) {
+      for ( PrefetchLinkDeque::const_iterator it2 = it->second.begin(); it2 != it->second.end(); it2++ ) {
+        double delta = ::std::abs( it2->time - NOW );
+
+        if ( it2->sim_freq == sim_freq && delta <= best_delta ) {
+          best = &(*it2);
+          best_delta = delta;
+        }
+      }
+    }
+
+    if ( best == NULL ) prefetch_unpredicted++;
+    else if ( best->tx_coordz.getCartDistance( coords[i].first ) > prefetch_tolerance
+              || best->rx_coordz.getCartDistance( coords[i].second ) > prefetch_tolerance ) prefetch_mispredicted++;
+    else if ( best->task->isDone() ) ready_links++;
+    else prefetch_in_flight++;
+  }
+  prefetch_ready += ready_links;
+
+  if ( NOW - prefetch_release_time >= prefetch_step ) releasePrefetch();
+  
+  return ready_links;
+}
+
+
+void WossChannelModule::issuePrefetch( const SimFreq& sim_freq ) {
+  PTMIter it = prefetch_end_times.find( sim_freq );
+
+  double time = NOW;
+  if ( it != prefetch_end_times.end() && it->second > time ) time = it->second;
+
+  for ( time += prefetch_step; time <= NOW + prefetch_horizon; time += prefetch_step ) {
+    issuePrefetchStep( sim_freq, time );
+    prefetch_end_times[sim_freq] = time;
+  }
+}
+
+
+void WossChannelModule::issuePrefetchStep( const SimFreq& sim_freq, double time ) {
+  ::std::vector< WossPosition* > positions;
+  ::std::vector< CoordZ > locations;
+  positions.reserve( getChSAPnum() );
+  locations.reserve( getChSAPnum() );
+
+  for ( int i = 0; i < getChSAPnum(); i++ ) {
+    positions.push_back( dynamic_cast< WossPosition* >( ((ChSAP*)getChSAP(i))->getPosition() ) );
+
+    if ( positions.back() != NULL ) locations.push_back( positions.back()->getPredictedLocation( time ) );
+    else locations.push_back( CoordZ() );
+  }
+
+  // the predicted locations are culled through a grid like the one of computeCoordZPairVect()
+  bool use_index = ( channel_max_distance != HUGE_VAL );
+  IndexCellMap predicted_cells;
+  IndexVector receivers;
+  
+  if ( use_index ) {
+    if ( isIndexStale() ) initIndex();
+    
+    for ( int i = 0; i < getChSAPnum(); i++ ) {
+      if ( positions[i] != NULL ) predicted_cells[ getIndexCell( locations[i] ) ].push_back( i );
+    }
+  }
+  else {
+    receivers.reserve( getChSAPnum() );
+    for ( int i = 0; i < getChSAPnum(); i++ ) receivers.push_back( i );
+  }
+
+  CoordZPairVect coords;
+  ::std::vector< LinkKey > keys;
+
+  for ( int i = 0; i < getChSAPnum(); i++ ) {
+    if ( positions[i] == NULL || locations[i].getDepth() < 0.0 ) continue;
+    
+    if ( use_index ) receivers = getIndexCandidates( predicted_cells, locations[i] );
+
+    for ( int k = 0; k < (int)receivers.size(); k++ ) {
+      int j = receivers[k];
+      
+      if ( i == j || positions[j] == NULL ) continue;
+
+      if ( locations[i].getGreatCircleDistance( locations[j] ) <= channel_max_distance ) {
+        coords.push_back( ::std::make_pair( locations[i], locations[j] ) );
+        keys.push_back( ::std::make_pair( (ChSAP*)getChSAP(i), (ChSAP*)getChSAP(j) ) );
+      }
+    }
+  }
+
+  if ( coords.empty() ) return;
+
+  PrefetchTask* task = new PrefetchTask( woss_manager, coords, sim_freq, time );
+  prefetch_tasks.push_back( task );
+
+  for ( int i = 0; i < (int)coords.size(); i++ ) {
+    PrefetchLink link;
+    link.tx_coordz = coords[i].first;
+    link.rx_coordz = coords[i].second;
+    link.sim_freq = sim_freq;
+    link.time = time;
+    link.task = task;
+
+    prefetch_links[keys[i]].push_back( link );
+  }
+
+  prefetch_issued_links += coords.size();
+
+  if (debug_) cout << NOW << "  WossChannelModule::issuePrefetchStep() time = " << time
+                   << "; links = " << coords.size() << endl;
+
+  prefetch_pool->submit( task );
+}
+
+
+void WossChannelModule::releasePrefetch() {
+  double release_limit = NOW - prefetch_step;
+
+  for ( PLMIter it = prefetch_links.begin(); it != prefetch_links.end(); ) {
+    PrefetchLinkDeque kept;
+
+    for ( PrefetchLinkDeque::const_iterator it2 = it->second.begin(); it2 != it->second.end(); it2++ ) {
+      if ( it2->time >= release_limit ) kept.push_back( *it2 );
+    }
+
+    if ( kept.empty() ) prefetch_links.erase( it++ );
+    else {
+      it->second.swap( kept );
+      it++;
+    }
+  }
+
+  // no link refers to these tasks anymore
+  PrefetchTaskDeque pending;
+
+  for ( int i = 0; i < (int)prefetch_tasks.size(); i++ ) {
+    if ( prefetch_tasks[i]->getTime() < release_limit && prefetch_tasks[i]->isDone() ) delete prefetch_tasks[i];
+    else pending.push_back( prefetch_tasks[i] );
+  }
+  prefetch_tasks.swap( pending );
+
+  prefetch_release_time = NOW;
+}
+
+
+void WossChannelModule::printPrefetchStats() {
+  unsigned long predicted = prefetch_ready + prefetch_in_flight;
+
+  cout << NOW << "  WossChannelModule::printPrefetchStats() prefetched links = " << prefetch_issued_links
+       << "; queried links = " << prefetch_queried_links
+       << "; predicted = " << predicted
+       << "; accuracy = " << ( prefetch_queried_links > 0 ? (double)predicted / (double)prefetch_queried_links : 0.0 )
+       << "; ready = " << prefetch_ready
+       << "; saved stalls = " << prefetch_saved_stalls
+       << "; misses after prefetch = " << prefetch_ready_misses
+       << "; in flight = " << prefetch_in_flight
+       << "; mispredicted = " << prefetch_mispredicted
+       << "; unpredicted = " << prefetch_unpredicted
+       << "; mean query time = " << ( prefetch_queries > 0 ? prefetch_query_time / (double)prefetch_queries : 0.0 )
+       << " [s]" << endl;
+}
+
+#endif // WOSS_MULTITHREAD
+
+
 double WossChannelModule::getPropDelay( const CoordZ& tx, const CoordZ& rx ) {
   return(uw.getPropagationDelay( tx.getLatitude(), tx.getLongitude(), ( -1.0 * tx.getDepth()),
                                  rx.getLatitude(), rx.getLongitude(), ( -1.0 * rx.getDepth())));
@@ -41,9 +41,16 @@
 #define UW_WOSS_CHANNEL_H
 
 
+#include <vector>
+#include <map>
+#include <set>
 #include <channel-module.h>
 #include <underwater.h>
 #include <woss-manager.h>
+#ifdef WOSS_MULTITHREAD
+#include <deque>
+#include <woss-thread-pool.h>
+#endif // WOSS_MULTITHREAD
 
 
 namespace woss {
@@ -53,6 +60,7 @@ namespace woss {
 
 
 class ChannelEstimator;
+class WossPosition;
 
 
 /**
@@ -77,12 +85,27 @@ class  WossChannelModule : public ChannelModule
   
   virtual void recv(Packet* p, ChSAP* chsap);
   
+  /**
+   * Records that the PHY connected through given ChSAP folds the taps of a tap list Packet 
+   * (see hdr_woss::total_taps). Any other PHY gets one Packet per tap even if channel_tap_list_ is set, 
+   * also when it shares the node with a tap list receiver
+   * @param chsap pointer to the ChSAP of the PHY
+   */
+  static void addTapListReceiver( const ChSAP* chsap ) { tap_list_receivers.insert( chsap ); }
+  
+  static bool isTapListReceiver( const ChSAP* chsap ) { return( tap_list_receivers.find( chsap ) != tap_list_receivers.end() ); }
+  
   
   protected:
 
     
   typedef ::std::vector< ChSAP* > ChSAPVector;
   
+  typedef ::std::set< const ChSAP* > ChSAPSet;
+  
+  
+  static ChSAPSet tap_list_receivers;
+  
   
   double getPropDelay( const woss::CoordZ& s, const woss::CoordZ& d);
  
@@ -97,9 +120,195 @@ class  WossChannelModule : public ChannelModule
 
   void schedulePacketCopies( const woss::CoordZPairVect& coords, const woss::TimeArrVector& channels, const woss::SimFreq& sim_freq, Packet* p );
 
+  // one Packet per tap of given receiver
+  void scheduleTapCopies( int index, const woss::CoordZPair& coords, const woss::TimeArr& channel, const woss::SimFreq& sim_freq, Packet* p );
+
+  // a single Packet for given receiver, all the taps following the first one are folded in its hdr_woss
+  void scheduleTapList( int index, const woss::CoordZPair& coords, const woss::TimeArr& channel, const woss::SimFreq& sim_freq, Packet* p );
+
   void deleteChannels( woss::TimeArrVector& channels );
 
   
+  /**
+   * \brief Cell of the receiver spatial index
+   *
+   * Cartesian cell of a node location projected on the earth sphere surface
+   */
+  struct IndexCell {
+    
+    int x;
+    
+    int y;
+    
+    int z;
+    
+    bool operator<( const IndexCell& right ) const {
+      if ( x != right.x ) return x < right.x;
+      if ( y != right.y ) return y < right.y;
+      return z < right.z;
+    }
+    
+    bool operator!=( const IndexCell& right ) const { return x != right.x || y != right.y || z != right.z; }
+    
+  };
+  
+  struct IndexNode {
+    
+    WossPosition* position;
+    
+    IndexCell cell;
+    
+    bool is_indexed;
+    
+  };
+  
+  typedef ::std::vector< int > IndexVector;
+  typedef ::std::vector< IndexNode > IndexNodeVector;
+  typedef ::std::map< IndexCell, IndexVector > IndexCellMap;
+  typedef IndexCellMap::iterator ICMIter;
+  typedef IndexCellMap::const_iterator ICMCIter;
+  typedef ::std::multimap< double, int > IndexRefreshMap;
+  typedef IndexRefreshMap::iterator IRMIter;
+  
+  
+  void initIndex();
+  
+  void refreshIndex();
+  
+  void updateIndexNode( int index );
+  
+  IndexCell getIndexCell( const woss::CoordZ& coordz ) const;
+  
+  bool isIndexStale() const;
+  
+  // ChSAP indexes, sorted, of the nodes of given cells that may lie within channel_max_distance of coordz
+  IndexVector getIndexCandidates( const IndexCellMap& cells, const woss::CoordZ& coordz ) const;
+  
+  
+  double index_cell_size; // [m]
+  
+  IndexNodeVector index_nodes;
+  
+  IndexCellMap index_cells;
+  
+  IndexRefreshMap index_refresh;
+  
+  unsigned long index_max_speed_changes; // WossPosition::getMaxSpeedChanges() when index_refresh was filled
+  
+
+  
+#ifdef WOSS_MULTITHREAD
+  
+  /**
+   * \brief Pool task that computes the channels of the links predicted at a future time
+   */
+  class PrefetchTask : public woss::WossThreadTask {
+    
+    public:
+      
+    PrefetchTask( woss::WossManager* manager, const woss::CoordZPairVect& coords, const woss::SimFreq& freq, double time );
+    
+    virtual ~PrefetchTask() { }
+    
+    virtual void execute();
+    
+    double getTime() const { return time_value; }
+    
+    protected:
+      
+    woss::WossManager* woss_manager;
+    
+    woss::CoordZPairVect coordinates;
+    
+    woss::SimFreq sim_freq;
+    
+    double time_value;
+    
+  };
+  
+  
+  // a predicted link, kept until its time is in the past
+  struct PrefetchLink {
+    
+    woss::CoordZ tx_coordz;
+    
+    woss::CoordZ rx_coordz;
+    
+    woss::SimFreq sim_freq;
+    
+    double time;
+    
+    PrefetchTask* task;
+    
+  };
+  
+  typedef ::std::pair< ChSAP*, ChSAP* > LinkKey;
+  typedef ::std::deque< PrefetchLink > PrefetchLinkDeque;
+  typedef ::std::map< LinkKey, PrefetchLinkDeque > PrefetchLinkMap;
+  typedef PrefetchLinkMap::iterator PLMIter;
+  typedef ::std::deque< PrefetchTask* > PrefetchTaskDeque;
+  typedef ::std::map< woss::SimFreq, double > PrefetchTimeMap;
+  typedef PrefetchTimeMap::iterator PTMIter;
+  
+  
+  bool initPrefetch();
+  
+  // returns the number of links whose prefetch task matched and is done
+  unsigned long checkPrefetch( ChSAP* chsap, const woss::CoordZPairVect& coords, const woss::SimFreq& sim_freq );
+  
+  void issuePrefetch( const woss::SimFreq& sim_freq );
+  
+  void issuePrefetchStep( const woss::SimFreq& sim_freq, double time );
+  
+  void releasePrefetch();
+  
+  void printPrefetchStats();
+  
+  
+  double prefetch_horizon; // [s], <= 0 disables prefetching
+  
+  double prefetch_step; // [s]
+  
+  int prefetch_threads;
+  
+  double prefetch_tolerance; // [m]
+  
+  bool prefetch_enabled;
+  
+  double prefetch_release_time;
+  
+  woss::WossThreadPool* prefetch_pool;
+  
+  PrefetchTaskDeque prefetch_tasks;
+  
+  PrefetchLinkMap prefetch_links;
+  
+  PrefetchTimeMap prefetch_end_times;
+  
+  
+  unsigned long prefetch_issued_links;
+  
+  unsigned long prefetch_queried_links;
+  
+  unsigned long prefetch_ready; // links whose prefetch task matched and was done when queried
+  
+  unsigned long prefetch_saved_stalls; // queries actually served by a prefetched result
+  
+  unsigned long prefetch_ready_misses; // ready links that still missed the result db and cache
+  
+  unsigned long prefetch_in_flight;
+  
+  unsigned long prefetch_mispredicted;
+  
+  unsigned long prefetch_unpredicted;
+  
+  unsigned long prefetch_queries;
+  
+  double prefetch_query_time; // monotonic clock time [s] spent in computeTimeArrVector()
+  
+#endif // WOSS_MULTITHREAD
+  
+  
   double channel_eq_snr_threshold_db;
 
   double channel_symbol_resolution;
@@ -110,6 +319,8 @@ class  WossChannelModule : public ChannelModule
 
   double channel_max_distance; // [m]
   
+  int channel_tap_list; // if != 0 schedulePacketCopies() delivers tap lists to tap list receivers
+  
   
   woss::WossManager* woss_manager;
   
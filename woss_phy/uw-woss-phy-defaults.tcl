@@ -46,15 +46,20 @@ WOSS/Definitions/TransducerHandler set debug 0
 
 WOSS/Creator/Database/NetCDF/Bathymetry/GEBCO set debug           0
 WOSS/Creator/Database/NetCDF/Bathymetry/GEBCO set woss_db_debug   0
+WOSS/Creator/Database/NetCDF/Bathymetry/GEBCO set tile_size       256
+WOSS/Creator/Database/NetCDF/Bathymetry/GEBCO set tile_cache_budget 64.0
+WOSS/Creator/Database/NetCDF/Bathymetry/GEBCO set bilinear_interpolation 0
 
 WOSS/Creator/Database/NetCDF/Sediment/DECK41 set debug            0
 WOSS/Creator/Database/NetCDF/Sediment/DECK41 set woss_db_debug    0
 
 WOSS/Creator/Database/NetCDF/SSP/WOA2005/MonthlyAverage set debug          0
 WOSS/Creator/Database/NetCDF/SSP/WOA2005/MonthlyAverage set woss_db_debug  0
+WOSS/Creator/Database/NetCDF/SSP/WOA2005/MonthlyAverage set bilinear_interpolation 0
 
 WOSS/Creator/Database/NetCDF/SSP/WOA2013/MonthlyAverage set debug          0
 WOSS/Creator/Database/NetCDF/SSP/WOA2013/MonthlyAverage set woss_db_debug  0
+WOSS/Creator/Database/NetCDF/SSP/WOA2013/MonthlyAverage set bilinear_interpolation 0
 
 WOSS/Creator/Database/Textual/Results/TimeArr set debug           0
 WOSS/Creator/Database/Textual/Results/TimeArr set woss_db_debug   0
@@ -64,6 +69,16 @@ WOSS/Creator/Database/Textual/Results/Pressure set debug          0
 WOSS/Creator/Database/Textual/Results/Pressure set woss_db_debug  0
 WOSS/Creator/Database/Textual/Results/Pressure set space_sampling 0
 
+WOSS/Creator/Database/Mmap/Results/TimeArr set debug                 0
+WOSS/Creator/Database/Mmap/Results/TimeArr set woss_db_debug         0
+WOSS/Creator/Database/Mmap/Results/TimeArr set space_sampling        0
+WOSS/Creator/Database/Mmap/Results/TimeArr set compaction_threshold  4096
+
+WOSS/Creator/Database/Mmap/Results/Pressure set debug                 0
+WOSS/Creator/Database/Mmap/Results/Pressure set woss_db_debug         0
+WOSS/Creator/Database/Mmap/Results/Pressure set space_sampling        0
+WOSS/Creator/Database/Mmap/Results/Pressure set compaction_threshold  4096
+
 WOSS/Creator/Database/Textual/Bathymetry/UMT_CSV set debug                0
 WOSS/Creator/Database/Textual/Bathymetry/UMT_CSV set woss_db_debug        0
 #Invalid Data to be filled by user in its example
@@ -84,6 +99,10 @@ WOSS/Creator/Bellhop set woss_debug                   0.0
 WOSS/Creator/Bellhop set woss_clean_workdir           0.0
 WOSS/Creator/Bellhop set bellhop_arr_syntax           2
 WOSS/Creator/Bellhop set bellhop_shd_syntax           1
+WOSS/Creator/Bellhop set concurrent_runs              1
+WOSS/Creator/Bellhop set shd_mmap_read                0.0
+WOSS/Creator/Bellhop set fan_depth_step               5.0
+WOSS/Creator/Bellhop set fan_range_step               10.0
 WOSS/Creator/Bellhop set evolution_time_quantum      -1.0
 WOSS/Creator/Bellhop set total_runs                   1
 WOSS/Creator/Bellhop set frequency_step               0.0
@@ -109,6 +128,13 @@ WOSS/Creator/Bellhop set box_range                    -3000.0
 WOSS/Manager/Simple set debug                     0.0
 WOSS/Manager/Simple set is_time_evolution_active -1.0
 WOSS/Manager/Simple set space_sampling            0.0
+WOSS/Manager/Simple set receiver_fan_sector       0.0
+WOSS/Manager/Simple set receiver_fan_min_size     2
+WOSS/Manager/Simple set tx_stack_min_size         0
+WOSS/Manager/Simple set is_snapshot_interpolation_active  -1.0
+WOSS/Manager/Simple set snapshot_error_bound      0.1
+WOSS/Manager/Simple set snapshot_delay_tolerance  1.0e-3
+WOSS/Manager/Simple set snapshot_delay_error_bound 1.0e-4
 
 
 WOSS/Controller set debug 0.0
@@ -119,6 +145,13 @@ WOSS/Definitions/RandomGenerator/C set seed_ 1
 #WOSS/Manager/Simple/MultiThread set is_time_evolution_active -1.0
 #WOSS/Manager/Simple/MultiThread set debug                     0.0
 #WOSS/Manager/Simple/MultiThread set space_sampling            0.0
+#WOSS/Manager/Simple/MultiThread set receiver_fan_sector       0.0
+#WOSS/Manager/Simple/MultiThread set receiver_fan_min_size     2
+#WOSS/Manager/Simple/MultiThread set tx_stack_min_size         0
+#WOSS/Manager/Simple/MultiThread set is_snapshot_interpolation_active  -1.0
+#WOSS/Manager/Simple/MultiThread set snapshot_error_bound      0.1
+#WOSS/Manager/Simple/MultiThread set snapshot_delay_tolerance  1.0e-3
+#WOSS/Manager/Simple/MultiThread set snapshot_delay_error_bound 1.0e-4
 
 PacketHeaderManager set tab_(PacketHeader/WOSS)    1
 
@@ -143,11 +176,16 @@ WOSS/Module/Channel set channel_max_distance_            -1.0
 WOSS/Module/Channel set channel_eq_snr_threshold_db_     -100.0
 WOSS/Module/Channel set channel_symbol_resolution_       -1.0
 WOSS/Module/Channel set channel_eq_time_                 -1.0
+WOSS/Module/Channel set channel_tap_list_                0
 WOSS/Module/Channel set debug_                           0.0
 WOSS/Module/Channel set windspeed_                       0.0
 WOSS/Module/Channel set shipping_                        0.0
 WOSS/Module/Channel set practical_spreading_             1.75
 WOSS/Module/Channel set prop_speed_                      1500.0
+WOSS/Module/Channel set prefetch_horizon_                 -1.0
+WOSS/Module/Channel set prefetch_step_                    10.0
+WOSS/Module/Channel set prefetch_threads_                 1
+WOSS/Module/Channel set prefetch_tolerance_               10.0
 
 WOSS/ChannelEstimator set debug_           0.0
 WOSS/ChannelEstimator set space_sampling_  0.0
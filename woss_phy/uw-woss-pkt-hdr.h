@@ -71,6 +71,22 @@ typedef struct hdr_woss {
   */
   bool already_processed;
 
+  /**
+  * number of channel taps folded in this Packet in tap list delivery mode, 
+  * 0 if the Packet carries the single tap in attenuation
+  */
+  int total_taps;
+
+  /**
+  * summed power of all the taps following the first one, whose attenuation is held by attenuation
+  */
+  double tap_power;
+
+  /**
+  * delay of the last tap relative to the Packet arrival time [s]
+  */
+  double tap_spread;
+
   static int offset_;
   inline static int& offset() { return offset_; }
   inline static struct hdr_woss* access(const Packet* p) {
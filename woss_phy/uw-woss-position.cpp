@@ -49,6 +49,9 @@ public:
 } class_WossPosition;
 
 
+unsigned long WossPosition::max_speed_changes = 0;
+
+
 WossPosition::WossPosition( double latitude, double longitude, double depth, double dist ) 
 : Location( latitude, longitude, depth, dist ),
   min_vertical_orientation(-45.0),
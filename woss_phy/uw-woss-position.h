@@ -113,8 +113,24 @@ class WossPosition : public Position, public woss::Location {
   virtual double getMaxVerticalOrientation();
   
   
+  // location the node will have at given simulation time. It doesn't update the current location
+  virtual woss::CoordZ getPredictedLocation( double time ) { return getLocation(); }
+  
+  // upper bound of the node speed [m/s], 0 for a node that doesn't move by itself
+  virtual double getMaxSpeed() { return 0.0; }
+  
+  // number of times the max speed of any WossPosition has been raised, so that its users can re-read it
+  static unsigned long getMaxSpeedChanges() { return max_speed_changes; }
+  
+  
   protected:
     
+    
+  static void notifyMaxSpeedChange() { max_speed_changes++; }
+  
+  
+  static unsigned long max_speed_changes;
+  
  
   double min_vertical_orientation;
   
@@ -108,6 +108,7 @@ WossWpPosition::WossWpPosition()
 : time_threshold(1e-5),
   last_time_update(0.0),
   current_speed(0.0),
+  max_speed(0.0),
   waypoint_vect(),
   timeid_map()
 {
@@ -252,6 +253,11 @@ double WossWpPosition::addWayPoint( const WayPoint& waypoint ) {
 
   waypoint_vect.push_back( waypoint );
   timeid_map[time_of_arrival] = waypoint_vect.size() - 1;
+  
+  if ( waypoint.getSpeed() > max_speed ) {
+    max_speed = waypoint.getSpeed();
+    notifyMaxSpeedChange();
+  }
   return time_of_arrival;
 }
 
@@ -322,6 +328,23 @@ void WossWpPosition::updateBearing( const woss::CoordZ& prev, const woss::CoordZ
 }
 
   
+woss::CoordZ WossWpPosition::getPredictedLocation( double time ) {
+  // same walk of update(), without touching the current location
+  if ( waypoint_vect.empty() ) return curr_coordz;
+  if ( waypoint_vect.size() == 1 ) return waypoint_vect[0].getDestination();
+  
+  TIMIter it = timeid_map.lower_bound(time);
+  
+  if ( it == timeid_map.end() ) return waypoint_vect[timeid_map.rbegin()->second].getDestination();
+  if ( it->first == time || it == timeid_map.begin() ) return waypoint_vect[it->second].getDestination();
+  
+  TIMIter before_it = it;
+  before_it--;
+  
+  return waypoint_vect[it->second - 1].getCurrentPosition( waypoint_vect[it->second], time - before_it->first );
+}
+
+  
 woss::CoordZ WossWpPosition::getLocation() {
   double now = Scheduler::instance().clock();             
   if (now>last_time_update+time_threshold) update(now);
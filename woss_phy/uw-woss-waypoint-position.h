@@ -73,6 +73,11 @@ class WossWpPosition : public WossPosition {
   virtual double getSpeed();
   
   
+  virtual woss::CoordZ getPredictedLocation( double time );
+  
+  virtual double getMaxSpeed() { return max_speed; }
+  
+  
   protected:
   
   
@@ -157,6 +162,8 @@ class WossWpPosition : public WossPosition {
   
   double current_speed;
   
+  double max_speed;
+  
   WayPointVect waypoint_vect;
   
   TimeIdMap timeid_map;